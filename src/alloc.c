@@ -37,9 +37,10 @@
 #include <stdio.h>
 #include <string.h>
 #include <errno.h>
+#include <pthread.h>
 #include "alloc.h"
 
-static int init;
+static pthread_once_t init = PTHREAD_ONCE_INIT;
 static void alloc_init(void);
 static void clean(void);
 
@@ -54,15 +55,12 @@ static FILE *diag_out;
 static char *fail_fnm;
 static int fail_line;
 
-/* Initialize this interface, when process starts */
+/* Initialize this interface, once, when first called from any thread */
 static void alloc_init(void)
 {
     char *s;
     int od;
 
-    if (init) {
-	return;
-    }
     s = getenv("MEM_DEBUG");
     if (s) {
 	if (sscanf(s, "%d", &od) == 1) {
@@ -83,7 +81,6 @@ static void alloc_init(void)
 	    free(fail_fnm);
 	}
     }
-    init = 1;
 }
 
 /* Clean up when process exits */
@@ -102,9 +99,7 @@ void *Tkx_Malloc(size_t sz, char *fnm, int ln)
 {
     void *m;
 
-    if ( !init ) {
-	alloc_init();
-    }
+    pthread_once(&init, alloc_init);
     m = malloc(sz);
     if (fail_fnm && (ln == fail_line) && strcmp(fail_fnm, fnm) == 0) {
 	return NULL;
@@ -120,9 +115,7 @@ void *Tkx_Calloc(size_t n, size_t sz, char *fnm, int ln)
 {
     void *m;
 
-    if ( !init ) {
-	alloc_init();
-    }
+    pthread_once(&init, alloc_init);
     if (fail_fnm && (ln == fail_line) && strcmp(fail_fnm, fnm) == 0) {
 	return NULL;
     }
@@ -138,9 +131,7 @@ void *Tkx_ReAlloc(void *m, size_t sz, char *fnm, int ln)
 {
     void *m2;
 
-    if ( !init ) {
-	alloc_init();
-    }
+    pthread_once(&init, alloc_init);
     if (fail_fnm && (ln == fail_line) && strcmp(fail_fnm, fnm) == 0) {
 	return NULL;
     }
@@ -164,9 +155,7 @@ void *Tkx_ReAlloc(void *m, size_t sz, char *fnm, int ln)
 /* See alloc (3) */
 void Tkx_Free(void *m, char *fnm, int ln)
 {
-    if ( !init ) {
-	alloc_init();
-    }
+    pthread_once(&init, alloc_init);
     if (diag_out) {
 	fprintf(diag_out, "%p (%09x) freed at %s:%d\n", m, ++c, fnm, ln);
     }
@@ -261,7 +261,7 @@ void Dorade_COMM_Init(struct Dorade_COMM *comm_p)
     memset(comm_p->comment, 0, sizeof(comm_p->comment));
 }
 
-int Dorade_COMM_Read(struct Dorade_COMM *comm_p, char *buf)
+int Dorade_COMM_Read(struct Dorade_COMM *comm_p, char *buf, int swap)
 {
     ValBuf_GetBytes(&buf, comm_p->comment, 500);
     return 1;
@@ -305,21 +305,21 @@ void Dorade_SSWB_Init(struct Dorade_SSWB *sswb_p)
     sswb_p->status = DORADE_BAD_I4;
 }
 
-int Dorade_SSWB_Read(struct Dorade_SSWB *sswb_p, char *buf)
+int Dorade_SSWB_Read(struct Dorade_SSWB *sswb_p, char *buf, int swap)
 {
-    sswb_p->last_used = ValBuf_GetI4BYT(&buf);
-    sswb_p->i_start_time = ValBuf_GetI4BYT(&buf);
-    sswb_p->i_stop_time = ValBuf_GetI4BYT(&buf);
-    sswb_p->sizeof_file = ValBuf_GetI4BYT(&buf);
-    sswb_p->compression_flag = ValBuf_GetI4BYT(&buf);
-    sswb_p->volume_time_stamp = ValBuf_GetI4BYT(&buf);
-    sswb_p->num_parms = ValBuf_GetI4BYT(&buf);
+    sswb_p->last_used = ValBuf_GetI4BYT(&buf, swap);
+    sswb_p->i_start_time = ValBuf_GetI4BYT(&buf, swap);
+    sswb_p->i_stop_time = ValBuf_GetI4BYT(&buf, swap);
+    sswb_p->sizeof_file = ValBuf_GetI4BYT(&buf, swap);
+    sswb_p->compression_flag = ValBuf_GetI4BYT(&buf, swap);
+    sswb_p->volume_time_stamp = ValBuf_GetI4BYT(&buf, swap);
+    sswb_p->num_parms = ValBuf_GetI4BYT(&buf, swap);
     ValBuf_GetBytes(&buf, sswb_p->radar_name, 8);
-    sswb_p->start_time = ValBuf_GetF8BYT(&buf);
-    sswb_p->stop_time = ValBuf_GetF8BYT(&buf);
-    sswb_p->version_num = ValBuf_GetI4BYT(&buf);
-    ValBuf_GetI4BYT(&buf);
-    sswb_p->status = ValBuf_GetI4BYT(&buf);
+    sswb_p->start_time = ValBuf_GetF8BYT(&buf, swap);
+    sswb_p->stop_time = ValBuf_GetF8BYT(&buf, swap);
+    sswb_p->version_num = ValBuf_GetI4BYT(&buf, swap);
+    ValBuf_GetI4BYT(&buf, swap);
+    sswb_p->status = ValBuf_GetI4BYT(&buf, swap);
     return 1;
 }
 
@@ -400,24 +400,24 @@ void Dorade_VOLD_Init(struct Dorade_VOLD *vold_p)
     vold_p->num_sensors = DORADE_BAD_I2;
 }
 
-int Dorade_VOLD_Read(struct Dorade_VOLD *vold_p, char *buf)
+int Dorade_VOLD_Read(struct Dorade_VOLD *vold_p, char *buf, int swap)
 {
-    vold_p->format_version = ValBuf_GetI2BYT(&buf);
-    vold_p->volume_num = ValBuf_GetI2BYT(&buf);
-    vold_p->maximum_bytes = ValBuf_GetI4BYT(&buf);
+    vold_p->format_version = ValBuf_GetI2BYT(&buf, swap);
+    vold_p->volume_num = ValBuf_GetI2BYT(&buf, swap);
+    vold_p->maximum_bytes = ValBuf_GetI4BYT(&buf, swap);
     ValBuf_GetBytes(&buf, vold_p->proj_name, 20);
-    vold_p->year = ValBuf_GetI2BYT(&buf);
-    vold_p->month = ValBuf_GetI2BYT(&buf);
-    vold_p->day = ValBuf_GetI2BYT(&buf);
-    vold_p->data_set_hour = ValBuf_GetI2BYT(&buf);
-    vold_p->data_set_minute = ValBuf_GetI2BYT(&buf);
-    vold_p->data_set_second = ValBuf_GetI2BYT(&buf);
+    vold_p->year = ValBuf_GetI2BYT(&buf, swap);
+    vold_p->month = ValBuf_GetI2BYT(&buf, swap);
+    vold_p->day = ValBuf_GetI2BYT(&buf, swap);
+    vold_p->data_set_hour = ValBuf_GetI2BYT(&buf, swap);
+    vold_p->data_set_minute = ValBuf_GetI2BYT(&buf, swap);
+    vold_p->data_set_second = ValBuf_GetI2BYT(&buf, swap);
     ValBuf_GetBytes(&buf, vold_p->flight_number, 8);
     ValBuf_GetBytes(&buf, vold_p->gen_facility, 8);
-    vold_p->gen_year = ValBuf_GetI2BYT(&buf);
-    vold_p->gen_month = ValBuf_GetI2BYT(&buf);
-    vold_p->gen_day = ValBuf_GetI2BYT(&buf);
-    vold_p->num_sensors = ValBuf_GetI2BYT(&buf);
+    vold_p->gen_year = ValBuf_GetI2BYT(&buf, swap);
+    vold_p->gen_month = ValBuf_GetI2BYT(&buf, swap);
+    vold_p->gen_day = ValBuf_GetI2BYT(&buf, swap);
+    vold_p->num_sensors = ValBuf_GetI2BYT(&buf, swap);
     return 1;
 }
 
@@ -533,64 +533,64 @@ void Dorade_RADD_Init(struct Dorade_RADD *radd_p)
     memset(radd_p->site_name, 0, sizeof(radd_p->site_name));
 }
 
-int Dorade_RADD_Read(struct Dorade_RADD *radd_p, char *buf)
+int Dorade_RADD_Read(struct Dorade_RADD *radd_p, char *buf, int swap)
 {
     int i;
 
     ValBuf_GetBytes(&buf, radd_p->radar_name, 8);
-    radd_p->radar_const = ValBuf_GetF4BYT(&buf);
-    radd_p->peak_power = ValBuf_GetF4BYT(&buf);
-    radd_p->noise_power = ValBuf_GetF4BYT(&buf);
-    radd_p->receiver_gain = ValBuf_GetF4BYT(&buf);
-    radd_p->antenna_gain = ValBuf_GetF4BYT(&buf);
-    radd_p->system_gain = ValBuf_GetF4BYT(&buf);
-    radd_p->horz_beam_width = ValBuf_GetF4BYT(&buf);
-    radd_p->vert_beam_width = ValBuf_GetF4BYT(&buf);
-    radd_p->radar_type = ValBuf_GetI2BYT(&buf);
-    radd_p->scan_mode = ValBuf_GetI2BYT(&buf);
-    radd_p->req_rotat_vel = ValBuf_GetF4BYT(&buf);
-    radd_p->scan_mode_pram0 = ValBuf_GetF4BYT(&buf);
-    radd_p->scan_mode_pram1 = ValBuf_GetF4BYT(&buf);
-    radd_p->num_parms = ValBuf_GetI2BYT(&buf);
-    radd_p->total_num_des = ValBuf_GetI2BYT(&buf);
-    radd_p->data_compress = ValBuf_GetI2BYT(&buf);
-    radd_p->data_reduction = ValBuf_GetI2BYT(&buf);
-    radd_p->data_red_parm0 = ValBuf_GetF4BYT(&buf);
-    radd_p->data_red_parm1 = ValBuf_GetF4BYT(&buf);
-    radd_p->radar_longitude = ValBuf_GetF4BYT(&buf);
-    radd_p->radar_latitude = ValBuf_GetF4BYT(&buf);
-    radd_p->radar_altitude = ValBuf_GetF4BYT(&buf);
-    radd_p->eff_unamb_vel = ValBuf_GetF4BYT(&buf);
-    radd_p->eff_unamb_range = ValBuf_GetF4BYT(&buf);
-    radd_p->num_freq_trans = ValBuf_GetI2BYT(&buf);
-    radd_p->num_ipps_trans = ValBuf_GetI2BYT(&buf);
-    radd_p->freq1 = ValBuf_GetF4BYT(&buf);
-    radd_p->freq2 = ValBuf_GetF4BYT(&buf);
-    radd_p->freq3 = ValBuf_GetF4BYT(&buf);
-    radd_p->freq4 = ValBuf_GetF4BYT(&buf);
-    radd_p->freq5 = ValBuf_GetF4BYT(&buf);
-    radd_p->interpulse_per1 = ValBuf_GetF4BYT(&buf);
-    radd_p->interpulse_per2 = ValBuf_GetF4BYT(&buf);
-    radd_p->interpulse_per3 = ValBuf_GetF4BYT(&buf);
-    radd_p->interpulse_per4 = ValBuf_GetF4BYT(&buf);
-    radd_p->interpulse_per5 = ValBuf_GetF4BYT(&buf);
-    radd_p->extension_num = ValBuf_GetI4BYT(&buf);
+    radd_p->radar_const = ValBuf_GetF4BYT(&buf, swap);
+    radd_p->peak_power = ValBuf_GetF4BYT(&buf, swap);
+    radd_p->noise_power = ValBuf_GetF4BYT(&buf, swap);
+    radd_p->receiver_gain = ValBuf_GetF4BYT(&buf, swap);
+    radd_p->antenna_gain = ValBuf_GetF4BYT(&buf, swap);
+    radd_p->system_gain = ValBuf_GetF4BYT(&buf, swap);
+    radd_p->horz_beam_width = ValBuf_GetF4BYT(&buf, swap);
+    radd_p->vert_beam_width = ValBuf_GetF4BYT(&buf, swap);
+    radd_p->radar_type = ValBuf_GetI2BYT(&buf, swap);
+    radd_p->scan_mode = ValBuf_GetI2BYT(&buf, swap);
+    radd_p->req_rotat_vel = ValBuf_GetF4BYT(&buf, swap);
+    radd_p->scan_mode_pram0 = ValBuf_GetF4BYT(&buf, swap);
+    radd_p->scan_mode_pram1 = ValBuf_GetF4BYT(&buf, swap);
+    radd_p->num_parms = ValBuf_GetI2BYT(&buf, swap);
+    radd_p->total_num_des = ValBuf_GetI2BYT(&buf, swap);
+    radd_p->data_compress = ValBuf_GetI2BYT(&buf, swap);
+    radd_p->data_reduction = ValBuf_GetI2BYT(&buf, swap);
+    radd_p->data_red_parm0 = ValBuf_GetF4BYT(&buf, swap);
+    radd_p->data_red_parm1 = ValBuf_GetF4BYT(&buf, swap);
+    radd_p->radar_longitude = ValBuf_GetF4BYT(&buf, swap);
+    radd_p->radar_latitude = ValBuf_GetF4BYT(&buf, swap);
+    radd_p->radar_altitude = ValBuf_GetF4BYT(&buf, swap);
+    radd_p->eff_unamb_vel = ValBuf_GetF4BYT(&buf, swap);
+    radd_p->eff_unamb_range = ValBuf_GetF4BYT(&buf, swap);
+    radd_p->num_freq_trans = ValBuf_GetI2BYT(&buf, swap);
+    radd_p->num_ipps_trans = ValBuf_GetI2BYT(&buf, swap);
+    radd_p->freq1 = ValBuf_GetF4BYT(&buf, swap);
+    radd_p->freq2 = ValBuf_GetF4BYT(&buf, swap);
+    radd_p->freq3 = ValBuf_GetF4BYT(&buf, swap);
+    radd_p->freq4 = ValBuf_GetF4BYT(&buf, swap);
+    radd_p->freq5 = ValBuf_GetF4BYT(&buf, swap);
+    radd_p->interpulse_per1 = ValBuf_GetF4BYT(&buf, swap);
+    radd_p->interpulse_per2 = ValBuf_GetF4BYT(&buf, swap);
+    radd_p->interpulse_per3 = ValBuf_GetF4BYT(&buf, swap);
+    radd_p->interpulse_per4 = ValBuf_GetF4BYT(&buf, swap);
+    radd_p->interpulse_per5 = ValBuf_GetF4BYT(&buf, swap);
+    radd_p->extension_num = ValBuf_GetI4BYT(&buf, swap);
     ValBuf_GetBytes(&buf, radd_p->config_name, 8);
-    radd_p->config_num = ValBuf_GetI4BYT(&buf);
-    radd_p->aperture_size = ValBuf_GetF4BYT(&buf);
-    radd_p->field_of_view = ValBuf_GetF4BYT(&buf);
-    radd_p->aperture_eff = ValBuf_GetF4BYT(&buf);
+    radd_p->config_num = ValBuf_GetI4BYT(&buf, swap);
+    radd_p->aperture_size = ValBuf_GetF4BYT(&buf, swap);
+    radd_p->field_of_view = ValBuf_GetF4BYT(&buf, swap);
+    radd_p->aperture_eff = ValBuf_GetF4BYT(&buf, swap);
     for (i = 0; i < 11; i++) {
-	radd_p->freq[i] = ValBuf_GetF4BYT(&buf);
+	radd_p->freq[i] = ValBuf_GetF4BYT(&buf, swap);
     }
     for (i = 0; i < 11; i++) {
-	radd_p->interpulse_per[i] = ValBuf_GetF4BYT(&buf);
+	radd_p->interpulse_per[i] = ValBuf_GetF4BYT(&buf, swap);
     }
-    radd_p->pulse_width = ValBuf_GetF4BYT(&buf);
-    radd_p->primary_cop_baseln = ValBuf_GetF4BYT(&buf);
-    radd_p->secondary_cop_baseln = ValBuf_GetF4BYT(&buf);
-    radd_p->pc_xmtr_bandwidth = ValBuf_GetF4BYT(&buf);
-    radd_p->pc_waveform_type = ValBuf_GetI4BYT(&buf);
+    radd_p->pulse_width = ValBuf_GetF4BYT(&buf, swap);
+    radd_p->primary_cop_baseln = ValBuf_GetF4BYT(&buf, swap);
+    radd_p->secondary_cop_baseln = ValBuf_GetF4BYT(&buf, swap);
+    radd_p->pc_xmtr_bandwidth = ValBuf_GetF4BYT(&buf, swap);
+    radd_p->pc_waveform_type = ValBuf_GetI4BYT(&buf, swap);
     ValBuf_GetBytes(&buf, radd_p->site_name, 20);
     return 1;
 }
@@ -783,24 +783,24 @@ void Dorade_CFAC_Init(struct Dorade_CFAC *cfac_p)
     cfac_p->tilt_corr = DORADE_BAD_F;
 }
 
-int Dorade_CFAC_Read(struct Dorade_CFAC *cfac_p, char *buf)
-{
-    cfac_p->azimuth_corr = ValBuf_GetF4BYT(&buf);
-    cfac_p->elevation_corr = ValBuf_GetF4BYT(&buf);
-    cfac_p->range_delay_corr = ValBuf_GetF4BYT(&buf);
-    cfac_p->longitude_corr = ValBuf_GetF4BYT(&buf);
-    cfac_p->latitude_corr = ValBuf_GetF4BYT(&buf);
-    cfac_p->pressure_alt_corr = ValBuf_GetF4BYT(&buf);
-    cfac_p->radar_alt_corr = ValBuf_GetF4BYT(&buf);
-    cfac_p->ew_gndspd_corr = ValBuf_GetF4BYT(&buf);
-    cfac_p->ns_gndspd_corr = ValBuf_GetF4BYT(&buf);
-    cfac_p->vert_vel_corr = ValBuf_GetF4BYT(&buf);
-    cfac_p->heading_corr = ValBuf_GetF4BYT(&buf);
-    cfac_p->roll_corr = ValBuf_GetF4BYT(&buf);
-    cfac_p->pitch_corr = ValBuf_GetF4BYT(&buf);
-    cfac_p->drift_corr = ValBuf_GetF4BYT(&buf);
-    cfac_p->rot_angle_corr = ValBuf_GetF4BYT(&buf);
-    cfac_p->tilt_corr = ValBuf_GetF4BYT(&buf);
+int Dorade_CFAC_Read(struct Dorade_CFAC *cfac_p, char *buf, int swap)
+{
+    cfac_p->azimuth_corr = ValBuf_GetF4BYT(&buf, swap);
+    cfac_p->elevation_corr = ValBuf_GetF4BYT(&buf, swap);
+    cfac_p->range_delay_corr = ValBuf_GetF4BYT(&buf, swap);
+    cfac_p->longitude_corr = ValBuf_GetF4BYT(&buf, swap);
+    cfac_p->latitude_corr = ValBuf_GetF4BYT(&buf, swap);
+    cfac_p->pressure_alt_corr = ValBuf_GetF4BYT(&buf, swap);
+    cfac_p->radar_alt_corr = ValBuf_GetF4BYT(&buf, swap);
+    cfac_p->ew_gndspd_corr = ValBuf_GetF4BYT(&buf, swap);
+    cfac_p->ns_gndspd_corr = ValBuf_GetF4BYT(&buf, swap);
+    cfac_p->vert_vel_corr = ValBuf_GetF4BYT(&buf, swap);
+    cfac_p->heading_corr = ValBuf_GetF4BYT(&buf, swap);
+    cfac_p->roll_corr = ValBuf_GetF4BYT(&buf, swap);
+    cfac_p->pitch_corr = ValBuf_GetF4BYT(&buf, swap);
+    cfac_p->drift_corr = ValBuf_GetF4BYT(&buf, swap);
+    cfac_p->rot_angle_corr = ValBuf_GetF4BYT(&buf, swap);
+    cfac_p->tilt_corr = ValBuf_GetF4BYT(&buf, swap);
     return 1;
 }
 
@@ -890,7 +890,7 @@ void Dorade_PARM_Init(struct Dorade_PARM *parm_p)
     parm_p->next = NULL;
 }
 
-int Dorade_PARM_Read(struct Dorade_PARM *parm_p, char *buf)
+int Dorade_PARM_Read(struct Dorade_PARM *parm_p, char *buf, int swap)
 {
     ValBuf_GetBytes(&buf, parm_p->parm_nm, 8);
     parm_p->parm_nm[8] = '\0';
@@ -898,31 +898,31 @@ int Dorade_PARM_Read(struct Dorade_PARM *parm_p, char *buf)
     parm_p->parm_description[40] = '\0';
     ValBuf_GetBytes(&buf, parm_p->parm_units, 8);
     parm_p->parm_units[8] = '\0';
-    parm_p->interpulse_time = ValBuf_GetI2BYT(&buf);
-    parm_p->xmitted_freq = ValBuf_GetI2BYT(&buf);
-    parm_p->recvr_bandwidth = ValBuf_GetF4BYT(&buf);
-    parm_p->pulse_width = ValBuf_GetI2BYT(&buf);
-    parm_p->polarization = ValBuf_GetI2BYT(&buf);
-    parm_p->num_samples = ValBuf_GetI2BYT(&buf);
-    parm_p->binary_format = ValBuf_GetI2BYT(&buf);
+    parm_p->interpulse_time = ValBuf_GetI2BYT(&buf, swap);
+    parm_p->xmitted_freq = ValBuf_GetI2BYT(&buf, swap);
+    parm_p->recvr_bandwidth = ValBuf_GetF4BYT(&buf, swap);
+    parm_p->pulse_width = ValBuf_GetI2BYT(&buf, swap);
+    parm_p->polarization = ValBuf_GetI2BYT(&buf, swap);
+    parm_p->num_samples = ValBuf_GetI2BYT(&buf, swap);
+    parm_p->binary_format = ValBuf_GetI2BYT(&buf, swap);
     ValBuf_GetBytes(&buf, parm_p->threshold_field, 8);
-    parm_p->threshold_value = ValBuf_GetF4BYT(&buf);
-    parm_p->parameter_scale = ValBuf_GetF4BYT(&buf);
-    parm_p->parameter_bias = ValBuf_GetF4BYT(&buf);
-    parm_p->bad_data = ValBuf_GetI4BYT(&buf);
-    parm_p->extension_num = ValBuf_GetI4BYT(&buf);
+    parm_p->threshold_value = ValBuf_GetF4BYT(&buf, swap);
+    parm_p->parameter_scale = ValBuf_GetF4BYT(&buf, swap);
+    parm_p->parameter_bias = ValBuf_GetF4BYT(&buf, swap);
+    parm_p->bad_data = ValBuf_GetI4BYT(&buf, swap);
+    parm_p->extension_num = ValBuf_GetI4BYT(&buf, swap);
     ValBuf_GetBytes(&buf, parm_p->config_name, 8);
-    parm_p->config_num = ValBuf_GetI4BYT(&buf);
-    parm_p->offset_to_data = ValBuf_GetI4BYT(&buf);
-    parm_p->mks_conversion = ValBuf_GetF4BYT(&buf);
-    parm_p->num_qnames = ValBuf_GetI4BYT(&buf);
+    parm_p->config_num = ValBuf_GetI4BYT(&buf, swap);
+    parm_p->offset_to_data = ValBuf_GetI4BYT(&buf, swap);
+    parm_p->mks_conversion = ValBuf_GetF4BYT(&buf, swap);
+    parm_p->num_qnames = ValBuf_GetI4BYT(&buf, swap);
     ValBuf_GetBytes(&buf, parm_p->qdata_names, 32);
-    parm_p->num_criteria = ValBuf_GetI4BYT(&buf);
+    parm_p->num_criteria = ValBuf_GetI4BYT(&buf, swap);
     ValBuf_GetBytes(&buf, parm_p->criteria_names, 32);
-    parm_p->num_cells = ValBuf_GetI4BYT(&buf);
-    parm_p->meters_to_first_cell = ValBuf_GetF4BYT(&buf);
-    parm_p->meters_between_cells = ValBuf_GetF4BYT(&buf);
-    parm_p->eff_unamb_vel = ValBuf_GetF4BYT(&buf);
+    parm_p->num_cells = ValBuf_GetI4BYT(&buf, swap);
+    parm_p->meters_to_first_cell = ValBuf_GetF4BYT(&buf, swap);
+    parm_p->meters_between_cells = ValBuf_GetF4BYT(&buf, swap);
+    parm_p->eff_unamb_vel = ValBuf_GetF4BYT(&buf, swap);
     return 1;
 }
 
@@ -1038,18 +1038,18 @@ void Dorade_CELV_Init(struct Dorade_CELV *celv_p)
     celv_p->dist_cells = NULL;
 }
 
-int Dorade_CELV_Read(struct Dorade_CELV *celv_p, char *buf)
+int Dorade_CELV_Read(struct Dorade_CELV *celv_p, char *buf, int swap)
 {
     int num_cells;
     float *dist_cells, *d;
 
-    num_cells = ValBuf_GetI4BYT(&buf);
+    num_cells = ValBuf_GetI4BYT(&buf, swap);
     if ( !(dist_cells = CALLOC(num_cells, sizeof(float))) ) {
 	fprintf(stderr, "Could not allocate memory for cell vector.\n");
 	return 0;
     }
     for (d = dist_cells ; d < dist_cells + num_cells; d++) {
-	*d = ValBuf_GetF4BYT(&buf);
+	*d = ValBuf_GetF4BYT(&buf, swap);
     }
     celv_p->num_cells = num_cells;
     celv_p->dist_cells = dist_cells;
@@ -1108,17 +1108,17 @@ void Dorade_CSFD_Init(struct Dorade_CSFD *csfd_p)
     }
 }
 
-int Dorade_CSFD_Read(struct Dorade_CSFD *csfd_p, char *buf)
+int Dorade_CSFD_Read(struct Dorade_CSFD *csfd_p, char *buf, int swap)
 {
     int i;
 
-    csfd_p->num_segments = ValBuf_GetI4BYT(&buf);
-    csfd_p->dist_to_first = ValBuf_GetF4BYT(&buf);
+    csfd_p->num_segments = ValBuf_GetI4BYT(&buf, swap);
+    csfd_p->dist_to_first = ValBuf_GetF4BYT(&buf, swap);
     for (i = 0; i < 8; i++) {
-	csfd_p->spacing[i] = ValBuf_GetF4BYT(&buf);
+	csfd_p->spacing[i] = ValBuf_GetF4BYT(&buf, swap);
     }
     for (i = 0; i < 8; i++) {
-	csfd_p->num_cells[i] = ValBuf_GetI2BYT(&buf);
+	csfd_p->num_cells[i] = ValBuf_GetI2BYT(&buf, swap);
     }
     return 1;
 }
@@ -1175,15 +1175,15 @@ void Dorade_SWIB_Init(struct Dorade_SWIB *swib_p)
     swib_p->filter_flag = DORADE_BAD_I4;
 }
 
-int Dorade_SWIB_Read(struct Dorade_SWIB *swib_p, char *buf)
+int Dorade_SWIB_Read(struct Dorade_SWIB *swib_p, char *buf, int swap)
 {
     ValBuf_GetBytes(&buf, swib_p->radar_name, 8);
-    swib_p->sweep_num = ValBuf_GetI4BYT(&buf);
-    swib_p->num_rays = ValBuf_GetI4BYT(&buf);
-    swib_p->start_angle = ValBuf_GetF4BYT(&buf);
-    swib_p->stop_angle = ValBuf_GetF4BYT(&buf);
-    swib_p->fixed_angle = ValBuf_GetF4BYT(&buf);
-    swib_p->filter_flag = ValBuf_GetI4BYT(&buf);
+    swib_p->sweep_num = ValBuf_GetI4BYT(&buf, swap);
+    swib_p->num_rays = ValBuf_GetI4BYT(&buf, swap);
+    swib_p->start_angle = ValBuf_GetF4BYT(&buf, swap);
+    swib_p->stop_angle = ValBuf_GetF4BYT(&buf, swap);
+    swib_p->fixed_angle = ValBuf_GetF4BYT(&buf, swap);
+    swib_p->filter_flag = ValBuf_GetI4BYT(&buf, swap);
     return 1;
 }
 
@@ -1244,26 +1244,26 @@ void Dorade_ASIB_Init(struct Dorade_ASIB *asib_p)
     asib_p->pitch_change = DORADE_BAD_F;
 }
 
-int Dorade_ASIB_Read(struct Dorade_ASIB *asib_p, char *buf)
-{
-    asib_p->longitude = ValBuf_GetF4BYT(&buf);
-    asib_p->latitude = ValBuf_GetF4BYT(&buf);
-    asib_p->altitude_msl = ValBuf_GetF4BYT(&buf);
-    asib_p->altitude_agl = ValBuf_GetF4BYT(&buf);
-    asib_p->ew_velocity = ValBuf_GetF4BYT(&buf);
-    asib_p->ns_velocity = ValBuf_GetF4BYT(&buf);
-    asib_p->vert_velocity = ValBuf_GetF4BYT(&buf);
-    asib_p->heading = ValBuf_GetF4BYT(&buf);
-    asib_p->roll = ValBuf_GetF4BYT(&buf);
-    asib_p->pitch = ValBuf_GetF4BYT(&buf);
-    asib_p->drift_angle = ValBuf_GetF4BYT(&buf);
-    asib_p->rotation_angle = ValBuf_GetF4BYT(&buf);
-    asib_p->tilt = ValBuf_GetF4BYT(&buf);
-    asib_p->ew_horiz_wind = ValBuf_GetF4BYT(&buf);
-    asib_p->ns_horiz_wind = ValBuf_GetF4BYT(&buf);
-    asib_p->vert_wind = ValBuf_GetF4BYT(&buf);
-    asib_p->heading_change = ValBuf_GetF4BYT(&buf);
-    asib_p->pitch_change = ValBuf_GetF4BYT(&buf);
+int Dorade_ASIB_Read(struct Dorade_ASIB *asib_p, char *buf, int swap)
+{
+    asib_p->longitude = ValBuf_GetF4BYT(&buf, swap);
+    asib_p->latitude = ValBuf_GetF4BYT(&buf, swap);
+    asib_p->altitude_msl = ValBuf_GetF4BYT(&buf, swap);
+    asib_p->altitude_agl = ValBuf_GetF4BYT(&buf, swap);
+    asib_p->ew_velocity = ValBuf_GetF4BYT(&buf, swap);
+    asib_p->ns_velocity = ValBuf_GetF4BYT(&buf, swap);
+    asib_p->vert_velocity = ValBuf_GetF4BYT(&buf, swap);
+    asib_p->heading = ValBuf_GetF4BYT(&buf, swap);
+    asib_p->roll = ValBuf_GetF4BYT(&buf, swap);
+    asib_p->pitch = ValBuf_GetF4BYT(&buf, swap);
+    asib_p->drift_angle = ValBuf_GetF4BYT(&buf, swap);
+    asib_p->rotation_angle = ValBuf_GetF4BYT(&buf, swap);
+    asib_p->tilt = ValBuf_GetF4BYT(&buf, swap);
+    asib_p->ew_horiz_wind = ValBuf_GetF4BYT(&buf, swap);
+    asib_p->ns_horiz_wind = ValBuf_GetF4BYT(&buf, swap);
+    asib_p->vert_wind = ValBuf_GetF4BYT(&buf, swap);
+    asib_p->heading_change = ValBuf_GetF4BYT(&buf, swap);
+    asib_p->pitch_change = ValBuf_GetF4BYT(&buf, swap);
     return 1;
 }
 
@@ -1358,19 +1358,19 @@ void Dorade_RYIB_Init(struct Dorade_RYIB *ryib_p)
     ryib_p->ray_status = DORADE_BAD_I4;
 }
 
-int Dorade_RYIB_Read(struct Dorade_RYIB *ryib_p, char *buf)
+int Dorade_RYIB_Read(struct Dorade_RYIB *ryib_p, char *buf, int swap)
 {
-    ryib_p->sweep_num = ValBuf_GetI4BYT(&buf);
-    ryib_p->julian_day = ValBuf_GetI4BYT(&buf);
-    ryib_p->hour = ValBuf_GetI2BYT(&buf);
-    ryib_p->minute = ValBuf_GetI2BYT(&buf);
-    ryib_p->second = ValBuf_GetI2BYT(&buf);
-    ryib_p->millisecond = ValBuf_GetI2BYT(&buf);
-    ryib_p->azimuth = ValBuf_GetF4BYT(&buf);
-    ryib_p->elevation = ValBuf_GetF4BYT(&buf);
-    ryib_p->peak_power = ValBuf_GetF4BYT(&buf);
-    ryib_p->true_scan_rate = ValBuf_GetF4BYT(&buf);
-    ryib_p->ray_status = ValBuf_GetI4BYT(&buf);
+    ryib_p->sweep_num = ValBuf_GetI4BYT(&buf, swap);
+    ryib_p->julian_day = ValBuf_GetI4BYT(&buf, swap);
+    ryib_p->hour = ValBuf_GetI2BYT(&buf, swap);
+    ryib_p->minute = ValBuf_GetI2BYT(&buf, swap);
+    ryib_p->second = ValBuf_GetI2BYT(&buf, swap);
+    ryib_p->millisecond = ValBuf_GetI2BYT(&buf, swap);
+    ryib_p->azimuth = ValBuf_GetF4BYT(&buf, swap);
+    ryib_p->elevation = ValBuf_GetF4BYT(&buf, swap);
+    ryib_p->peak_power = ValBuf_GetF4BYT(&buf, swap);
+    ryib_p->true_scan_rate = ValBuf_GetF4BYT(&buf, swap);
+    ryib_p->ray_status = ValBuf_GetI4BYT(&buf, swap);
     return 1;
 }
 
@@ -1590,6 +1590,7 @@ int Dorade_Sweep_Read(struct Dorade_Sweep *swp_p, FILE *in)
     F4BYT *dp_in;			/* 4 byte floating point input */
     F4BYT *dp1;				/* Loop parameter */
     int cnt;				/* Number of values in a run of data */
+    int swap = 0;			/* If true, swap bytes from in */
 
     /* Initialize input buffer */
     buf_sz = comm_sz;
@@ -1626,14 +1627,14 @@ int Dorade_Sweep_Read(struct Dorade_Sweep *swp_p, FILE *in)
 	    goto error;
 	}
 	buf_p = buf;
-	blk_len = ValBuf_GetI4BYT(&buf_p);
+	blk_len = ValBuf_GetI4BYT(&buf_p, swap);
 	if ( blk_len < 0 && !read ) {
 	    /*
 	       Block size cannot be negative. See if adjusting byte
 	       swapping produces something non-negative.
 	     */
 
-	    Toggle_Swap();
+	    swap = !swap;
 	    Swap_4Byt(&blk_len);
 	    if ( blk_len < 0 ) {
 		fprintf(stderr, "Negative size (%d) for %s block\n",
@@ -1664,7 +1665,7 @@ int Dorade_Sweep_Read(struct Dorade_Sweep *swp_p, FILE *in)
 		   Toggle byte swapping policy and try again.
 		 */
 
-		Toggle_Swap();
+		swap = !swap;
 		Swap_4Byt(&blk_len);
 		blk_len8 = blk_len - 8;
 		if ( fseek(in, 8, SEEK_SET) != 0 ) {
@@ -1697,35 +1698,35 @@ int Dorade_Sweep_Read(struct Dorade_Sweep *swp_p, FILE *in)
 	/* Process block */
 	switch (blk_typ) {
 	    case BT_COMM:
-		if ( !Dorade_COMM_Read(&swp_p->comm, buf) ) {
+		if ( !Dorade_COMM_Read(&swp_p->comm, buf, swap) ) {
 		    fprintf(stderr, "Could not read COMM block.\n%s\n",
 			    strerror(errno));
 		    goto error;
 		}
 		break;
 	    case BT_SSWB:
-		if ( !Dorade_SSWB_Read(&swp_p->sswb, buf) ) {
+		if ( !Dorade_SSWB_Read(&swp_p->sswb, buf, swap) ) {
 		    fprintf(stderr, "Could not read SSWB block.\n%s\n",
 			    strerror(errno));
 		    goto error;
 		}
 		break;
 	    case BT_VOLD:
-		if ( !Dorade_VOLD_Read(&swp_p->vold, buf) ) {
+		if ( !Dorade_VOLD_Read(&swp_p->vold, buf, swap) ) {
 		    fprintf(stderr, "Could not read VOLD block.\n%s\n",
 			    strerror(errno));
 		    goto error;
 		}
 		break;
 	    case BT_RADD:
-		if ( !Dorade_RADD_Read(&swp_p->sensor.radd, buf) ) {
+		if ( !Dorade_RADD_Read(&swp_p->sensor.radd, buf, swap) ) {
 		    fprintf(stderr, "Could not read RADD block.\n%s\n",
 			    strerror(errno));
 		    goto error;
 		}
 		break;
 	    case BT_CFAC:
-		if ( !Dorade_CFAC_Read(&swp_p->sensor.cfac, buf) ) {
+		if ( !Dorade_CFAC_Read(&swp_p->sensor.cfac, buf, swap) ) {
 		    fprintf(stderr, "Could not read CFAC block.\n%s\n",
 			    strerror(errno));
 		    goto error;
@@ -1744,7 +1745,7 @@ int Dorade_Sweep_Read(struct Dorade_Sweep *swp_p, FILE *in)
 		    goto error;
 		}
 		Dorade_PARM_Init(&parm);
-		if ( !Dorade_PARM_Read(&parm, buf) ) {
+		if ( !Dorade_PARM_Read(&parm, buf, swap) ) {
 		    fprintf(stderr, "Failed to read PARM block.\n");
 		    goto error;
 		}
@@ -1764,21 +1765,21 @@ int Dorade_Sweep_Read(struct Dorade_Sweep *swp_p, FILE *in)
 		prev_parm = parm_p;
 		break;
 	    case BT_CELV:
-		if ( !Dorade_CELV_Read(&swp_p->sensor.cell_geo.celv, buf) ) {
+		if ( !Dorade_CELV_Read(&swp_p->sensor.cell_geo.celv, buf, swap) ) {
 		    fprintf(stderr, "Failed to read CELV block.\n");
 		    goto error;
 		}
 		swp_p->sensor.cell_geo_t = CG_CELV;
 		break;
 	    case BT_CSFD:
-		if ( !Dorade_CSFD_Read(&swp_p->sensor.cell_geo.csfd, buf) ) {
+		if ( !Dorade_CSFD_Read(&swp_p->sensor.cell_geo.csfd, buf, swap) ) {
 		    fprintf(stderr, "Failed to read CSFD block.\n");
 		    goto error;
 		}
 		swp_p->sensor.cell_geo_t = CG_CSFD;
 		break;
 	    case BT_SWIB:
-		if ( !Dorade_SWIB_Read(&swp_p->swib, buf) ) {
+		if ( !Dorade_SWIB_Read(&swp_p->swib, buf, swap) ) {
 		    fprintf(stderr, "Failed to read SWIB block.\n");
 		    goto error;
 		}
@@ -1820,14 +1821,14 @@ int Dorade_Sweep_Read(struct Dorade_Sweep *swp_p, FILE *in)
 			    "count known.\n");
 		    goto error;
 		}
-		if ( !Dorade_RYIB_Read(&swp_p->ray_hdr[r].ryib, buf) ) {
+		if ( !Dorade_RYIB_Read(&swp_p->ray_hdr[r].ryib, buf, swap) ) {
 		    fprintf(stderr, "Failed to read RYIB block.\n");
 		    goto error;
 		}
 		parm_p = swp_p->sensor.parm0;
 		break;
 	    case BT_ASIB:
-		if ( !Dorade_ASIB_Read(&swp_p->ray_hdr[r].asib, buf) ) {
+		if ( !Dorade_ASIB_Read(&swp_p->ray_hdr[r].asib, buf, swap) ) {
 		    fprintf(stderr, "Could not read ASIB block, ray %dk.\n", r);
 		    goto error;
 		}
@@ -1867,7 +1868,7 @@ int Dorade_Sweep_Read(struct Dorade_Sweep *swp_p, FILE *in)
 			}
 			break;
 		    case DD_16_BITS:
-			s = ValBuf_GetI2BYT(&buf_p);
+			s = ValBuf_GetI2BYT(&buf_p, swap);
 			dp  = swp_p->dat[p][r];
 			if (swp_p->sensor.radd.data_compress) {
 			    while (s != 1) {
@@ -1887,14 +1888,14 @@ int Dorade_Sweep_Read(struct Dorade_Sweep *swp_p, FILE *in)
 				     */
 
 				    for (c = 0; c < cnt; c++) {
-					s = ValBuf_GetI2BYT(&buf_p);
+					s = ValBuf_GetI2BYT(&buf_p, swap);
 					if (s == parm_p->bad_data) {
 					    *dp++ = NAN;
 					} else {
 					    *dp++ = s * scale_inv - bias;
 					}
 				    }
-				    s = ValBuf_GetI2BYT(&buf_p);
+				    s = ValBuf_GetI2BYT(&buf_p, swap);
 				} else {
 				    /*
 				       Run of no data or bad data.  Put
@@ -1905,7 +1906,7 @@ int Dorade_Sweep_Read(struct Dorade_Sweep *swp_p, FILE *in)
 				    for (c = 0; c < cnt; c++) {
 					*dp++ = NAN;
 				    }
-				    s = ValBuf_GetI2BYT(&buf_p);
+				    s = ValBuf_GetI2BYT(&buf_p, swap);
 				}
 			    }
 			    if (dp != swp_p->dat[p][r] + num_cells) {
@@ -1920,7 +1921,7 @@ int Dorade_Sweep_Read(struct Dorade_Sweep *swp_p, FILE *in)
 				dp[0] = s * scale_inv - bias;
 			    }
 			    for (c = 1; c < num_cells; c++) {
-				s = ValBuf_GetI2BYT(&buf_p);
+				s = ValBuf_GetI2BYT(&buf_p, swap);
 				if ( s == parm_p->bad_data ) {
 				    dp[c] = NAN;
 				} else {
@@ -2238,7 +2239,6 @@ int Dorade_Sweep_Write(struct Dorade_Sweep *swp_p, char *swpFlNm)
 		swpFlNm, strerror(errno));
 	goto error;
     }
-    Swap_4Byt(&fl_sz);
     if ( fseek(out, 508 + 20, SEEK_SET) != 0 ) {
 	fprintf(stderr, "Could not set position in sweep file %s to add "
 		"file size to SSWB block\n%s\n", swpFlNm, strerror(errno));
@@ -2498,27 +2498,37 @@ int Dorade_Smooth(struct Dorade_Sweep *swp_p, int p, int n)
 	goto error;
     }
     for (r = 0; r < num_rays; r++) {
-	for (c = 0; c < num_cells; c++) {
-	    int c_;			/* Cell index in averaging interval */
-	    int c0, c1;			/* Limits for c_ */
-	    int c_used;			/* Number of values to use in
+	float *d = swp_p->dat[p][r];
+	int c0, c1;			/* Cells leaving and entering the
+					   averaging interval for cell c,
+					   which is c - (n - 1) / 2 to
+					   c + n / 2 */
+	int c_used;			/* Number of values to use in
 					   averaging, less than n, because
 					   NAN cell values are skipped. */
-	    float dat_sum;		/* Data total in smoothing interval */
+	double dat_sum;			/* Data total in smoothing interval */
+
+	/*
+	   Keep a running total, so cost does not grow with n.
+	 */
 
-	    c0 = c - (n - 1) / 2;
-	    if ( c0 < 0 ) {
-		c0 = 0;
+	for (dat_sum = 0.0, c_used = 0, c1 = 0; c1 < n / 2 && c1 < num_cells;
+		c1++) {
+	    if ( isfinite(d[c1]) ) {
+		dat_sum += d[c1];
+		c_used++;
 	    }
+	}
+	for (c = 0; c < num_cells; c++) {
 	    c1 = c + n / 2;
-	    if ( c1 >= num_cells ) {
-		c1 = num_cells - 1;
+	    if ( c1 < num_cells && isfinite(d[c1]) ) {
+		dat_sum += d[c1];
+		c_used++;
 	    }
-	    for (dat_sum = 0.0, c_used = 0, c_ = c0; c_ <= c1; c_++) {
-		if ( isfinite(swp_p->dat[p][r][c_]) ) {
-		    dat_sum += swp_p->dat[p][r][c_];
-		    c_used++;
-		}
+	    c0 = c - (n - 1) / 2 - 1;
+	    if ( c0 >= 0 && isfinite(d[c0]) ) {
+		dat_sum -= d[c0];
+		c_used--;
 	    }
 	    dat_r[c] = (c_used > 0) ? dat_sum / c_used : NAN;
 	}
@@ -569,47 +569,47 @@ struct Dorade_Sweep {
  */
 
 void Dorade_COMM_Init(struct Dorade_COMM *);
-int Dorade_COMM_Read(struct Dorade_COMM *, char *);
+int Dorade_COMM_Read(struct Dorade_COMM *, char *, int);
 int Dorade_COMM_Write(struct Dorade_COMM *, FILE *);
 void Dorade_COMM_Print(struct Dorade_COMM *, FILE *);
 void Dorade_SSWB_Init(struct Dorade_SSWB *);
-int Dorade_SSWB_Read(struct Dorade_SSWB *, char *);
+int Dorade_SSWB_Read(struct Dorade_SSWB *, char *, int);
 int Dorade_SSWB_Write(struct Dorade_Sweep *, FILE *);
 void Dorade_SSWB_Print(struct Dorade_SSWB *, FILE *);
 void Dorade_VOLD_Init(struct Dorade_VOLD *);
-int Dorade_VOLD_Read(struct Dorade_VOLD *, char *);
+int Dorade_VOLD_Read(struct Dorade_VOLD *, char *, int);
 int Dorade_VOLD_Write(struct Dorade_VOLD *, FILE *);
 void Dorade_VOLD_Print(struct Dorade_VOLD *, FILE *);
 void Dorade_RADD_Init(struct Dorade_RADD *);
-int Dorade_RADD_Read(struct Dorade_RADD *, char *);
+int Dorade_RADD_Read(struct Dorade_RADD *, char *, int);
 int Dorade_RADD_Write(struct Dorade_RADD *, FILE *);
 void Dorade_RADD_Print(struct Dorade_RADD *, FILE *);
 void Dorade_CFAC_Init(struct Dorade_CFAC *);
-int Dorade_CFAC_Read(struct Dorade_CFAC *, char *);
+int Dorade_CFAC_Read(struct Dorade_CFAC *, char *, int);
 int Dorade_CFAC_Write(struct Dorade_CFAC *, FILE *);
 void Dorade_CFAC_Print(struct Dorade_CFAC *, FILE *);
 void Dorade_PARM_Init(struct Dorade_PARM *);
-int Dorade_PARM_Read(struct Dorade_PARM *, char *);
+int Dorade_PARM_Read(struct Dorade_PARM *, char *, int);
 int Dorade_PARM_Write(struct Dorade_PARM *, FILE *);
 void Dorade_PARM_Print(struct Dorade_PARM *, int n, FILE *);
 void Dorade_CELV_Init(struct Dorade_CELV *);
-int Dorade_CELV_Read(struct Dorade_CELV *, char *);
+int Dorade_CELV_Read(struct Dorade_CELV *, char *, int);
 int Dorade_CELV_Write(struct Dorade_CELV *, FILE *);
 void Dorade_CELV_Print(struct Dorade_CELV *, FILE *);
 void Dorade_CSFD_Init(struct Dorade_CSFD *);
-int Dorade_CSFD_Read(struct Dorade_CSFD *, char *);
+int Dorade_CSFD_Read(struct Dorade_CSFD *, char *, int);
 int Dorade_CSFD_Write(struct Dorade_CSFD *, FILE *);
 void Dorade_CSFD_Print(struct Dorade_CSFD *, FILE *);
 void Dorade_SWIB_Init(struct Dorade_SWIB *);
-int Dorade_SWIB_Read(struct Dorade_SWIB *, char *);
+int Dorade_SWIB_Read(struct Dorade_SWIB *, char *, int);
 int Dorade_SWIB_Write(struct Dorade_SWIB *, FILE *);
 void Dorade_SWIB_Print(struct Dorade_SWIB *, FILE *);
 void Dorade_ASIB_Init(struct Dorade_ASIB *);
-int Dorade_ASIB_Read(struct Dorade_ASIB *, char *);
+int Dorade_ASIB_Read(struct Dorade_ASIB *, char *, int);
 int Dorade_ASIB_Write(struct Dorade_ASIB *, FILE *);
 void Dorade_ASIB_Print(struct Dorade_ASIB *, int, FILE *);
 void Dorade_RYIB_Init(struct Dorade_RYIB *);
-int Dorade_RYIB_Read(struct Dorade_RYIB *, char *);
+int Dorade_RYIB_Read(struct Dorade_RYIB *, char *, int);
 int Dorade_RYIB_Write(struct Dorade_RYIB *, FILE *);
 void Dorade_RYIB_Print(struct Dorade_RYIB *, int, FILE *);
 void Dorade_Sensor_Init(struct Dorade_Sensor *);
@@ -58,6 +58,12 @@
 #define DEG_PER_RAD	57.29577951308232087648
 #endif
 
+/*
+   Length of a record in a Sigmet raw product file
+ */
+
+#define SIGMET_REC_LEN 6144
+
 /*
    Enumerator for the data types defined in the IRIS Programmer's Manual
    (section 3.3).
@@ -80,10 +86,14 @@ enum Sigmet_DataTypeN {
        SIGMET_FLT	float
        SIGMET_DBL	double
        SIGMET_MT	empty. Unknown or pseudo data type
+       SIGMET_F16	2 byte IEEE 754 half precision float
+
+   Fields that are not Sigmet data types can be stored as SIGMET_FLT,
+   SIGMET_F16, or as SIGMET_U1 or SIGMET_U2 with a scale and offset.
  */
 
 enum Sigmet_StorFmt {
-    SIGMET_U1, SIGMET_U2, SIGMET_FLT, SIGMET_DBL, SIGMET_MT
+    SIGMET_U1, SIGMET_U2, SIGMET_FLT, SIGMET_DBL, SIGMET_MT, SIGMET_F16
 };
 
 /*
@@ -99,6 +109,13 @@ enum Sigmet_Multi_PRF {ONE_ONE, TWO_THREE, THREE_FOUR, FOUR_FIVE};
 
 enum Sigmet_ScanMode {PPI_S = 1, RHI, MAN_SCAN, PPI_C, FILE_SCAN};
 
+/*
+   Filters for Sigmet_Vol_Fld_Filter. SIGMET_BOXCAR gives the mean, and
+   SIGMET_MEDIAN the median, of the values in a window around each bin.
+ */
+
+enum Sigmet_FldFilter {SIGMET_BOXCAR, SIGMET_MEDIAN};
+
 /*
    The following structures store data from volume headers.
    Ref. IRIS Programmer's Manual
@@ -487,6 +504,21 @@ struct Sigmet_Sweep_Hdr {
     double angle;			/* Sweep angle, radians */
 };
 
+/*
+   Location of a sweep in a raw product file, for volumes whose sweeps are
+   decoded on demand.
+ */
+
+struct Sigmet_Sweep_Idx {
+    size_t off;				/* Offset of first record of sweep
+					   from start of file */
+    int num_recs;			/* Number of records in sweep */
+    int last;				/* If true, sweep runs to end of
+					   file */
+    int ld;				/* If true, sweep has been decoded,
+					   or there is nothing to decode */
+};
+
 /*
    Ray header
  */
@@ -504,8 +536,13 @@ struct Sigmet_Ray_Hdr {
 
 /*
    Data array. A volume will have one of these for each data type in the
-   volume. If not NULL, u1, u2, or f is an array with dimensions
-   [sweep][ray][bin] with data values from the volume.
+   volume. If not NULL, u1, u2, or f is one contiguous block with the
+   data values for every sweep, ray, and bin in the volume. The value
+   for sweep s, ray r, bin b is at offset
+   s * sweep_stride + r * ray_stride + b. Bins in a ray are adjacent.
+   Use SIGMET_DAT_U1, SIGMET_DAT_U2, or SIGMET_DAT_FLT to get the start
+   of a ray. The block has no pointers, so it can be copied with memcpy,
+   or shared between processes, as is.
  */
 
 #define SIGMET_NAME_LEN 32
@@ -521,21 +558,113 @@ struct Sigmet_Dat {
     enum Sigmet_DataTypeN sig_type;	/* Sigmet data type, if any */
     Sigmet_StorToMxFn stor_to_comp;     /* Function to convert storage value to
                                            computation value */
+    double scale, offset;		/* If scale is not zero, field is not
+					   a Sigmet data type, and U1 or U2
+					   storage value u means
+					   offset + scale * u. 0 means no
+					   data. */
+    float *lut;				/* If not NULL, lut[u] is the
+					   computation value for U1, U2 or
+					   F16 storage value u. Built when
+					   needed. */
+    int lut_prf, lut_wave_len;		/* Headers that lut was built for */
+    enum Sigmet_Multi_PRF lut_prf_mode;
     union {
-	U1BYT ***u1;			/* 1 byte data */
-	U2BYT ***u2;			/* 2 byte data */
-	float ***f;			/* Floating point data */
+	U1BYT *u1;			/* 1 byte data */
+	U2BYT *u2;			/* 2 byte data, or SIGMET_F16 */
+	float *f;			/* Floating point data */
     } vals;
-    int vals_id;			/* Shared memory identifier for vals,
-					   or -1 */
+    size_t sweep_stride;		/* Values per sweep in vals */
+    size_t ray_stride;			/* Values per ray in vals */
+    size_t vals_sz;			/* Bytes allocated at vals */
 };
 
 /*
-   Maximum number of data types allowed in a Sigmet volume.
+   Address of the first bin of ray r in sweep s of the values in
+   struct Sigmet_Dat *dat_p, with storage format SIGMET_U1, SIGMET_U2 or
+   SIGMET_F16, or SIGMET_FLT respectively.
  */
 
-#define SIGMET_MAX_TYPES 512
+#define SIGMET_DAT_U1(dat_p, s, r)					\
+    ((dat_p)->vals.u1 + (size_t)(s) * (dat_p)->sweep_stride		\
+     + (size_t)(r) * (dat_p)->ray_stride)
+#define SIGMET_DAT_U2(dat_p, s, r)					\
+    ((dat_p)->vals.u2 + (size_t)(s) * (dat_p)->sweep_stride		\
+     + (size_t)(r) * (dat_p)->ray_stride)
+#define SIGMET_DAT_FLT(dat_p, s, r)					\
+    ((dat_p)->vals.f + (size_t)(s) * (dat_p)->sweep_stride		\
+     + (size_t)(r) * (dat_p)->ray_stride)
+
+/*
+   Maximum number of sweeps in a volume scan, per IRIS documentation.
+ */
 
+#define SIGMET_MAX_SWEEPS 40
+
+/*
+   struct Sigmet_Vol_Filter:
+
+   Select the data types and sweeps that Sigmet_Vol_Read loads.  Types
+   and sweeps that are not selected are skipped while the volume is read,
+   and no memory is allocated for them.  Sweeps with index at or beyond
+   SIGMET_MAX_SWEEPS are always loaded.  Also set the number of threads
+   that decode sweeps.
+ */
+
+struct Sigmet_Vol_Filter {
+    int types[SIGMET_NTYPES];		/* If true, load data type.  Index
+					   with enum Sigmet_DataTypeN */
+    int sweeps[SIGMET_MAX_SWEEPS];	/* If true, load sweep.  Index is
+					   sweep index, 0 is first sweep */
+    int num_threads;			/* Number of threads that decode
+					   sweeps and compute fields */
+};
+
+/*
+   struct Sigmet_Ray:
+
+   One ray from Sigmet_Vol_Scan.  vals[y] has storage values for data
+   type y of the volume, as u1 or u2 depending on the stor_fmt member of
+   dat[y] in the volume.  Each has num_bins_out elements.  The same
+   buffers receive the next ray.
+ */
+
+struct Sigmet_Ray {
+    int s;				/* Sweep index */
+    int r;				/* Ray index */
+    struct Sigmet_Ray_Hdr hdr;		/* Ray header */
+    union {
+	U1BYT *u1;			/* 1 byte data */
+	U2BYT *u2;			/* 2 byte data */
+    } vals[SIGMET_NTYPES];		/* Storage values for each data type
+					   in the volume */
+};
+
+/*
+   Ray callback for Sigmet_Vol_Scan.  Return true to continue scanning,
+   or false to stop.
+ */
+
+struct Sigmet_Vol;
+typedef int (*Sigmet_RayFn)(struct Sigmet_Vol *, struct Sigmet_Ray *,
+	void *);
+
+/*
+   struct Sigmet_Vol_In:
+
+   Input stream for a raw product file, which might be compressed with
+   gzip or bzip2.  If it is, a thread decompresses the file into a buffer
+   in memory while the caller reads and decodes from f, which has no file
+   descriptor.  Use Sigmet_Vol_Open and Sigmet_Vol_Close.
+ */
+
+struct sigmet_unz;
+struct Sigmet_Vol_In {
+    FILE *f;				/* Provide uncompressed raw product
+					   file */
+    struct sigmet_unz *unz;		/* Decompressor providing f, or
+					   NULL */
+};
 
 /*
    struct Sigmet_Vol:
@@ -551,12 +680,16 @@ struct Sigmet_Dat {
    3.1).
  */
 
+struct sigmet_ingest;
+struct sigmet_chunk;
 struct Sigmet_Vol {
     int has_headers;			/* true => struct has headers */
     struct Sigmet_Product_Hdr ph;	/* Record #1 */
     struct Sigmet_Ingest_Header ih;	/* Record #2 */
     int xhdr;				/* true => extended headers present */
     int num_types;			/* Number of data types */
+    int num_types_fl;			/* Number of data types in raw
+					   product file, including DB_XHDR */
     enum Sigmet_DataTypeN
 	types_fl[SIGMET_NTYPES];	/* Data types in raw product
 					   file. This means Sigmet
@@ -569,39 +702,58 @@ struct Sigmet_Vol {
 					   "STOP NOW" during the task,
 					   or if a volume transfer fails */
     int num_sweeps_ax;			/* Actual number of sweeps */
+    int swap;				/* If true, multi-byte values in the
+					   raw product file have the other
+					   byte order */
+    struct Sigmet_Vol_Filter filter;	/* Data types and sweeps loaded */
     struct Sigmet_Sweep_Hdr *sweep_hdr;	/* Sweep headers, dimensioned
 					   num_sweeps_ax */
-    int sweep_hdr_id;			/* Shared memory identifier for sweep
-					   headers */
     struct Sigmet_Ray_Hdr **ray_hdr;	/* Ray headers,
 					   dimensioned [sweep][ray] */
-    int ray_hdr_id;			/* Shared memory identifier for ray
-					   headers */
+    U1BYT *rec_map;			/* Memory map of raw product file, if
+					   sweeps are decoded on demand.
+					   Otherwise NULL. */
+    size_t rec_map_sz;			/* Size of rec_map */
+    struct Sigmet_Sweep_Idx *sweep_idx;	/* Where to find sweeps in rec_map,
+					   dimensioned num_sweeps, or NULL */
 
     /*
-       Data array. One element for each data type.
+       Data arrays. One element for each data type. Allocations grow
+       as fields are added.
      */
 
-    struct Sigmet_Dat dat[SIGMET_MAX_TYPES];
+    struct Sigmet_Dat *dat;		/* Data arrays, num_types in use */
+    int dat_max;			/* Allocation at dat, in elements */
 
     /*
-       Look up table, associates data type names with offsets in dat array
+       Look up table, associates data type names with offsets in dat array.
+       Each slot has an index into dat, or -1. The number of slots is a
+       power of two, at least twice dat_max.
      */
 
-    struct {
-	char data_type_s[SIGMET_NAME_LEN];/* Data type abbreviation */
-	int y;				/* Index in dat of data identified as of
-					   type data_type_s */
-    } types_tbl[SIGMET_MAX_TYPES];
+    int *types_tbl;			/* Indeces into dat, hashed by data
+					   type abbreviation */
+    unsigned types_tbl_sz;		/* Number of slots in types_tbl */
 
     size_t size;			/* Number of bytes of memory
 					   this structure is using */
     int mod;				/* If true, volume in memory
 					   is different from volume in
 					   raw product file */
-    int shm;				/* If true, volume allocations are in
-					   shared memory. Otherwise, allocations
-					   are in process address space. */
+    char *arena;			/* If not NULL, a private map of a
+					   shared memory arena or cache file,
+					   from Sigmet_Vol_ShmAttach or
+					   Sigmet_Vol_CacheRead, that holds
+					   the sweep headers, ray headers, and
+					   field values of the volume. */
+    size_t arena_sz;			/* Size of arena */
+    struct sigmet_chunk *chunks;	/* Memory for headers and field
+					   values, released all at once
+					   when the volume is freed */
+    struct sigmet_ingest *ingest;	/* If not NULL, a thread is still
+					   decoding the volume as its raw
+					   product file grows. See
+					   Sigmet_Vol_Follow. */
 };
 
 /*
@@ -619,10 +771,19 @@ enum SigmetStatus {
  */
 
 void Sigmet_Vol_Init(struct Sigmet_Vol *);
+void Sigmet_Vol_FilterInit(struct Sigmet_Vol_Filter *);
 enum SigmetStatus Sigmet_Vol_Free(struct Sigmet_Vol *);
-enum SigmetStatus Sigmet_ShMemAttach(struct Sigmet_Vol *);
-enum SigmetStatus Sigmet_ShMemDetach(struct Sigmet_Vol *);
+enum SigmetStatus Sigmet_Vol_ShmPublish(struct Sigmet_Vol *, const char *);
+enum SigmetStatus Sigmet_Vol_ShmAttach(const char *, struct Sigmet_Vol *);
+enum SigmetStatus Sigmet_Vol_ShmUnlink(const char *);
+enum SigmetStatus Sigmet_Vol_CacheWrite(struct Sigmet_Vol *, const char *,
+	const char *);
+enum SigmetStatus Sigmet_Vol_CacheRead(const char *,
+	struct Sigmet_Vol_Filter *, const char *, struct Sigmet_Vol *);
+enum SigmetStatus Sigmet_Vol_Open(const char *, struct Sigmet_Vol_In *);
+enum SigmetStatus Sigmet_Vol_Close(struct Sigmet_Vol_In *);
 enum SigmetStatus Sigmet_Vol_ReadHdr(FILE *, struct Sigmet_Vol *);
+enum SigmetStatus Sigmet_Vol_DecodeHdr(char *, struct Sigmet_Vol *);
 enum SigmetStatus Sigmet_Vol_DataTypeHdrs(struct Sigmet_Vol *, int, char **,
 	char **, char **);
 void Sigmet_Vol_PrintHdr(FILE *, struct Sigmet_Vol *);
@@ -639,7 +800,16 @@ enum SigmetStatus Sigmet_Vol_RayHdr(struct Sigmet_Vol *, int, int, int *,
 	double *, int *, double *, double *, double *, double *);
 int Sigmet_Vol_IsPPI(struct Sigmet_Vol *);
 int Sigmet_Vol_IsRHI(struct Sigmet_Vol *);
-enum SigmetStatus Sigmet_Vol_Read(FILE *, struct Sigmet_Vol *);
+enum SigmetStatus Sigmet_Vol_Read(FILE *, struct Sigmet_Vol *,
+	struct Sigmet_Vol_Filter *);
+enum SigmetStatus Sigmet_Vol_ReadIdx(FILE *, struct Sigmet_Vol *,
+	struct Sigmet_Vol_Filter *);
+enum SigmetStatus Sigmet_Vol_LoadSweep(struct Sigmet_Vol *, int);
+enum SigmetStatus Sigmet_Vol_Scan(FILE *, struct Sigmet_Vol *,
+	struct Sigmet_Vol_Filter *, Sigmet_RayFn, void *);
+enum SigmetStatus Sigmet_Vol_Follow(FILE *, struct Sigmet_Vol *,
+	struct Sigmet_Vol_Filter *, double);
+enum SigmetStatus Sigmet_Vol_FollowEnd(struct Sigmet_Vol *);
 void Sigmet_Vol_LzCpy(struct Sigmet_Vol *, struct Sigmet_Vol *);
 double Sigmet_Vol_RadarLon(struct Sigmet_Vol *, double *);
 double Sigmet_Vol_RadarLat(struct Sigmet_Vol *, double *);
@@ -649,16 +819,19 @@ enum SigmetStatus Sigmet_Vol_RayGeom(struct Sigmet_Vol *, int ,
 	double *, double *, double *, double *, double *, double *, int);
 double Sigmet_Vol_BinStart(struct Sigmet_Vol *, int);
 enum SigmetStatus Sigmet_Vol_PPI_Bnds(struct Sigmet_Vol *, int,
-	int (*)(double, double, double *, double *),
+	int (*)(double, double, double *, double *, void *), void *,
 	double *, double *, double *, double *);
 enum SigmetStatus Sigmet_Vol_PPI_BinOutl(struct Sigmet_Vol *, int, int, int,
-	int (*)(double, double, double *, double *), double *);
+	int (*)(double, double, double *, double *, void *), void *,
+	double *);
 enum SigmetStatus Sigmet_Vol_RHI_Bnds(struct Sigmet_Vol *, int, double *,
 	double *);
 enum SigmetStatus Sigmet_Vol_RHI_BinOutl(struct Sigmet_Vol *, int, int, int,
 	double *);
 enum SigmetStatus Sigmet_Vol_NewField(struct Sigmet_Vol *, char *, char *,
 	char *);
+enum SigmetStatus Sigmet_Vol_NewFieldFmt(struct Sigmet_Vol *, char *, char *,
+	char *, enum Sigmet_StorFmt, double, double);
 enum SigmetStatus Sigmet_Vol_DelField(struct Sigmet_Vol *, char *);
 enum SigmetStatus Sigmet_Vol_Fld_SetVal(struct Sigmet_Vol *, char *, float);
 enum SigmetStatus Sigmet_Vol_Fld_SetRBeam(struct Sigmet_Vol *, char *);
@@ -672,6 +845,14 @@ enum SigmetStatus Sigmet_Vol_Fld_MulFld(struct Sigmet_Vol *, char *, char *);
 enum SigmetStatus Sigmet_Vol_Fld_DivVal(struct Sigmet_Vol *, char *, float);
 enum SigmetStatus Sigmet_Vol_Fld_DivFld(struct Sigmet_Vol *, char *, char *);
 enum SigmetStatus Sigmet_Vol_Fld_Log10(struct Sigmet_Vol *, char *);
+enum SigmetStatus Sigmet_Vol_Fld_Calc(struct Sigmet_Vol *, char *, char *);
+enum SigmetStatus Sigmet_Vol_Fld_Mask(struct Sigmet_Vol *, char *, char *,
+	char *, double);
+enum SigmetStatus Sigmet_Vol_Fld_Despeckle(struct Sigmet_Vol *, char *, int,
+	int, int);
+enum SigmetStatus Sigmet_Vol_Fld_Filter(struct Sigmet_Vol *, char *, char *,
+	enum Sigmet_FldFilter, int, int);
+enum SigmetStatus Sigmet_Vol_Fld_Dealias(struct Sigmet_Vol *, char *, char *);
 enum SigmetStatus Sigmet_Vol_IncrTm(struct Sigmet_Vol *, double);
 enum SigmetStatus Sigmet_Vol_ShiftAz(struct Sigmet_Vol *, double);
 double Sigmet_Vol_VNyquist(struct Sigmet_Vol *);
@@ -687,8 +868,8 @@ enum SigmetStatus Sigmet_Vol_ToDorade(struct Sigmet_Vol *, int,
    coordinates.
  */
 
-int Sigmet_Proj_Set(char *);
-int Sigmet_Proj_XYTLonLat(double, double, double *, double *);
-int Sigmet_Proj_LonLatToXY(double, double, double *, double *);
+int Sigmet_Proj_Set(struct GeogProj *, char *);
+int Sigmet_Proj_XYTLonLat(double, double, double *, double *, void *);
+int Sigmet_Proj_LonLatToXY(double, double, double *, double *, void *);
 
 #endif
@@ -0,0 +1,703 @@
+/*
+   -	sigmet_cat.c --
+   -		Build and query a catalog of the headers of Sigmet
+   -		raw product files.
+   - 
+   .	Copyright (c) 2013 Gordon D. Carrie.  All rights reserved.
+   .	
+   .	Redistribution and use in source and binary forms, with or without
+   .	modification, are permitted provided that the following conditions
+   .	are met:
+   .	
+   .	    * Redistributions of source code must retain the above copyright
+   .	    notice, this list of conditions and the following disclaimer.
+   .
+   .	    * Redistributions in binary form must reproduce the above copyright
+   .	    notice, this list of conditions and the following disclaimer in the
+   .	    documentation and/or other materials provided with the distribution.
+   .	
+   .	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   .	"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   .	LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   .	A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   .	HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   .	SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+   .	TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   .	PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   .	LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   .	NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   .	SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+   .
+   .	Please send feedback to dev0@trekix.net
+   .
+   .	$Revision: $ $Date: $
+ */
+
+#include "unix_defs.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include <errno.h>
+#include <unistd.h>
+#include <ftw.h>
+#include <pthread.h>
+#include "alloc.h"
+#include "strlcpy.h"
+#include "tm_calc_lib.h"
+#include "sigmet.h"
+
+/*
+   Usage
+   sigmet_cat make [-j threads] catalog path ...
+   sigmet_cat query [-l] [-t start end] [-s site] [-m scan_mode]
+	   [-y data_type] catalog
+ */
+
+/*
+   A catalog file has a header, an array of entries sorted by volume
+   start time, and a table of null terminated file paths. Values are
+   stored in the byte order of the machine that made the catalog.
+ */
+
+#define CAT_MAGIC "sigmet_cat 1"
+#define CAT_ORDER 0x01020304U
+struct cat_hdr {
+    char magic[16];			/* CAT_MAGIC */
+    unsigned order;			/* CAT_ORDER, to detect other byte
+					   order */
+    unsigned ent_sz;			/* sizeof(struct cat_ent) */
+    unsigned num_ents;			/* Number of entries */
+    unsigned strs_sz;			/* Size of path table */
+};
+struct cat_ent {
+    double tm;				/* Volume start time, seconds since
+					   1970/01/01 00:00:00 */
+    unsigned types;			/* Bit n is set if volume has Sigmet
+					   data type n */
+    unsigned path;			/* Offset of file path in path table */
+    int num_sweeps;			/* Number of sweeps in task */
+    int num_rays;			/* Number of rays per sweep */
+    int num_bins;			/* Number of output bins */
+    int bin0;				/* Range to first bin, cm */
+    int bin_step;			/* Bin step, cm */
+    float angles[SIGMET_MAX_SWEEPS];	/* Sweep angles, degrees. Elevations
+					   for PPI, azimuths for RHI. */
+    char site[17];			/* Site name */
+    char task[13];			/* Task name */
+    char scan_mode;			/* enum Sigmet_ScanMode */
+};
+
+/*
+   Catalog builder threads take the next path from a shared counter.
+ */
+
+struct cat_pool {
+    char *strs;				/* Paths, null separated */
+    size_t *paths;			/* Offset of each path in strs */
+    size_t num_paths;			/* Number of paths */
+    size_t n;				/* Next path to read */
+    struct cat_ent *ents;		/* Entry for each path */
+    unsigned char *good;		/* If good[n], ents[n] is a volume */
+    pthread_mutex_t mtx;		/* Guard n */
+};
+
+/*
+   Paths found while walking the directory trees for the catalog.
+ */
+
+static char *strs;			/* Paths, null separated */
+static size_t strs_sz;			/* Bytes used in strs */
+static size_t strs_max;			/* Allocation at strs */
+static size_t *paths;			/* Offset of each path in strs */
+static size_t num_paths;		/* Number of paths */
+static size_t paths_max;		/* Allocation at paths */
+
+/*
+   Scan mode names, indexed by enum Sigmet_ScanMode.
+ */
+
+static char *scan_mode_nm[] = {
+    "unknown", "ppi_sector", "rhi", "manual", "ppi_continuous", "file"
+};
+
+static int make_cb(int, char *[]);
+static int query_cb(int, char *[]);
+static int visit(const char *, const struct stat *, int, struct FTW *);
+static void *cat_thr(void *);
+static int cat_ent_set(struct cat_ent *, char *, struct Sigmet_Vol *);
+static int ent_cmp(const void *, const void *);
+static double epoch(int, int, int, double);
+static int tm_parse(char *, double *);
+static void tm_print(FILE *, double);
+static int scan_mode_match(char, char *);
+
+int main(int argc, char *argv[])
+{
+    char *argv0 = argv[0];
+
+    if ( argc == 2 && strcmp(argv[1], "-v") == 0 ) {
+	printf("%s version %s\nCopyright (c) 2013, Gordon D. Carrie.\n"
+		"All rights reserved.\n", argv0, SIGMET_RAW_VERSION);
+	return EXIT_SUCCESS;
+    }
+    if ( argc > 1 && strcmp(argv[1], "make") == 0 ) {
+	return make_cb(argc, argv) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    if ( argc > 1 && strcmp(argv[1], "query") == 0 ) {
+	return query_cb(argc, argv) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    fprintf(stderr, "Usage: %s make [-j threads] catalog path ...\n"
+	    "       %s query [-l] [-t start end] [-s site] [-m scan_mode] "
+	    "[-y data_type] catalog\n", argv0, argv0);
+    return EXIT_FAILURE;
+}
+
+/*
+   Make a catalog of the raw product files at or under the paths given
+   on the command line. Read only the first two records of each file.
+ */
+
+static int make_cb(int argc, char *argv[])
+{
+    char *argv0 = argv[0];
+    char *cat_fl_nm;			/* Catalog file name */
+    FILE *cat_fl = NULL;		/* Catalog file */
+    int num_thr = 1;			/* Number of threads */
+    pthread_t *thr = NULL;		/* Threads that read headers */
+    struct cat_pool pool;		/* Paths to read */
+    struct cat_hdr hdr;			/* Catalog header */
+    char *cat_strs = NULL;		/* Path table for catalog */
+    size_t cat_strs_sz;			/* Size of cat_strs */
+    size_t n, num_ents;
+    int a, status;
+
+    memset(&pool, 0, sizeof(pool));
+    for (a = 2; a < argc && argv[a][0] == '-'; a += 2) {
+	if ( strcmp(argv[a], "-j") == 0 && a + 1 < argc ) {
+	    if ( sscanf(argv[a + 1], "%d", &num_thr) != 1 || num_thr < 1 ) {
+		fprintf(stderr, "%s: expected positive integer for number of "
+			"threads, got %s.\n", argv0, argv[a + 1]);
+		return 0;
+	    }
+	} else {
+	    fprintf(stderr, "%s: unknown option %s.\n", argv0, argv[a]);
+	    return 0;
+	}
+    }
+    if ( argc - a < 2 ) {
+	fprintf(stderr, "Usage: %s make [-j threads] catalog path ...\n",
+		argv0);
+	return 0;
+    }
+    cat_fl_nm = argv[a++];
+
+    /*
+       Find the files.
+     */
+
+    for ( ; a < argc; a++) {
+	if ( nftw(argv[a], visit, 32, FTW_PHYS) != 0 ) {
+	    fprintf(stderr, "%s: could not search %s.\n%s\n",
+		    argv0, argv[a], strerror(errno));
+	    goto error;
+	}
+    }
+
+    /*
+       Read the headers, on several threads.
+     */
+
+    pool.strs = strs;
+    pool.paths = paths;
+    pool.num_paths = num_paths;
+    pool.n = 0;
+    if ( num_paths > 0
+	    && (!(pool.ents = CALLOC(num_paths, sizeof(struct cat_ent)))
+		|| !(pool.good = CALLOC(num_paths, 1))) ) {
+	fprintf(stderr, "%s: could not allocate catalog for %lu files.\n",
+		argv0, (unsigned long)num_paths);
+	goto error;
+    }
+    if ( (status = pthread_mutex_init(&pool.mtx, NULL)) != 0 ) {
+	fprintf(stderr, "%s: could not initialize mutex.\n%s\n",
+		argv0, strerror(status));
+	goto error;
+    }
+    num_thr = ((size_t)num_thr > num_paths) ? (int)num_paths : num_thr;
+    if ( num_thr > 1 && !(thr = CALLOC(num_thr, sizeof(pthread_t))) ) {
+	num_thr = 1;
+    }
+    for (a = 1; a < num_thr; a++) {
+	if ( pthread_create(thr + a, NULL, cat_thr, &pool) != 0 ) {
+	    break;
+	}
+    }
+    num_thr = a;
+    cat_thr(&pool);
+    for (a = 1; a < num_thr; a++) {
+	pthread_join(thr[a], NULL);
+    }
+    FREE(thr);
+    thr = NULL;
+    pthread_mutex_destroy(&pool.mtx);
+
+    /*
+       Keep the volumes, sorted by time, with their own path table.
+     */
+
+    for (num_ents = 0, cat_strs_sz = 0, n = 0; n < num_paths; n++) {
+	if ( pool.good[n] ) {
+	    pool.ents[num_ents++] = pool.ents[n];
+	    cat_strs_sz += strlen(strs + pool.ents[n].path) + 1;
+	}
+    }
+    qsort(pool.ents, num_ents, sizeof(struct cat_ent), ent_cmp);
+    if ( cat_strs_sz > 0 && !(cat_strs = MALLOC(cat_strs_sz)) ) {
+	fprintf(stderr, "%s: could not allocate path table.\n", argv0);
+	goto error;
+    }
+    for (cat_strs_sz = 0, n = 0; n < num_ents; n++) {
+	char *path = strs + pool.ents[n].path;
+	size_t len = strlen(path) + 1;
+
+	memcpy(cat_strs + cat_strs_sz, path, len);
+	pool.ents[n].path = cat_strs_sz;
+	cat_strs_sz += len;
+    }
+
+    /*
+       Write the catalog.
+     */
+
+    memset(&hdr, 0, sizeof(hdr));
+    strlcpy(hdr.magic, CAT_MAGIC, sizeof(hdr.magic));
+    hdr.order = CAT_ORDER;
+    hdr.ent_sz = sizeof(struct cat_ent);
+    hdr.num_ents = num_ents;
+    hdr.strs_sz = cat_strs_sz;
+    if ( !(cat_fl = fopen(cat_fl_nm, "w")) ) {
+	fprintf(stderr, "%s: could not open %s for writing.\n%s\n",
+		argv0, cat_fl_nm, strerror(errno));
+	goto error;
+    }
+    if ( fwrite(&hdr, sizeof(hdr), 1, cat_fl) != 1
+	    || fwrite(pool.ents, sizeof(struct cat_ent), num_ents, cat_fl)
+	    != num_ents
+	    || fwrite(cat_strs, 1, cat_strs_sz, cat_fl) != cat_strs_sz
+	    || fclose(cat_fl) == EOF ) {
+	fprintf(stderr, "%s: could not write catalog %s.\n%s\n",
+		argv0, cat_fl_nm, strerror(errno));
+	cat_fl = NULL;
+	unlink(cat_fl_nm);
+	goto error;
+    }
+    FREE(cat_strs);
+    FREE(pool.ents);
+    FREE(pool.good);
+    FREE(strs);
+    FREE(paths);
+    return 1;
+
+error:
+    FREE(thr);
+    FREE(cat_strs);
+    FREE(pool.ents);
+    FREE(pool.good);
+    FREE(strs);
+    FREE(paths);
+    return 0;
+}
+
+/*
+   nftw callback for make_cb. Append regular files to strs and paths.
+ */
+
+static int visit(const char *path, const struct stat *sbuf, int type,
+	struct FTW *ftw)
+{
+    size_t len = strlen(path) + 1;
+
+    if ( type != FTW_F ) {
+	return 0;
+    }
+    if ( strs_sz + len > strs_max ) {
+	size_t sz = 2 * (strs_sz + len) + 4096;
+	char *t;
+
+	if ( !(t = REALLOC(strs, sz)) ) {
+	    fprintf(stderr, "%d: could not allocate space for file names.\n",
+		    getpid());
+	    return -1;
+	}
+	strs = t;
+	strs_max = sz;
+    }
+    if ( num_paths + 1 > paths_max ) {
+	size_t mx = 2 * paths_max + 256;
+	size_t *t;
+
+	if ( !(t = REALLOC(paths, mx * sizeof(size_t))) ) {
+	    fprintf(stderr, "%d: could not allocate space for file names.\n",
+		    getpid());
+	    return -1;
+	}
+	paths = t;
+	paths_max = mx;
+    }
+    memcpy(strs + strs_sz, path, len);
+    paths[num_paths++] = strs_sz;
+    strs_sz += len;
+    return 0;
+}
+
+/*
+   Thread start routine for make_cb. Read headers for paths from the
+   pool at arg until none are left. Files that do not start with a
+   product header are skipped quietly, since catalog directories usually
+   hold other files as well.
+ */
+
+static void *cat_thr(void *arg)
+{
+    struct cat_pool *pool_p = arg;
+    struct Sigmet_Vol *vol_p;		/* Receive headers */
+    struct Sigmet_Vol_In in;		/* Input stream for a file */
+    char rec[2 * SIGMET_REC_LEN];	/* First two records of a file */
+    unsigned char *r = (unsigned char *)rec;
+    size_t n, rd;
+    char *path;
+
+    if ( !(vol_p = MALLOC(sizeof(struct Sigmet_Vol))) ) {
+	fprintf(stderr, "%d: could not allocate volume.\n", getpid());
+	return NULL;
+    }
+    Sigmet_Vol_Init(vol_p);
+    while ( 1 ) {
+	pthread_mutex_lock(&pool_p->mtx);
+	n = pool_p->n++;
+	pthread_mutex_unlock(&pool_p->mtx);
+	if ( n >= pool_p->num_paths ) {
+	    break;
+	}
+	path = pool_p->strs + pool_p->paths[n];
+	if ( Sigmet_Vol_Open(path, &in) != SIGMET_OK ) {
+	    continue;
+	}
+	rd = fread(rec, 1, sizeof(rec), in.f);
+	Sigmet_Vol_Close(&in);
+
+	/*
+	   Product header starts with 27, in either byte order.
+	 */
+
+	if ( rd != sizeof(rec)
+		|| !((r[0] == 27 && r[1] == 0) || (r[0] == 0 && r[1] == 27)) ) {
+	    continue;
+	}
+	if ( Sigmet_Vol_DecodeHdr(rec, vol_p) != SIGMET_OK ) {
+	    fprintf(stderr, "%d: could not read headers from %s.\n",
+		    getpid(), path);
+	    continue;
+	}
+	pool_p->good[n] = cat_ent_set(pool_p->ents + n, path, vol_p);
+	pool_p->ents[n].path = pool_p->paths[n];
+	Sigmet_Vol_Free(vol_p);
+    }
+    FREE(vol_p);
+    return NULL;
+}
+
+/*
+   Store headers from vol_p, read from path, in catalog entry ent_p.
+   Return true on success.
+ */
+
+static int cat_ent_set(struct cat_ent *ent_p, char *path,
+	struct Sigmet_Vol *vol_p)
+{
+    struct Sigmet_YMDS_Time *t = &vol_p->ih.ic.vol_start_time;
+    enum Sigmet_ScanMode scan_mode = vol_p->ih.tc.tni.scan_mode;
+    char *c;
+    int s, y;
+
+    memset(ent_p, 0, sizeof(struct cat_ent));
+    ent_p->tm = epoch(t->year, t->month, t->day, t->sec + 0.001 * t->msec);
+    if ( !isfinite(ent_p->tm) ) {
+	fprintf(stderr, "%d: bad volume start time in %s.\n", getpid(), path);
+	return 0;
+    }
+    for (y = 0; y < vol_p->num_types; y++) {
+	ent_p->types |= 1U << vol_p->dat[y].sig_type;
+    }
+    ent_p->num_sweeps = vol_p->ih.tc.tni.num_sweeps;
+    ent_p->num_rays = vol_p->ih.ic.num_rays;
+    ent_p->num_bins = vol_p->ih.tc.tri.num_bins_out;
+    ent_p->bin0 = vol_p->ih.tc.tri.rng_1st_bin;
+    ent_p->bin_step = vol_p->ih.tc.tri.step_out;
+    for (s = 0; s < SIGMET_MAX_SWEEPS; s++) {
+	ent_p->angles[s] = NAN;
+    }
+    for (s = 0; s < ent_p->num_sweeps && s < SIGMET_MAX_SWEEPS; s++) {
+	switch (scan_mode) {
+	    case PPI_S:
+	    case PPI_C:
+		ent_p->angles[s] = DEG_PER_RAD * Sigmet_Bin2Rad(
+			vol_p->ih.tc.tni.scan_info.ppi_info.elevs[s]);
+		break;
+	    case RHI:
+		ent_p->angles[s] = DEG_PER_RAD * Sigmet_Bin2Rad(
+			vol_p->ih.tc.tni.scan_info.rhi_info.az[s]);
+		break;
+	    case MAN_SCAN:
+	    case FILE_SCAN:
+		break;
+	}
+    }
+    strlcpy(ent_p->site, vol_p->ih.ic.su_site_name, sizeof(ent_p->site));
+    for (c = ent_p->site + strlen(ent_p->site) - 1;
+	    c >= ent_p->site && *c == ' '; c--) {
+	*c = '\0';
+    }
+    strlcpy(ent_p->task, vol_p->ph.pc.task_name, sizeof(ent_p->task));
+    for (c = ent_p->task + strlen(ent_p->task) - 1;
+	    c >= ent_p->task && *c == ' '; c--) {
+	*c = '\0';
+    }
+    ent_p->scan_mode = (scan_mode >= PPI_S && scan_mode <= FILE_SCAN)
+	? scan_mode : 0;
+    return 1;
+}
+
+/*
+   Compare catalog entries by time, then site, then path, for qsort.
+   Paths are still offsets in strs.
+ */
+
+static int ent_cmp(const void *a, const void *b)
+{
+    const struct cat_ent *ent_a = a, *ent_b = b;
+    int c;
+
+    if ( ent_a->tm < ent_b->tm ) {
+	return -1;
+    } else if ( ent_a->tm > ent_b->tm ) {
+	return 1;
+    }
+    if ( (c = strcmp(ent_a->site, ent_b->site)) != 0 ) {
+	return c;
+    }
+    return strcmp(strs + ent_a->path, strs + ent_b->path);
+}
+
+/*
+   Print the volumes in a catalog that match the options on the command
+   line.
+ */
+
+static int query_cb(int argc, char *argv[])
+{
+    char *argv0 = argv[0];
+    char *cat_fl_nm;			/* Catalog file name */
+    FILE *cat_fl;			/* Catalog file */
+    struct cat_hdr hdr;			/* Catalog header */
+    struct cat_ent *ents = NULL;	/* Catalog entries */
+    char *cat_strs = NULL;		/* Path table */
+    int lng = 0;			/* If true, print all headers */
+    double tm0 = -INFINITY;		/* Start of time range */
+    double tm1 = INFINITY;		/* End of time range */
+    char *site = NULL;			/* If not NULL, site to match */
+    char *scan_mode = NULL;		/* If not NULL, scan mode to match */
+    unsigned types = 0;			/* Data types to match */
+    enum Sigmet_DataTypeN sig_type;
+    size_t lo, hi, mid, n;
+    int a, s, y;
+
+    for (a = 2; a < argc && argv[a][0] == '-'; a++) {
+	if ( strcmp(argv[a], "-l") == 0 ) {
+	    lng = 1;
+	} else if ( strcmp(argv[a], "-t") == 0 && a + 2 < argc ) {
+	    if ( !tm_parse(argv[a + 1], &tm0) || !tm_parse(argv[a + 2], &tm1) ) {
+		fprintf(stderr, "%s: expected times of form "
+			"yyyy/mm/dd[/hh[:mm[:ss]]], got %s %s.\n",
+			argv0, argv[a + 1], argv[a + 2]);
+		return 0;
+	    }
+	    a += 2;
+	} else if ( strcmp(argv[a], "-s") == 0 && a + 1 < argc ) {
+	    site = argv[++a];
+	} else if ( strcmp(argv[a], "-m") == 0 && a + 1 < argc ) {
+	    scan_mode = argv[++a];
+	} else if ( strcmp(argv[a], "-y") == 0 && a + 1 < argc ) {
+	    if ( !Sigmet_DataType_GetN(argv[a + 1], &sig_type) ) {
+		fprintf(stderr, "%s: %s is not a Sigmet data type.\n",
+			argv0, argv[a + 1]);
+		return 0;
+	    }
+	    types |= 1U << sig_type;
+	    a++;
+	} else {
+	    fprintf(stderr, "%s: unknown option or missing value %s.\n",
+		    argv0, argv[a]);
+	    return 0;
+	}
+    }
+    if ( argc - a != 1 ) {
+	fprintf(stderr, "Usage: %s query [-l] [-t start end] [-s site] "
+		"[-m scan_mode] [-y data_type] catalog\n", argv0);
+	return 0;
+    }
+    cat_fl_nm = argv[a];
+
+    /*
+       Read the catalog.
+     */
+
+    if ( !(cat_fl = fopen(cat_fl_nm, "r")) ) {
+	fprintf(stderr, "%s: could not open %s for reading.\n%s\n",
+		argv0, cat_fl_nm, strerror(errno));
+	return 0;
+    }
+    if ( fread(&hdr, sizeof(hdr), 1, cat_fl) != 1
+	    || strncmp(hdr.magic, CAT_MAGIC, sizeof(hdr.magic)) != 0 ) {
+	fprintf(stderr, "%s: %s is not a catalog.\n", argv0, cat_fl_nm);
+	goto error;
+    }
+    if ( hdr.order != CAT_ORDER || hdr.ent_sz != sizeof(struct cat_ent) ) {
+	fprintf(stderr, "%s: catalog %s was made on an incompatible "
+		"machine.\n", argv0, cat_fl_nm);
+	goto error;
+    }
+    if ( (hdr.num_ents > 0
+		&& !(ents = CALLOC(hdr.num_ents, sizeof(struct cat_ent))))
+	    || (hdr.strs_sz > 0 && !(cat_strs = MALLOC(hdr.strs_sz))) ) {
+	fprintf(stderr, "%s: could not allocate memory for catalog %s.\n",
+		argv0, cat_fl_nm);
+	goto error;
+    }
+    if ( fread(ents, sizeof(struct cat_ent), hdr.num_ents, cat_fl)
+	    != hdr.num_ents
+	    || fread(cat_strs, 1, hdr.strs_sz, cat_fl) != hdr.strs_sz ) {
+	fprintf(stderr, "%s: could not read catalog %s.\n", argv0, cat_fl_nm);
+	goto error;
+    }
+    fclose(cat_fl);
+    cat_fl = NULL;
+
+    /*
+       Find the first volume at or after tm0, then print volumes until tm1.
+     */
+
+    for (lo = 0, hi = hdr.num_ents; lo < hi; ) {
+	mid = lo + (hi - lo) / 2;
+	if ( ents[mid].tm < tm0 ) {
+	    lo = mid + 1;
+	} else {
+	    hi = mid;
+	}
+    }
+    for (n = lo; n < hdr.num_ents && ents[n].tm <= tm1; n++) {
+	struct cat_ent *ent_p = ents + n;
+
+	if ( ent_p->path >= hdr.strs_sz
+		|| (site && strcmp(site, ent_p->site) != 0)
+		|| (scan_mode && !scan_mode_match(ent_p->scan_mode, scan_mode))
+		|| (ent_p->types & types) != types ) {
+	    continue;
+	}
+	printf("%.0f ", ent_p->tm);
+	tm_print(stdout, ent_p->tm);
+	printf(" %s", cat_strs + ent_p->path);
+	if ( lng ) {
+	    printf(" %s %s %s %d %d %d %d %d ",
+		    strlen(ent_p->site) ? ent_p->site : "-",
+		    strlen(ent_p->task) ? ent_p->task : "-",
+		    scan_mode_nm[(int)ent_p->scan_mode], ent_p->num_sweeps,
+		    ent_p->num_rays, ent_p->num_bins, ent_p->bin0,
+		    ent_p->bin_step);
+	    for (a = 0, y = 0; y < SIGMET_NTYPES; y++) {
+		if ( ent_p->types & (1U << y) ) {
+		    printf("%s%s", a++ ? "," : "", Sigmet_DataType_Abbrv(y));
+		}
+	    }
+	    printf("%s ", a ? "" : "-");
+	    for (s = 0; s < ent_p->num_sweeps && s < SIGMET_MAX_SWEEPS; s++) {
+		printf("%s%.2f", s ? "," : "", ent_p->angles[s]);
+	    }
+	    printf("%s", s ? "" : "-");
+	}
+	printf("\n");
+    }
+    FREE(ents);
+    FREE(cat_strs);
+    return 1;
+
+error:
+    if ( cat_fl ) {
+	fclose(cat_fl);
+    }
+    FREE(ents);
+    FREE(cat_strs);
+    return 0;
+}
+
+/*
+   Return seconds since 1970/01/01 00:00:00 for second sec of the given
+   day.
+ */
+
+static double epoch(int year, int month, int day, double sec)
+{
+    return (Tm_CalToJul(year, month, day, 0, 0, 0.0)
+	    - Tm_CalToJul(1970, 1, 1, 0, 0, 0.0)) * 86400.0 + sec;
+}
+
+/*
+   Parse a time of form yyyy/mm/dd[/hh[:mm[:ss]]] from s into seconds
+   since 1970/01/01 00:00:00 at tm_p. Return true on success.
+ */
+
+static int tm_parse(char *s, double *tm_p)
+{
+    int year, month, day, hour = 0, minute = 0;
+    double sec = 0.0;
+
+    if ( sscanf(s, "%d/%d/%d/%d:%d:%lf",
+		&year, &month, &day, &hour, &minute, &sec) < 3 ) {
+	return 0;
+    }
+    *tm_p = epoch(year, month, day, 3600.0 * hour + 60.0 * minute + sec);
+    return 1;
+}
+
+/*
+   Print time tm, given as seconds since 1970/01/01 00:00:00, as
+   yyyy/mm/dd hh:mm:ss to out, rounded to the nearest second.
+ */
+
+static void tm_print(FILE *out, double tm)
+{
+    double t = floor(tm + 0.5);
+    double days = floor(t / 86400.0);	/* Days since 1970/01/01 */
+    long sec = (long)(t - days * 86400.0); /* Seconds since midnight */
+    int year, month, day, hour, minute;
+    double second;
+
+    Tm_JulToCal(Tm_CalToJul(1970, 1, 1, 0, 0, 0.0) + days,
+	    &year, &month, &day, &hour, &minute, &second);
+    fprintf(out, "%04d/%02d/%02d %02ld:%02ld:%02ld",
+	    year, month, day, sec / 3600, sec % 3600 / 60, sec % 60);
+}
+
+/*
+   Return true if scan mode given by enum value mode has name nm. "ppi"
+   matches sector and continuous PPI.
+ */
+
+static int scan_mode_match(char mode, char *nm)
+{
+    if ( strcmp(nm, "ppi") == 0 ) {
+	return mode == PPI_S || mode == PPI_C;
+    }
+    return strcmp(nm, scan_mode_nm[(int)mode]) == 0;
+}
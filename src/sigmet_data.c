@@ -37,7 +37,6 @@
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
-#include <assert.h>
 #include "sigmet.h"
 
 /*
@@ -63,21 +62,23 @@ static char *data_type_s[SIGMET_NTYPES] = {
 
 /*
    This hash table maps abbreviations to Sigmet_DataTypeN enumerators.
-   N_BUCKETS = 182 makes a perfect table.
+   N_BUCKETS = 182 makes a perfect table. The table is constant, so that
+   threads can look up data types without initializing anything. If
+   data_type_s changes, recompute the bucket indeces with hash.
  */
 
 #define HASH_X 31
 #define N_BUCKETS 182
 static unsigned hash(const char *);
-static enum Sigmet_DataTypeN sig_data_type[N_BUCKETS];
-
-/*
-   If init is true, data type interface is initialized.
-   Otherwise, need to call data_type_init.
- */
-
-static int init;
-static void data_type_init(void);
+static const enum Sigmet_DataTypeN sig_data_type[N_BUCKETS] = {
+    [1] = DB_RAINRATE2, [17] = DB_DBT, [20] = DB_SQI2, [22] = DB_RHOHV2,
+    [23] = DB_DBZ, [30] = DB_KDP2, [49] = DB_LDRV2, [57] = DB_LDRH,
+    [58] = DB_VEL2, [63] = DB_XHDR, [68] = DB_KDP, [71] = DB_LDRV,
+    [75] = DB_VELC, [87] = DB_DBT2, [91] = DB_DBZ2, [104] = DB_DBZC2,
+    [107] = DB_ZDR, [108] = DB_DBZC, [110] = DB_VEL, [134] = DB_RHOHV,
+    [138] = DB_PHIDP, [139] = DB_WIDTH, [144] = DB_SQI, [146] = DB_PHIDP2,
+    [147] = DB_ZDR2, [161] = DB_LDRH2, [173] = DB_VELC2, [177] = DB_WIDTH2
+};
 
 /*
    Descriptors for Sigmet data types. Index with enum Sigmet_DataTypeN.
@@ -230,26 +231,6 @@ char * Sigmet_DataType_Unit(enum Sigmet_DataTypeN y)
     return (y < SIGMET_NTYPES) ? unit[y] : NULL;
 }
 
-/*
-   Initialize the hash table.
- */
-
-static void data_type_init(void)
-{
-    int sig_type;		/* Loop index */
-    unsigned i;
-
-    if ( init ) {
-	return;
-    }
-    for (sig_type = 0; sig_type < SIGMET_NTYPES; sig_type++) {
-	i = hash(data_type_s[sig_type]);
-	assert(i < N_BUCKETS);
-	sig_data_type[i] = sig_type;
-    }
-    init = 1;
-}
-
 /*
    Get Sigmet_DataTypeN enumerator corresponding to abbreviation a.
    If successful, put the enumerator at y_p and return true. Otherwise,
@@ -264,9 +245,6 @@ int Sigmet_DataType_GetN(char *a, enum Sigmet_DataTypeN *y_p)
     if ( !a ) {
 	return 0;
     }
-    if ( !init ) {
-	data_type_init();
-    }
     i = hash(a);
     if ( i < N_BUCKETS ) {
 	y = sig_data_type[i];
@@ -105,11 +105,15 @@ enum SigmetStatus Sigmet_Vol_ToDorade(struct Sigmet_Vol *vol_p, int s,
 
     num_parms = num_rays = num_cells = -1;
 
-    if ( s > vol_p->ih.ic.num_sweeps ) {
+    if ( s < 0 || s >= vol_p->ih.ic.num_sweeps ) {
 	fprintf(stderr, "Sweep index out of range.\n");
 	status = SIGMET_RNG_ERR;
 	goto error;
     }
+    if ( (status = Sigmet_Vol_LoadSweep(vol_p, s)) != SIGMET_OK ) {
+	fprintf(stderr, "Could not load sweep %d.\n", s);
+	goto error;
+    }
     if ( !vol_p->sweep_hdr[s].ok ) {
 	fprintf(stderr, "Sweep %d is bad.\n", s);
 	status = SIGMET_BAD_VOL;
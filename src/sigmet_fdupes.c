@@ -0,0 +1,704 @@
+/*
+   -	sigmet_fdupes.c --
+   -		Find Sigmet raw product files that hold the same
+   -		volume.
+   - 
+   .	Copyright (c) 2013 Gordon D. Carrie.  All rights reserved.
+   .	
+   .	Redistribution and use in source and binary forms, with or without
+   .	modification, are permitted provided that the following conditions
+   .	are met:
+   .	
+   .	    * Redistributions of source code must retain the above copyright
+   .	    notice, this list of conditions and the following disclaimer.
+   .
+   .	    * Redistributions in binary form must reproduce the above copyright
+   .	    notice, this list of conditions and the following disclaimer in the
+   .	    documentation and/or other materials provided with the distribution.
+   .	
+   .	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   .	"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   .	LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   .	A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   .	HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   .	SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+   .	TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   .	PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   .	LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   .	NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   .	SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+   .
+   .	Please send feedback to dev0@trekix.net
+   .
+   .	$Revision: $ $Date: $
+ */
+
+#include "unix_defs.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include <unistd.h>
+#include <ftw.h>
+#include <pthread.h>
+#include "alloc.h"
+#include "sigmet.h"
+
+/*
+   Usage
+   sigmet_fdupes [-j threads] [path ...]
+
+   Search the paths, default current working directory, for raw product
+   files that contain the same volume, compressed or not. Print each
+   group of duplicates on a line.
+
+   Fingerprints select candidates. Candidates are confirmed by comparing
+   their contents byte for byte before they are reported.
+ */
+
+/*
+   Fingerprint of a byte stream. Two independent 64 bit hashes of the
+   uncompressed contents, and the length.
+ */
+
+struct fd_fp {
+    unsigned long long h0, h1;
+    unsigned long long len;
+};
+
+/*
+   A file found while walking the directory trees.
+ */
+
+struct fd_file {
+    size_t path;			/* Offset of path in strs */
+    dev_t dev;				/* Device and inode, to skip */
+    ino_t ino;				/* hard links */
+    int good;				/* True if file is a volume */
+    struct fd_fp hdr;			/* Fingerprint of the first two
+					   records */
+    struct fd_fp vol;			/* Fingerprint of the whole file,
+					   computed only if hdr matches
+					   another file */
+    size_t rep;				/* Index in files of the file
+					   this one is compared with, or
+					   its own index if it represents
+					   a group */
+    int same;				/* 1 if contents match those of rep,
+					   0 if not, -1 if not compared */
+    int rep_bad;			/* If true, rep could not be read
+					   during the comparison */
+};
+
+/*
+   Tasks for the threads.
+ */
+
+enum fd_task {
+    FD_HDR,				/* Fingerprint first two records */
+    FD_VOL,				/* Fingerprint whole file */
+    FD_CMP				/* Compare file with its rep */
+};
+
+/*
+   Fingerprinting threads take the next file from a shared counter.
+ */
+
+struct fd_pool {
+    size_t *idx;			/* Indeces into files to fingerprint */
+    size_t num_idx;			/* Number of elements in idx */
+    size_t n;				/* Next element of idx to do */
+    enum fd_task task;			/* What to do with each file */
+    pthread_mutex_t mtx;		/* Guard n */
+};
+
+/*
+   Files found while walking the directory trees.
+ */
+
+static char *strs;			/* Paths, null separated */
+static size_t strs_sz;			/* Bytes used in strs */
+static size_t strs_max;			/* Allocation at strs */
+static struct fd_file *files;		/* Files found */
+static size_t num_files;		/* Number of files */
+static size_t files_max;		/* Allocation at files */
+
+#define FD_BUF_SZ (16 * SIGMET_REC_LEN)
+
+static int visit(const char *, const struct stat *, int, struct FTW *);
+static int run_pool(struct fd_pool *, int);
+static void *fd_thr(void *);
+static void fd_same(struct fd_file *, unsigned char *);
+static void fp_init(struct fd_fp *);
+static void fp_add(struct fd_fp *, unsigned char *, size_t);
+static int fp_cmp(const struct fd_fp *, const struct fd_fp *);
+static int path_cmp(const void *, const void *);
+static int ino_cmp(const void *, const void *);
+static int hdr_cmp(const void *, const void *);
+static int vol_cmp(const void *, const void *);
+static int rep_cmp(const void *, const void *);
+
+int main(int argc, char *argv[])
+{
+    char *argv0 = argv[0];
+    int num_thr = 1;			/* Number of threads */
+    struct fd_pool pool;		/* Files to fingerprint */
+    size_t *idx = NULL;			/* Indeces into files */
+    size_t num_idx;
+    size_t *cmp = NULL;			/* Indeces of files to compare */
+    size_t num_cmp;
+    size_t n, m, k, r;
+    int have_rep;
+    int a;
+
+    if ( argc == 2 && strcmp(argv[1], "-v") == 0 ) {
+	printf("%s version %s\nCopyright (c) 2013, Gordon D. Carrie.\n"
+		"All rights reserved.\n", argv0, SIGMET_RAW_VERSION);
+	return EXIT_SUCCESS;
+    }
+    for (a = 1; a < argc && argv[a][0] == '-' && argv[a][1] != '\0'; a += 2) {
+	if ( strcmp(argv[a], "-j") == 0 && a + 1 < argc ) {
+	    if ( sscanf(argv[a + 1], "%d", &num_thr) != 1 || num_thr < 1 ) {
+		fprintf(stderr, "%s: expected positive integer for number of "
+			"threads, got %s.\n", argv0, argv[a + 1]);
+		return EXIT_FAILURE;
+	    }
+	} else {
+	    fprintf(stderr, "Usage: %s [-j threads] [path ...]\n", argv0);
+	    return EXIT_FAILURE;
+	}
+    }
+
+    /*
+       Find the files.
+     */
+
+    if ( a == argc ) {
+	if ( nftw(".", visit, 32, FTW_PHYS) != 0 ) {
+	    fprintf(stderr, "%s: could not search current directory.\n%s\n",
+		    argv0, strerror(errno));
+	    goto error;
+	}
+    }
+    for ( ; a < argc; a++) {
+	if ( nftw(argv[a], visit, 32, FTW_PHYS) != 0 ) {
+	    fprintf(stderr, "%s: could not search %s.\n%s\n",
+		    argv0, argv[a], strerror(errno));
+	    goto error;
+	}
+    }
+    if ( num_files < 2 ) {
+	FREE(strs);
+	FREE(files);
+	return EXIT_SUCCESS;
+    }
+
+    /*
+       Several paths to one inode are not redundant copies. Keep the
+       first path.
+     */
+
+    qsort(files, num_files, sizeof(struct fd_file), ino_cmp);
+    for (m = 1, n = 1; n < num_files; n++) {
+	if ( files[n].dev != files[m - 1].dev
+		|| files[n].ino != files[m - 1].ino ) {
+	    files[m++] = files[n];
+	}
+    }
+    num_files = m;
+    if ( !(idx = CALLOC(num_files, sizeof(size_t))) ) {
+	fprintf(stderr, "%s: could not allocate index for %lu files.\n",
+		argv0, (unsigned long)num_files);
+	goto error;
+    }
+
+    /*
+       Fingerprint the first two records of every file. This costs one
+       read of 12 KB per file, and eliminates most unique volumes.
+     */
+
+    for (n = 0; n < num_files; n++) {
+	idx[n] = n;
+    }
+    pool.idx = idx;
+    pool.num_idx = num_files;
+    pool.task = FD_HDR;
+    if ( !run_pool(&pool, num_thr) ) {
+	goto error;
+    }
+
+    /*
+       Fingerprint whole files for volumes whose headers match another.
+     */
+
+    for (num_idx = 0, n = 0; n < num_files; n++) {
+	if ( files[n].good ) {
+	    idx[num_idx++] = n;
+	}
+    }
+    qsort(idx, num_idx, sizeof(size_t), hdr_cmp);
+    for (m = 0, n = 0; n < num_idx; n = k) {
+	for (k = n + 1;
+		k < num_idx
+		&& fp_cmp(&files[idx[n]].hdr, &files[idx[k]].hdr) == 0;
+		k++) {
+	}
+	if ( k - n > 1 ) {
+	    for ( ; n < k; n++) {
+		idx[m++] = idx[n];
+	    }
+	}
+    }
+    num_idx = m;
+    pool.idx = idx;
+    pool.num_idx = num_idx;
+    pool.task = FD_VOL;
+    if ( !run_pool(&pool, num_thr) ) {
+	goto error;
+    }
+
+    /*
+       Files with the same fingerprint are candidates. Files that could
+       not be read completely are no longer good.
+     */
+
+    for (m = 0, n = 0; n < num_idx; n++) {
+	if ( files[idx[n]].good ) {
+	    idx[m++] = idx[n];
+	    files[idx[n]].same = 0;
+	}
+    }
+    num_idx = m;
+    qsort(idx, num_idx, sizeof(size_t), vol_cmp);
+    if ( !(cmp = CALLOC(num_idx + 1, sizeof(size_t))) ) {
+	fprintf(stderr, "%s: could not allocate index for %lu files.\n",
+		argv0, (unsigned long)num_idx);
+	goto error;
+    }
+
+    /*
+       Confirm candidates by comparing contents. In each set of files with
+       the same fingerprint, the first file not yet matched represents a
+       group, and the other unmatched files are compared with it. Files
+       that differ from it, or that were matched with a file that later
+       could not be read, try again with a new representative. Each pass
+       removes at least one file from every set, so this ends.
+     */
+
+    do {
+	for (num_cmp = 0, n = 0; n < num_idx; n = k) {
+	    for (k = n + 1;
+		    k < num_idx
+		    && fp_cmp(&files[idx[n]].vol, &files[idx[k]].vol) == 0;
+		    k++) {
+	    }
+	    for (have_rep = 0, r = 0, m = n; m < k; m++) {
+		struct fd_file *file_p = files + idx[m];
+
+		if ( !file_p->good
+			|| (file_p->same == 1 && files[file_p->rep].good) ) {
+		    continue;
+		}
+		if ( !have_rep ) {
+		    r = idx[m];
+		    have_rep = 1;
+		    file_p->rep = r;
+		    file_p->same = 1;
+		} else {
+		    file_p->rep = r;
+		    file_p->same = -1;
+		    file_p->rep_bad = 0;
+		    cmp[num_cmp++] = idx[m];
+		}
+	    }
+	}
+	pool.idx = cmp;
+	pool.num_idx = num_cmp;
+	pool.task = FD_CMP;
+	if ( !run_pool(&pool, num_thr) ) {
+	    goto error;
+	}
+	for (n = 0; n < num_cmp; n++) {
+	    if ( files[cmp[n]].rep_bad ) {
+		files[files[cmp[n]].rep].good = 0;
+	    }
+	}
+    } while ( num_cmp > 0 );
+
+    /*
+       Print groups of files with the same contents.
+     */
+
+    for (m = 0, n = 0; n < num_idx; n++) {
+	if ( files[idx[n]].good ) {
+	    idx[m++] = idx[n];
+	}
+    }
+    num_idx = m;
+    qsort(idx, num_idx, sizeof(size_t), rep_cmp);
+    for (n = 0; n < num_idx; n = k) {
+	for (k = n + 1;
+		k < num_idx && files[idx[n]].rep == files[idx[k]].rep;
+		k++) {
+	}
+	if ( k - n > 1 ) {
+	    for (m = n; m < k; m++) {
+		printf("%s%s", (m == n) ? "" : " ", strs + files[idx[m]].path);
+	    }
+	    printf("\n");
+	}
+    }
+
+    FREE(cmp);
+    FREE(idx);
+    FREE(strs);
+    FREE(files);
+    return EXIT_SUCCESS;
+
+error:
+    FREE(cmp);
+    FREE(idx);
+    FREE(strs);
+    FREE(files);
+    return EXIT_FAILURE;
+}
+
+/*
+   nftw callback. Append regular files to strs and files.
+ */
+
+static int visit(const char *path, const struct stat *sbuf, int type,
+	struct FTW *ftw)
+{
+    size_t len = strlen(path) + 1;
+
+    if ( type != FTW_F || !S_ISREG(sbuf->st_mode) ) {
+	return 0;
+    }
+    if ( strs_sz + len > strs_max ) {
+	size_t sz = 2 * (strs_sz + len) + 4096;
+	char *t;
+
+	if ( !(t = REALLOC(strs, sz)) ) {
+	    fprintf(stderr, "%d: could not allocate space for file names.\n",
+		    getpid());
+	    return -1;
+	}
+	strs = t;
+	strs_max = sz;
+    }
+    if ( num_files + 1 > files_max ) {
+	size_t mx = 2 * files_max + 256;
+	struct fd_file *t;
+
+	if ( !(t = REALLOC(files, mx * sizeof(struct fd_file))) ) {
+	    fprintf(stderr, "%d: could not allocate space for file names.\n",
+		    getpid());
+	    return -1;
+	}
+	files = t;
+	files_max = mx;
+    }
+    memcpy(strs + strs_sz, path, len);
+    memset(files + num_files, 0, sizeof(struct fd_file));
+    files[num_files].path = strs_sz;
+    files[num_files].dev = sbuf->st_dev;
+    files[num_files].ino = sbuf->st_ino;
+    num_files++;
+    strs_sz += len;
+    return 0;
+}
+
+/*
+   Fingerprint the files in pool_p with num_thr threads. Return true on
+   success.
+ */
+
+static int run_pool(struct fd_pool *pool_p, int num_thr)
+{
+    pthread_t *thr = NULL;		/* Threads that fingerprint files */
+    int status, t;
+
+    if ( pool_p->num_idx == 0 ) {
+	return 1;
+    }
+    pool_p->n = 0;
+    if ( (status = pthread_mutex_init(&pool_p->mtx, NULL)) != 0 ) {
+	fprintf(stderr, "%d: could not initialize mutex.\n%s\n",
+		getpid(), strerror(status));
+	return 0;
+    }
+    num_thr = ((size_t)num_thr > pool_p->num_idx)
+	? (int)pool_p->num_idx : num_thr;
+    if ( num_thr > 1 && !(thr = CALLOC(num_thr, sizeof(pthread_t))) ) {
+	num_thr = 1;
+    }
+    for (t = 1; t < num_thr; t++) {
+	if ( pthread_create(thr + t, NULL, fd_thr, pool_p) != 0 ) {
+	    break;
+	}
+    }
+    num_thr = t;
+    fd_thr(pool_p);
+    for (t = 1; t < num_thr; t++) {
+	pthread_join(thr[t], NULL);
+    }
+    FREE(thr);
+    pthread_mutex_destroy(&pool_p->mtx);
+    return 1;
+}
+
+/*
+   Thread start routine for run_pool. Fingerprint or compare files from
+   the pool at arg until none are left. Files that do not start with a
+   product header are skipped quietly, since archive directories usually
+   hold other files as well.
+ */
+
+static void *fd_thr(void *arg)
+{
+    struct fd_pool *pool_p = arg;
+    struct Sigmet_Vol_In in;		/* Input stream for a file */
+    unsigned char *buf;			/* Receive uncompressed file */
+    struct fd_file *file_p;
+    size_t n, rd;
+    char *path;
+    int err;
+
+    if ( !(buf = MALLOC(2 * FD_BUF_SZ)) ) {
+	fprintf(stderr, "%d: could not allocate input buffer.\n", getpid());
+	return NULL;
+    }
+    while ( 1 ) {
+	pthread_mutex_lock(&pool_p->mtx);
+	n = pool_p->n++;
+	pthread_mutex_unlock(&pool_p->mtx);
+	if ( n >= pool_p->num_idx ) {
+	    break;
+	}
+	file_p = files + pool_p->idx[n];
+	path = strs + file_p->path;
+	if ( pool_p->task == FD_CMP ) {
+	    fd_same(file_p, buf);
+	    continue;
+	}
+	if ( Sigmet_Vol_Open(path, &in) != SIGMET_OK ) {
+	    file_p->good = 0;
+	    continue;
+	}
+	if ( pool_p->task == FD_HDR ) {
+	    rd = fread(buf, 1, 2 * SIGMET_REC_LEN, in.f);
+	    Sigmet_Vol_Close(&in);
+
+	    /*
+	       Product header starts with 27, in either byte order.
+	     */
+
+	    file_p->good = rd == 2 * SIGMET_REC_LEN
+		&& ((buf[0] == 27 && buf[1] == 0)
+			|| (buf[0] == 0 && buf[1] == 27));
+	    if ( file_p->good ) {
+		fp_init(&file_p->hdr);
+		fp_add(&file_p->hdr, buf, rd);
+	    }
+	} else {
+	    fp_init(&file_p->vol);
+	    while ( (rd = fread(buf, 1, FD_BUF_SZ, in.f)) > 0 ) {
+		fp_add(&file_p->vol, buf, rd);
+	    }
+	    err = ferror(in.f);
+	    if ( Sigmet_Vol_Close(&in) != SIGMET_OK || err ) {
+		fprintf(stderr, "%d: could not read %s.\n", getpid(), path);
+		file_p->good = 0;
+	    }
+	}
+    }
+    FREE(buf);
+    return NULL;
+}
+
+/*
+   Compare the uncompressed contents of file_p with those of file_p->rep.
+   buf must have space for 2 * FD_BUF_SZ bytes. Set file_p->same. If
+   file_p cannot be read, clear file_p->good. If its rep cannot be read,
+   set file_p->rep_bad. Only file_p is modified, so several threads can
+   compare with the same rep.
+ */
+
+static void fd_same(struct fd_file *file_p, unsigned char *buf)
+{
+    struct fd_file *rep_p = files + file_p->rep;
+    struct Sigmet_Vol_In in, rep_in;	/* Input streams for the files */
+    size_t rd, rep_rd;
+    int err, rep_err;
+
+    file_p->same = 0;
+    if ( Sigmet_Vol_Open(strs + file_p->path, &in) != SIGMET_OK ) {
+	fprintf(stderr, "%d: could not open %s.\n",
+		getpid(), strs + file_p->path);
+	file_p->good = 0;
+	return;
+    }
+    if ( Sigmet_Vol_Open(strs + rep_p->path, &rep_in) != SIGMET_OK ) {
+	fprintf(stderr, "%d: could not open %s.\n",
+		getpid(), strs + rep_p->path);
+	Sigmet_Vol_Close(&in);
+	file_p->rep_bad = 1;
+	return;
+    }
+    do {
+	rd = fread(buf, 1, FD_BUF_SZ, in.f);
+	rep_rd = fread(buf + FD_BUF_SZ, 1, FD_BUF_SZ, rep_in.f);
+    } while ( rd > 0 && rd == rep_rd
+	    && memcmp(buf, buf + FD_BUF_SZ, rd) == 0 );
+    file_p->same = (rd == 0 && rep_rd == 0);
+    err = ferror(in.f);
+    rep_err = ferror(rep_in.f);
+    if ( Sigmet_Vol_Close(&in) != SIGMET_OK || err ) {
+	fprintf(stderr, "%d: could not read %s.\n",
+		getpid(), strs + file_p->path);
+	file_p->good = 0;
+	file_p->same = 0;
+    }
+    if ( Sigmet_Vol_Close(&rep_in) != SIGMET_OK || rep_err ) {
+	fprintf(stderr, "%d: could not read %s.\n",
+		getpid(), strs + rep_p->path);
+	file_p->rep_bad = 1;
+	file_p->same = 0;
+    }
+}
+
+/*
+   Fingerprints are computed over little endian 64 bit words, so a file
+   has the same fingerprint on any host. Partial words, which only occur
+   at the end of a stream since fp_add is called with multiples of 8 bytes
+   until the last call, are padded with zeros. The length distinguishes
+   padding from data.
+ */
+
+#define FP_K0 0x9e3779b97f4a7c15ULL
+#define FP_K1 0xc2b2ae3d27d4eb4fULL
+#define FP_K2 0x165667b19e3779f9ULL
+#define ROTL64(x, r) (((x) << (r)) | ((x) >> (64 - (r))))
+
+static void fp_init(struct fd_fp *fp_p)
+{
+    fp_p->h0 = FP_K0;
+    fp_p->h1 = FP_K1;
+    fp_p->len = 0;
+}
+
+static void fp_add(struct fd_fp *fp_p, unsigned char *buf, size_t sz)
+{
+    unsigned long long h0 = fp_p->h0, h1 = fp_p->h1, w;
+    unsigned char *b, *e;
+    int i;
+
+    for (b = buf, e = buf + sz; b < e; b += 8) {
+	if ( e - b >= 8 ) {
+	    w = (unsigned long long)b[0]
+		| (unsigned long long)b[1] << 8
+		| (unsigned long long)b[2] << 16
+		| (unsigned long long)b[3] << 24
+		| (unsigned long long)b[4] << 32
+		| (unsigned long long)b[5] << 40
+		| (unsigned long long)b[6] << 48
+		| (unsigned long long)b[7] << 56;
+	} else {
+	    for (w = 0, i = 0; b + i < e; i++) {
+		w |= (unsigned long long)b[i] << (8 * i);
+	    }
+	}
+	h0 = ROTL64(h0 ^ (w * FP_K1), 31) * FP_K0;
+	h1 = (ROTL64(h1 + w, 27) ^ (h1 >> 29)) * FP_K2;
+    }
+    fp_p->h0 = h0;
+    fp_p->h1 = h1;
+    fp_p->len += sz;
+}
+
+static int fp_cmp(const struct fd_fp *a, const struct fd_fp *b)
+{
+    if ( a->len != b->len ) {
+	return (a->len < b->len) ? -1 : 1;
+    }
+    if ( a->h0 != b->h0 ) {
+	return (a->h0 < b->h0) ? -1 : 1;
+    }
+    if ( a->h1 != b->h1 ) {
+	return (a->h1 < b->h1) ? -1 : 1;
+    }
+    return 0;
+}
+
+/*
+   Compare files by path name, for qsort.
+ */
+
+static int path_cmp(const void *a, const void *b)
+{
+    const struct fd_file *file_a = a, *file_b = b;
+
+    return strcmp(strs + file_a->path, strs + file_b->path);
+}
+
+/*
+   Compare files by device, inode, and path, for qsort.
+ */
+
+static int ino_cmp(const void *a, const void *b)
+{
+    const struct fd_file *file_a = a, *file_b = b;
+
+    if ( file_a->dev != file_b->dev ) {
+	return (file_a->dev < file_b->dev) ? -1 : 1;
+    }
+    if ( file_a->ino != file_b->ino ) {
+	return (file_a->ino < file_b->ino) ? -1 : 1;
+    }
+    return path_cmp(a, b);
+}
+
+/*
+   Compare indeces into files by header fingerprint, for qsort.
+ */
+
+static int hdr_cmp(const void *a, const void *b)
+{
+    const struct fd_file *file_a = files + *(const size_t *)a;
+    const struct fd_file *file_b = files + *(const size_t *)b;
+
+    return fp_cmp(&file_a->hdr, &file_b->hdr);
+}
+
+/*
+   Compare indeces into files by volume fingerprint, then path, for
+   qsort.
+ */
+
+static int vol_cmp(const void *a, const void *b)
+{
+    const struct fd_file *file_a = files + *(const size_t *)a;
+    const struct fd_file *file_b = files + *(const size_t *)b;
+    int c;
+
+    if ( (c = fp_cmp(&file_a->vol, &file_b->vol)) != 0 ) {
+	return c;
+    }
+    return path_cmp(file_a, file_b);
+}
+
+/*
+   Compare indeces into files by representative, then path, for qsort.
+ */
+
+static int rep_cmp(const void *a, const void *b)
+{
+    const struct fd_file *file_a = files + *(const size_t *)a;
+    const struct fd_file *file_b = files + *(const size_t *)b;
+
+    if ( file_a->rep != file_b->rep ) {
+	return (file_a->rep < file_b->rep) ? -1 : 1;
+    }
+    return path_cmp(file_a, file_b);
+}
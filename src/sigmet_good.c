@@ -42,7 +42,7 @@ int main(int argc, char *argv[])
 {
     char *argv0 = argv[0];
     char *vol_fl_nm;		/* Name of Sigmet raw product file */
-    FILE *in;
+    struct Sigmet_Vol_In in;	/* Input stream for vol_fl_nm */
     int status;
 
     if ( argc == 2 && strcmp(argv[1], "-v") == 0 ) {
@@ -51,20 +51,18 @@ int main(int argc, char *argv[])
 	return EXIT_SUCCESS;
     }
     if ( argc == 1 ) {
-	status = Sigmet_Vol_Read(stdin, NULL);
+	status = Sigmet_Vol_Read(stdin, NULL, NULL);
     } else if ( argc == 2 ) {
 	vol_fl_nm = argv[1];
-	if ( strcmp(vol_fl_nm, "-") == 0 ) {
-	    in = stdin;
-	} else {
-	    in = fopen(vol_fl_nm, "r");
-	}
-	if ( !in ) {
+	if ( Sigmet_Vol_Open(vol_fl_nm, &in) != SIGMET_OK ) {
 	    fprintf(stderr, "%s: could not open %s for reading.\n",
 		    argv0, vol_fl_nm);
-	    status = SIGMET_IO_FAIL;
+	    return EXIT_FAILURE;
+	}
+	status = Sigmet_Vol_Read(in.f, NULL, NULL);
+	if ( Sigmet_Vol_Close(&in) != SIGMET_OK ) {
+	    status = SIGMET_BAD_FILE;
 	}
-	status = Sigmet_Vol_Read(in, NULL);
     } else {
 	fprintf(stderr, "Usage: %s [raw_file]\n", argv0);
 	exit(EXIT_FAILURE);
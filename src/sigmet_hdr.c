@@ -63,7 +63,7 @@ int main(int argc, char *argv[])
 {
     char *argv0 = argv[0];
     char *vol_fl_nm = "-";
-    FILE *in;
+    struct Sigmet_Vol_In in;		/* Input stream for vol_fl_nm */
     int abbrv = 0;		/* If true, give abbreviated output */
     struct Sigmet_Vol vol;
     enum SigmetStatus s;
@@ -77,7 +77,7 @@ int main(int argc, char *argv[])
     Sigmet_Vol_Init(&vol);
 
     if ( argc == 1 ) {
-	in = stdin;
+	vol_fl_nm = "-";
     } else if ( argc == 2 ) {
 	if ( strcmp(argv[1], "-v") == 0 ) {
 	    printf("%s version %s\nCopyright (c) 2011, Gordon D. Carrie.\n"
@@ -100,17 +100,13 @@ int main(int argc, char *argv[])
 	fprintf(stderr, "Usage: %s [-a] [raw_file]\n", argv0);
 	exit(EXIT_FAILURE);
     }
-    if ( strcmp(vol_fl_nm, "-") == 0 ) {
-	in = stdin;
-    } else {
-	in = fopen(vol_fl_nm, "r");
-    }
-    if ( !in ) {
-	fprintf(stderr, "%s: could not open %s for input\n%s\n",
-		argv0, vol_fl_nm, strerror(errno));
+    if ( Sigmet_Vol_Open(vol_fl_nm, &in) != SIGMET_OK ) {
+	fprintf(stderr, "%s: could not open %s for input\n", argv0, vol_fl_nm);
 	exit(EXIT_FAILURE);
     }
-    if ( (s = Sigmet_Vol_ReadHdr(in, &vol)) != SIGMET_OK ) {
+    s = Sigmet_Vol_ReadHdr(in.f, &vol);
+    Sigmet_Vol_Close(&in);
+    if ( s != SIGMET_OK ) {
 	fprintf(stderr, "%s: read failed\n", argv0);
 	switch (s) {
 	    case SIGMET_OK:
@@ -41,33 +41,33 @@
 #include "geog_proj.h"
 #include "sigmet.h"
 
-static int init;
-static struct GeogProj proj;
+/*
+   Projections are held by the caller, so that several threads can draw
+   with different projections. proj_p should point to a struct GeogProj
+   that Sigmet_Proj_Set has initialized.
+ */
 
-int Sigmet_Proj_Set(char *l)
+int Sigmet_Proj_Set(struct GeogProj *proj_p, char *l)
 {
-    if ( GeogProjSetFmStr(l, &proj) ) {
-	init = 1;
-	return 1;
-    } else {
-	return 0;
-    }
+    return proj_p && GeogProjSetFmStr(l, proj_p);
 }
 
-int Sigmet_Proj_XYTLonLat(double x, double y, double *lon_p, double *lat_p)
+int Sigmet_Proj_XYTLonLat(double x, double y, double *lon_p, double *lat_p,
+	void *proj_p)
 {
-    if ( !init ) {
+    if ( !proj_p ) {
 	fprintf(stderr, "Sigmet map projection not set.\n");
 	return 0;
     }
-    return GeogProjXYToLonLat(x, y, lon_p, lat_p, &proj);
+    return GeogProjXYToLonLat(x, y, lon_p, lat_p, proj_p);
 }
 
-int Sigmet_Proj_LonLatToXY(double lon, double lat, double *x_p, double *y_p)
+int Sigmet_Proj_LonLatToXY(double lon, double lat, double *x_p, double *y_p,
+	void *proj_p)
 {
-    if ( !init ) {
+    if ( !proj_p ) {
 	fprintf(stderr, "Sigmet map projection not set.\n");
 	return 0;
     }
-    return GeogProjLonLatToXY(lon, lat, x_p, y_p, &proj);
+    return GeogProjLonLatToXY(lon, lat, x_p, y_p, proj_p);
 }
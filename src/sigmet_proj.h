@@ -36,12 +36,14 @@
 #ifndef _SIGMET_PROJ_H_
 #define _SIGMET_PROJ_H_
 
+#include "geog_proj.h"
+
 /*
    Global function declarations.
  */
 
-int Sigmet_Proj_Set(char *);
-int Sigmet_Proj_XYTLonLat(double, double, double *, double *);
-int Sigmet_Proj_LonLatToXY(double, double, double *, double *);
+int Sigmet_Proj_Set(struct GeogProj *, char *);
+int Sigmet_Proj_XYTLonLat(double, double, double *, double *, void *);
+int Sigmet_Proj_LonLatToXY(double, double, double *, double *, void *);
 
 #endif
@@ -47,6 +47,7 @@
 #include <sys/unistd.h>
 #include <sys/un.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
 #include <sys/wait.h>
 #include "alloc.h"
 #include "hash.h"
@@ -58,10 +59,48 @@
 #include "sigmet.h"
 
 /*
-   This struct contains the Sigmet raw product volume used by this process.
+   This struct contains the Sigmet raw product volume used by this process,
+   unless the process has a pool of volumes. Commands use the volume at
+   vol_p.
  */
 
 static struct Sigmet_Vol vol;
+static struct Sigmet_Vol *vol_p = &vol;
+
+/*
+   In pool mode, the process holds volumes for several raw product files,
+   keyed by path, in a list ordered from most to least recently used. The
+   volume command loads a volume on first reference and makes it current.
+   Least recently used volumes are freed when the sizes of the volumes,
+   from Sigmet_Vol_MemSz, add up to more than pool_budget bytes. The
+   current volume, and volumes that commands have modified, are never
+   freed this way. volume -d frees them.
+ */
+
+struct pool_vol {
+    char *vol_fl_nm;			/* Raw product file */
+    dev_t dev;				/* Device and inode of file when */
+    ino_t ino;				/* loaded */
+    struct timespec mtim;		/* Modification time of file when
+					   loaded */
+    off_t fl_sz;			/* Size of file when loaded */
+    struct Sigmet_Vol vol;
+    struct pool_vol *prev, *next;	/* Neighbors in list */
+};
+static struct pool_vol *pool_head;	/* Most recently used volume */
+static size_t pool_budget;		/* If not 0, process is in pool mode */
+static struct Sigmet_Vol_Filter pool_filter; /* Filter for pool volumes */
+static struct pool_vol *pool_find(char *);
+static struct pool_vol *pool_get(char *);
+static void pool_trim(void);
+static void pool_rm(struct pool_vol *);
+
+/*
+   If not NULL, name of shared memory volume this process published.
+   It is removed when the process exits.
+ */
+
+static char *shm_nm;
 
 /*
    Where to send output from various commands.
@@ -96,11 +135,12 @@ static FILE *out;
 
 /*
    Function to convert between longitude-latitude coordinates and map
-   coordinates.
+   coordinates, and the projection it uses. set_proj sets proj.
  */
 
-static int (*lonlat_to_xy)(double, double, double *, double *)
+static int (*lonlat_to_xy)(double, double, double *, double *, void *)
     = Sigmet_Proj_LonLatToXY;
+static struct GeogProj proj;
 
 /*
    Default static string length
@@ -113,18 +153,21 @@ static int (*lonlat_to_xy)(double, double, double *, double *)
  */
 
 static int set_proj(void);
-static FILE *vol_open(const char *, pid_t *);
+static int filter_types(char *, struct Sigmet_Vol_Filter *);
+static int filter_sweeps(char *, struct Sigmet_Vol_Filter *);
 static int handle_signals(void);
 static void handler(int);
 static void parent_handler(int);
 static char *sigmet_err(enum SigmetStatus);
 static double msec(double);
+static void shm_cleanup(void);
 
 /*
    Callbacks for the subcommands.
  */
 
 typedef int (callback)(int , char **);
+static callback *cmd_cb(char *);
 static callback commands_cb;
 static callback open_cb;
 static callback close_cb;
@@ -144,6 +187,13 @@ static callback sub_cb;
 static callback mul_cb;
 static callback div_cb;
 static callback log10_cb;
+static callback calc_cb;
+static callback mask_cb;
+static callback despeckle_cb;
+static callback boxcar_cb;
+static callback median_cb;
+static callback dealias_cb;
+static int filter(int, char *[], enum Sigmet_FldFilter);
 static callback incr_time_cb;
 static callback data_cb;
 static callback bdata_cb;
@@ -154,6 +204,7 @@ static callback radar_lat_cb;
 static callback shift_az_cb;
 static callback outlines_cb;
 static callback dorade_cb;
+static callback volume_cb;
 
 /*
    Subcommand names and associated callbacks. Hash returns the index from
@@ -166,40 +217,54 @@ static callback dorade_cb;
    Programming, Reading, Massachusetts. 1999
  */
 
-#define N_HASH_CMD 114
+#define N_HASH_CMD 175
 static char *cmd1v[N_HASH_CMD] = {
-    "close", "", "shift_az", "", "radar_lon", "", "", "", 
-    "", "outlines", "", "", "sub", "", "", "", 
-    "", "", "", "", "", "", "del_field", "", 
-    "", "", "", "", "", "", "", "ray_headers", 
-    "radar_lat", "", "", "", "data_types", "", "", "", 
-    "", "", "", "", "", "sweep_headers", "", "", 
-    "", "", "", "", "commands", "", "incr_time", "set_field", 
-    "", "", "sweep_bnds", "size", "", "", "data", "near_sweep", 
-    "bdata", "div", "", "", "open", "", "mul", "new_field", 
-    "bin_outline", "", "", "", "", "log10", "", "", 
-    "vol_hdr", "", "", "", "", "", "", "add", 
+    "", "", "", "", "", "", "bin_outline", "", 
+    "", "", "", "radar_lon", "", "", "", "", 
+    "", "", "", "", "", "", "", "near_sweep", 
     "", "", "", "", "", "", "", "", 
+    "", "mask", "", "data", "", "", "incr_time", "data_types", 
+    "", "ray_headers", "", "del_field", "", "", "new_field", "", 
+    "shift_az", "", "", "", "dealias", "", "", "", 
+    "", "", "", "boxcar", "", "", "", "", 
+    "", "", "", "", "", "volume", "", "", 
+    "", "div", "", "", "", "", "", "", 
+    "", "sweep_headers", "", "commands", "", "", "", "outlines", 
+    "", "", "vol_hdr", "", "", "", "", "", 
+    "", "sweep_bnds", "calc", "open", "", "", "median", "", 
+    "", "", "", "", "radar_lat", "", "", "", 
     "", "", "", "", "", "", "", "", 
-    "", "", "exit", "dorade", "", "volume_headers", "", "", 
-    "", "", 
+    "", "", "", "dorade", "", "", "", "", 
+    "size", "", "", "", "", "", "", "despeckle", 
+    "", "", "", "", "sub", "", "", "", 
+    "close", "volume_headers", "", "", "", "", "", "", 
+    "", "", "", "set_field", "", "exit", "", "mul", 
+    "", "", "", "", "", "", "", "add", 
+    "bdata", "log10", "", "", "", "", "", 
 };
 static callback *cb1v[N_HASH_CMD] = {
-    close_cb, NULL, shift_az_cb, NULL, radar_lon_cb, NULL, NULL, NULL, 
-    NULL, outlines_cb, NULL, NULL, sub_cb, NULL, NULL, NULL, 
-    NULL, NULL, NULL, NULL, NULL, NULL, del_field_cb, NULL, 
-    NULL, NULL, NULL, NULL, NULL, NULL, NULL, ray_headers_cb, 
-    radar_lat_cb, NULL, NULL, NULL, data_types_cb, NULL, NULL, NULL, 
-    NULL, NULL, NULL, NULL, NULL, sweep_headers_cb, NULL, NULL, 
-    NULL, NULL, NULL, NULL, commands_cb, NULL, incr_time_cb, set_field_cb, 
-    NULL, NULL, sweep_bnds_cb, size_cb, NULL, NULL, data_cb, near_sweep_cb, 
-    bdata_cb, div_cb, NULL, NULL, open_cb, NULL, mul_cb, new_field_cb, 
-    bin_outline_cb, NULL, NULL, NULL, NULL, log10_cb, NULL, NULL, 
-    vol_hdr_cb, NULL, NULL, NULL, NULL, NULL, NULL, add_cb, 
+    NULL, NULL, NULL, NULL, NULL, NULL, bin_outline_cb, NULL, 
+    NULL, NULL, NULL, radar_lon_cb, NULL, NULL, NULL, NULL, 
+    NULL, NULL, NULL, NULL, NULL, NULL, NULL, near_sweep_cb, 
     NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, 
+    NULL, mask_cb, NULL, data_cb, NULL, NULL, incr_time_cb, data_types_cb, 
+    NULL, ray_headers_cb, NULL, del_field_cb, NULL, NULL, new_field_cb, NULL, 
+    shift_az_cb, NULL, NULL, NULL, dealias_cb, NULL, NULL, NULL, 
+    NULL, NULL, NULL, boxcar_cb, NULL, NULL, NULL, NULL, 
+    NULL, NULL, NULL, NULL, NULL, volume_cb, NULL, NULL, 
+    NULL, div_cb, NULL, NULL, NULL, NULL, NULL, NULL, 
+    NULL, sweep_headers_cb, NULL, commands_cb, NULL, NULL, NULL, outlines_cb, 
+    NULL, NULL, vol_hdr_cb, NULL, NULL, NULL, NULL, NULL, 
+    NULL, sweep_bnds_cb, calc_cb, open_cb, NULL, NULL, median_cb, NULL, 
+    NULL, NULL, NULL, NULL, radar_lat_cb, NULL, NULL, NULL, 
     NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, 
-    NULL, NULL, exit_cb, dorade_cb, NULL, volume_headers_cb, NULL, NULL, 
-    NULL, NULL, 
+    NULL, NULL, NULL, dorade_cb, NULL, NULL, NULL, NULL, 
+    size_cb, NULL, NULL, NULL, NULL, NULL, NULL, despeckle_cb, 
+    NULL, NULL, NULL, NULL, sub_cb, NULL, NULL, NULL, 
+    close_cb, volume_headers_cb, NULL, NULL, NULL, NULL, NULL, NULL, 
+    NULL, NULL, NULL, set_field_cb, NULL, exit_cb, NULL, mul_cb, 
+    NULL, NULL, NULL, NULL, NULL, NULL, NULL, add_cb, 
+    bdata_cb, log10_cb, NULL, NULL, NULL, NULL, NULL, 
 };
 
 /*
@@ -216,10 +281,16 @@ int main(int argc, char *argv[])
 {
     char *argv0 = argv[0];
     char *vol_fl_nm;			/* Name of raw product file */
-    FILE *vol_fl;			/* Input stream associated with
+    char *shm_in = NULL;		/* If not NULL, attach to shared memory
+					   volume with this name instead of
+					   reading a raw product file */
+    char *shm_out = NULL;		/* If not NULL, publish volume in shared
+					   memory with this name */
+    char *cache_nm = NULL;		/* If not NULL, cache file for decoded
+					   volume */
+    struct Sigmet_Vol_In vol_in;	/* Input stream associated with
 					   vol_fl_nm */
-    pid_t lpid;				/* Id if reading volume from another
-					   process */
+    enum SigmetStatus unz_stat;		/* Result of decompression */
     char *script_nm;			/* Name of script file */
     FILE *script;			/* Script stream */
     int daemon = 0;			/* If true, do not exit on EOF */
@@ -229,6 +300,16 @@ int main(int argc, char *argv[])
     int argc1;				/* Number of words in argv1 */
     char *cmd;				/* Comand name, from input */
     enum SigmetStatus sig_stat;		/* Return from a Sigmet function */
+    struct Sigmet_Vol_Filter filter;	/* Data types and sweeps to load */
+    int follow = 0;			/* If true, keep decoding the volume
+					   as it arrives */
+    double budget_mb;			/* Memory budget for pool mode,
+					   megabytes */
+    callback *cb;			/* Callback for cmd */
+    double idle = 0.0;			/* In follow mode, stop waiting for
+					   a regular file after it does not
+					   grow for this many seconds */
+    int a;				/* Index in argv */
     int n;
 
     if ( !handle_signals() ) {
@@ -239,41 +320,144 @@ int main(int argc, char *argv[])
     if ( argc == 1 ) {
 	fprintf(out, "%s version %s\nCopyright (c) 2011, Gordon D. Carrie.\n"
 		"All rights reserved.\n"
-		"Usage: %s raw_product_file [command_file]\n"
+		"Usage: %s [-t type,...] [-s sweep,...] [-j threads] "
+		"[-f idle] [-c cache] [-p name] raw_product_file "
+		"[command_file]\n"
+		"       %s [-p name] -a name [command_file]\n"
+		"       %s -m megabytes [-t type,...] [-s sweep,...] "
+		"[-j threads] [command_file]\n"
 		"See sigmet_raw (1) for more information.\n",
-		argv0, SIGMET_RAW_VERSION, argv0);
+		argv0, SIGMET_RAW_VERSION, argv0, argv0, argv0);
 	exit(EXIT_SUCCESS);
-    } else if ( argc == 2 ) {
-	vol_fl_nm = argv[1];
+    }
+    Sigmet_Vol_FilterInit(&filter);
+    for (a = 1; a < argc && argv[a][0] == '-' && argv[a][1] != '\0'; a += 2) {
+	if ( a + 1 == argc ) {
+	    fprintf(stderr, "%s: %s option needs a value.\n", argv0, argv[a]);
+	    exit(EXIT_FAILURE);
+	}
+	if ( strcmp(argv[a], "-t") == 0 ) {
+	    if ( !filter_types(argv[a + 1], &filter) ) {
+		exit(EXIT_FAILURE);
+	    }
+	} else if ( strcmp(argv[a], "-s") == 0 ) {
+	    if ( !filter_sweeps(argv[a + 1], &filter) ) {
+		exit(EXIT_FAILURE);
+	    }
+	} else if ( strcmp(argv[a], "-j") == 0 ) {
+	    if ( sscanf(argv[a + 1], "%d", &filter.num_threads) != 1
+		    || filter.num_threads < 1 ) {
+		fprintf(stderr, "%s: expected positive integer for number of "
+			"threads, got %s.\n", argv0, argv[a + 1]);
+		exit(EXIT_FAILURE);
+	    }
+	} else if ( strcmp(argv[a], "-f") == 0 ) {
+	    if ( sscanf(argv[a + 1], "%lf", &idle) != 1 || !(idle >= 0.0) ) {
+		fprintf(stderr, "%s: expected non-negative number of seconds "
+			"to wait for volume, got %s.\n", argv0, argv[a + 1]);
+		exit(EXIT_FAILURE);
+	    }
+	    follow = 1;
+	} else if ( strcmp(argv[a], "-a") == 0 ) {
+	    shm_in = argv[a + 1];
+	} else if ( strcmp(argv[a], "-p") == 0 ) {
+	    shm_out = argv[a + 1];
+	} else if ( strcmp(argv[a], "-c") == 0 ) {
+	    cache_nm = argv[a + 1];
+	} else if ( strcmp(argv[a], "-m") == 0 ) {
+	    if ( sscanf(argv[a + 1], "%lf", &budget_mb) != 1
+		    || !(budget_mb > 0.0)
+		    || budget_mb * 1048576.0 > (double)((size_t)-1) ) {
+		fprintf(stderr, "%s: expected positive number of megabytes "
+			"for volume pool, got %s.\n", argv0, argv[a + 1]);
+		exit(EXIT_FAILURE);
+	    }
+	    pool_budget = budget_mb * 1048576.0;
+	} else {
+	    fprintf(stderr, "%s: unknown option %s.\n", argv0, argv[a]);
+	    exit(EXIT_FAILURE);
+	}
+    }
+    if ( pool_budget && (follow || shm_in || shm_out || cache_nm) ) {
+	fprintf(stderr, "%s: volume pool cannot be combined with -f, -a, -p, "
+		"or -c.\n", argv0);
+	exit(EXIT_FAILURE);
+    }
+    if ( shm_in && follow ) {
+	fprintf(stderr, "%s: cannot follow a shared memory volume.\n", argv0);
+	exit(EXIT_FAILURE);
+    }
+    if ( cache_nm && (follow || shm_in) ) {
+	fprintf(stderr, "%s: cache only applies to a complete raw product "
+		"file.\n", argv0);
+	exit(EXIT_FAILURE);
+    }
+    if ( pool_budget && argc - a <= 1 ) {
+	vol_fl_nm = NULL;
+	script_nm = (argc - a == 1) ? argv[a] : "-";
+    } else if ( shm_in && argc - a == 0 ) {
+	vol_fl_nm = shm_in;
 	script_nm = "-";
-    } else if ( argc == 3 ) {
-	vol_fl_nm = argv[1];
-	script_nm = argv[2];
+    } else if ( shm_in && argc - a == 1 ) {
+	vol_fl_nm = shm_in;
+	script_nm = argv[a];
+    } else if ( !shm_in && argc - a == 1 ) {
+	vol_fl_nm = argv[a];
+	script_nm = "-";
+    } else if ( !shm_in && argc - a == 2 ) {
+	vol_fl_nm = argv[a];
+	script_nm = argv[a + 1];
     } else {
-	fprintf(stderr, "Usage: %s sigmet_raw_file [command_file]\n", argv0);
+	fprintf(stderr, "Usage: %s [-t type,...] [-s sweep,...] [-j threads] "
+		"[-f idle] [-c cache] [-p name] sigmet_raw_file "
+		"[command_file]\n"
+		"       %s [-p name] -a name [command_file]\n"
+		"       %s -m megabytes [-t type,...] [-s sweep,...] "
+		"[-j threads] [command_file]\n", argv0, argv0, argv0);
 	exit(EXIT_FAILURE);
     }
 
     /*
-       Load the volume
+       Load the volume. In follow mode, wait until after the fork to daemon
+       mode, since the threads that decode the volume would not survive it.
      */
 
-    Sigmet_Vol_Init(&vol);
-    lpid = -1;
-    if ( !(vol_fl = vol_open(vol_fl_nm, &lpid)) ) {
-	fprintf(stderr, "%s: could not open file %s for reading.\n%s\n",
-		argv0, vol_fl_nm, strerror(errno));
-	exit(EXIT_FAILURE);
-    }
-    sig_stat = Sigmet_Vol_Read(vol_fl, &vol);
-    fclose(vol_fl);
-    if ( lpid != -1 ) {
-	waitpid(lpid, NULL, 0);
-    }
-    if ( sig_stat != SIGMET_OK ) {
-	fprintf(stderr, "%s: could not read volume.\n%s\n",
-		argv0, sigmet_err(sig_stat));
-	exit(EXIT_FAILURE);
+    Sigmet_Vol_Init(vol_p);
+    if ( pool_budget ) {
+	/* Volumes are loaded by the volume command */
+	pool_filter = filter;
+    } else if ( shm_in ) {
+	if ( (sig_stat = Sigmet_Vol_ShmAttach(shm_in, vol_p)) != SIGMET_OK ) {
+	    fprintf(stderr, "%s: could not attach to shared memory volume "
+		    "%s.\n%s\n", argv0, shm_in, sigmet_err(sig_stat));
+	    exit(EXIT_FAILURE);
+	}
+    } else if ( cache_nm && strcmp(vol_fl_nm, "-") != 0
+	    && Sigmet_Vol_CacheRead(vol_fl_nm, &filter, cache_nm, vol_p)
+	    == SIGMET_OK ) {
+	/* Volume is mapped from the cache */
+    } else if ( !follow ) {
+	if ( (sig_stat = Sigmet_Vol_Open(vol_fl_nm, &vol_in)) != SIGMET_OK ) {
+	    fprintf(stderr, "%s: could not open file %s for reading.\n%s\n",
+		    argv0, vol_fl_nm, sigmet_err(sig_stat));
+	    exit(EXIT_FAILURE);
+	}
+	sig_stat = Sigmet_Vol_ReadIdx(vol_in.f, vol_p, &filter);
+	if ( (unz_stat = Sigmet_Vol_Close(&vol_in)) != SIGMET_OK ) {
+	    fprintf(stderr, "%s: warning: could not decompress all of %s.\n"
+		    "%s\n", argv0, vol_fl_nm, sigmet_err(unz_stat));
+	}
+	if ( sig_stat != SIGMET_OK ) {
+	    fprintf(stderr, "%s: could not read volume.\n%s\n",
+		    argv0, sigmet_err(sig_stat));
+	    exit(EXIT_FAILURE);
+	}
+	if ( cache_nm && strcmp(vol_fl_nm, "-") != 0
+		&& (sig_stat = Sigmet_Vol_CacheWrite(vol_p, vol_fl_nm,
+			cache_nm)) != SIGMET_OK ) {
+	    fprintf(stderr, "%s: warning: could not write cache %s.\n%s\n",
+		    argv0, cache_nm, sigmet_err(sig_stat));
+	}
     }
 
     /* Open the script file */
@@ -398,7 +582,9 @@ int main(int argc, char *argv[])
 			    strerror(errno));
 		    exit(EXIT_FAILURE);
 		}
-		fclose(stdin);
+		if ( !follow || strcmp(vol_fl_nm, "-") != 0 ) {
+		    fclose(stdin);
+		}
 	    }
 	} else {
 	    /*
@@ -414,6 +600,51 @@ int main(int argc, char *argv[])
 	}
     }
 
+    /*
+       In follow mode, start decoding the volume. Commands that need a
+       sweep wait for it to arrive. The input stream stays open until
+       the process exits.
+     */
+
+    if ( follow ) {
+	if ( (sig_stat = Sigmet_Vol_Open(vol_fl_nm, &vol_in)) != SIGMET_OK ) {
+	    fprintf(stderr, "%s: could not open file %s for reading.\n%s\n",
+		    argv0, vol_fl_nm, sigmet_err(sig_stat));
+	    exit(EXIT_FAILURE);
+	}
+	sig_stat = Sigmet_Vol_Follow(vol_in.f, vol_p, &filter, idle);
+	if ( sig_stat != SIGMET_OK ) {
+	    fprintf(stderr, "%s: could not read volume.\n%s\n",
+		    argv0, sigmet_err(sig_stat));
+	    exit(EXIT_FAILURE);
+	}
+    }
+
+    /*
+       Publish the volume, if requested. Then this process switches to the
+       shared copy, so that it does not hold the volume twice. A followed
+       volume is published when it is complete.
+     */
+
+    if ( shm_out ) {
+	if ( (sig_stat = Sigmet_Vol_ShmPublish(vol_p, shm_out)) != SIGMET_OK ) {
+	    fprintf(stderr, "%s: could not publish volume as %s.\n%s\n",
+		    argv0, shm_out, sigmet_err(sig_stat));
+	    exit(EXIT_FAILURE);
+	}
+	shm_nm = shm_out;
+	if ( atexit(shm_cleanup) != 0 ) {
+	    fprintf(stderr, "%s: could not arrange to remove shared memory "
+		    "volume %s at exit.\n", argv0, shm_out);
+	}
+	Sigmet_Vol_Free(vol_p);
+	if ( (sig_stat = Sigmet_Vol_ShmAttach(shm_out, vol_p)) != SIGMET_OK ) {
+	    fprintf(stderr, "%s: could not attach to shared memory volume "
+		    "%s.\n%s\n", argv0, shm_out, sigmet_err(sig_stat));
+	    exit(EXIT_FAILURE);
+	}
+    }
+
     /*
        Read commands from standard input. Go to callback specified in first
        word.
@@ -430,8 +661,7 @@ int main(int argc, char *argv[])
 		if ( !cmd || strcmp(cmd, "#") == 0 ) {
 		    continue;
 		}
-		n = Hash(cmd, N_HASH_CMD);
-		if ( strcmp(cmd, cmd1v[n]) != 0 ) {
+		if ( !(cb = cmd_cb(cmd)) ) {
 		    fprintf(stderr, "%s: unknown command %s. "
 			    "Subcommand must be one of ", argv0, cmd);
 		    for (n = 0; n < N_HASH_CMD; n++) {
@@ -440,7 +670,13 @@ int main(int argc, char *argv[])
 			}
 		    }
 		    fprintf(stderr, "\n");
-		} else if ( !cb1v[n](argc1, argv1) ) {
+		} else if ( pool_budget && vol_p == &vol
+			&& cb != commands_cb && cb != open_cb
+			&& cb != close_cb && cb != exit_cb
+			&& cb != volume_cb ) {
+		    fprintf(stderr, "%s: no volume selected for %s. Use the "
+			    "volume command.\n", argv0, cmd);
+		} else if ( !cb(argc1, argv1) ) {
 		    fprintf(stderr, "%s: %s failed.\n", argv0, cmd);
 		}
 		break;
@@ -458,6 +694,18 @@ int main(int argc, char *argv[])
     return EXIT_FAILURE;
 }
 
+/*
+   Return the callback for command cmd, or NULL if there is no such command.
+ */
+
+static callback *cmd_cb(char *cmd)
+{
+    int n;
+
+    n = Hash(cmd, N_HASH_CMD);
+    return (strcmp(cmd, cmd1v[n]) == 0) ? cb1v[n] : NULL;
+}
+
 /*
    Callbacks.
  */
@@ -539,8 +787,8 @@ static int data_types_cb(int argc, char *argv[])
 	fprintf(stderr, "Usage: %s\n", argv0);
 	return 0;
     }
-    for (y = 0; y < Sigmet_Vol_NumTypes(&vol); y++) {
-	Sigmet_Vol_DataTypeHdrs(&vol, y, &data_type_s, &descr, &unit);
+    for (y = 0; y < Sigmet_Vol_NumTypes(vol_p); y++) {
+	Sigmet_Vol_DataTypeHdrs(vol_p, y, &data_type_s, &descr, &unit);
 	fprintf(out, "%s | %s | %s\n", data_type_s, descr, unit);
     }
     return 1;
@@ -554,7 +802,7 @@ static int volume_headers_cb(int argc, char *argv[])
 	fprintf(stderr, "Usage: %s\n", argv0);
 	return 0;
     }
-    Sigmet_Vol_PrintHdr(out, &vol);
+    Sigmet_Vol_PrintHdr(out, vol_p);
     return 1;
 }
 
@@ -566,7 +814,7 @@ static int vol_hdr_cb(int argc, char *argv[])
 	fprintf(stderr, "Usage: %s\n", argv0);
 	return 0;
     }
-    Sigmet_Vol_PrintMinHdr(out, &vol);
+    Sigmet_Vol_PrintMinHdr(out, vol_p);
     return 1;
 }
 
@@ -588,7 +836,7 @@ static int near_sweep_cb(int argc, char *argv[])
 	return 0;
     }
     ang *= RAD_PER_DEG;
-    s = Sigmet_Vol_NearSweep(&vol, ang);
+    s = Sigmet_Vol_NearSweep(vol_p, ang);
     if ( s == -1 ) {
 	fprintf(stderr, "%s: could not determine sweep with "
 		"sweep angle nearest %s\n", argv0, ang_s);
@@ -612,9 +860,9 @@ static int sweep_headers_cb(int argc, char *argv[])
 	fprintf(stderr, "Usage: %s\n", argv0);
 	return 0;
     }
-    for (s = 0; s < Sigmet_Vol_NumSweeps(&vol); s++) {
+    for (s = 0; s < Sigmet_Vol_NumSweeps(vol_p); s++) {
 	fprintf(out, "sweep %2d ", s);
-	sig_stat = Sigmet_Vol_SweepHdr(&vol, s, &ok, &tm, &ang);
+	sig_stat = Sigmet_Vol_SweepHdr(vol_p, s, &ok, &tm, &ang);
 	if ( sig_stat != SIGMET_OK ) {
 	    fprintf(stderr, "%s: %s\n", argv0, sigmet_err(sig_stat));
 	}
@@ -648,14 +896,14 @@ static int ray_headers_cb(int argc, char *argv[])
 	fprintf(stderr, "Usage: %s\n", argv0);
 	return 0;
     }
-    for (s = 0; s < Sigmet_Vol_NumSweeps(&vol); s++) {
-	sig_stat = Sigmet_Vol_SweepHdr(&vol, s, &ok, NULL, NULL);
+    for (s = 0; s < Sigmet_Vol_NumSweeps(vol_p); s++) {
+	sig_stat = Sigmet_Vol_SweepHdr(vol_p, s, &ok, NULL, NULL);
 	if ( sig_stat != SIGMET_OK ) {
 	    fprintf(stderr, "%s: %s\n", argv0, sigmet_err(sig_stat));
 	}
 	if ( ok ) {
-	    for (r = 0; r < Sigmet_Vol_NumRays(&vol); r++) {
-		sig_stat = Sigmet_Vol_RayHdr(&vol, s, r, &ok, &tm, &num_bins,
+	    for (r = 0; r < Sigmet_Vol_NumRays(vol_p); r++) {
+		sig_stat = Sigmet_Vol_RayHdr(vol_p, s, r, &ok, &tm, &num_bins,
 			&tilt0, &tilt1, &az0, &az1);
 		if ( sig_stat != SIGMET_OK ) {
 		    fprintf(stderr, "%s: %s\n", argv0, sigmet_err(sig_stat));
@@ -696,6 +944,11 @@ static int new_field_cb(int argc, char *argv[])
     double val;
     char *descr = NULL;			/* Descriptor for new field */
     char *unit = NULL;			/* Unit for new field */
+    char *fmt_s = NULL;			/* Storage format */
+    enum Sigmet_StorFmt stor_fmt = SIGMET_FLT;
+    char *scale_s = NULL, *offset_s = NULL;
+    double scale = 0.0, offset = 0.0;	/* Scale and offset for integer
+					   storage */
     enum SigmetStatus sig_stat;		/* Return from a Sigmet function */
 
     /*
@@ -703,9 +956,10 @@ static int new_field_cb(int argc, char *argv[])
        this data type.
      */
 
-    if ( argc < 2 || argc > 8 ) {
+    if ( argc < 2 || argc > 14 ) {
 	fprintf(stderr, "Usage: %s data_type [-d description] [-u unit] "
-		"[-v value]\n", argv0);
+		"[-v value] [-f flt|f16|u1|u2] [-s scale] [-o offset]\n",
+		argv0);
 	return 0;
     }
     data_type_s = argv[1];
@@ -721,18 +975,58 @@ static int new_field_cb(int argc, char *argv[])
 	    unit = argv[++a];
 	} else if (strcmp(argv[a], "-v") == 0) {
 	    val_s = argv[++a];
+	} else if (strcmp(argv[a], "-f") == 0) {
+	    fmt_s = argv[++a];
+	} else if (strcmp(argv[a], "-s") == 0) {
+	    scale_s = argv[++a];
+	} else if (strcmp(argv[a], "-o") == 0) {
+	    offset_s = argv[++a];
 	} else {
 	    fprintf(stderr, "%s: unknown option %s.\n", argv0, argv[a]);
 	    return 0;
 	}
     }
+
+    /*
+       Obtain optional storage format. Integer formats need a scale.
+     */
+
+    if ( !fmt_s || strcmp(fmt_s, "flt") == 0 ) {
+	stor_fmt = SIGMET_FLT;
+    } else if ( strcmp(fmt_s, "f16") == 0 ) {
+	stor_fmt = SIGMET_F16;
+    } else if ( strcmp(fmt_s, "u1") == 0 ) {
+	stor_fmt = SIGMET_U1;
+    } else if ( strcmp(fmt_s, "u2") == 0 ) {
+	stor_fmt = SIGMET_U2;
+    } else {
+	fprintf(stderr, "%s: storage format must be flt, f16, u1, or u2.\n",
+		argv0);
+	return 0;
+    }
+    if ( scale_s && sscanf(scale_s, "%lf", &scale) != 1 ) {
+	fprintf(stderr, "%s: expected float value for scale, got %s.\n",
+		argv0, scale_s);
+	return 0;
+    }
+    if ( offset_s && sscanf(offset_s, "%lf", &offset) != 1 ) {
+	fprintf(stderr, "%s: expected float value for offset, got %s.\n",
+		argv0, offset_s);
+	return 0;
+    }
+    if ( (stor_fmt == SIGMET_U1 || stor_fmt == SIGMET_U2) && !scale_s ) {
+	fprintf(stderr, "%s: storage format %s needs a scale.\n",
+		argv0, fmt_s);
+	return 0;
+    }
     if ( !descr || strlen(descr) == 0 ) {
 	descr = "No description";
     }
     if ( !unit || strlen(unit) == 0 ) {
 	unit = "Dimensionless";
     }
-    sig_stat = Sigmet_Vol_NewField(&vol, data_type_s, descr, unit);
+    sig_stat = Sigmet_Vol_NewFieldFmt(vol_p, data_type_s, descr, unit,
+	    stor_fmt, scale, offset);
     if ( sig_stat != SIGMET_OK ) {
 	fprintf(stderr, "%s: could not add data type %s to volume\n%s\n",
 		argv0, data_type_s, sigmet_err(sig_stat));
@@ -745,7 +1039,7 @@ static int new_field_cb(int argc, char *argv[])
 
     if ( val_s ) {
 	if ( sscanf(val_s, "%lf", &val) == 1 ) {
-	    sig_stat = Sigmet_Vol_Fld_SetVal(&vol, data_type_s, val);
+	    sig_stat = Sigmet_Vol_Fld_SetVal(vol_p, data_type_s, val);
 	    if ( sig_stat != SIGMET_OK ) {
 		fprintf(stderr, "%s: could not set %s to %lf in volume\n%s\n"
 			"Field is retained in volume but values are garbage.\n",
@@ -753,7 +1047,7 @@ static int new_field_cb(int argc, char *argv[])
 		return 0;
 	    }
 	} else if ( strcmp(val_s, "r_beam") == 0 ) {
-	    sig_stat = Sigmet_Vol_Fld_SetRBeam(&vol, data_type_s);
+	    sig_stat = Sigmet_Vol_Fld_SetRBeam(vol_p, data_type_s);
 	    if ( sig_stat != SIGMET_OK ) {
 		fprintf(stderr, "%s: could not set %s to %s in volume\n%s\n"
 			"Field is retained in volume but values are garbage.\n",
@@ -761,7 +1055,7 @@ static int new_field_cb(int argc, char *argv[])
 		return 0;
 	    }
 	} else {
-	    sig_stat = Sigmet_Vol_Fld_Copy(&vol, data_type_s, val_s);
+	    sig_stat = Sigmet_Vol_Fld_Copy(vol_p, data_type_s, val_s);
 	    if ( sig_stat != SIGMET_OK ) {
 		fprintf(stderr, "%s: could not set %s to %s in volume\n%s\n"
 			"Field is retained in volume but values are garbage.\n",
@@ -784,7 +1078,7 @@ static int del_field_cb(int argc, char *argv[])
 	return 0;
     }
     data_type_s = argv[1];
-    if ( (sig_stat = Sigmet_Vol_DelField(&vol, data_type_s)) != SIGMET_OK ) {
+    if ( (sig_stat = Sigmet_Vol_DelField(vol_p, data_type_s)) != SIGMET_OK ) {
 	fprintf(stderr, "%s: could not remove data type %s from volume\n%s\n",
 		argv0, data_type_s, sigmet_err(sig_stat));
 	return 0;
@@ -800,7 +1094,7 @@ static int size_cb(int argc, char *argv[])
 	fprintf(stderr, "Usage: %s\n", argv0);
 	return 0;
     }
-    fprintf(out, "%lu\n", (unsigned long)Sigmet_Vol_MemSz(&vol));
+    fprintf(out, "%lu\n", (unsigned long)Sigmet_Vol_MemSz(vol_p));
     return 1;
 }
 
@@ -826,7 +1120,7 @@ static int set_field_cb(int argc, char *argv[])
      */
 
     if ( strcmp("r_beam", d_s) == 0 ) {
-	sig_stat = Sigmet_Vol_Fld_SetRBeam(&vol, data_type_s);
+	sig_stat = Sigmet_Vol_Fld_SetRBeam(vol_p, data_type_s);
 	if ( sig_stat != SIGMET_OK ) {
 	    fprintf(stderr, "%s: could not set %s to beam range "
 		    "in volume\n%s\n", argv0, data_type_s,
@@ -834,7 +1128,7 @@ static int set_field_cb(int argc, char *argv[])
 	    return 0;
 	}
     } else if ( sscanf(d_s, "%lf", &d) == 1 ) {
-	sig_stat = Sigmet_Vol_Fld_SetVal(&vol, data_type_s, d);
+	sig_stat = Sigmet_Vol_Fld_SetVal(vol_p, data_type_s, d);
 	if ( sig_stat != SIGMET_OK ) {
 	    fprintf(stderr, "%s: could not set %s to %lf in volume\n%s\n",
 		    argv0, data_type_s, d, sigmet_err(sig_stat));
@@ -863,13 +1157,13 @@ static int add_cb(int argc, char *argv[])
     data_type_s = argv[1];
     a_s = argv[2];
     if ( sscanf(a_s, "%lf", &a) == 1 ) {
-	sig_stat = Sigmet_Vol_Fld_AddVal(&vol, data_type_s, a);
+	sig_stat = Sigmet_Vol_Fld_AddVal(vol_p, data_type_s, a);
 	if ( sig_stat != SIGMET_OK ) {
 	    fprintf(stderr, "%s: could not add %s to %lf in volume\n%s\n",
 		    argv0, data_type_s, a, sigmet_err(sig_stat));
 	    return 0;
 	}
-    } else if ( (sig_stat = Sigmet_Vol_Fld_AddFld(&vol, data_type_s, a_s))
+    } else if ( (sig_stat = Sigmet_Vol_Fld_AddFld(vol_p, data_type_s, a_s))
 	    != SIGMET_OK ) {
 	fprintf(stderr, "%s: could not add %s to %s in volume\n%s\n",
 		argv0, data_type_s, a_s, sigmet_err(sig_stat));
@@ -893,14 +1187,14 @@ static int sub_cb(int argc, char *argv[])
     data_type_s = argv[1];
     a_s = argv[2];
     if ( sscanf(a_s, "%lf", &a) == 1 ) {
-	sig_stat = Sigmet_Vol_Fld_SubVal(&vol, data_type_s, a);
+	sig_stat = Sigmet_Vol_Fld_SubVal(vol_p, data_type_s, a);
 	if ( sig_stat != SIGMET_OK ) {
 	    fprintf(stderr, "%s: could not subtract %lf from %s in "
 		    "volume\n%s\n", argv0, a, data_type_s,
 		    sigmet_err(sig_stat));
 	    return 0;
 	}
-    } else if ( (sig_stat = Sigmet_Vol_Fld_SubFld(&vol, data_type_s, a_s))
+    } else if ( (sig_stat = Sigmet_Vol_Fld_SubFld(vol_p, data_type_s, a_s))
 	    != SIGMET_OK ) {
 	fprintf(stderr, "%s: could not subtract %s from %s in volume\n%s\n",
 		argv0, a_s, data_type_s, sigmet_err(sig_stat));
@@ -924,14 +1218,14 @@ static int mul_cb(int argc, char *argv[])
     data_type_s = argv[1];
     a_s = argv[2];
     if ( sscanf(a_s, "%lf", &a) == 1 ) {
-	sig_stat = Sigmet_Vol_Fld_MulVal(&vol, data_type_s, a);
+	sig_stat = Sigmet_Vol_Fld_MulVal(vol_p, data_type_s, a);
 	if ( sig_stat != SIGMET_OK ) {
 	    fprintf(stderr, "%s: could not multiply %s by %lf in "
 		    "volume\n%s\n", argv0, data_type_s, a,
 		    sigmet_err(sig_stat));
 	    return 0;
 	}
-    } else if ( (sig_stat = Sigmet_Vol_Fld_MulFld(&vol, data_type_s, a_s))
+    } else if ( (sig_stat = Sigmet_Vol_Fld_MulFld(vol_p, data_type_s, a_s))
 	    != SIGMET_OK ) {
 	fprintf(stderr, "%s: could not multiply %s by %s in volume\n%s\n",
 		argv0, data_type_s, a_s, sigmet_err(sig_stat));
@@ -955,13 +1249,13 @@ static int div_cb(int argc, char *argv[])
     data_type_s = argv[1];
     a_s = argv[2];
     if ( sscanf(a_s, "%lf", &a) == 1 ) {
-	sig_stat = Sigmet_Vol_Fld_DivVal(&vol, data_type_s, a);
+	sig_stat = Sigmet_Vol_Fld_DivVal(vol_p, data_type_s, a);
 	if ( sig_stat != SIGMET_OK ) {
 	    fprintf(stderr, "%s: could not divide %s by %lf in volume\n%s\n",
 		    argv0, data_type_s, a, sigmet_err(sig_stat));
 	    return 0;
 	}
-    } else if ( (sig_stat = Sigmet_Vol_Fld_DivFld(&vol, data_type_s, a_s))
+    } else if ( (sig_stat = Sigmet_Vol_Fld_DivFld(vol_p, data_type_s, a_s))
 	    != SIGMET_OK ) {
 	fprintf(stderr, "%s: could not divide %s by %s in volume\n%s\n",
 		argv0, data_type_s, a_s, sigmet_err(sig_stat));
@@ -981,7 +1275,7 @@ static int log10_cb(int argc, char *argv[])
 	return 0;
     }
     data_type_s = argv[1];
-    if ( (sig_stat = Sigmet_Vol_Fld_Log10(&vol, data_type_s)) != SIGMET_OK ) {
+    if ( (sig_stat = Sigmet_Vol_Fld_Log10(vol_p, data_type_s)) != SIGMET_OK ) {
 	fprintf(stderr, "%s: could not compute log10 of %s in volume\n%s\n",
 		argv0, data_type_s, sigmet_err(sig_stat));
 	return 0;
@@ -989,6 +1283,229 @@ static int log10_cb(int argc, char *argv[])
     return 1;
 }
 
+/*
+   Set a field to the value of an expression. Words after the field name
+   are joined with spaces to make the expression.
+ */
+
+static int calc_cb(int argc, char *argv[])
+{
+    char *argv0 = argv[0];
+    enum SigmetStatus sig_stat;		/* Return from a Sigmet function */
+    char *data_type_s;			/* Data type abbreviation */
+    char *expr;				/* Expression */
+    size_t sz;
+    int a;
+
+    if ( argc < 3 ) {
+	fprintf(stderr, "Usage: %s data_type expression\n", argv0);
+	return 0;
+    }
+    data_type_s = argv[1];
+    for (sz = 0, a = 2; a < argc; a++) {
+	sz += strlen(argv[a]) + 1;
+    }
+    if ( !(expr = MALLOC(sz)) ) {
+	fprintf(stderr, "%s: could not allocate expression.\n", argv0);
+	return 0;
+    }
+    strcpy(expr, argv[2]);
+    for (a = 3; a < argc; a++) {
+	strcat(expr, " ");
+	strcat(expr, argv[a]);
+    }
+    sig_stat = Sigmet_Vol_Fld_Calc(vol_p, data_type_s, expr);
+    FREE(expr);
+    if ( sig_stat != SIGMET_OK ) {
+	fprintf(stderr, "%s: could not calculate %s in volume\n%s\n",
+		argv0, data_type_s, sigmet_err(sig_stat));
+	return 0;
+    }
+    return 1;
+}
+
+/*
+   Blank a field where another field passes a threshold test.
+ */
+
+static int mask_cb(int argc, char *argv[])
+{
+    char *argv0 = argv[0];
+    enum SigmetStatus sig_stat;		/* Return from a Sigmet function */
+    char *data_type_s;			/* Data type abbreviation */
+    char *ctl_s;			/* Controlling data type */
+    char *cmp;				/* Comparison */
+    char *thr_s;			/* Threshold, as a string */
+    double thr;				/* Threshold */
+
+    if ( argc != 5 ) {
+	fprintf(stderr, "Usage: %s data_type control_type cmp threshold\n",
+		argv0);
+	return 0;
+    }
+    data_type_s = argv[1];
+    ctl_s = argv[2];
+    cmp = argv[3];
+    thr_s = argv[4];
+    if ( sscanf(thr_s, "%lf", &thr) != 1 ) {
+	fprintf(stderr, "%s: expected float value for threshold, got %s\n",
+		argv0, thr_s);
+	return 0;
+    }
+    sig_stat = Sigmet_Vol_Fld_Mask(vol_p, data_type_s, ctl_s, cmp, thr);
+    if ( sig_stat != SIGMET_OK ) {
+	fprintf(stderr, "%s: could not mask %s with %s\n%s\n",
+		argv0, data_type_s, ctl_s, sigmet_err(sig_stat));
+	return 0;
+    }
+    return 1;
+}
+
+/*
+   Remove isolated gates and small clusters of gates from a field.
+ */
+
+static int despeckle_cb(int argc, char *argv[])
+{
+    char *argv0 = argv[0];
+    enum SigmetStatus sig_stat;		/* Return from a Sigmet function */
+    char *data_type_s;			/* Data type abbreviation */
+    int d_bin = 1, d_ray = 1;		/* Half width of window */
+    int min_count = 2;			/* Gates with data needed in window */
+    int *i_p;
+    int a;
+
+    if ( argc < 2 || argc > 8 ) {
+	fprintf(stderr, "Usage: %s data_type [-b bins] [-r rays] [-n count]\n",
+		argv0);
+	return 0;
+    }
+    data_type_s = argv[1];
+    for (a = 2; a < argc; a++) {
+	if ( strcmp(argv[a], "-b") == 0 ) {
+	    i_p = &d_bin;
+	} else if ( strcmp(argv[a], "-r") == 0 ) {
+	    i_p = &d_ray;
+	} else if ( strcmp(argv[a], "-n") == 0 ) {
+	    i_p = &min_count;
+	} else {
+	    fprintf(stderr, "%s: unknown option %s.\n", argv0, argv[a]);
+	    return 0;
+	}
+	if ( ++a == argc || sscanf(argv[a], "%d", i_p) != 1 ) {
+	    fprintf(stderr, "%s: expected integer for %s option.\n",
+		    argv0, argv[a - 1]);
+	    return 0;
+	}
+    }
+    sig_stat = Sigmet_Vol_Fld_Despeckle(vol_p, data_type_s, d_bin, d_ray,
+	    min_count);
+    if ( sig_stat != SIGMET_OK ) {
+	fprintf(stderr, "%s: could not despeckle %s\n%s\n",
+		argv0, data_type_s, sigmet_err(sig_stat));
+	return 0;
+    }
+    return 1;
+}
+
+static int boxcar_cb(int argc, char *argv[])
+{
+    return filter(argc, argv, SIGMET_BOXCAR);
+}
+
+static int median_cb(int argc, char *argv[])
+{
+    return filter(argc, argv, SIGMET_MEDIAN);
+}
+
+/*
+   Run filter on the field named in argv. Options give the window size and
+   the output field.
+ */
+
+static int filter(int argc, char *argv[], enum Sigmet_FldFilter filter)
+{
+    char *argv0 = argv[0];
+    enum SigmetStatus sig_stat;		/* Return from a Sigmet function */
+    char *data_type_s;			/* Data type abbreviation */
+    char *out_s = NULL;			/* Output data type, if not in place */
+    int d_bin = 1, d_ray = 0;		/* Half width of window */
+    int *i_p;
+    int a;
+
+    if ( argc < 2 || argc > 8 ) {
+	fprintf(stderr, "Usage: %s data_type [-b bins] [-r rays] "
+		"[-o data_type]\n", argv0);
+	return 0;
+    }
+    data_type_s = argv[1];
+    for (a = 2; a < argc; a++) {
+	if ( strcmp(argv[a], "-o") == 0 ) {
+	    if ( ++a == argc ) {
+		fprintf(stderr, "%s: expected data type for -o option.\n",
+			argv0);
+		return 0;
+	    }
+	    out_s = argv[a];
+	    continue;
+	} else if ( strcmp(argv[a], "-b") == 0 ) {
+	    i_p = &d_bin;
+	} else if ( strcmp(argv[a], "-r") == 0 ) {
+	    i_p = &d_ray;
+	} else {
+	    fprintf(stderr, "%s: unknown option %s.\n", argv0, argv[a]);
+	    return 0;
+	}
+	if ( ++a == argc || sscanf(argv[a], "%d", i_p) != 1 ) {
+	    fprintf(stderr, "%s: expected integer for %s option.\n",
+		    argv0, argv[a - 1]);
+	    return 0;
+	}
+    }
+    sig_stat = Sigmet_Vol_Fld_Filter(vol_p, data_type_s, out_s, filter,
+	    d_bin, d_ray);
+    if ( sig_stat != SIGMET_OK ) {
+	fprintf(stderr, "%s: could not filter %s\n%s\n",
+		argv0, data_type_s, sigmet_err(sig_stat));
+	return 0;
+    }
+    return 1;
+}
+
+/*
+   Unfold velocities from the field named in argv[1] into a new float field
+   named in argv[2].
+ */
+
+static int dealias_cb(int argc, char *argv[])
+{
+    char *argv0 = argv[0];
+    enum SigmetStatus sig_stat;		/* Return from a Sigmet function */
+    char *data_type_s;			/* Velocity data type */
+    char *out_s;			/* Data type for unfolded velocity */
+
+    if ( argc != 3 ) {
+	fprintf(stderr, "Usage: %s data_type new_data_type\n", argv0);
+	return 0;
+    }
+    data_type_s = argv[1];
+    out_s = argv[2];
+    sig_stat = Sigmet_Vol_NewField(vol_p, out_s, "Dealiased velocity", "m/s");
+    if ( sig_stat != SIGMET_OK ) {
+	fprintf(stderr, "%s: could not add data type %s to volume\n%s\n",
+		argv0, out_s, sigmet_err(sig_stat));
+	return 0;
+    }
+    sig_stat = Sigmet_Vol_Fld_Dealias(vol_p, data_type_s, out_s);
+    if ( sig_stat != SIGMET_OK ) {
+	fprintf(stderr, "%s: could not dealias %s\n%s\n",
+		argv0, data_type_s, sigmet_err(sig_stat));
+	Sigmet_Vol_DelField(vol_p, out_s);
+	return 0;
+    }
+    return 1;
+}
+
 static int incr_time_cb(int argc, char *argv[])
 {
     char *argv0 = argv[0];
@@ -1006,7 +1523,7 @@ static int incr_time_cb(int argc, char *argv[])
 		argv0, dt_s);
 	return 0;
     }
-    if ( (sig_stat = Sigmet_Vol_IncrTm(&vol, dt / 86400.0)) != SIGMET_OK ) {
+    if ( (sig_stat = Sigmet_Vol_IncrTm(vol_p, dt / 86400.0)) != SIGMET_OK ) {
 	fprintf(stderr, "%s: could not increment time in volume\n%s\n",
 		argv0, sigmet_err(sig_stat));
 	return 0;
@@ -1063,20 +1580,20 @@ static int data_cb(int argc, char *argv[])
        Validate.
      */
 
-    num_types = Sigmet_Vol_NumTypes(&vol);
+    num_types = Sigmet_Vol_NumTypes(vol_p);
     if ( data_type_s
-	    && (y = Sigmet_Vol_GetFld(&vol, data_type_s, NULL)) == -1 ) {
+	    && (y = Sigmet_Vol_GetFld(vol_p, data_type_s, NULL)) == -1 ) {
 	fprintf(stderr, "%s: no data type named %s\n",
 		argv0, data_type_s);
 	return 0;
     }
-    num_sweeps = Sigmet_Vol_NumSweeps(&vol);
+    num_sweeps = Sigmet_Vol_NumSweeps(vol_p);
     if ( s != all && s >= num_sweeps ) {
 	fprintf(stderr, "%s: sweep index %d out of range for volume\n",
 		argv0, s);
 	return 0;
     }
-    num_rays = Sigmet_Vol_NumRays(&vol);
+    num_rays = Sigmet_Vol_NumRays(vol_p);
     if ( r != all && r >= num_rays ) {
 	fprintf(stderr, "%s: ray index %d out of range for volume\n",
 		argv0, r);
@@ -1085,12 +1602,12 @@ static int data_cb(int argc, char *argv[])
     if ( s == all ) {
 	num_bins_max = -1;
 	for (int s_ = 0; s_ < num_sweeps; s_++) {
-	    if ( Sigmet_Vol_NumBins(&vol, s_, -1) > num_bins_max ) {
-		num_bins_max = Sigmet_Vol_NumBins(&vol, s_, -1);
+	    if ( Sigmet_Vol_NumBins(vol_p, s_, -1) > num_bins_max ) {
+		num_bins_max = Sigmet_Vol_NumBins(vol_p, s_, -1);
 	    }
 	}
     } else {
-	num_bins_max = Sigmet_Vol_NumBins(&vol, s, -1);
+	num_bins_max = Sigmet_Vol_NumBins(vol_p, s, -1);
     }
     if ( b != all && b >= num_bins_max ) {
 	fprintf(stderr, "%s: bin index %d out of range for volume\n",
@@ -1105,15 +1622,15 @@ static int data_cb(int argc, char *argv[])
     if ( y == all && s == all && r == all && b == all ) {
 	for (y = 0; y < num_types; y++) {
 	    for (s = 0; s < num_sweeps; s++) {
-		Sigmet_Vol_DataTypeHdrs(&vol, y, &data_type_s, NULL, NULL);
+		Sigmet_Vol_DataTypeHdrs(vol_p, y, &data_type_s, NULL, NULL);
 		fprintf(out, "%s. sweep %d\n", data_type_s, s);
 		for (r = 0; r < num_rays; r++) {
 		    fprintf(out, "ray %d: ", r);
-		    if ( Sigmet_Vol_GoodRay(&vol, s, r) ) {
-			num_bins = Sigmet_Vol_NumBins(&vol, s, r);
+		    if ( Sigmet_Vol_GoodRay(vol_p, s, r) ) {
+			num_bins = Sigmet_Vol_NumBins(vol_p, s, r);
 			for (b = 0; b < num_bins; b++) {
 			    fprintf(out, "%f ",
-				    Sigmet_Vol_GetDatum(&vol, y, s, r, b));
+				    Sigmet_Vol_GetDatum(vol_p, y, s, r, b));
 			}
 			for ( ; b < num_bins_max; b++) {
 			    fprintf(out, "%f ", NAN);
@@ -1132,11 +1649,11 @@ static int data_cb(int argc, char *argv[])
 	    fprintf(out, "%s. sweep %d\n", data_type_s, s);
 	    for (r = 0; r < num_rays; r++) {
 		fprintf(out, "ray %d: ", r);
-		if ( Sigmet_Vol_GoodRay(&vol, s, r) ) {
-		    num_bins = Sigmet_Vol_NumBins(&vol, s, r);
+		if ( Sigmet_Vol_GoodRay(vol_p, s, r) ) {
+		    num_bins = Sigmet_Vol_NumBins(vol_p, s, r);
 		    for (b = 0; b < num_bins; b++) {
 			fprintf(out, "%f ",
-				Sigmet_Vol_GetDatum(&vol, y, s, r, b));
+				Sigmet_Vol_GetDatum(vol_p, y, s, r, b));
 		    }
 		    for ( ; b < num_bins_max; b++) {
 			fprintf(out, "%f ", NAN);
@@ -1153,10 +1670,10 @@ static int data_cb(int argc, char *argv[])
 	fprintf(out, "%s. sweep %d\n", data_type_s, s);
 	for (r = 0; r < num_rays; r++) {
 	    fprintf(out, "ray %d: ", r);
-	    if ( Sigmet_Vol_GoodRay(&vol, s, r) ) {
-		num_bins = Sigmet_Vol_NumBins(&vol, s, r);
+	    if ( Sigmet_Vol_GoodRay(vol_p, s, r) ) {
+		num_bins = Sigmet_Vol_NumBins(vol_p, s, r);
 		for (b = 0; b < num_bins; b++) {
-		    fprintf(out, "%f ", Sigmet_Vol_GetDatum(&vol, y, s, r, b));
+		    fprintf(out, "%f ", Sigmet_Vol_GetDatum(vol_p, y, s, r, b));
 		}
 		for ( ; b < num_bins_max; b++) {
 		    fprintf(out, "%f ", NAN);
@@ -1170,10 +1687,10 @@ static int data_cb(int argc, char *argv[])
 	}
     } else if ( b == all ) {
 	fprintf(out, "%s. sweep %d, ray %d: ", data_type_s, s, r);
-	if ( Sigmet_Vol_GoodRay(&vol, s, r) ) {
-	    num_bins = Sigmet_Vol_NumBins(&vol, s, r);
+	if ( Sigmet_Vol_GoodRay(vol_p, s, r) ) {
+	    num_bins = Sigmet_Vol_NumBins(vol_p, s, r);
 	    for (b = 0; b < num_bins; b++) {
-		fprintf(out, "%f ", Sigmet_Vol_GetDatum(&vol, y, s, r, b));
+		fprintf(out, "%f ", Sigmet_Vol_GetDatum(vol_p, y, s, r, b));
 	    }
 	    for ( ; b < num_bins_max; b++) {
 		fprintf(out, "%f ", NAN);
@@ -1185,10 +1702,10 @@ static int data_cb(int argc, char *argv[])
 	}
 	fprintf(out, "\n");
     } else {
-	if ( Sigmet_Vol_GoodRay(&vol, s, r) ) {
+	if ( Sigmet_Vol_GoodRay(vol_p, s, r) ) {
 	    fprintf(out, "%s. sweep %d, ray %d, bin %d: ",
 		    data_type_s, s, r, b);
-	    fprintf(out, "%f ", Sigmet_Vol_GetDatum(&vol, y, s, r, b));
+	    fprintf(out, "%f ", Sigmet_Vol_GetDatum(vol_p, y, s, r, b));
 	    fprintf(out, "\n");
 	}
     }
@@ -1214,17 +1731,17 @@ static int bdata_cb(int argc, char *argv[])
 		argv0, argv[2]);
 	return 0;
     }
-    if ( (y = Sigmet_Vol_GetFld(&vol, data_type_s, NULL)) == -1 ) {
+    if ( (y = Sigmet_Vol_GetFld(vol_p, data_type_s, NULL)) == -1 ) {
 	fprintf(stderr, "%s: no data type named %s\n", argv0, data_type_s);
 	return 0;
     }
-    num_sweeps = Sigmet_Vol_NumSweeps(&vol);
+    num_sweeps = Sigmet_Vol_NumSweeps(vol_p);
     if ( s >= num_sweeps ) {
 	fprintf(stderr, "%s: sweep index %d out of range for volume\n",
 		argv0, s);
 	return 0;
     }
-    num_bins = Sigmet_Vol_NumBins(&vol, s, -1);
+    num_bins = Sigmet_Vol_NumBins(vol_p, s, -1);
     if ( num_bins == -1 ) {
 	fprintf(stderr, "%s: could not get number of bins for sweep %d\n",
 		argv0, s);
@@ -1234,13 +1751,13 @@ static int bdata_cb(int argc, char *argv[])
 	fprintf(stderr, "Could not allocate output buffer for ray.\n");
 	return 0;
     }
-    for (r = 0; r < Sigmet_Vol_NumRays(&vol); r++) {
-	num_bins = Sigmet_Vol_NumBins(&vol, s, r);
+    for (r = 0; r < Sigmet_Vol_NumRays(vol_p); r++) {
+	num_bins = Sigmet_Vol_NumBins(vol_p, s, r);
 	for (b = 0; b < num_bins; b++) {
 	    ray_p[b] = NAN;
 	}
-	if ( Sigmet_Vol_GoodRay(&vol, s, r) ) {
-	    sig_stat = Sigmet_Vol_GetRayDat(&vol, y, s, r, &ray_p);
+	if ( Sigmet_Vol_GoodRay(vol_p, s, r) ) {
+	    sig_stat = Sigmet_Vol_GetRayDat(vol_p, y, s, r, &ray_p);
 	    if ( sig_stat != SIGMET_OK ) {
 		fprintf(stderr, "%s: could not get ray data "
 			"for data type %s, sweep index %d, ray %d.\n%s\n",
@@ -1288,36 +1805,37 @@ static int bin_outline_cb(int argc, char *argv[])
 		argv0, b_s);
 	return 0;
     }
-    if ( s >= Sigmet_Vol_NumSweeps(&vol) ) {
+    if ( s >= Sigmet_Vol_NumSweeps(vol_p) ) {
 	fprintf(stderr, "%s: sweep index %d out of range for volume\n",
 		argv0, s);
 	return 0;
     }
-    if ( r >= Sigmet_Vol_NumRays(&vol) ) {
+    if ( r >= Sigmet_Vol_NumRays(vol_p) ) {
 	fprintf(stderr, "%s: ray index %d out of range for volume\n",
 		argv0, r);
 	return 0;
     }
-    if ( b >= Sigmet_Vol_NumBins(&vol, s, r) ) {
+    if ( b >= Sigmet_Vol_NumBins(vol_p, s, r) ) {
 	fprintf(stderr, "%s: bin index %d out of range for volume\n",
 		argv0, b);
 	return 0;
     }
-    if ( Sigmet_Vol_IsPPI(&vol) ) {
+    if ( Sigmet_Vol_IsPPI(vol_p) ) {
 	if ( !set_proj() ) {
 	    fprintf(stderr, "%s: could not set geographic projection.\n",
 		    argv0);
 	    return 0;
 	}
-	sig_stat = Sigmet_Vol_PPI_BinOutl(&vol, s, r, b, lonlat_to_xy, cnr);
+	sig_stat = Sigmet_Vol_PPI_BinOutl(vol_p, s, r, b, lonlat_to_xy, &proj,
+		cnr);
 	if ( sig_stat != SIGMET_OK ) {
 	    fprintf(stderr, "%s: could not compute bin outlines for bin "
 		    "%d %d %d in volume\n%s\n", argv0, s, r, b,
 		    sigmet_err(sig_stat));
 	    return 0;
 	}
-    } else if ( Sigmet_Vol_IsRHI(&vol) ) {
-	sig_stat = Sigmet_Vol_RHI_BinOutl(&vol, s, r, b, cnr);
+    } else if ( Sigmet_Vol_IsRHI(vol_p) ) {
+	sig_stat = Sigmet_Vol_RHI_BinOutl(vol_p, s, r, b, cnr);
 	if ( sig_stat != SIGMET_OK ) {
 	    fprintf(stderr, "%s: could not compute bin outlines for bin "
 		    "%d %d %d in volume\n%s\n", argv0, s, r, b,
@@ -1350,21 +1868,21 @@ static int sweep_bnds_cb(int argc, char *argv[])
 	fprintf(stderr, "%s: expected integer for sweep index, got %s.\n",
 		argv0, sweep_s);
     }
-    if ( Sigmet_Vol_IsPPI(&vol) ) {
+    if ( Sigmet_Vol_IsPPI(vol_p) ) {
 	if ( !set_proj() ) {
 	    fprintf(stderr, "%s: could not set geographic projection.\n",
 		    argv0);
 	    return 0;
 	}
-	if ( Sigmet_Vol_PPI_Bnds(&vol, s, lonlat_to_xy,
+	if ( Sigmet_Vol_PPI_Bnds(vol_p, s, lonlat_to_xy, &proj,
 		    &x_min, &x_max, &y_min, &y_max) != SIGMET_OK ) {
 	    fprintf(stderr, "%s: could not compute PPI boundaries.\n",
 		    argv0);
 	    return 0;
 	}
-    } else if ( Sigmet_Vol_IsRHI(&vol) ) {
+    } else if ( Sigmet_Vol_IsRHI(vol_p) ) {
 	x_min = y_min = 0.0;
-	if ( Sigmet_Vol_RHI_Bnds(&vol, s, &x_max, &y_max) != SIGMET_OK ) {
+	if ( Sigmet_Vol_RHI_Bnds(vol_p, s, &x_max, &y_max) != SIGMET_OK ) {
 	    fprintf(stderr, "%s: could not compute PPI boundaries.\n",
 		    argv0);
 	    return 0;
@@ -1382,7 +1900,7 @@ static int radar_lon_cb(int argc, char *argv[])
     double lon;				/* New longitude, degrees */
 
     if ( argc == 1 ) {
-	fprintf(out, "%lf\n", Sigmet_Vol_RadarLon(&vol, NULL) * DEG_PER_RAD);
+	fprintf(out, "%lf\n", Sigmet_Vol_RadarLon(vol_p, NULL) * DEG_PER_RAD);
 	return 1;
     } else if ( argc == 2 ) {
 	lon_s = argv[1];
@@ -1392,7 +1910,7 @@ static int radar_lon_cb(int argc, char *argv[])
 	    return 0;
 	}
 	lon = GeogLonR(lon * RAD_PER_DEG, M_PI);
-	fprintf(out, "%lf\n", Sigmet_Vol_RadarLon(&vol, &lon) * DEG_PER_RAD);
+	fprintf(out, "%lf\n", Sigmet_Vol_RadarLon(vol_p, &lon) * DEG_PER_RAD);
 	return 1;
     } else {
 	fprintf(stderr, "Usage: %s new_lon\n", argv0);
@@ -1407,7 +1925,7 @@ static int radar_lat_cb(int argc, char *argv[])
     double lat;				/* New latitude, degrees */
 
     if ( argc == 1 ) {
-	fprintf(out, "%lf\n", Sigmet_Vol_RadarLat(&vol, NULL) * DEG_PER_RAD);
+	fprintf(out, "%lf\n", Sigmet_Vol_RadarLat(vol_p, NULL) * DEG_PER_RAD);
 	return 1;
     } else if ( argc == 2 ) {
 	lat_s = argv[1];
@@ -1417,7 +1935,7 @@ static int radar_lat_cb(int argc, char *argv[])
 	    return 0;
 	}
 	lat = GeogLatN(lat * RAD_PER_DEG);
-	fprintf(out, "%lf\n", Sigmet_Vol_RadarLat(&vol, &lat) * DEG_PER_RAD);
+	fprintf(out, "%lf\n", Sigmet_Vol_RadarLat(vol_p, &lat) * DEG_PER_RAD);
 	return 1;
     } else {
 	fprintf(stderr, "Usage: %s new_lat\n", argv0);
@@ -1443,7 +1961,7 @@ static int shift_az_cb(int argc, char *argv[])
 	return 0;
     }
     daz = GeogLonR(daz * RAD_PER_DEG, M_PI);
-    if ( (sig_stat = Sigmet_Vol_ShiftAz(&vol, daz)) != SIGMET_OK ) {
+    if ( (sig_stat = Sigmet_Vol_ShiftAz(vol_p, daz)) != SIGMET_OK ) {
 	fprintf(stderr, "%s: failed to shift azimuths.\n%s\n",
 		argv0, sigmet_err(sig_stat));
 	return 0;
@@ -1573,20 +2091,20 @@ static int outlines_cb(int argc, char *argv[])
        Get sweep data and ray geometry.
      */
 
-    num_rays = Sigmet_Vol_NumRays(&vol);
-    num_bins = Sigmet_Vol_NumBins(&vol, s, -1);
+    num_rays = Sigmet_Vol_NumRays(vol_p);
+    num_bins = Sigmet_Vol_NumBins(vol_p, s, -1);
     if ( num_rays == -1 || num_bins == -1 ) {
 	fprintf(stderr, "%s: could not get sweep geometry %d\n", argv0, s);
 	goto error;
     }
-    ppi = Sigmet_Vol_IsPPI(&vol);
+    ppi = Sigmet_Vol_IsPPI(vol_p);
     if ( ppi && !set_proj() ) {
 	fprintf(stderr, "%s: could not set geographic projection.\n", argv0);
 	goto error;
     }
-    lon_r = Sigmet_Vol_RadarLon(&vol, NULL);
-    lat_r = Sigmet_Vol_RadarLat(&vol, NULL);
-    if ( (y = Sigmet_Vol_GetFld(&vol, data_type_s, NULL)) == -1 ) {
+    lon_r = Sigmet_Vol_RadarLon(vol_p, NULL);
+    lat_r = Sigmet_Vol_RadarLat(vol_p, NULL);
+    if ( (y = Sigmet_Vol_GetFld(vol_p, data_type_s, NULL)) == -1 ) {
 	fprintf(stderr, "%s: volume has no data type named %s\n",
 		argv0, data_type_s);
 	goto error;
@@ -1600,7 +2118,7 @@ static int outlines_cb(int argc, char *argv[])
     az1 = az0 + num_rays;
     tilt0 = az1 + num_rays;
     tilt1 = tilt0 + num_rays;
-    sig_stat = Sigmet_Vol_RayGeom(&vol, s, &r00, &dr, az0, az1, tilt0, tilt1,
+    sig_stat = Sigmet_Vol_RayGeom(vol_p, s, &r00, &dr, az0, az1, tilt0, tilt1,
 	    fill);
     if ( sig_stat != SIGMET_OK ) {
 	fprintf(stderr, "%s: could not get ray geometry.\n%s\n",
@@ -1616,7 +2134,7 @@ static int outlines_cb(int argc, char *argv[])
 	for (b = 0; b < num_bins; b++) {
 	    d_p[b] = NAN;
 	}
-	if ( Sigmet_Vol_GetRayDat(&vol, y, s, r, &d_p) ) {
+	if ( Sigmet_Vol_GetRayDat(vol_p, y, s, r, &d_p) ) {
 	    fprintf(stderr, "%s: could not get data for ray %d.\n",
 		    argv0, r);
 	    goto error;
@@ -1660,13 +2178,13 @@ static int outlines_cb(int argc, char *argv[])
 		    r0_g = atan(r0 * cos(tilt) / (re + r0 * sin(tilt)));
 		    r1_g = atan(r1 * cos(tilt) / (re + r1 * sin(tilt)));
 		    GeogStep(lon_r, lat_r, a0, r0_g, &lon, &lat);
-		    lonlat_to_xy(lon, lat, cnr + 0, cnr + 1);
+		    lonlat_to_xy(lon, lat, cnr + 0, cnr + 1, &proj);
 		    GeogStep(lon_r, lat_r, a0, r1_g, &lon, &lat);
-		    lonlat_to_xy(lon, lat, cnr + 2, cnr + 3);
+		    lonlat_to_xy(lon, lat, cnr + 2, cnr + 3, &proj);
 		    GeogStep(lon_r, lat_r, a1, r1_g, &lon, &lat);
-		    lonlat_to_xy(lon, lat, cnr + 4, cnr + 5);
+		    lonlat_to_xy(lon, lat, cnr + 4, cnr + 5, &proj);
 		    GeogStep(lon_r, lat_r, a1, r0_g, &lon, &lat);
-		    lonlat_to_xy(lon, lat, cnr + 6, cnr + 7);
+		    lonlat_to_xy(lon, lat, cnr + 6, cnr + 7, &proj);
 
 		} else {
 		    tl0 = tilt0[r];
@@ -1747,7 +2265,7 @@ static int dorade_cb(int argc, char *argv[])
 	fprintf(stderr, "Usage: %s [s]\n", argv0);
 	return 0;
     }
-    num_sweeps = Sigmet_Vol_NumSweeps(&vol);
+    num_sweeps = Sigmet_Vol_NumSweeps(vol_p);
     if ( s >= num_sweeps ) {
 	fprintf(stderr, "%s: sweep index %d out of range for volume\n",
 		argv0, s);
@@ -1756,7 +2274,7 @@ static int dorade_cb(int argc, char *argv[])
     if ( s == all ) {
 	for (s = 0; s < num_sweeps; s++) {
 	    Dorade_Sweep_Init(&swp);
-	    if ( (sig_stat = Sigmet_Vol_ToDorade(&vol, s, &swp)) != SIGMET_OK ) {
+	    if ( (sig_stat = Sigmet_Vol_ToDorade(vol_p, s, &swp)) != SIGMET_OK ) {
 		fprintf(stderr, "%s: could not translate sweep %d of volume "
 			"to DORADE format\n%s\n", argv0, s,
 			sigmet_err(sig_stat));
@@ -1771,7 +2289,7 @@ static int dorade_cb(int argc, char *argv[])
 	}
     } else {
 	Dorade_Sweep_Init(&swp);
-	if ( (sig_stat = Sigmet_Vol_ToDorade(&vol, s, &swp)) != SIGMET_OK ) {
+	if ( (sig_stat = Sigmet_Vol_ToDorade(vol_p, s, &swp)) != SIGMET_OK ) {
 	    fprintf(stderr, "%s: could not translate sweep %d of volume to "
 		    "DORADE format\n%s\n", argv0, s,
 		    sigmet_err(sig_stat));
@@ -1792,6 +2310,220 @@ error:
     return 0;
 }
 
+/*
+   Select a volume from the pool, loading it if necessary. If given a
+   command, run it on the volume. With no arguments, print the size and
+   path of each volume in the pool, most recently used first. With -d,
+   free the volume.
+ */
+
+static int volume_cb(int argc, char *argv[])
+{
+    char *argv0 = argv[0];
+    struct pool_vol *pv;
+    callback *cb;
+    int status;
+
+    if ( !pool_budget ) {
+	fprintf(stderr, "%s: no volume pool. Start sigmet_raw with -m.\n",
+		argv0);
+	return 0;
+    }
+    if ( argc == 1 ) {
+	for (pv = pool_head; pv; pv = pv->next) {
+	    fprintf(out, "%lu %s\n",
+		    (unsigned long)Sigmet_Vol_MemSz(&pv->vol), pv->vol_fl_nm);
+	}
+	return 1;
+    }
+    if ( strcmp(argv[1], "-d") == 0 ) {
+	if ( argc != 3 ) {
+	    fprintf(stderr, "Usage: %s -d raw_product_file\n", argv0);
+	    return 0;
+	}
+	if ( !(pv = pool_find(argv[2])) ) {
+	    fprintf(stderr, "%s: %s is not in the pool.\n", argv0, argv[2]);
+	    return 0;
+	}
+	pool_rm(pv);
+	return 1;
+    }
+    if ( !(pv = pool_get(argv[1])) ) {
+	fprintf(stderr, "%s: could not load volume %s.\n", argv0, argv[1]);
+	return 0;
+    }
+    vol_p = &pv->vol;
+    if ( argc == 2 ) {
+	pool_trim();
+	return 1;
+    }
+    if ( !(cb = cmd_cb(argv[2])) || cb == volume_cb ) {
+	fprintf(stderr, "%s: %s is not a command for a volume.\n",
+		argv0, argv[2]);
+	pool_trim();
+	return 0;
+    }
+    status = cb(argc - 2, argv + 2);
+    pool_trim();
+    return status;
+}
+
+/*
+   Return the pool volume for raw product file vol_fl_nm, or NULL if it is
+   not in the pool.
+ */
+
+static struct pool_vol *pool_find(char *vol_fl_nm)
+{
+    struct pool_vol *pv;
+
+    for (pv = pool_head; pv; pv = pv->next) {
+	if ( strcmp(pv->vol_fl_nm, vol_fl_nm) == 0 ) {
+	    return pv;
+	}
+    }
+    return NULL;
+}
+
+/*
+   Return the pool volume for raw product file vol_fl_nm, moved to the head
+   of the pool. Load the volume if it is not in the pool, or if the file has
+   changed since it was loaded. The file has changed if its device, inode,
+   modification time in nanoseconds, or size differ. Return NULL on
+   failure.
+ */
+
+static struct pool_vol *pool_get(char *vol_fl_nm)
+{
+    struct stat buf;			/* Information about vol_fl_nm */
+    struct pool_vol *pv;
+    struct Sigmet_Vol_In vol_in;	/* Input stream for vol_fl_nm */
+    enum SigmetStatus sig_stat, unz_stat;
+
+    if ( stat(vol_fl_nm, &buf) == -1 ) {
+	fprintf(stderr, "%d: could not get information about %s.\n%s\n",
+		getpid(), vol_fl_nm, strerror(errno));
+	return NULL;
+    }
+    pv = pool_find(vol_fl_nm);
+    if ( pv && (pv->dev != buf.st_dev || pv->ino != buf.st_ino
+		|| pv->mtim.tv_sec != buf.st_mtim.tv_sec
+		|| pv->mtim.tv_nsec != buf.st_mtim.tv_nsec
+		|| pv->fl_sz != buf.st_size) ) {
+	if ( pv->vol.mod ) {
+	    fprintf(stderr, "%d: warning: %s has changed. Reloading it and "
+		    "discarding changes to the volume.\n", getpid(),
+		    vol_fl_nm);
+	}
+	pool_rm(pv);
+	pv = NULL;
+    }
+    if ( pv ) {
+	if ( pv != pool_head ) {
+	    pv->prev->next = pv->next;
+	    if ( pv->next ) {
+		pv->next->prev = pv->prev;
+	    }
+	    pv->prev = NULL;
+	    pv->next = pool_head;
+	    pool_head->prev = pv;
+	    pool_head = pv;
+	}
+	return pv;
+    }
+
+    /*
+       Load the volume.
+     */
+
+    if ( !(pv = CALLOC(1, sizeof(struct pool_vol)))
+	    || !(pv->vol_fl_nm = MALLOC(strlen(vol_fl_nm) + 1)) ) {
+	fprintf(stderr, "%d: could not allocate pool entry for %s.\n",
+		getpid(), vol_fl_nm);
+	FREE(pv);
+	return NULL;
+    }
+    strcpy(pv->vol_fl_nm, vol_fl_nm);
+    pv->dev = buf.st_dev;
+    pv->ino = buf.st_ino;
+    pv->mtim = buf.st_mtim;
+    pv->fl_sz = buf.st_size;
+    Sigmet_Vol_Init(&pv->vol);
+    if ( (sig_stat = Sigmet_Vol_Open(vol_fl_nm, &vol_in)) != SIGMET_OK ) {
+	fprintf(stderr, "%d: could not open file %s for reading.\n%s\n",
+		getpid(), vol_fl_nm, sigmet_err(sig_stat));
+	goto error;
+    }
+    sig_stat = Sigmet_Vol_ReadIdx(vol_in.f, &pv->vol, &pool_filter);
+    if ( (unz_stat = Sigmet_Vol_Close(&vol_in)) != SIGMET_OK ) {
+	fprintf(stderr, "%d: warning: could not decompress all of %s.\n%s\n",
+		getpid(), vol_fl_nm, sigmet_err(unz_stat));
+    }
+    if ( sig_stat != SIGMET_OK ) {
+	fprintf(stderr, "%d: could not read volume %s.\n%s\n",
+		getpid(), vol_fl_nm, sigmet_err(sig_stat));
+	goto error;
+    }
+    pv->next = pool_head;
+    if ( pool_head ) {
+	pool_head->prev = pv;
+    }
+    pool_head = pv;
+    return pv;
+
+error:
+    Sigmet_Vol_Free(&pv->vol);
+    FREE(pv->vol_fl_nm);
+    FREE(pv);
+    return NULL;
+}
+
+/*
+   Free least recently used volumes, other than the current one and
+   modified ones, until the pool fits in its budget. Modified volumes have
+   data that cannot be read again from their files.
+ */
+
+static void pool_trim(void)
+{
+    struct pool_vol *pv, *tail, *prev;
+    size_t sz;				/* Total size of pool volumes */
+
+    for (sz = 0, tail = NULL, pv = pool_head; pv; pv = pv->next) {
+	sz += Sigmet_Vol_MemSz(&pv->vol);
+	tail = pv;
+    }
+    for (pv = tail; pv && sz > pool_budget; pv = prev) {
+	prev = pv->prev;
+	if ( &pv->vol != vol_p && !pv->vol.mod ) {
+	    sz -= Sigmet_Vol_MemSz(&pv->vol);
+	    pool_rm(pv);
+	}
+    }
+}
+
+/*
+   Remove pv from the pool and free it.
+ */
+
+static void pool_rm(struct pool_vol *pv)
+{
+    if ( pv->prev ) {
+	pv->prev->next = pv->next;
+    } else {
+	pool_head = pv->next;
+    }
+    if ( pv->next ) {
+	pv->next->prev = pv->prev;
+    }
+    if ( vol_p == &pv->vol ) {
+	vol_p = &vol;
+    }
+    Sigmet_Vol_Free(&pv->vol);
+    FREE(pv->vol_fl_nm);
+    FREE(pv);
+}
+
 /*
    Set geographic projection from string. String can be taken from environment
    variable. Otherwise a default is used. String should be intelligible to
@@ -1807,7 +2539,7 @@ static int set_proj(void)
     if ( (proj_s = getenv(SIGMET_GEOG_PROJ)) ) {
 	/* Set projection from environment variable */
 
-	if ( !Sigmet_Proj_Set(proj_s) ) {
+	if ( !Sigmet_Proj_Set(&proj, proj_s) ) {
 	    fprintf(stderr, "Could not set projection from "
 		    SIGMET_GEOG_PROJ " environment variable.\n");
 	    return 0;
@@ -1815,11 +2547,11 @@ static int set_proj(void)
     } else {
 	/* Set default projection */
 
-	lon = DEG_PER_RAD * Sigmet_Vol_RadarLon(&vol, NULL);
-	lat = DEG_PER_RAD * Sigmet_Vol_RadarLat(&vol, NULL);
+	lon = DEG_PER_RAD * Sigmet_Vol_RadarLon(vol_p, NULL);
+	lat = DEG_PER_RAD * Sigmet_Vol_RadarLat(vol_p, NULL);
 	if ( snprintf(dflt_proj_s, LEN,
 		    "CylEqDist %.9g %.9g", lon, lat) > LEN
-		|| !Sigmet_Proj_Set(dflt_proj_s) ) {
+		|| !Sigmet_Proj_Set(&proj, dflt_proj_s) ) {
 	    fprintf(stderr, "Could not set default projection.\n");
 	    return 0;
 	}
@@ -1884,108 +2616,55 @@ static double msec(double tm)
 }
 
 /*
-   Open volume file vol_nm.  If vol_nm suffix indicates a compressed file, open
-   a pipe to a decompression process.  Return a file handle to the file or
-   decompression process, or NULL if failure. If return value is output from a
-   decompression process, put the process id at pid_p. Set *pid_p to -1 if
-   there is no decompression process (i.e. vol_nm is a plain file).
+   Set filt_p to load only the data types named in comma separated list
+   types_s. Return 1 on success. If something goes wrong, print an error
+   message and return 0.
  */
 
-static FILE *vol_open(const char *vol_nm, pid_t *pid_p)
+static int filter_types(char *types_s, struct Sigmet_Vol_Filter *filt_p)
 {
-    FILE *in = NULL;		/* Return value */
-    char *sfx;			/* Filename suffix */
-    int pfd[2] = {-1};		/* Pipe for data */
-    pid_t ch_pid = -1;		/* Child process id */
-
-    *pid_p = -1;
-    if ( strcmp(vol_nm, "-") == 0 ) {
-	return stdin;
-    }
-    sfx = strrchr(vol_nm, '.');
-    if ( sfx && sfx == vol_nm + strlen(vol_nm) - strlen(".gz")
-	    && strcmp(sfx, ".gz") == 0 ) {
-	if ( pipe(pfd) == -1 ) {
-	    fprintf(stderr, "Could not create pipe for gzip\n%s\n",
-		    strerror(errno));
-	    goto error;
-	}
-	ch_pid = fork();
-	switch (ch_pid) {
-	    case -1:
-		fprintf(stderr, "Could not spawn gzip\n");
-		goto error;
-	    case 0: /* Child process - gzip */
-		if ( dup2(pfd[1], STDOUT_FILENO) == -1 || close(pfd[1]) == -1
-			|| close(pfd[0]) == -1 ) {
-		    fprintf(stderr, "gzip process failed\n%s\n",
-			    strerror(errno));
-		    _exit(EXIT_FAILURE);
-		}
-		execlp("gunzip", "gunzip", "-c", vol_nm, (char *)NULL);
-		_exit(EXIT_FAILURE);
-	    default: /* This process.  Read output from gzip. */
-		if ( close(pfd[1]) == -1 || !(in = fdopen(pfd[0], "r"))) {
-		    fprintf(stderr, "Could not read gzip process\n%s\n",
-			    strerror(errno));
-		    goto error;
-		} else {
-		    *pid_p = ch_pid;
-		    return in;
-		}
-	}
-    } else if ( sfx && sfx == vol_nm + strlen(vol_nm) - strlen(".bz2")
-	    && strcmp(sfx, ".bz2") == 0 ) {
-	if ( pipe(pfd) == -1 ) {
-	    fprintf(stderr, "Could not create pipe for bzip2\n%s\n",
-		    strerror(errno));
-	    goto error;
-	}
-	ch_pid = fork();
-	switch (ch_pid) {
-	    case -1:
-		fprintf(stderr, "Could not spawn bzip2\n");
-		goto error;
-	    case 0: /* Child process - bzip2 */
-		if ( dup2(pfd[1], STDOUT_FILENO) == -1 || close(pfd[1]) == -1
-			|| close(pfd[0]) == -1 ) {
-		    fprintf(stderr, "could not set up bzip2 process");
-		    _exit(EXIT_FAILURE);
-		}
-		execlp("bunzip2", "bunzip2", "-c", vol_nm, (char *)NULL);
-		_exit(EXIT_FAILURE);
-	    default: /* This process.  Read output from bzip2. */
-		if ( close(pfd[1]) == -1 || !(in = fdopen(pfd[0], "r"))) {
-		    fprintf(stderr, "Could not read bzip2 process\n%s\n",
-			    strerror(errno));
-		    goto error;
-		} else {
-		    *pid_p = ch_pid;
-		    return in;
-		}
-	}
-    } else if ( !(in = fopen(vol_nm, "r")) ) {
-	fprintf(stderr, "Could not open %s\n%s\n", vol_nm, strerror(errno));
-	return NULL;
-    }
-    return in;
+    char *data_type_s;
+    enum Sigmet_DataTypeN sig_type;
 
-error:
-    if ( ch_pid != -1 ) {
-	kill(ch_pid, SIGTERM);
-	ch_pid = -1;
+    for (sig_type = 0; sig_type < SIGMET_NTYPES; sig_type++) {
+	filt_p->types[sig_type] = 0;
     }
-    if ( in ) {
-	fclose(in);
-	pfd[0] = -1;
+    for (data_type_s = strtok(types_s, ",");
+	    data_type_s;
+	    data_type_s = strtok(NULL, ",")) {
+	if ( !Sigmet_DataType_GetN(data_type_s, &sig_type) ) {
+	    fprintf(stderr, "%d: %s is not a Sigmet data type.\n",
+		    getpid(), data_type_s);
+	    return 0;
+	}
+	filt_p->types[sig_type] = 1;
     }
-    if ( pfd[0] != -1 ) {
-	close(pfd[0]);
+    return 1;
+}
+
+/*
+   Set filt_p to load only the sweeps with indeces in comma separated list
+   sweeps_s. Return 1 on success. If something goes wrong, print an error
+   message and return 0.
+ */
+
+static int filter_sweeps(char *sweeps_s, struct Sigmet_Vol_Filter *filt_p)
+{
+    char *s_s;
+    int s;
+
+    for (s = 0; s < SIGMET_MAX_SWEEPS; s++) {
+	filt_p->sweeps[s] = 0;
     }
-    if ( pfd[1] != -1 ) {
-	close(pfd[1]);
+    for (s_s = strtok(sweeps_s, ","); s_s; s_s = strtok(NULL, ",")) {
+	if ( sscanf(s_s, "%d", &s) != 1 || s < 0 || s >= SIGMET_MAX_SWEEPS ) {
+	    fprintf(stderr, "%d: expected sweep index from 0 to %d, got %s.\n",
+		    getpid(), SIGMET_MAX_SWEEPS - 1, s_s);
+	    return 0;
+	}
+	filt_p->sweeps[s] = 1;
     }
-    return NULL;
+    return 1;
 }
 
 /*
@@ -2111,9 +2790,24 @@ static void handler(int signum)
 	    status = EXIT_FAILURE;
 	    break;
     }
+    if ( shm_nm ) {
+	shm_unlink(shm_nm);
+    }
     _exit(write(STDERR_FILENO, msg, 53) == 53 ?  status : EXIT_FAILURE);
 }
 
+/*
+   Remove the shared memory volume this process published.
+ */
+
+static void shm_cleanup(void)
+{
+    if ( shm_nm ) {
+	Sigmet_Vol_ShmUnlink(shm_nm);
+	shm_nm = NULL;
+    }
+}
+
 /*
    This handler tells a deamon to exit if its child does.
  */
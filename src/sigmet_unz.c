@@ -0,0 +1,483 @@
+/*
+   -	sigmet_unz.c --
+   -		This file defines functions that open Sigmet raw
+   -		product files which might be compressed with gzip
+   -		or bzip2.
+   - 
+   .	Copyright (c) 2013 Gordon D. Carrie.  All rights reserved.
+   .	
+   .	Redistribution and use in source and binary forms, with or without
+   .	modification, are permitted provided that the following conditions
+   .	are met:
+   .	
+   .	    * Redistributions of source code must retain the above copyright
+   .	    notice, this list of conditions and the following disclaimer.
+   .
+   .	    * Redistributions in binary form must reproduce the above copyright
+   .	    notice, this list of conditions and the following disclaimer in the
+   .	    documentation and/or other materials provided with the distribution.
+   .	
+   .	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   .	"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   .	LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   .	A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   .	HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   .	SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+   .	TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   .	PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   .	LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   .	NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   .	SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+   .
+   .	Please send feedback to dev0@trekix.net
+   .
+   .	$Revision: $ $Date: $
+ */
+
+/*
+   Decompressed data reach the reader through a stream from fopencookie
+   (GNU) or funopen (BSD), which these request.
+ */
+
+#define _GNU_SOURCE
+#define _DARWIN_C_SOURCE
+
+#include "unix_defs.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <zlib.h>
+#include <bzlib.h>
+#include "alloc.h"
+#include "sigmet.h"
+
+/*
+   A decompressor reads a compressed raw product file on its own thread
+   and puts the uncompressed bytes into a ring buffer. The caller reads
+   the ring through a stream in a Sigmet_Vol_In structure, so records are
+   decoded while the rest of the file is still being decompressed. The
+   decompressor writes straight into free space in the ring, and the
+   stream copies out of it, so data never pass through the kernel.
+ */
+
+enum unz_fmt {UNZ_GZ, UNZ_BZ2};
+struct sigmet_unz {
+    enum unz_fmt fmt;			/* Compression format */
+    gzFile gz;				/* Input for UNZ_GZ */
+    FILE *bz_f;				/* Input for UNZ_BZ2 */
+    char *ring;				/* Uncompressed data, UNZ_RING_SZ
+					   bytes */
+    size_t wr, rd;			/* Bytes put into and taken from
+					   ring since start */
+    int done;				/* If true, decompressor has put all
+					   it will */
+    int closed;				/* If true, reader closed stream */
+    pthread_mutex_t mtx;		/* Protect wr, rd, done, closed */
+    pthread_cond_t cond;		/* Signal change to wr, rd, done,
+					   closed */
+    pthread_t thr;			/* Decompress into ring */
+    enum SigmetStatus status;		/* Result of decompression */
+};
+
+static int has_sfx(const char *, const char *);
+static void *unz_thr(void *);
+static enum SigmetStatus unz_gz(struct sigmet_unz *);
+static enum SigmetStatus unz_bz2(struct sigmet_unz *);
+static size_t unz_space(struct sigmet_unz *, char **);
+static void unz_put(struct sigmet_unz *, size_t);
+static size_t unz_get(struct sigmet_unz *, char *, size_t);
+static int unz_close(void *);
+#ifdef __GLIBC__
+static ssize_t unz_read(void *, char *, size_t);
+#else
+static int unz_read(void *, char *, int);
+#endif
+
+/*
+   Maximum number of bytes the decompressor produces at once. This is
+   also the size of the zlib input buffer.
+ */
+
+#define UNZ_BUF_SZ 131072
+
+/*
+   Size of ring buffer
+ */
+
+#define UNZ_RING_SZ (4 * UNZ_BUF_SZ)
+
+/*
+   Open raw product file vol_nm for reading. If vol_nm is "-", read
+   standard input. If vol_nm ends with ".gz" or ".bz2", start a thread
+   that decompresses it. Caller reads uncompressed data from in_p->f,
+   and must call Sigmet_Vol_Close when done.
+ */
+
+enum SigmetStatus Sigmet_Vol_Open(const char *vol_nm, struct Sigmet_Vol_In *in_p)
+{
+    struct sigmet_unz *unz = NULL;
+    enum unz_fmt fmt;
+    int sync = 0;			/* If true, mtx and cond exist */
+#ifdef __GLIBC__
+    cookie_io_functions_t io = {unz_read, NULL, NULL, unz_close};
+#endif
+    int e;				/* Return from pthread function */
+
+    if ( !vol_nm || !in_p ) {
+	fprintf(stderr, "%d: open function called with bogus arguments.\n",
+		getpid());
+	return SIGMET_BAD_ARG;
+    }
+    in_p->f = NULL;
+    in_p->unz = NULL;
+    if ( strcmp(vol_nm, "-") == 0 ) {
+	in_p->f = stdin;
+	return SIGMET_OK;
+    }
+    if ( has_sfx(vol_nm, ".gz") ) {
+	fmt = UNZ_GZ;
+    } else if ( has_sfx(vol_nm, ".bz2") ) {
+	fmt = UNZ_BZ2;
+    } else {
+	if ( !(in_p->f = fopen(vol_nm, "r")) ) {
+	    fprintf(stderr, "%d: could not open %s.\n%s\n",
+		    getpid(), vol_nm, strerror(errno));
+	    return SIGMET_IO_FAIL;
+	}
+	return SIGMET_OK;
+    }
+
+    if ( !(unz = CALLOC(1, sizeof(struct sigmet_unz)))
+	    || !(unz->ring = MALLOC(UNZ_RING_SZ)) ) {
+	fprintf(stderr, "%d: could not allocate decompressor for %s.\n",
+		getpid(), vol_nm);
+	FREE(unz);
+	return SIGMET_MEM_FAIL;
+    }
+    unz->fmt = fmt;
+    unz->gz = NULL;
+    unz->bz_f = NULL;
+    unz->wr = unz->rd = 0;
+    unz->done = unz->closed = 0;
+    unz->status = SIGMET_OK;
+    switch (fmt) {
+	case UNZ_GZ:
+	    if ( !(unz->gz = gzopen(vol_nm, "rb")) ) {
+		fprintf(stderr, "%d: could not open %s.\n%s\n",
+			getpid(), vol_nm, strerror(errno));
+		goto error;
+	    }
+	    gzbuffer(unz->gz, UNZ_BUF_SZ);
+	    break;
+	case UNZ_BZ2:
+	    if ( !(unz->bz_f = fopen(vol_nm, "r")) ) {
+		fprintf(stderr, "%d: could not open %s.\n%s\n",
+			getpid(), vol_nm, strerror(errno));
+		goto error;
+	    }
+	    break;
+    }
+    if ( (e = pthread_mutex_init(&unz->mtx, NULL)) != 0 ) {
+	fprintf(stderr, "%d: could not initialize mutex to decompress "
+		"%s.\n%s\n", getpid(), vol_nm, strerror(e));
+	goto error;
+    }
+    if ( (e = pthread_cond_init(&unz->cond, NULL)) != 0 ) {
+	fprintf(stderr, "%d: could not initialize condition to decompress "
+		"%s.\n%s\n", getpid(), vol_nm, strerror(e));
+	pthread_mutex_destroy(&unz->mtx);
+	goto error;
+    }
+    sync = 1;
+#ifdef __GLIBC__
+    in_p->f = fopencookie(unz, "r", io);
+#else
+    in_p->f = funopen(unz, unz_read, NULL, NULL, unz_close);
+#endif
+    if ( !in_p->f ) {
+	fprintf(stderr, "%d: could not create stream to decompress %s.\n%s\n",
+		getpid(), vol_nm, strerror(errno));
+	goto error;
+    }
+    if ( (e = pthread_create(&unz->thr, NULL, unz_thr, unz)) != 0 ) {
+	fprintf(stderr, "%d: could not start thread to decompress %s.\n%s\n",
+		getpid(), vol_nm, strerror(e));
+	goto error;
+    }
+    in_p->unz = unz;
+    return SIGMET_OK;
+
+error:
+    if ( in_p->f ) {
+	fclose(in_p->f);
+	in_p->f = NULL;
+    }
+    if ( sync ) {
+	pthread_cond_destroy(&unz->cond);
+	pthread_mutex_destroy(&unz->mtx);
+    }
+    if ( unz->gz ) {
+	gzclose(unz->gz);
+    }
+    if ( unz->bz_f ) {
+	fclose(unz->bz_f);
+    }
+    FREE(unz->ring);
+    FREE(unz);
+    return SIGMET_IO_FAIL;
+}
+
+/*
+   Close input stream in_p, which should have been opened with
+   Sigmet_Vol_Open. If a thread was decompressing the file, wait for it
+   and return its result. Stopping before the end of a compressed file is
+   not an error.
+ */
+
+enum SigmetStatus Sigmet_Vol_Close(struct Sigmet_Vol_In *in_p)
+{
+    enum SigmetStatus status = SIGMET_OK;
+
+    if ( !in_p ) {
+	return SIGMET_BAD_ARG;
+    }
+    if ( in_p->f && in_p->f != stdin ) {
+	fclose(in_p->f);
+    }
+    in_p->f = NULL;
+    if ( in_p->unz ) {
+	pthread_join(in_p->unz->thr, NULL);
+	status = in_p->unz->status;
+	pthread_cond_destroy(&in_p->unz->cond);
+	pthread_mutex_destroy(&in_p->unz->mtx);
+	FREE(in_p->unz->ring);
+	FREE(in_p->unz);
+	in_p->unz = NULL;
+    }
+    return status;
+}
+
+/*
+   Return true if string s ends with suffix sfx.
+ */
+
+static int has_sfx(const char *s, const char *sfx)
+{
+    size_t n = strlen(s), n_sfx = strlen(sfx);
+
+    return n > n_sfx && strcmp(s + n - n_sfx, sfx) == 0;
+}
+
+/*
+   Start routine for decompression thread.
+ */
+
+static void *unz_thr(void *arg)
+{
+    struct sigmet_unz *unz = (struct sigmet_unz *)arg;
+
+    switch (unz->fmt) {
+	case UNZ_GZ:
+	    unz->status = unz_gz(unz);
+	    break;
+	case UNZ_BZ2:
+	    unz->status = unz_bz2(unz);
+	    break;
+    }
+    if ( unz->gz ) {
+	gzclose(unz->gz);
+	unz->gz = NULL;
+    }
+    if ( unz->bz_f ) {
+	fclose(unz->bz_f);
+	unz->bz_f = NULL;
+    }
+    pthread_mutex_lock(&unz->mtx);
+    unz->done = 1;
+    pthread_cond_signal(&unz->cond);
+    pthread_mutex_unlock(&unz->mtx);
+    return NULL;
+}
+
+/*
+   Decompress gzip input into the ring. gzread continues through
+   concatenated gzip members.
+ */
+
+static enum SigmetStatus unz_gz(struct sigmet_unz *unz)
+{
+    char *buf;				/* Free space in ring */
+    size_t sz;				/* Size of buf */
+    int n;				/* Return from gzread */
+    int gz_err;				/* zlib error code */
+    const char *msg;			/* zlib error message */
+
+    while ( (sz = unz_space(unz, &buf)) > 0
+	    && (n = gzread(unz->gz, buf, (unsigned)sz)) > 0 ) {
+	unz_put(unz, (size_t)n);
+    }
+    if ( sz == 0 ) {
+	return SIGMET_OK;
+    }
+    msg = gzerror(unz->gz, &gz_err);
+    if ( n < 0 || gz_err != Z_OK ) {
+	fprintf(stderr, "%d: gzip decompression failed.\n%s\n",
+		getpid(), msg);
+	return SIGMET_BAD_FILE;
+    }
+    return SIGMET_OK;
+}
+
+/*
+   Decompress bzip2 input into the ring. Like bunzip2, continue through
+   concatenated bzip2 streams.
+ */
+
+static enum SigmetStatus unz_bz2(struct sigmet_unz *unz)
+{
+    BZFILE *bz;
+    char *buf;				/* Free space in ring */
+    size_t sz;				/* Size of buf */
+    int bz_err;				/* bzlib error code */
+    int n;				/* Return from BZ2_bzRead */
+    char unused[BZ_MAX_UNUSED];		/* Input read past end of stream */
+    void *unused_p;
+    int n_unused = 0;
+
+    while (1) {
+	bz = BZ2_bzReadOpen(&bz_err, unz->bz_f, 0, 0, unused, n_unused);
+	if ( bz_err != BZ_OK ) {
+	    fprintf(stderr, "%d: could not start bzip2 decompression.\n",
+		    getpid());
+	    BZ2_bzReadClose(&bz_err, bz);
+	    return SIGMET_IO_FAIL;
+	}
+	do {
+	    if ( (sz = unz_space(unz, &buf)) == 0 ) {
+		BZ2_bzReadClose(&bz_err, bz);
+		return SIGMET_OK;
+	    }
+	    n = BZ2_bzRead(&bz_err, bz, buf, (int)sz);
+	    if ( (bz_err == BZ_OK || bz_err == BZ_STREAM_END) && n > 0 ) {
+		unz_put(unz, (size_t)n);
+	    }
+	} while (bz_err == BZ_OK);
+	if ( bz_err != BZ_STREAM_END ) {
+	    fprintf(stderr, "%d: bzip2 decompression failed, error %d.\n",
+		    getpid(), bz_err);
+	    BZ2_bzReadClose(&bz_err, bz);
+	    return SIGMET_BAD_FILE;
+	}
+	BZ2_bzReadGetUnused(&bz_err, bz, &unused_p, &n_unused);
+	memcpy(unused, unused_p, n_unused);
+	BZ2_bzReadClose(&bz_err, bz);
+	if ( n_unused == 0 ) {
+	    int c = getc(unz->bz_f);
+
+	    if ( c == EOF ) {
+		return SIGMET_OK;
+	    }
+	    ungetc(c, unz->bz_f);
+	}
+    }
+}
+
+/*
+   Wait for free space in the ring of unz. Put the address of the free
+   space into buf_p and return its size, at most UNZ_BUF_SZ. Return 0 if
+   the reader has closed the stream, in which case decompression should
+   stop.
+ */
+
+static size_t unz_space(struct sigmet_unz *unz, char **buf_p)
+{
+    size_t i, sz;
+
+    pthread_mutex_lock(&unz->mtx);
+    while ( !unz->closed && unz->wr - unz->rd == UNZ_RING_SZ ) {
+	pthread_cond_wait(&unz->cond, &unz->mtx);
+    }
+    if ( unz->closed ) {
+	pthread_mutex_unlock(&unz->mtx);
+	return 0;
+    }
+    i = unz->wr % UNZ_RING_SZ;
+    sz = UNZ_RING_SZ - (unz->wr - unz->rd);
+    pthread_mutex_unlock(&unz->mtx);
+    sz = (sz < UNZ_RING_SZ - i) ? sz : UNZ_RING_SZ - i;
+    *buf_p = unz->ring + i;
+    return (sz < UNZ_BUF_SZ) ? sz : UNZ_BUF_SZ;
+}
+
+/*
+   Make n bytes, which the decompressor has put into the space from
+   unz_space, available to the reader.
+ */
+
+static void unz_put(struct sigmet_unz *unz, size_t n)
+{
+    pthread_mutex_lock(&unz->mtx);
+    unz->wr += n;
+    pthread_cond_signal(&unz->cond);
+    pthread_mutex_unlock(&unz->mtx);
+}
+
+/*
+   Copy up to n bytes from the ring of unz to buf, waiting for the
+   decompressor if the ring is empty. Return the number of bytes copied,
+   or 0 if decompression has ended.
+ */
+
+static size_t unz_get(struct sigmet_unz *unz, char *buf, size_t n)
+{
+    size_t i, avail;
+
+    pthread_mutex_lock(&unz->mtx);
+    while ( !unz->done && unz->wr == unz->rd ) {
+	pthread_cond_wait(&unz->cond, &unz->mtx);
+    }
+    i = unz->rd % UNZ_RING_SZ;
+    avail = unz->wr - unz->rd;
+    pthread_mutex_unlock(&unz->mtx);
+    n = (n < avail) ? n : avail;
+    n = (n < UNZ_RING_SZ - i) ? n : UNZ_RING_SZ - i;
+    memcpy(buf, unz->ring + i, n);
+    pthread_mutex_lock(&unz->mtx);
+    unz->rd += n;
+    pthread_cond_signal(&unz->cond);
+    pthread_mutex_unlock(&unz->mtx);
+    return n;
+}
+
+/*
+   Read function for the stream from Sigmet_Vol_Open.
+ */
+
+#ifdef __GLIBC__
+static ssize_t unz_read(void *cookie, char *buf, size_t n)
+{
+    return (ssize_t)unz_get((struct sigmet_unz *)cookie, buf, n);
+}
+#else
+static int unz_read(void *cookie, char *buf, int n)
+{
+    return (int)unz_get((struct sigmet_unz *)cookie, buf, (size_t)n);
+}
+#endif
+
+/*
+   Close function for the stream from Sigmet_Vol_Open. Tell the
+   decompressor to stop. Sigmet_Vol_Close waits for it and frees unz.
+ */
+
+static int unz_close(void *cookie)
+{
+    struct sigmet_unz *unz = (struct sigmet_unz *)cookie;
+
+    pthread_mutex_lock(&unz->mtx);
+    unz->closed = 1;
+    pthread_cond_signal(&unz->cond);
+    pthread_mutex_unlock(&unz->mtx);
+    return 0;
+}
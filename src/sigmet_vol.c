@@ -48,7 +48,9 @@
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <sys/wait.h>
-#include <sys/shm.h>
+#include <sys/mman.h>
+#include <poll.h>
+#include <pthread.h>
 #include "alloc.h"
 #include "tm_calc_lib.h"
 #include "swap.h"
@@ -67,7 +69,7 @@
    Length of a record in a Sigmet raw file
  */
 
-#define REC_LEN 6144
+#define REC_LEN SIGMET_REC_LEN
 
 /*
    Header sizes in data record
@@ -94,13 +96,334 @@ enum SCAN_MODE {ppi_sec = 1, rhi, man, ppi_cont, file};
  */
 
 static char *trimRight(char *, int);
-static int get_sint16(void *);
-static unsigned get_uint16(void *);
-static int get_sint32(void *);
-static unsigned get_uint32(void *);
+static int get_sint16(void *, int);
+static unsigned get_uint16(void *, int);
+static int get_sint32(void *, int);
+static unsigned get_uint32(void *, int);
 static enum SigmetStatus vol_good(FILE *);
+
+/*
+   Source of data records for the readers. If the raw product file is a
+   regular file, records come straight from a read only memory map of it.
+   Otherwise, they are copied into buf with fread.
+ */
+
+struct rec_src {
+    FILE *f;				/* Input stream */
+    U1BYT *map;				/* Memory map of the file, or NULL */
+    size_t map_sz;			/* Size of map */
+    U1BYT *map_p;			/* Next record in map */
+    U1BYT *map_e;			/* End of last whole record in map */
+    U1BYT buf[REC_LEN];			/* Receive records from fread */
+};
+static void rec_src_init(struct rec_src *, FILE *);
+static U1BYT *rec_src_next(struct rec_src *);
+static int rec_src_eof(struct rec_src *);
+static void rec_src_close(struct rec_src *);
+
+/*
+   Data record decoder. Sigmet_Vol_Read gives it data records one at a
+   time. It expands the run length encoded rays straight from the records
+   into the data arrays of the volume, without an intermediate ray buffer.
+   Runs can cross record boundaries, so the decoder keeps its place
+   between records. Rays of data types and sweeps that the volume filter
+   does not select are stepped over without being copied.
+ */
+
+enum dcdr_stop {
+    DCDR_GO,				/* Keep decoding records */
+    DCDR_DONE,				/* Volume ended normally */
+    DCDR_TRUNC				/* Sweeps went out of order */
+};
+struct rec_dcdr {
+    struct Sigmet_Vol *vol_p;		/* Receive data */
+    int swap;				/* If true, swap bytes from records */
+    int num_types_fl;			/* Number of types in the file,
+					   including DB_XHDR */
+    int num_sweeps;			/* Number of sweeps in vol_p */
+    int num_rays;			/* Number of rays per sweep */
+    size_t num_bins;			/* Number of output bins */
+    int rec_idx;			/* Index of last record decoded */
+    int sweep_num;			/* Current sweep number (1 is first) */
+    int s, r, yf;			/* Sweep, ray, file type indeces */
+    int y_fl[SIGMET_NTYPES];		/* Index in dat for each file type,
+					   or -1 if type is not loaded */
+    int skip;				/* If true, current sweep is not
+					   loaded */
+    double swp_tm;			/* Sweep start time */
+    size_t run;				/* Data words remaining in a run that
+					   crosses a record boundary */
+    size_t w;				/* Number of words given to current
+					   ray, including ray header */
+    size_t max_wds;			/* Most words allowed in a ray */
+    U1BYT ray_hdr[SZ_RAY_HDR];		/* Header of current ray */
+    U1BYT xhdr[4];			/* Start of extended header */
+    int xhdr_ray;			/* If true, current ray is extended
+					   header */
+    U1BYT *u1;				/* Receive U1 data for current ray */
+    U2BYT *u2;				/* Receive U2 data for current ray */
+    void (*u2_cpy)(U2BYT *, const U1BYT *, size_t);
+					/* Copy U2 words from records,
+					   u2_cpy or u2_cpy_swap */
+    struct Sigmet_Ray *ray;		/* If not NULL, receive rays here
+					   instead of in vol_p, and give
+					   each one to ray_fn */
+    Sigmet_RayFn ray_fn;		/* Receive rays from Sigmet_Vol_Scan */
+    void *ray_arg;			/* Last argument for ray_fn */
+    enum dcdr_stop stop;
+};
+static void dcdr_init(struct rec_dcdr *, struct Sigmet_Vol *);
+static enum SigmetStatus dcdr_ray_start(struct rec_dcdr *);
+static enum SigmetStatus dcdr_data(struct rec_dcdr *, U1BYT *, size_t);
+static void u2_cpy(U2BYT *, const U1BYT *, size_t);
+static void u2_cpy_swap(U2BYT *, const U1BYT *, size_t);
+static enum SigmetStatus dcdr_zeros(struct rec_dcdr *, size_t);
+static enum SigmetStatus dcdr_ray_end(struct rec_dcdr *);
+static enum SigmetStatus dcdr_rec(struct rec_dcdr *, U1BYT *);
+static int swp_start(struct Sigmet_Vol *, int, U1BYT *, int);
+static enum SigmetStatus vol_alloc(struct Sigmet_Vol *);
+static enum SigmetStatus vol_read(FILE *, struct Sigmet_Vol *,
+	struct Sigmet_Vol_Filter *, int);
+static enum SigmetStatus vol_idx(struct Sigmet_Vol *, struct rec_src *);
+static void sweep_ready(struct Sigmet_Vol *, int);
+
+/*
+   A followed volume is decoded on its own thread while the raw product
+   file is still being written. The thread counts the sweeps whose rays
+   are all in the volume. Accessors wait on the condition variable until
+   the sweep they want is counted.
+ */
+
+#define INGEST_POLL_NS 250000000L	/* Wait this long, in nanoseconds,
+					   before checking a regular file for
+					   more data */
+struct sigmet_ingest {
+    FILE *f;				/* Input stream */
+    int reg;				/* If true, f is a regular file that
+					   might still grow */
+    int fd;				/* If f is not regular, its descriptor,
+					   which is read directly, or -1 */
+    double idle;			/* If f is regular, give up after it
+					   stops growing for this many
+					   seconds */
+    struct rec_dcdr dcdr;		/* Decode data records */
+    U1BYT rec[REC_LEN];			/* Current data record */
+    pthread_t thr;			/* Read and decode records */
+    pthread_mutex_t mtx;		/* Guard members below */
+    pthread_cond_t cond;		/* Signal change in num_sweeps_rd */
+    int num_sweeps_rd;			/* Number of sweeps complete */
+    int done;				/* If true, thread has finished */
+    int stop;				/* If true, thread should finish */
+    enum SigmetStatus status;		/* Result from thread */
+    int truncated;			/* Value for vol_p->truncated */
+    int num_sweeps_ax;			/* Value for vol_p->num_sweeps_ax */
+};
+static int ingest_rec(struct sigmet_ingest *);
+static void *ingest_thr(void *);
+static void ingest_wait(struct Sigmet_Vol *, int);
+
+/*
+   Sweeps can be decoded concurrently once the sweep index gives their
+   record boundaries. Threads take the next sweep from a shared counter.
+ */
+
+struct sweep_pool {
+    struct Sigmet_Vol *vol_p;		/* Volume with sweep index */
+    int num_sweeps;			/* Number of sweeps in vol_p */
+    int s;				/* Next sweep to decode */
+    enum SigmetStatus status;		/* First failure, or SIGMET_OK */
+    int truncated;			/* If true, last sweep lacks rays */
+    pthread_mutex_t mtx;		/* Guard s, status, and truncated */
+};
+static enum SigmetStatus load_sweep(struct Sigmet_Vol *, int, int *);
+static enum SigmetStatus load_sweeps(struct Sigmet_Vol *);
+static void *sweep_thr(void *);
 static unsigned hash(const char *);
+static int fld_reserve(struct Sigmet_Vol *, int);
+static void fld_tbl_fill(struct Sigmet_Vol *);
 static void hash_add(struct Sigmet_Vol *, char *, int);
+static void vol_filter_types(struct Sigmet_Vol *);
+static int fld_derived(struct Sigmet_Dat *);
+static U2BYT flt_to_half(float);
+static float half_to_flt(U2BYT);
+static float *fld_lut(struct Sigmet_Vol *, struct Sigmet_Dat *);
+static size_t fld_lut_sz(struct Sigmet_Dat *);
+static void fld_lut_free(struct Sigmet_Vol *, struct Sigmet_Dat *);
+static float fld_get(struct Sigmet_Vol *, struct Sigmet_Dat *, int, int, int);
+static float *fld_ray_get(struct Sigmet_Vol *, struct Sigmet_Dat *, int, int,
+	float *);
+static void fld_ray_put(struct Sigmet_Dat *, int, int, const float *, int);
+typedef void (fld_kern)(float *, const float *, int, float);
+static fld_kern kern_set, kern_copy, kern_add, kern_mul, kern_div,
+       kern_log10, kern_add_fld, kern_sub_fld, kern_mul_fld, kern_div_fld;
+static enum SigmetStatus fld_apply(struct Sigmet_Vol *, struct Sigmet_Dat *,
+	struct Sigmet_Dat *, fld_kern *, float);
+
+/*
+   Field operations process sweeps independently, so they can divide the
+   sweeps among vol_p->filter.num_threads threads, like load_sweeps. A
+   fld_swp_fn processes sweep s of vol_p with its own buffers. arg holds
+   the operation's shared, read only, state.
+ */
+
+typedef enum SigmetStatus (fld_swp_fn)(struct Sigmet_Vol *, int, void *);
+struct fld_pool {
+    struct Sigmet_Vol *vol_p;		/* Volume with fields */
+    fld_swp_fn *fn;			/* Process one sweep */
+    void *arg;				/* Argument for fn */
+    int s;				/* Next sweep to process */
+    enum SigmetStatus status;		/* First failure, or SIGMET_OK */
+    pthread_mutex_t mtx;		/* Guard s and status */
+};
+static enum SigmetStatus fld_sweeps(struct Sigmet_Vol *,
+	struct Sigmet_Dat **, int, fld_swp_fn *, void *);
+static void *fld_thr(void *);
+static fld_swp_fn apply_swp, rbeam_swp, calc_swp, mask_swp, despeckle_swp,
+       filter_swp;
+static void fld_blank(struct Sigmet_Dat *, int, int, const U1BYT *, int);
+
+/*
+   Comparisons for Sigmet_Vol_Fld_Mask
+ */
+
+enum mask_op {MASK_LT, MASK_LE, MASK_GT, MASK_GE, MASK_EQ, MASK_NE};
+struct mask_arg {
+    struct Sigmet_Dat *dat_p;		/* Field to blank */
+    struct Sigmet_Dat *ctl_p;		/* Field to compare */
+    U1BYT *tbl;				/* If ctl_p stores integers, tbl[u]
+					   is true if storage value u
+					   passes the comparison */
+    enum mask_op op;
+    double thr;				/* Threshold */
+};
+static int mask_cmp(float, enum mask_op, double);
+
+/*
+   Parameters for Sigmet_Vol_Fld_Despeckle
+ */
+
+struct despeckle_arg {
+    struct Sigmet_Dat *dat_p;		/* Field to clean */
+    U1BYT *tbl;				/* If dat_p stores integers, tbl[u]
+					   is true if storage value u is
+					   data */
+    int d_bin, d_ray;			/* Window extends this many bins and
+					   rays on either side of a gate */
+    int min_count;			/* Gates with data the window needs to
+					   keep its center */
+};
+
+/*
+   Parameters for Sigmet_Vol_Fld_Filter
+ */
+
+struct filter_arg {
+    struct Sigmet_Dat *dat_p;		/* Field to filter */
+    struct Sigmet_Dat *out_p;		/* Field for result, may be dat_p */
+    enum Sigmet_FldFilter filter;
+    int d_bin, d_ray;			/* Window extends this many bins and
+					   rays on either side of a gate */
+};
+
+/*
+   Sliding window for the median filter. The window is a Fenwick tree of
+   counts indexed by rank (see filter_median).
+ */
+
+struct flt_med {
+    const int *rank;			/* rank[r * num_bins + b] is the index
+					   in srt of the value at ray r, bin
+					   b, or -1 */
+    int num_bins;
+    float *srt;				/* Distinct values, sorted */
+    int n_srt;
+    int *tree;				/* tree[j] counts values with rank
+					   j - lowbit(j) to j - 1 */
+    int top;				/* Highest power of 2 <= n_srt */
+    int cnt;				/* Values in window */
+};
+static int filter_ray(struct Sigmet_Vol *, int);
+static int filter_d_ray(struct Sigmet_Vol *, int);
+static void filter_box_ray(const float *, int, int, double *, int *, int);
+static int filter_boxcar(struct Sigmet_Vol *, int, struct filter_arg *,
+	const float *, float *);
+static void flt_med_add(struct flt_med *, int, int, int, int);
+static void flt_med_move(struct Sigmet_Vol *, struct flt_med *, int, int,
+	int, int, int, int);
+static float flt_med_get(struct flt_med *);
+static int filter_median(struct Sigmet_Vol *, int, struct filter_arg *,
+	const float *, float *);
+static int flt_rank(const float *, size_t, float *, int *);
+
+/*
+   Parameters and buffers for Sigmet_Vol_Fld_Dealias
+ */
+
+struct dealias_arg {
+    struct Sigmet_Dat *dat_p;		/* Velocity field */
+    struct Sigmet_Dat *out_p;		/* Field for unfolded velocity */
+    double nyq2;			/* Width of unambiguous interval,
+					   twice the Nyquist velocity */
+    float *in_buf, *cur;		/* Input and result for a ray */
+    float *prev_buf, *ref_buf;		/* Previous ray and ray from previous
+					   sweep, if out_p is not float */
+    int *near;				/* near[i] is the ray in the previous
+					   sweep nearest to azimuth
+					   i * 360 / num_rays, or -1 */
+};
+static void dealias_swp(struct Sigmet_Vol *, int, int, struct dealias_arg *);
+static int dealias_near(struct Sigmet_Vol *, int, int *);
+static int dealias_cell(struct Sigmet_Vol *, int, int);
+
+/*
+   Quiet NAN in IEEE 754 half precision, for SIGMET_F16 fields.
+ */
+
+#define HALF_NAN 0x7e00
+
+/*
+   Sigmet_Vol_Fld_Calc compiles an expression into a program for a stack
+   machine. Each element of the stack is a ray of values, so instructions
+   are loops over bins, and the program runs once per ray.
+ */
+
+enum calc_op {
+    CALC_CONST, CALC_FLD, CALC_RBEAM, CALC_NEG, CALC_NOT, CALC_LOG10,
+    CALC_LOG, CALC_EXP, CALC_SQRT, CALC_ABS, CALC_ISNAN, CALC_ADD, CALC_SUB,
+    CALC_MUL, CALC_DIV, CALC_POW, CALC_MIN, CALC_MAX, CALC_LT, CALC_LE,
+    CALC_GT, CALC_GE, CALC_EQ, CALC_NE, CALC_AND, CALC_OR, CALC_COND
+};
+struct calc_ins {
+    enum calc_op op;
+    float v;				/* Value for CALC_CONST */
+    int f;				/* Index in fld for CALC_FLD */
+};
+struct calc_prog {
+    struct calc_ins *ins;		/* Instructions */
+    int n_ins, max_ins;			/* Number of instructions, allocation */
+    int *fld;				/* Indeces in dat of fields used */
+    int n_fld;				/* Number of elements in fld */
+    int depth, max_depth;		/* Stack depth, maximum stack depth */
+    struct Sigmet_Vol *vol_p;		/* Volume with fields */
+    struct Sigmet_Dat *dat_p;		/* Field that receives the result */
+    char *expr, *p;			/* Expression, and parse position */
+};
+static int calc_compile(struct Sigmet_Vol *, char *, struct calc_prog *);
+static void calc_free(struct calc_prog *);
+static int calc_err(struct calc_prog *, char *);
+static void calc_space(struct calc_prog *);
+static int calc_tok(struct calc_prog *, char *);
+static int calc_emit(struct calc_prog *, enum calc_op, float, int);
+static int calc_cond(struct calc_prog *);
+static int calc_or(struct calc_prog *);
+static int calc_and(struct calc_prog *);
+static int calc_cmp(struct calc_prog *);
+static int calc_add(struct calc_prog *);
+static int calc_mul(struct calc_prog *);
+static int calc_unary(struct calc_prog *);
+static int calc_prim(struct calc_prog *);
+static float *calc_ray(struct calc_prog *, float **, float *, int, float **,
+	float *, int);
 
 /*
    Default length for character strings
@@ -115,67 +438,67 @@ static void hash_add(struct Sigmet_Vol *, char *, int);
  */
 
 static int ymds_incr(struct Sigmet_YMDS_Time *, double);
-static struct Sigmet_YMDS_Time get_ymds_time(char *);
+static struct Sigmet_YMDS_Time get_ymds_time(char *, int);
 static void print_ymds_time(FILE *, struct Sigmet_YMDS_Time,
 	char *, char *, char *);
-static struct Sigmet_Structure_Header get_structure_header(char *);
+static struct Sigmet_Structure_Header get_structure_header(char *, int);
 static void print_structure_header(FILE *, char *,
 	struct Sigmet_Structure_Header);
-static struct Sigmet_Product_Specific_Info get_product_specific_info(char *);
+static struct Sigmet_Product_Specific_Info get_product_specific_info(char *, int);
 static void print_product_specific_info(FILE *, char *,
 	struct Sigmet_Product_Specific_Info);
-static struct Sigmet_Color_Scale_Def get_color_scale_def(char *);
+static struct Sigmet_Color_Scale_Def get_color_scale_def(char *, int);
 static void print_color_scale_def(FILE *, char *,
 	struct Sigmet_Color_Scale_Def);
-static struct Sigmet_Product_Configuration get_product_configuration(char *);
+static struct Sigmet_Product_Configuration get_product_configuration(char *, int);
 static void print_product_configuration(FILE *, char *,
 	struct Sigmet_Product_Configuration);
-static struct Sigmet_Product_End get_product_end(char *);
+static struct Sigmet_Product_End get_product_end(char *, int);
 static void print_product_end(FILE *, char *, struct Sigmet_Product_End);
-static struct Sigmet_Product_Hdr get_product_hdr(char *);
+static struct Sigmet_Product_Hdr get_product_hdr(char *, int);
 static void print_product_hdr(FILE *, char *, struct Sigmet_Product_Hdr);
-static struct Sigmet_Ingest_Configuration get_ingest_configuration(char *);
+static struct Sigmet_Ingest_Configuration get_ingest_configuration(char *, int);
 static void print_ingest_configuration(FILE *, char *,
 	struct Sigmet_Ingest_Configuration);
-static struct Sigmet_Task_Sched_Info get_task_sched_info(char *);
+static struct Sigmet_Task_Sched_Info get_task_sched_info(char *, int);
 static void print_task_sched_info(FILE *, char *,
 	struct Sigmet_Task_Sched_Info);
-static struct Sigmet_DSP_Data_Mask get_dsp_data_mask(char *);
+static struct Sigmet_DSP_Data_Mask get_dsp_data_mask(char *, int);
 static void print_dsp_data_mask(FILE *, char *, struct Sigmet_DSP_Data_Mask,
 	char *);
-static struct Sigmet_Task_DSP_Mode_Batch get_task_dsp_mode_batch(char *);
+static struct Sigmet_Task_DSP_Mode_Batch get_task_dsp_mode_batch(char *, int);
 static void print_task_dsp_mode_batch(FILE *, char *,
 	struct Sigmet_Task_DSP_Mode_Batch);
-static struct Sigmet_Task_DSP_Info get_task_dsp_info(char *);
+static struct Sigmet_Task_DSP_Info get_task_dsp_info(char *, int);
 static void print_task_dsp_info(FILE *, char *, struct Sigmet_Task_DSP_Info);
-static struct Sigmet_Task_Calib_Info get_task_calib_info(char *);
+static struct Sigmet_Task_Calib_Info get_task_calib_info(char *, int);
 static void print_task_calib_info(FILE *, char *,
 	struct Sigmet_Task_Calib_Info);
-static struct Sigmet_Task_Range_Info get_task_range_info(char *);
+static struct Sigmet_Task_Range_Info get_task_range_info(char *, int);
 static void print_task_range_info(FILE *, char *,
 	struct Sigmet_Task_Range_Info);
-static struct Sigmet_Task_RHI_Scan_Info get_task_rhi_scan_info(char *);
+static struct Sigmet_Task_RHI_Scan_Info get_task_rhi_scan_info(char *, int);
 static void print_task_rhi_scan_info(FILE *, char *,
 	struct Sigmet_Task_RHI_Scan_Info);
-static struct Sigmet_Task_PPI_Scan_Info get_task_ppi_scan_info(char *);
+static struct Sigmet_Task_PPI_Scan_Info get_task_ppi_scan_info(char *, int);
 static void print_task_ppi_scan_info(FILE *, char *,
 	struct Sigmet_Task_PPI_Scan_Info);
-static struct Sigmet_Task_File_Scan_Info get_task_file_scan_info(char *);
+static struct Sigmet_Task_File_Scan_Info get_task_file_scan_info(char *, int);
 static void print_task_file_scan_info(FILE *, char *,
 	struct Sigmet_Task_File_Scan_Info);
-static struct Sigmet_Task_Manual_Scan_Info get_task_manual_scan_info(char *);
+static struct Sigmet_Task_Manual_Scan_Info get_task_manual_scan_info(char *, int);
 static void print_task_manual_scan_info(FILE *, char *,
 	struct Sigmet_Task_Manual_Scan_Info);
-static struct Sigmet_Task_Scan_Info get_task_scan_info(char *);
+static struct Sigmet_Task_Scan_Info get_task_scan_info(char *, int);
 static void print_task_scan_info(FILE *, char *, struct Sigmet_Task_Scan_Info);
-static struct Sigmet_Task_Misc_Info get_task_misc_info(char *);
+static struct Sigmet_Task_Misc_Info get_task_misc_info(char *, int);
 static void print_task_misc_info(FILE *, char *, struct Sigmet_Task_Misc_Info);
-static struct Sigmet_Task_End_Info get_task_end_info(char *);
+static struct Sigmet_Task_End_Info get_task_end_info(char *, int);
 static void print_task_end_info(FILE *, char *, struct Sigmet_Task_End_Info);
-static struct Sigmet_Task_Configuration get_task_configuration(char *);
+static struct Sigmet_Task_Configuration get_task_configuration(char *, int);
 static void print_task_configuration(FILE *, char *,
 	struct Sigmet_Task_Configuration);
-static struct Sigmet_Ingest_Header get_ingest_header(char *);
+static struct Sigmet_Ingest_Header get_ingest_header(char *, int);
 static void print_ingest_header(FILE *, char *, struct Sigmet_Ingest_Header);
 
 /*
@@ -191,9 +514,13 @@ static void print_s(FILE *, char *, char *, char *, char *);
    Allocators
  */
 
-static U1BYT *** malloc3_u1(long, long, long, int *);
-static U2BYT *** malloc3_u2(long, long, long, int *);
-static float *** malloc3_flt(long, long, long, int *);
+static int sweep_ld(const struct Sigmet_Vol_Filter *, long);
+static long num_sweeps_ld(const struct Sigmet_Vol_Filter *, long);
+static void *vol_pool_alloc(struct Sigmet_Vol *, size_t);
+static void vol_pool_free(struct Sigmet_Vol *, void *);
+static void vol_pool_release(struct Sigmet_Vol *);
+static int fld_alloc(struct Sigmet_Vol *, struct Sigmet_Dat *, long, long,
+	long, const struct Sigmet_Vol_Filter *);
 
 /*
    Add dt DAYS to the time structure at time_p. Return success/failure.
@@ -225,7 +552,7 @@ static int ymds_incr(struct Sigmet_YMDS_Time *tm_p, double dt)
 
 void Sigmet_Vol_Init(struct Sigmet_Vol *vol_p)
 {
-    int n, y;
+    int n;
 
     if (!vol_p) {
 	return;
@@ -235,311 +562,816 @@ void Sigmet_Vol_Init(struct Sigmet_Vol *vol_p)
     for (n = 0; n < SIGMET_NTYPES; n++) {
 	vol_p->types_fl[n] = DB_XHDR;		/* Force error if used */
     }
-    vol_p->sweep_hdr_id = -1;
-    vol_p->ray_hdr_id = -1;
-    for (y = 0; y < SIGMET_MAX_TYPES; y++) {
-	memset(vol_p->dat[y].data_type_s, 0, sizeof(vol_p->dat[y].data_type_s));
-	memset(vol_p->dat[y].descr, 0, sizeof(vol_p->dat[y].descr));
-	memset(vol_p->dat[y].unit, 0, sizeof(vol_p->dat[y].unit));
-	vol_p->dat[y].stor_fmt = SIGMET_MT;
-	vol_p->dat[y].stor_to_comp = Sigmet_DblDbl;
-	vol_p->dat[y].vals.u1 = NULL;
-	vol_p->dat[y].vals_id = -1;
-    }
+    Sigmet_Vol_FilterInit(&vol_p->filter);
+    vol_p->dat = NULL;
+    vol_p->dat_max = 0;
+    vol_p->types_tbl = NULL;
+    vol_p->types_tbl_sz = 0;
     vol_p->truncated = 1;
     vol_p->size = sizeof(struct Sigmet_Vol);
     return;
 }
 
+/*
+   Set filter at filt_p to select all data types and sweeps, and to decode
+   with one thread.
+ */
+
+void Sigmet_Vol_FilterInit(struct Sigmet_Vol_Filter *filt_p)
+{
+    int n;
+
+    if ( !filt_p ) {
+	return;
+    }
+    for (n = 0; n < SIGMET_NTYPES; n++) {
+	filt_p->types[n] = 1;
+    }
+    for (n = 0; n < SIGMET_MAX_SWEEPS; n++) {
+	filt_p->sweeps[n] = 1;
+    }
+    filt_p->num_threads = 1;
+}
+
 enum SigmetStatus Sigmet_Vol_Free(struct Sigmet_Vol *vol_p)
 {
-    struct Sigmet_Dat *dat_p;
     enum SigmetStatus sig_stat = SIGMET_OK;
+    int y;
 
     if (!vol_p) {
 	return SIGMET_BAD_ARG;
     }
-    if ( vol_p->shm ) {
-	if ( Sigmet_ShMemDetach(vol_p) != SIGMET_OK ) {
-	    fprintf(stderr, "%d: could not detach volume from shared "
-		    "memory.\n", getpid());
-	    sig_stat = SIGMET_MEM_FAIL;
-	}
-	if ( vol_p->sweep_hdr_id != -1
-		&& shmctl(vol_p->sweep_hdr_id, IPC_RMID, NULL) == -1 ) {
-	    fprintf(stderr, "%d: could not remove shared memory for "
-		    "sweep headers.\n%s\nPlease use ipcrm command for id %d\n",
-		    getpid(), strerror(errno), vol_p->sweep_hdr_id);
-	    sig_stat = SIGMET_MEM_FAIL;
-	}
-	if ( vol_p->ray_hdr_id != -1
-		&& shmctl(vol_p->ray_hdr_id, IPC_RMID, NULL) == -1 ) {
-	    fprintf(stderr, "%d: could not remove shared memory for "
-		    "ray headers.\n%s\nPlease use ipcrm command for id %d\n",
-		    getpid(), strerror(errno), vol_p->ray_hdr_id);
-	    sig_stat = SIGMET_MEM_FAIL;
-	}
-	for (dat_p = vol_p->dat;
-		dat_p < vol_p->dat + SIGMET_MAX_TYPES;
-		dat_p++) {
-	    if ( dat_p->vals_id != -1
-		    && shmctl(dat_p->vals_id, IPC_RMID, NULL) == -1 ) {
-		fprintf(stderr, "%d: could not remove shared memory for "
-			"%s array.\n%s\nPlease use ipcrm command for id %d\n",
-			getpid(), dat_p->data_type_s, strerror(errno),
-			dat_p->vals_id);
-		sig_stat = SIGMET_MEM_FAIL;
-	    }
-	}
-    } else {
-	int y;
+    if ( vol_p->ingest ) {
+	pthread_mutex_lock(&vol_p->ingest->mtx);
+	vol_p->ingest->stop = 1;
+	pthread_mutex_unlock(&vol_p->ingest->mtx);
+	Sigmet_Vol_FollowEnd(vol_p);
+    }
 
-	FREE(vol_p->sweep_hdr);
-	FREE(vol_p->ray_hdr);
-	for (y = 0; y < SIGMET_MAX_TYPES; y++) {
-	    switch (vol_p->dat[y].stor_fmt) {
-		case SIGMET_U1:
-		    FREE(vol_p->dat[y].vals.u1);
-		    break;
-		case SIGMET_U2:
-		    FREE(vol_p->dat[y].vals.u2);
-		    break;
-		case SIGMET_FLT:
-		    FREE(vol_p->dat[y].vals.f);
-		    break;
-		case SIGMET_DBL:
-		case SIGMET_MT:
-		    break;
-	    }
-	}
-	sig_stat = SIGMET_OK;
+    /*
+       Headers and field values are in the volume's chunks, or in the
+       arena, which go away all at once.
+     */
+
+    vol_pool_release(vol_p);
+    if ( vol_p->arena && munmap(vol_p->arena, vol_p->arena_sz) == -1 ) {
+	fprintf(stderr, "%d: could not unmap shared memory for volume.\n%s\n",
+		getpid(), strerror(errno));
+	sig_stat = SIGMET_MEM_FAIL;
+    }
+    if ( vol_p->rec_map ) {
+	munmap(vol_p->rec_map, vol_p->rec_map_sz);
+    }
+    for (y = 0; y < vol_p->num_types; y++) {
+	FREE(vol_p->dat[y].lut);
     }
+    FREE(vol_p->sweep_idx);
+    FREE(vol_p->dat);
+    FREE(vol_p->types_tbl);
     Sigmet_Vol_Init(vol_p);
     return sig_stat;
 }
 
-enum SigmetStatus Sigmet_ShMemAttach(struct Sigmet_Vol *vol_p)
+/*
+   A decoded volume can be stored in one block of memory, or arena, that
+   is either a POSIX shared memory object, which other processes attach
+   to by name, or a cache file, which later runs map instead of decoding
+   the raw product file again. The arena starts with a struct arena_hdr.
+   Everything else is found from offsets in it, so the arena has no
+   addresses and can be mapped anywhere. Sections are aligned to
+   ARENA_ALIGN bytes.
+
+   Arena layout:
+	struct arena_hdr
+	struct Sigmet_Vol, with addresses zeroed
+	sweep headers, num_sweeps elements
+	ray headers, num_sweeps * num_rays elements, sweep major
+	struct Sigmet_Dat, num_types elements, with addresses zeroed
+	offsets of field values, num_types size_t elements
+	field values, one block per field, laid out as in process memory
+
+   The writer stores the magic string last, so a reader that maps the
+   arena while it is being filled sees a bad magic string and fails.
+ */
+
+#define ARENA_MAGIC "SIGMVOL"
+#define ARENA_VERSION 4
+#define ARENA_ALIGN 64
+struct arena_hdr {
+    char magic[8];			/* ARENA_MAGIC */
+    unsigned version;			/* ARENA_VERSION */
+    size_t vol_sz;			/* sizeof(struct Sigmet_Vol) */
+    size_t dat_sz;			/* sizeof(struct Sigmet_Dat) */
+    size_t sz;				/* Size of arena */
+    size_t vol_off;			/* Offset of volume struct */
+    size_t sweep_hdr_off;		/* Offset of sweep headers */
+    size_t ray_hdr_off;			/* Offset of ray headers */
+    size_t dat_off;			/* Offset of data array structs */
+    size_t vals_off;			/* Offset of field value offsets */
+
+    /*
+       For a cache file, identify the raw product file the volume came
+       from. Zero for shared memory.
+     */
+
+    dev_t src_dev;			/* Device with raw product file */
+    ino_t src_ino;			/* Inode of raw product file */
+    off_t src_sz;			/* Size of raw product file */
+    time_t src_mtime;			/* Modification time, seconds */
+    long src_mtime_ns;			/* Nanoseconds */
+    unsigned long long src_fp;		/* Fingerprint of first two records
+					   and last record */
+};
+
+static size_t arena_align(size_t sz)
+{
+    return (sz + ARENA_ALIGN - 1) / ARENA_ALIGN * ARENA_ALIGN;
+}
+
+/*
+   Return true if n elements of elem_sz bytes starting at offset off fit in
+   an arena of sz bytes, and off is aligned as arena_write aligns sections.
+   Safe for any values read from a damaged arena.
+ */
+
+static int arena_fits(size_t sz, size_t off, size_t n, size_t elem_sz)
 {
-    int y, s, r;			/* Type, sweep, ray */
-    int num_sweeps, num_rays, num_bins;
-    int n;
-    enum SigmetStatus sig_stat;
+    return off % ARENA_ALIGN == 0 && off <= sz
+	&& (elem_sz == 0 || n <= (sz - off) / elem_sz);
+}
+
+/*
+   Write vol_p to an arena in the object open for reading and writing at
+   file descriptor fd, whose name is nm. The key members of hdr_p must be
+   set. Others are set here. Do not close fd.
+ */
 
-    if ( !vol_p || !vol_p->shm) {
+static enum SigmetStatus arena_write(struct Sigmet_Vol *vol_p, int fd,
+	const char *nm, struct arena_hdr *hdr_p)
+{
+    int num_sweeps, num_rays;
+    int s, y;				/* Sweep, data type indeces */
+    size_t sz;				/* Size of arena */
+    size_t *vals_off;			/* Offsets of field values, in arena */
+    struct Sigmet_Vol *vol_a;		/* Volume struct in arena */
+    struct Sigmet_Dat *dat_a;		/* Data arrays in arena */
+    char *arena;
+
+    if ( !vol_p->sweep_hdr || !vol_p->ray_hdr ) {
+	fprintf(stderr, "%d: cannot store a volume with no data.\n",
+		getpid());
 	return SIGMET_BAD_ARG;
     }
+    sweep_ready(vol_p, -1);
+    num_sweeps = vol_p->ih.tc.tni.num_sweeps;
+    num_rays = vol_p->ih.ic.num_rays;
 
-    vol_p->sweep_hdr = shmat(vol_p->sweep_hdr_id, NULL, 0);
-    if ( vol_p->sweep_hdr == (void *)-1) {
-	fprintf(stderr, "%d: could not attach to sweep headers "
-		"in shared memory.\n%s\n", getpid(), strerror(errno));
-	sig_stat = SIGMET_MEM_FAIL;
-	goto error;
+    /*
+       Lay out the arena.
+     */
+
+    memset(hdr_p->magic, 0, sizeof(hdr_p->magic));
+    hdr_p->version = ARENA_VERSION;
+    hdr_p->vol_sz = sizeof(struct Sigmet_Vol);
+    hdr_p->dat_sz = sizeof(struct Sigmet_Dat);
+    sz = arena_align(sizeof(struct arena_hdr));
+    hdr_p->vol_off = sz;
+    sz += arena_align(sizeof(struct Sigmet_Vol));
+    hdr_p->sweep_hdr_off = sz;
+    sz += arena_align(num_sweeps * sizeof(struct Sigmet_Sweep_Hdr));
+    hdr_p->ray_hdr_off = sz;
+    sz += arena_align((size_t)num_sweeps * num_rays
+	    * sizeof(struct Sigmet_Ray_Hdr));
+    hdr_p->dat_off = sz;
+    sz += arena_align(vol_p->num_types * sizeof(struct Sigmet_Dat));
+    hdr_p->vals_off = sz;
+    sz += arena_align(vol_p->num_types * sizeof(size_t));
+    for (y = 0; y < vol_p->num_types; y++) {
+	sz += arena_align(vol_p->dat[y].vals_sz);
     }
+    hdr_p->sz = sz;
 
-    num_sweeps = vol_p->ih.tc.tni.num_sweeps;
-    num_rays = vol_p->ih.ic.num_rays;
-    num_bins = vol_p->ih.tc.tri.num_bins_out;
+    /*
+       Size the object. New space is all zeros, so sweeps that are not
+       loaded need not be written.
+     */
 
-    vol_p->ray_hdr = shmat(vol_p->ray_hdr_id, NULL, 0);
-    if ( vol_p->ray_hdr == (void *)-1) {
-	fprintf(stderr, "%d: could not attach to ray headers "
-		"in shared memory.\n%s\n", getpid(), strerror(errno));
-	sig_stat = SIGMET_MEM_FAIL;
-	goto error;
+    if ( ftruncate(fd, (off_t)sz) == -1 ) {
+	fprintf(stderr, "%d: could not allocate %lu bytes for volume in "
+		"%s.\n%s\n", getpid(), (unsigned long)sz, nm, strerror(errno));
+	return SIGMET_MEM_FAIL;
     }
-    vol_p->ray_hdr[0] = (struct Sigmet_Ray_Hdr *)(vol_p->ray_hdr + num_sweeps);
-    for (n = 1; n < num_sweeps; n++) {
-	vol_p->ray_hdr[n] = vol_p->ray_hdr[n - 1] + num_rays;
+    arena = mmap(NULL, sz, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if ( arena == MAP_FAILED ) {
+	fprintf(stderr, "%d: could not map %s.\n%s\n",
+		getpid(), nm, strerror(errno));
+	return SIGMET_MEM_FAIL;
     }
 
+    /*
+       Copy the volume. Addresses in the copies of the structs would mean
+       nothing to other processes, so zero them.
+     */
+
+    vol_a = (struct Sigmet_Vol *)(arena + hdr_p->vol_off);
+    *vol_a = *vol_p;
+    vol_a->sweep_hdr = NULL;
+    vol_a->ray_hdr = NULL;
+    vol_a->rec_map = NULL;
+    vol_a->rec_map_sz = 0;
+    vol_a->sweep_idx = NULL;
+    vol_a->dat = NULL;
+    vol_a->dat_max = 0;
+    vol_a->types_tbl = NULL;
+    vol_a->types_tbl_sz = 0;
+    vol_a->arena = NULL;
+    vol_a->arena_sz = 0;
+    vol_a->chunks = NULL;
+    vol_a->ingest = NULL;
+    memcpy(arena + hdr_p->sweep_hdr_off, vol_p->sweep_hdr,
+	    num_sweeps * sizeof(struct Sigmet_Sweep_Hdr));
+    memcpy(arena + hdr_p->ray_hdr_off, vol_p->ray_hdr[0],
+	    (size_t)num_sweeps * num_rays * sizeof(struct Sigmet_Ray_Hdr));
+    dat_a = (struct Sigmet_Dat *)(arena + hdr_p->dat_off);
+    vals_off = (size_t *)(arena + hdr_p->vals_off);
+    sz = hdr_p->vals_off + arena_align(vol_p->num_types * sizeof(size_t));
     for (y = 0; y < vol_p->num_types; y++) {
 	struct Sigmet_Dat *dat_p = vol_p->dat + y;
-	enum Sigmet_DataTypeN sig_type;
-
-	switch (vol_p->dat[y].stor_fmt) {
-	    case SIGMET_U1:
-		dat_p->vals.u1 = shmat(dat_p->vals_id, NULL, 0);
-		if ( dat_p->vals.u1 == (void *)-1) {
-		    fprintf(stderr, "%d: could not attach to data array for "
-			    "field %s in shared memory.\n%s\n",
-			    getpid(), dat_p->data_type_s, strerror(errno));
-		    sig_stat = SIGMET_MEM_FAIL;
-		    goto error;
-		} else {
-		    U1BYT ***dat;
-
-		    sig_type = dat_p->sig_type;
-		    dat_p->stor_to_comp = Sigmet_DataType_StorToComp(sig_type);
-		    dat = dat_p->vals.u1;
-		    dat[0] = (U1BYT **)(dat + num_sweeps);
-		    dat[0][0] = (U1BYT *)(dat[0] + num_sweeps * num_rays);
-		    for (s = 1; s < num_sweeps; s++) {
-			dat[s] = dat[s - 1] + num_rays;
-		    }
-		    for (r = 1; r < num_sweeps * num_rays; r++) {
-			dat[0][r] = dat[0][r - 1] + num_bins;
-		    }
-		}
-		break;
-	    case SIGMET_U2:
-		dat_p->vals.u2 = shmat(dat_p->vals_id, NULL, 0);
-		if ( dat_p->vals.u2 == (void *)-1) {
-		    fprintf(stderr, "%d: could not attach to data array for "
-			    "field %s in shared memory.\n%s\n",
-			    getpid(), dat_p->data_type_s, strerror(errno));
-		    sig_stat = SIGMET_MEM_FAIL;
-		    goto error;
-		} else {
-		    U2BYT ***dat;
-
-		    sig_type = dat_p->sig_type;
-		    dat_p->stor_to_comp = Sigmet_DataType_StorToComp(sig_type);
-		    dat = dat_p->vals.u2;
-		    dat[0] = (U2BYT **)(dat + num_sweeps);
-		    dat[0][0] = (U2BYT *)(dat[0] + num_sweeps * num_rays);
-		    for (s = 1; s < num_sweeps; s++) {
-			dat[s] = dat[s - 1] + num_rays;
-		    }
-		    for (r = 1; r < num_sweeps * num_rays; r++) {
-			dat[0][r] = dat[0][r - 1] + num_bins;
-		    }
-		}
-		break;
-	    case SIGMET_FLT:
-		dat_p->vals.f = shmat(dat_p->vals_id, NULL, 0);
-		if ( dat_p->vals.f == (void *)-1) {
-		    fprintf(stderr, "%d: could not attach to data array for "
-			    "field %s in shared memory.\n%s\n",
-			    getpid(), dat_p->data_type_s, strerror(errno));
-		    sig_stat = SIGMET_MEM_FAIL;
-		    goto error;
-		} else {
-		    float ***dat;
-
-		    dat_p->stor_to_comp = Sigmet_DblDbl;
-		    dat = dat_p->vals.f;
-		    dat[0] = (float **)(dat + num_sweeps);
-		    dat[0][0] = (float *)(dat[0] + num_sweeps * num_rays);
-		    for (s = 1; s < num_sweeps; s++) {
-			dat[s] = dat[s - 1] + num_rays;
-		    }
-		    for (r = 1; r < num_sweeps * num_rays; r++) {
-			dat[0][r] = dat[0][r - 1] + num_bins;
-		    }
-		}
-		break;
-	    case SIGMET_DBL:
-	    case SIGMET_MT:
-		fprintf(stderr, "%d: volume in memory is corrupt. "
-			"Unknown data type in data array for field %s.\n",
-			getpid(), dat_p->data_type_s);
-		sig_stat = SIGMET_BAD_VOL;
-		goto error;
-		break;
+	size_t swp_sz = dat_p->vals_sz / num_sweeps;
+
+	dat_a[y] = *dat_p;
+	dat_a[y].vals.u1 = NULL;
+	dat_a[y].stor_to_comp = NULL;
+	dat_a[y].lut = NULL;
+	vol_a->size -= fld_lut_sz(dat_p);
+	vals_off[y] = sz;
+	for (s = 0; s < num_sweeps; s++) {
+	    if ( sweep_ld(&vol_p->filter, s) ) {
+		memcpy(arena + sz + s * swp_sz, dat_p->vals.u1 + s * swp_sz,
+			swp_sz);
+	    }
 	}
+	sz += arena_align(dat_p->vals_sz);
+    }
+    memcpy(hdr_p->magic, ARENA_MAGIC, sizeof(ARENA_MAGIC));
+    memcpy(arena, hdr_p, sizeof(struct arena_hdr));
+    if ( munmap(arena, hdr_p->sz) == -1 ) {
+	fprintf(stderr, "%d: could not unmap %s.\n%s\n",
+		getpid(), nm, strerror(errno));
     }
     return SIGMET_OK;
-
-error:
-    vol_p->sweep_hdr = NULL;
-    vol_p->ray_hdr = NULL;
-    return sig_stat;
 }
 
-enum SigmetStatus Sigmet_ShMemDetach(struct Sigmet_Vol *vol_p)
+/*
+   Attach vol_p to the arena in the object open for reading at file
+   descriptor fd, whose name is nm. The object is mapped copy on write,
+   so the process can modify its volume without affecting the object.
+   Headers and field values are used in place. Only small tables of
+   addresses are allocated. Sigmet_Vol_Free detaches. Do not close fd.
+ */
+
+static enum SigmetStatus arena_attach(int fd, const char *nm,
+	struct Sigmet_Vol *vol_p)
 {
-    struct Sigmet_Dat *dat_p;
+    struct stat sbuf;			/* Information about the object */
+    char *arena;
+    struct arena_hdr *hdr_p;		/* Start of arena */
+    struct Sigmet_Dat *dat_a;		/* Data arrays in arena */
+    size_t *vals_off;			/* Offsets of field values, in arena */
+    int num_sweeps, num_rays, num_bins, num_types;
+    int s, y;				/* Sweep, data type indeces */
     enum SigmetStatus sig_stat;
 
-    sig_stat = SIGMET_OK;
-    if ( !vol_p || !vol_p->shm ) {
-	return SIGMET_BAD_ARG;
+    if ( fstat(fd, &sbuf) == -1 ) {
+	fprintf(stderr, "%d: could not get size of %s.\n%s\n",
+		getpid(), nm, strerror(errno));
+	return SIGMET_IO_FAIL;
     }
-    if ( vol_p->sweep_hdr && shmdt(vol_p->sweep_hdr) == -1 ) {
-	fprintf(stderr, "%d: could not detach shared memory for "
-		"sweep headers.\n%s\n", getpid(), strerror(errno));
-	sig_stat = SIGMET_MEM_FAIL;
+    if ( sbuf.st_size < (off_t)sizeof(struct arena_hdr) ) {
+	fprintf(stderr, "%d: volume in %s is not ready.\n", getpid(), nm);
+	return SIGMET_BAD_VOL;
     }
-    vol_p->sweep_hdr = NULL;
-    if ( vol_p->ray_hdr && shmdt(vol_p->ray_hdr) == -1 ) {
-	fprintf(stderr, "%d: could not detach shared memory for "
-		"ray headers.\n%s\n", getpid(), strerror(errno));
-	sig_stat = SIGMET_MEM_FAIL;
+    arena = mmap(NULL, (size_t)sbuf.st_size, PROT_READ | PROT_WRITE,
+	    MAP_PRIVATE, fd, 0);
+    if ( arena == MAP_FAILED ) {
+	fprintf(stderr, "%d: could not map %s.\n%s\n",
+		getpid(), nm, strerror(errno));
+	return SIGMET_MEM_FAIL;
+    }
+    Sigmet_Vol_Init(vol_p);
+    vol_p->arena = arena;
+    vol_p->arena_sz = (size_t)sbuf.st_size;
+
+    /*
+       Check that the arena is complete, and came from a compatible
+       writer.
+     */
+
+    hdr_p = (struct arena_hdr *)arena;
+    if ( memcmp(hdr_p->magic, ARENA_MAGIC, sizeof(ARENA_MAGIC)) != 0
+	    || hdr_p->version != ARENA_VERSION
+	    || hdr_p->vol_sz != sizeof(struct Sigmet_Vol)
+	    || hdr_p->dat_sz != sizeof(struct Sigmet_Dat)
+	    || hdr_p->sz != vol_p->arena_sz ) {
+	fprintf(stderr, "%d: %s does not have a complete volume from this "
+		"version of the Sigmet library.\n", getpid(), nm);
+	sig_stat = SIGMET_BAD_VOL;
+	goto error;
     }
+
+    /*
+       The header is intact, but offsets and dimensions could still be
+       damaged. Check every section against the size of the map before
+       touching it. Addresses in the volume struct are meaningless here,
+       so clear them before anything, including Sigmet_Vol_Free, can use
+       them.
+     */
+
+    if ( !arena_fits(hdr_p->sz, hdr_p->vol_off, 1,
+		sizeof(struct Sigmet_Vol)) ) {
+	goto corrupt;
+    }
+    *vol_p = *(struct Sigmet_Vol *)(arena + hdr_p->vol_off);
+    vol_p->sweep_hdr = NULL;
     vol_p->ray_hdr = NULL;
-    for (dat_p = vol_p->dat; dat_p < vol_p->dat + SIGMET_MAX_TYPES; dat_p++) {
+    vol_p->rec_map = NULL;
+    vol_p->rec_map_sz = 0;
+    vol_p->sweep_idx = NULL;
+    vol_p->dat = NULL;
+    vol_p->dat_max = 0;
+    vol_p->types_tbl = NULL;
+    vol_p->types_tbl_sz = 0;
+    vol_p->chunks = NULL;
+    vol_p->ingest = NULL;
+    vol_p->arena = arena;
+    vol_p->arena_sz = hdr_p->sz;
+    num_sweeps = vol_p->ih.tc.tni.num_sweeps;
+    num_rays = vol_p->ih.ic.num_rays;
+    num_bins = vol_p->ih.tc.tri.num_bins_out;
+    num_types = vol_p->num_types;
+    vol_p->num_types = 0;
+    if ( num_sweeps <= 0 || num_rays <= 0 || num_bins <= 0 || num_types < 0
+	    || vol_p->num_sweeps_ax < 0 || vol_p->num_sweeps_ax > num_sweeps
+	    || !arena_fits(hdr_p->sz, hdr_p->sweep_hdr_off, num_sweeps,
+		sizeof(struct Sigmet_Sweep_Hdr))
+	    || !arena_fits(hdr_p->sz, hdr_p->ray_hdr_off, num_sweeps,
+		num_rays * sizeof(struct Sigmet_Ray_Hdr))
+	    || !arena_fits(hdr_p->sz, hdr_p->dat_off, num_types,
+		sizeof(struct Sigmet_Dat))
+	    || !arena_fits(hdr_p->sz, hdr_p->vals_off, num_types,
+		sizeof(size_t)) ) {
+	goto corrupt;
+    }
+    dat_a = (struct Sigmet_Dat *)(arena + hdr_p->dat_off);
+    vals_off = (size_t *)(arena + hdr_p->vals_off);
+    for (y = 0; y < num_types; y++) {
+	struct Sigmet_Dat *dat_p = dat_a + y;
+	size_t elem_sz;			/* Size of one value */
+
 	switch (dat_p->stor_fmt) {
 	    case SIGMET_U1:
-		if ( dat_p->vals.u1 && shmdt(dat_p->vals.u1) == -1 ) {
-		    fprintf(stderr, "%d: could not detach shared memory "
-			    "for %s.\n%s\n",
-			    getpid(), dat_p->data_type_s, strerror(errno));
-		    sig_stat = SIGMET_MEM_FAIL;
-		}
-		dat_p->vals.u1 = NULL;
+		elem_sz = sizeof(U1BYT);
 		break;
 	    case SIGMET_U2:
-		if ( dat_p->vals.u2 && shmdt(dat_p->vals.u2) == -1 ) {
-		    fprintf(stderr, "%d: could not detach shared memory "
-			    "for %s.\n%s\n",
-			    getpid(), dat_p->data_type_s, strerror(errno));
-		    sig_stat = SIGMET_MEM_FAIL;
-		}
-		dat_p->vals.u2 = NULL;
+	    case SIGMET_F16:
+		elem_sz = sizeof(U2BYT);
 		break;
 	    case SIGMET_FLT:
-		if ( dat_p->vals.f && shmdt(dat_p->vals.f) == -1 ) {
-		    fprintf(stderr, "%d: could not detach shared memory "
-			    "for %s.\n%s\n",
-			    getpid(), dat_p->data_type_s, strerror(errno));
-		    sig_stat = SIGMET_MEM_FAIL;
-		}
-		dat_p->vals.f = NULL;
+		elem_sz = sizeof(float);
 		break;
 	    case SIGMET_DBL:
 	    case SIGMET_MT:
-		break;
+	    default:
+		goto corrupt;
 	}
+	if ( !memchr(dat_p->data_type_s, '\0', sizeof(dat_p->data_type_s))
+		|| !memchr(dat_p->descr, '\0', sizeof(dat_p->descr))
+		|| !memchr(dat_p->unit, '\0', sizeof(dat_p->unit))
+		|| (!fld_derived(dat_p)
+		    && (dat_p->sig_type < 0 || dat_p->sig_type >= SIGMET_NTYPES))
+		|| !arena_fits(hdr_p->sz, vals_off[y],
+		    (size_t)num_sweeps * num_rays, num_bins * elem_sz)
+		|| dat_p->ray_stride != (size_t)num_bins
+		|| dat_p->sweep_stride != (size_t)num_rays * num_bins
+		|| dat_p->vals_sz
+		!= (size_t)num_sweeps * num_rays * num_bins * elem_sz ) {
+	    goto corrupt;
+	}
+    }
+
+    /*
+       Sweep headers and field values are used in place. Ray headers need
+       a row address for each sweep. The data array structs go in process
+       memory, so that fields can still be added and removed.
+     */
+
+    vol_p->sweep_hdr = (struct Sigmet_Sweep_Hdr *)(arena
+	    + hdr_p->sweep_hdr_off);
+    vol_p->ray_hdr = (struct Sigmet_Ray_Hdr **)vol_pool_alloc(vol_p,
+	    num_sweeps * sizeof(struct Sigmet_Ray_Hdr *));
+    if ( !vol_p->ray_hdr ) {
+	fprintf(stderr, "%d: could not allocate ray header rows for volume "
+		"in %s.\n", getpid(), nm);
+	sig_stat = SIGMET_MEM_FAIL;
+	goto error;
+    }
+    vol_p->ray_hdr[0] = (struct Sigmet_Ray_Hdr *)(arena + hdr_p->ray_hdr_off);
+    for (s = 1; s < num_sweeps; s++) {
+	vol_p->ray_hdr[s] = vol_p->ray_hdr[s - 1] + num_rays;
+    }
+    if ( !fld_reserve(vol_p, num_types) ) {
+	sig_stat = SIGMET_MEM_FAIL;
+	goto error;
+    }
+    for (y = 0; y < num_types; y++) {
+	struct Sigmet_Dat *dat_p = vol_p->dat + y;
+
+	*dat_p = dat_a[y];
+	dat_p->vals.u1 = (U1BYT *)(arena + vals_off[y]);
+	dat_p->lut = NULL;
+	dat_p->stor_to_comp = fld_derived(dat_p)
+	    ? Sigmet_DblDbl : Sigmet_DataType_StorToComp(dat_p->sig_type);
+	vol_p->num_types++;
     }
+    fld_tbl_fill(vol_p);
+    return SIGMET_OK;
+
+corrupt:
+    fprintf(stderr, "%d: volume in %s is corrupt.\n", getpid(), nm);
+    sig_stat = SIGMET_BAD_VOL;
+error:
+    Sigmet_Vol_Free(vol_p);
     return sig_stat;
 }
 
 /*
- * hash - return a random index h, 0 < h < SIGMET_MAX_TYPES, for key k.
- *
- * Reference:
- *   Kernighan, Brian W. and Rob Pike.
- *   The Practice of Programming.
- *   Reading, Massachusetts. 1999
+   Copy vol_p to a new shared memory arena named nm. An earlier arena with
+   the same name is removed. Processes already attached to it keep their
+   view of it. The arena stays in the system until Sigmet_Vol_ShmUnlink
+   removes it.
  */
 
-static unsigned hash(const char *k)
+enum SigmetStatus Sigmet_Vol_ShmPublish(struct Sigmet_Vol *vol_p,
+	const char *nm)
 {
-    unsigned h;
-    unsigned hash_x =  31;
+    struct arena_hdr hdr;		/* Goes at start of arena */
+    int fd;
+    enum SigmetStatus sig_stat;
 
-    for (h = 0; *k != '\0'; k++) {
-	h = hash_x * h + (unsigned)*k;
+    if ( !vol_p || !nm ) {
+	return SIGMET_BAD_ARG;
+    }
+    if ( shm_unlink(nm) == -1 && errno != ENOENT ) {
+	fprintf(stderr, "%d: could not remove old shared memory volume %s.\n"
+		"%s\n", getpid(), nm, strerror(errno));
+	return SIGMET_MEM_FAIL;
     }
-    return h % SIGMET_MAX_TYPES;
+    fd = shm_open(nm, O_RDWR | O_CREAT | O_EXCL,
+	    S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    if ( fd == -1 ) {
+	fprintf(stderr, "%d: could not create shared memory volume %s.\n%s\n",
+		getpid(), nm, strerror(errno));
+	return SIGMET_MEM_FAIL;
+    }
+    memset(&hdr, 0, sizeof(hdr));
+    sig_stat = arena_write(vol_p, fd, nm, &hdr);
+    close(fd);
+    if ( sig_stat != SIGMET_OK ) {
+	shm_unlink(nm);
+    }
+    return sig_stat;
 }
 
 /*
-   Make an entry in vol_p->types_tbl for abbreviation data_type pointing to 
-   element y of vol_p->dat.
+   Attach vol_p, which should be initialized with Sigmet_Vol_Init, to the
+   shared memory arena named nm.
  */
 
-static void hash_add(struct Sigmet_Vol *vol_p, char *data_type_s, int y)
+enum SigmetStatus Sigmet_Vol_ShmAttach(const char *nm, struct Sigmet_Vol *vol_p)
 {
-    unsigned h;
+    int fd;
+    enum SigmetStatus sig_stat;
 
-    for (h = hash(data_type_s);
-	    strlen(vol_p->types_tbl[h].data_type_s) != 0;
-	    h = (h + 1) % SIGMET_MAX_TYPES) {
+    if ( !nm || !vol_p ) {
+	return SIGMET_BAD_ARG;
+    }
+    if ( (fd = shm_open(nm, O_RDONLY, 0)) == -1 ) {
+	fprintf(stderr, "%d: could not open shared memory volume %s.\n%s\n",
+		getpid(), nm, strerror(errno));
+	return SIGMET_IO_FAIL;
     }
-    strncpy(vol_p->types_tbl[h].data_type_s, data_type_s, SIGMET_NAME_LEN - 1);
-    vol_p->types_tbl[h].y = y;
+    sig_stat = arena_attach(fd, nm, vol_p);
+    close(fd);
+    return sig_stat;
+}
+
+/*
+   Remove the arena named nm from the system. Processes attached to it
+   keep it until they detach.
+ */
+
+enum SigmetStatus Sigmet_Vol_ShmUnlink(const char *nm)
+{
+    if ( !nm ) {
+	return SIGMET_BAD_ARG;
+    }
+    if ( shm_unlink(nm) == -1 ) {
+	fprintf(stderr, "%d: could not remove shared memory volume %s.\n%s\n",
+		getpid(), nm, strerror(errno));
+	return SIGMET_IO_FAIL;
+    }
+    return SIGMET_OK;
+}
+
+/*
+   Store the device, inode, size, modification time to the nanosecond,
+   and a fingerprint of the first two records and the last record of raw
+   product file vol_nm in the key members of hdr_p. The headers alone
+   often repeat when a volume is ingested again, but the last record
+   holds the end of the data. The fingerprint is FNV-1a, 64 bit, of the
+   bytes as stored, so compressed files are not decompressed. Return true
+   on success.
+ */
+
+static int arena_key(const char *vol_nm, struct arena_hdr *hdr_p)
+{
+    struct stat sbuf;
+    int fd;
+    unsigned char buf[3 * REC_LEN];
+    ssize_t n0, n1;			/* Bytes from start and end of file */
+    off_t off1;				/* Offset of last record */
+    size_t i;
+    unsigned long long h;
+
+    if ( (fd = open(vol_nm, O_RDONLY)) == -1 ) {
+	fprintf(stderr, "%d: could not open %s.\n%s\n",
+		getpid(), vol_nm, strerror(errno));
+	return 0;
+    }
+    if ( fstat(fd, &sbuf) == -1 ) {
+	fprintf(stderr, "%d: could not get information about %s.\n%s\n",
+		getpid(), vol_nm, strerror(errno));
+	close(fd);
+	return 0;
+    }
+    n0 = pread(fd, buf, 2 * REC_LEN, 0);
+    off1 = (sbuf.st_size > 3 * REC_LEN)
+	? sbuf.st_size - REC_LEN : 2 * REC_LEN;
+    n1 = pread(fd, buf + 2 * REC_LEN, REC_LEN, off1);
+    close(fd);
+    if ( n0 == -1 || n1 == -1 ) {
+	fprintf(stderr, "%d: could not read %s.\n%s\n",
+		getpid(), vol_nm, strerror(errno));
+	return 0;
+    }
+    for (h = 14695981039346656037ULL, i = 0; i < (size_t)n0; i++) {
+	h = (h ^ buf[i]) * 1099511628211ULL;
+    }
+    for (i = 2 * REC_LEN; i < 2 * REC_LEN + (size_t)n1; i++) {
+	h = (h ^ buf[i]) * 1099511628211ULL;
+    }
+    hdr_p->src_dev = sbuf.st_dev;
+    hdr_p->src_ino = sbuf.st_ino;
+    hdr_p->src_sz = sbuf.st_size;
+    hdr_p->src_mtime = sbuf.st_mtim.tv_sec;
+    hdr_p->src_mtime_ns = sbuf.st_mtim.tv_nsec;
+    hdr_p->src_fp = h;
+    return 1;
+}
+
+/*
+   Write vol_p, read from raw product file vol_nm, to cache file
+   cache_nm. The file is written under a temporary name and renamed, so
+   processes that have mapped an earlier version keep it intact.
+ */
+
+enum SigmetStatus Sigmet_Vol_CacheWrite(struct Sigmet_Vol *vol_p,
+	const char *vol_nm, const char *cache_nm)
+{
+    struct arena_hdr hdr;		/* Goes at start of arena */
+    char *tmp_nm = NULL;		/* Temporary name for cache file */
+    size_t len;
+    int fd = -1;
+    enum SigmetStatus sig_stat;
+
+    if ( !vol_p || !vol_nm || !cache_nm ) {
+	return SIGMET_BAD_ARG;
+    }
+    memset(&hdr, 0, sizeof(hdr));
+    if ( !arena_key(vol_nm, &hdr) ) {
+	return SIGMET_IO_FAIL;
+    }
+    len = strlen(cache_nm) + sizeof(".XXXXXX");
+    if ( !(tmp_nm = MALLOC(len)) ) {
+	fprintf(stderr, "%d: could not allocate name for cache file.\n",
+		getpid());
+	return SIGMET_MEM_FAIL;
+    }
+    snprintf(tmp_nm, len, "%s.XXXXXX", cache_nm);
+    if ( (fd = mkstemp(tmp_nm)) == -1 ) {
+	fprintf(stderr, "%d: could not create temporary file for cache "
+		"%s.\n%s\n", getpid(), cache_nm, strerror(errno));
+	FREE(tmp_nm);
+	return SIGMET_IO_FAIL;
+    }
+    fchmod(fd, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    if ( (sig_stat = arena_write(vol_p, fd, tmp_nm, &hdr)) != SIGMET_OK ) {
+	goto error;
+    }
+    if ( close(fd) == -1 ) {
+	fd = -1;
+	fprintf(stderr, "%d: could not write cache %s.\n%s\n",
+		getpid(), tmp_nm, strerror(errno));
+	sig_stat = SIGMET_IO_FAIL;
+	goto error;
+    }
+    fd = -1;
+    if ( rename(tmp_nm, cache_nm) == -1 ) {
+	fprintf(stderr, "%d: could not rename %s to %s.\n%s\n",
+		getpid(), tmp_nm, cache_nm, strerror(errno));
+	sig_stat = SIGMET_IO_FAIL;
+	goto error;
+    }
+    FREE(tmp_nm);
+    return SIGMET_OK;
+
+error:
+    if ( fd != -1 ) {
+	close(fd);
+    }
+    unlink(tmp_nm);
+    FREE(tmp_nm);
+    return sig_stat;
+}
+
+/*
+   If cache file cache_nm has raw product file vol_nm, as it is now,
+   decoded with the types and sweeps that filt_p selects, attach vol_p,
+   which should be initialized with Sigmet_Vol_Init, to it and return
+   SIGMET_OK. If filt_p is NULL, the cache must have every type and sweep.
+   If the cache is missing or stale, return SIGMET_BAD_FILE quietly, and
+   leave vol_p empty.
+ */
+
+enum SigmetStatus Sigmet_Vol_CacheRead(const char *vol_nm,
+	struct Sigmet_Vol_Filter *filt_p, const char *cache_nm,
+	struct Sigmet_Vol *vol_p)
+{
+    struct Sigmet_Vol_Filter filter;	/* Filter for volume to read */
+    struct arena_hdr hdr, key;
+    int fd;
+    enum SigmetStatus sig_stat;
+
+    if ( !vol_nm || !cache_nm || !vol_p ) {
+	return SIGMET_BAD_ARG;
+    }
+    if ( filt_p ) {
+	filter = *filt_p;
+    } else {
+	Sigmet_Vol_FilterInit(&filter);
+    }
+
+    /*
+       Compare keys before mapping anything.
+     */
+
+    if ( (fd = open(cache_nm, O_RDONLY)) == -1 ) {
+	if ( errno == ENOENT ) {
+	    return SIGMET_BAD_FILE;
+	}
+	fprintf(stderr, "%d: could not open cache %s.\n%s\n",
+		getpid(), cache_nm, strerror(errno));
+	return SIGMET_IO_FAIL;
+    }
+    memset(&key, 0, sizeof(key));
+    if ( pread(fd, &hdr, sizeof(hdr), 0) != (ssize_t)sizeof(hdr)
+	    || memcmp(hdr.magic, ARENA_MAGIC, sizeof(ARENA_MAGIC)) != 0
+	    || hdr.version != ARENA_VERSION
+	    || !arena_key(vol_nm, &key)
+	    || hdr.src_dev != key.src_dev
+	    || hdr.src_ino != key.src_ino
+	    || hdr.src_sz != key.src_sz
+	    || hdr.src_mtime != key.src_mtime
+	    || hdr.src_mtime_ns != key.src_mtime_ns
+	    || hdr.src_fp != key.src_fp ) {
+	close(fd);
+	return SIGMET_BAD_FILE;
+    }
+    sig_stat = arena_attach(fd, cache_nm, vol_p);
+    close(fd);
+    if ( sig_stat != SIGMET_OK ) {
+	return sig_stat;
+    }
+    if ( memcmp(vol_p->filter.types, filter.types, sizeof(filter.types)) != 0
+	    || memcmp(vol_p->filter.sweeps, filter.sweeps,
+		sizeof(filter.sweeps)) != 0 ) {
+	Sigmet_Vol_Free(vol_p);
+	return SIGMET_BAD_FILE;
+    }
+    vol_p->filter.num_threads = filter.num_threads;
+    return SIGMET_OK;
+}
+
+/*
+ * hash - return a random value h for key k. Reduce it modulo the table
+ * size.
+ *
+ * Reference:
+ *   Kernighan, Brian W. and Rob Pike.
+ *   The Practice of Programming.
+ *   Reading, Massachusetts. 1999
+ */
+
+static unsigned hash(const char *k)
+{
+    unsigned h;
+    unsigned hash_x =  31;
+
+    for (h = 0; *k != '\0'; k++) {
+	h = hash_x * h + (unsigned)*k;
+    }
+    return h;
+}
+
+/*
+   Make sure vol_p->dat has room for n data arrays, and that the look up
+   table is big enough for them. New elements of dat are empty. Return
+   true on success.
+ */
+
+static int fld_reserve(struct Sigmet_Vol *vol_p, int n)
+{
+    struct Sigmet_Dat *dat, *dat_p;
+    int dat_max;
+    int *tbl;
+    unsigned tbl_sz;
+
+    if ( n <= vol_p->dat_max ) {
+	return 1;
+    }
+    for (dat_max = (vol_p->dat_max > 0) ? vol_p->dat_max : 8;
+	    dat_max < n;
+	    dat_max *= 2) {
+    }
+    for (tbl_sz = 16; tbl_sz < 2 * (unsigned)dat_max; tbl_sz *= 2) {
+    }
+    if ( !(dat = REALLOC(vol_p->dat, dat_max * sizeof(struct Sigmet_Dat))) ) {
+	fprintf(stderr, "%d: could not allocate space for %d data arrays.\n",
+		getpid(), dat_max);
+	return 0;
+    }
+    vol_p->dat = dat;
+    for (dat_p = dat + vol_p->dat_max; dat_p < dat + dat_max; dat_p++) {
+	memset(dat_p, 0, sizeof(struct Sigmet_Dat));
+	dat_p->stor_fmt = SIGMET_MT;
+	dat_p->stor_to_comp = Sigmet_DblDbl;
+    }
+    vol_p->dat_max = dat_max;
+    if ( tbl_sz > vol_p->types_tbl_sz ) {
+	if ( !(tbl = REALLOC(vol_p->types_tbl, tbl_sz * sizeof(int))) ) {
+	    fprintf(stderr, "%d: could not allocate look up table for data "
+		    "arrays.\n", getpid());
+	    return 0;
+	}
+	vol_p->types_tbl = tbl;
+	vol_p->types_tbl_sz = tbl_sz;
+	fld_tbl_fill(vol_p);
+    }
+    return 1;
+}
+
+/*
+   Rebuild the look up table in vol_p from the data types in vol_p->dat.
+ */
+
+static void fld_tbl_fill(struct Sigmet_Vol *vol_p)
+{
+    unsigned h;
+    int y;
+
+    for (h = 0; h < vol_p->types_tbl_sz; h++) {
+	vol_p->types_tbl[h] = -1;
+    }
+    for (y = 0; y < vol_p->num_types; y++) {
+	hash_add(vol_p, vol_p->dat[y].data_type_s, y);
+    }
+}
+
+/*
+   Make an entry in vol_p->types_tbl for abbreviation data_type pointing to 
+   element y of vol_p->dat. The table must have a free slot.
+ */
+
+static void hash_add(struct Sigmet_Vol *vol_p, char *data_type_s, int y)
+{
+    unsigned m = vol_p->types_tbl_sz - 1;
+    unsigned h;
+
+    for (h = hash(data_type_s) & m;
+	    vol_p->types_tbl[h] != -1;
+	    h = (h + 1) & m) {
+    }
+    vol_p->types_tbl[h] = y;
 }
 
 /*
@@ -550,25 +1382,23 @@ static void hash_add(struct Sigmet_Vol *vol_p, char *data_type_s, int y)
 int Sigmet_Vol_GetFld(struct Sigmet_Vol *vol_p, char *data_type_s,
 	struct Sigmet_Dat **dat_pp)
 {
-    unsigned h, h0;
+    unsigned h, m;
     int y;
 
-    if ( !vol_p || !data_type_s ) {
+    if ( !vol_p || !data_type_s || vol_p->types_tbl_sz == 0 ) {
 	return -1;
     }
-    h0 = hash(data_type_s);
-    if ( strcmp(vol_p->types_tbl[h0].data_type_s, data_type_s) == 0 ) {
-	y = vol_p->types_tbl[h0].y;
-	if ( dat_pp ) {
-	    *dat_pp = vol_p->dat + y;
-	}
-	return y;
-    }
-    for (h = (h0 + 1) % SIGMET_MAX_TYPES;
-	    h != h0;
-	    h = (h + 1) % SIGMET_MAX_TYPES) {
-	if ( strcmp(vol_p->types_tbl[h].data_type_s, data_type_s) == 0 ) {
-	    y = vol_p->types_tbl[h].y;
+
+    /*
+       The table is never more than half full, so the search stops at an
+       empty slot.
+     */
+
+    m = vol_p->types_tbl_sz - 1;
+    for (h = hash(data_type_s) & m;
+	    (y = vol_p->types_tbl[h]) != -1;
+	    h = (h + 1) & m) {
+	if ( strcmp(vol_p->dat[y].data_type_s, data_type_s) == 0 ) {
 	    if ( dat_pp ) {
 		*dat_pp = vol_p->dat + y;
 	    }
@@ -578,6 +1408,35 @@ int Sigmet_Vol_GetFld(struct Sigmet_Vol *vol_p, char *data_type_s,
     return -1;
 }
 
+/*
+   Remove from the dat array of vol_p the data types that vol_p->filter
+   does not select, and rebuild the look up table. types_fl still lists
+   every type in the raw product file, so that the reader can step over
+   the types that are not loaded.
+ */
+
+static void vol_filter_types(struct Sigmet_Vol *vol_p)
+{
+    int y, y1;
+
+    for (y = y1 = 0; y < vol_p->num_types; y++) {
+	if ( vol_p->filter.types[vol_p->dat[y].sig_type] ) {
+	    if ( y1 != y ) {
+		vol_p->dat[y1] = vol_p->dat[y];
+	    }
+	    y1++;
+	}
+    }
+    vol_p->size -= (vol_p->num_types - y1) * sizeof(struct Sigmet_Dat);
+    for (y = y1; y < vol_p->num_types; y++) {
+	memset(vol_p->dat + y, 0, sizeof(struct Sigmet_Dat));
+	vol_p->dat[y].stor_fmt = SIGMET_MT;
+	vol_p->dat[y].stor_to_comp = Sigmet_DblDbl;
+    }
+    vol_p->num_types = y1;
+    fld_tbl_fill(vol_p);
+}
+
 /*
    vol_p should point to a volume structure initialized with a call to
    Sigmet_Vol_Init.
@@ -585,7 +1444,57 @@ int Sigmet_Vol_GetFld(struct Sigmet_Vol *vol_p, char *data_type_s,
 
 enum SigmetStatus Sigmet_Vol_ReadHdr(FILE *f, struct Sigmet_Vol *vol_p)
 {
-    char rec[REC_LEN];			/* Input record from file */
+    char rec[2 * REC_LEN];		/* First two records from file */
+    int sig_stat;
+
+    if ( !f ) {
+	fprintf(stderr, "%d: read header function called with bogus "
+		"input stream.\n", getpid());
+	sig_stat = SIGMET_BAD_ARG;
+	goto error;
+    }
+    if ( !vol_p ) {
+	fprintf(stderr, "%d: read header function called with bogus volume.\n",
+		getpid());
+	sig_stat = SIGMET_BAD_ARG;
+	goto error;
+    }
+
+    /*
+       record 1, <product_header>
+     */
+
+    if (fread(rec, 1, REC_LEN, f) != REC_LEN) {
+	fprintf(stderr, "%d: could not read record 1 of Sigmet volume.\n",
+		getpid());
+	sig_stat = SIGMET_IO_FAIL;
+	goto error;
+    }
+
+    /*
+       record 2, <ingest_header>
+     */
+
+    if (fread(rec + REC_LEN, 1, REC_LEN, f) != REC_LEN) {
+	fprintf(stderr, "%d: could not read record 2 of Sigmet volume.\n",
+		getpid());
+	sig_stat = SIGMET_IO_FAIL;
+	goto error;
+    }
+    return Sigmet_Vol_DecodeHdr(rec, vol_p);
+
+error:
+    Sigmet_Vol_Free(vol_p);
+    return sig_stat;
+}
+
+/*
+   Store volume headers from rec, which must have the first two records,
+   i.e. 2 * SIGMET_REC_LEN bytes, of a raw product file, in vol_p.
+ */
+
+enum SigmetStatus Sigmet_Vol_DecodeHdr(char *rec, struct Sigmet_Vol *vol_p)
+{
     int sig_stat;
 
     /*
@@ -622,38 +1531,22 @@ enum SigmetStatus Sigmet_Vol_ReadHdr(FILE *f, struct Sigmet_Vol *vol_p)
     };
     unsigned vol_type_mask;
 
-    if ( !f ) {
-	fprintf(stderr, "%d: read header function called with bogus "
-		"input stream.\n", getpid());
-	sig_stat = SIGMET_BAD_ARG;
-	goto error;
-    }
-    if ( !vol_p ) {
-	fprintf(stderr, "%d: read header function called with bogus volume.\n",
-		getpid());
+    if ( !rec || !vol_p ) {
+	fprintf(stderr, "%d: decode header function called with bogus "
+		"arguments.\n", getpid());
 	sig_stat = SIGMET_BAD_ARG;
 	goto error;
     }
 
-    /*
-       record 1, <product_header>
-     */
-
-    if (fread(rec, 1, REC_LEN, f) != REC_LEN) {
-	fprintf(stderr, "%d: could not read record 1 of Sigmet volume.\n",
-		getpid());
-	sig_stat = SIGMET_IO_FAIL;
-	goto error;
-    }
-
     /*
        If first 16 bits of product header != 27, turn on byte swapping
        and check again. If still not 27, give up.
      */
 
-    if (get_sint16(rec) != 27) {
-	Toggle_Swap();
-	if (get_sint16(rec) != 27) {
+    vol_p->swap = 0;
+    if (get_sint16(rec, vol_p->swap) != 27) {
+	vol_p->swap = 1;
+	if (get_sint16(rec, vol_p->swap) != 27) {
 	    fprintf(stderr,  "%d: bad magic number (should be 27).\n",
 		    getpid());
 	    sig_stat = SIGMET_BAD_FILE;
@@ -661,19 +1554,9 @@ enum SigmetStatus Sigmet_Vol_ReadHdr(FILE *f, struct Sigmet_Vol *vol_p)
 	}
     }
 
-    vol_p->ph = get_product_hdr(rec);
-
-    /*
-       record 2, <ingest_header>
-     */
-
-    if (fread(rec, 1, REC_LEN, f) != REC_LEN) {
-	fprintf(stderr, "%d: could not read record 2 of Sigmet volume.\n",
-		getpid());
-	sig_stat = SIGMET_IO_FAIL;
-	goto error;
-    }
-    vol_p->ih = get_ingest_header(rec);
+    vol_p->ph = get_product_hdr(rec, vol_p->swap);
+    rec += REC_LEN;
+    vol_p->ih = get_ingest_header(rec, vol_p->swap);
 
     /*
        Loop through the bits in the data type mask. 
@@ -684,6 +1567,18 @@ enum SigmetStatus Sigmet_Vol_ReadHdr(FILE *f, struct Sigmet_Vol *vol_p)
     if (vol_type_mask & type_mask_bit[DB_XHDR]) {
 	vol_p->xhdr = 1;
     }
+    for (sig_type = 0, y = 0; sig_type < SIGMET_NTYPES; sig_type++) {
+	if ( (vol_type_mask & type_mask_bit[sig_type])
+		&& Sigmet_DataType_StorFmt(sig_type) != SIGMET_MT ) {
+	    y++;
+	}
+    }
+    if ( !fld_reserve(vol_p, y) ) {
+	sig_stat = SIGMET_MEM_FAIL;
+	goto error;
+    }
+    vol_p->num_types = 0;
+    fld_tbl_fill(vol_p);
     for (sig_type = 0, yf = y = 0; sig_type < SIGMET_NTYPES; sig_type++) {
 	if (vol_type_mask & type_mask_bit[sig_type]) {
 	    data_type_s = Sigmet_DataType_Abbrv(sig_type);
@@ -720,6 +1615,7 @@ enum SigmetStatus Sigmet_Vol_ReadHdr(FILE *f, struct Sigmet_Vol *vol_p)
 		    y++;
 		    break;
 		case SIGMET_FLT:
+		case SIGMET_F16:
 		case SIGMET_DBL:
 		    fprintf(stderr, "%d: volume in memory is corrupt. Unknown "
 			    "data type in data array.", getpid());
@@ -732,6 +1628,7 @@ enum SigmetStatus Sigmet_Vol_ReadHdr(FILE *f, struct Sigmet_Vol *vol_p)
 	}
     }
     vol_p->num_types = y;
+    vol_p->num_types_fl = yf;
     vol_p->size += vol_p->num_types * sizeof(struct Sigmet_Dat);
     vol_p->has_headers = 1;
     return SIGMET_OK;
@@ -871,6 +1768,7 @@ int Sigmet_Vol_NumTypes(struct Sigmet_Vol *vol_p)
 
 int Sigmet_Vol_NumSweeps(struct Sigmet_Vol *vol_p)
 {
+    ingest_wait(vol_p, -2);
     return vol_p ? vol_p->num_sweeps_ax : -1;
 }
 
@@ -893,6 +1791,7 @@ int Sigmet_Vol_NumBins(struct Sigmet_Vol *vol_p, int s, int r)
 	fprintf(stderr, "Sweep index %d out of range.\n", s);
 	return -1;
     }
+    sweep_ready(vol_p, s);
     if ( r == -1 ) {
 	int num_bins;
 
@@ -924,6 +1823,7 @@ enum SigmetStatus Sigmet_Vol_SweepHdr(struct Sigmet_Vol *vol_p, int s,
     if ( s >= vol_p->num_sweeps_ax ) {
 	return SIGMET_RNG_ERR;
     }
+    ingest_wait(vol_p, s);
     if ( vol_p->sweep_hdr[s].ok ) {
 	if ( ok_p ) {
 	    *ok_p = 1;
@@ -958,6 +1858,7 @@ enum SigmetStatus Sigmet_Vol_RayHdr(struct Sigmet_Vol *vol_p, int s, int r,
     if ( s >= vol_p->num_sweeps_ax || r >= vol_p->ih.ic.num_rays ) {
 	return SIGMET_RNG_ERR;
     }
+    sweep_ready(vol_p, s);
     if ( vol_p->sweep_hdr[s].ok && vol_p->ray_hdr[s][r].ok ) {
 	if ( ok_p ) {
 	    *ok_p = 1;
@@ -1018,16 +1919,98 @@ int Sigmet_Vol_IsRHI(struct Sigmet_Vol *vol_p)
     return vol_p && (vol_p->ih.tc.tni.scan_mode == RHI);
 }
 
-static enum SigmetStatus vol_good(FILE *f)
+/*
+   Set up src_p to provide the data records remaining in stream f.
+   If f is a regular file, map it into memory so that records can be
+   decoded where they sit. Otherwise, records will be copied into
+   src_p->buf with fread.
+ */
+
+static void rec_src_init(struct rec_src *src_p, FILE *f)
 {
-    struct Sigmet_Vol vol;
-    char rec[REC_LEN];			/* Input record from file */
-    char *rec_p;			/* Pointer into rec */
-    char *rec_e = rec + REC_LEN;	/* End rec */
-    int num_types_fl;
-    int num_types;
-    static unsigned type_mask_bit[SIGMET_NTYPES] = {
-	(1 <<  0), (1 <<  1), (1 <<  2), (1 <<  3), (1 <<  4),
+    struct stat sbuf;			/* Information about f */
+    off_t off;				/* Current offset in f */
+    size_t sz;				/* Size of f */
+    void *map;				/* Return from mmap */
+
+    src_p->f = f;
+    src_p->map = src_p->map_p = src_p->map_e = NULL;
+    src_p->map_sz = 0;
+    if ( fstat(fileno(f), &sbuf) == -1 || !S_ISREG(sbuf.st_mode)
+	    || (off = ftello(f)) == -1 || off >= sbuf.st_size ) {
+	return;
+    }
+    sz = (size_t)sbuf.st_size;
+    if ( (off_t)sz != sbuf.st_size ) {
+	return;
+    }
+    map = mmap(NULL, sz, PROT_READ, MAP_SHARED, fileno(f), 0);
+    if ( map == MAP_FAILED ) {
+	return;
+    }
+    posix_madvise(map, sz, POSIX_MADV_SEQUENTIAL);
+    src_p->map = (U1BYT *)map;
+    src_p->map_sz = sz;
+    src_p->map_p = src_p->map + off;
+    src_p->map_e = src_p->map_p + (sz - off) / REC_LEN * REC_LEN;
+}
+
+/*
+   Return the next record from src_p, or NULL if there are no more.
+   The record remains valid until the next call.
+ */
+
+static U1BYT *rec_src_next(struct rec_src *src_p)
+{
+    U1BYT *rec;
+
+    if ( src_p->map ) {
+	if ( src_p->map_p >= src_p->map_e ) {
+	    return NULL;
+	}
+	rec = src_p->map_p;
+	src_p->map_p += REC_LEN;
+	return rec;
+    }
+    return (fread(src_p->buf, 1, REC_LEN, src_p->f) == REC_LEN)
+	? src_p->buf : NULL;
+}
+
+/*
+   Return true if src_p has no more records.
+ */
+
+static int rec_src_eof(struct rec_src *src_p)
+{
+    return src_p->map ? src_p->map_p >= src_p->map_e : feof(src_p->f);
+}
+
+/*
+   Release the memory map, if any, and leave the input stream positioned
+   after the last record consumed.
+ */
+
+static void rec_src_close(struct rec_src *src_p)
+{
+    if ( src_p->map ) {
+	fseeko(src_p->f, (off_t)(src_p->map_p - src_p->map), SEEK_SET);
+	munmap(src_p->map, src_p->map_sz);
+	src_p->map = src_p->map_p = src_p->map_e = NULL;
+    }
+}
+
+static enum SigmetStatus vol_good(FILE *f)
+{
+    struct Sigmet_Vol vol;
+    char hdr_rec[REC_LEN];		/* Header record from file */
+    struct rec_src src;			/* Provide data records */
+    U1BYT *rec;				/* Current data record */
+    U1BYT *rec_p;			/* Pointer into rec */
+    U1BYT *rec_e;			/* End rec */
+    int num_types_fl;
+    int num_types;
+    static unsigned type_mask_bit[SIGMET_NTYPES] = {
+	(1 <<  0), (1 <<  1), (1 <<  2), (1 <<  3), (1 <<  4),
 	(1 <<  5), (1 <<  7), (1 <<  8), (1 <<  9), (1 << 10),
 	(1 << 11), (1 << 12), (1 << 13), (1 << 14), (1 << 15),
 	(1 << 16), (1 << 17), (1 << 18), (1 << 19), (1 << 20),
@@ -1047,6 +2030,8 @@ static enum SigmetStatus vol_good(FILE *f)
     int i, n;				/* Temporary values */
     U2BYT cc;				/* Compression code to navigate ray
 					   segment in rec */
+    int swap = 0;			/* If true, swap bytes from f */
+    enum SigmetStatus sig_stat;
 
     if ( !f ) {
 	return SIGMET_BAD_FILE;
@@ -1062,12 +2047,12 @@ static enum SigmetStatus vol_good(FILE *f)
        and check again. If still not 27, give up.
      */
 
-    if (fread(rec, 1, REC_LEN, f) != REC_LEN) {
+    if (fread(hdr_rec, 1, REC_LEN, f) != REC_LEN) {
 	return SIGMET_IO_FAIL;
     }
-    if (get_sint16(rec) != 27) {
-	Toggle_Swap();
-	if (get_sint16(rec) != 27) {
+    if (get_sint16(hdr_rec, swap) != 27) {
+	swap = 1;
+	if (get_sint16(hdr_rec, swap) != 27) {
 	    return SIGMET_BAD_FILE;
 	}
     }
@@ -1076,10 +2061,10 @@ static enum SigmetStatus vol_good(FILE *f)
        record 2, <ingest_header>
      */
 
-    if (fread(rec, 1, REC_LEN, f) != REC_LEN) {
+    if (fread(hdr_rec, 1, REC_LEN, f) != REC_LEN) {
 	return SIGMET_IO_FAIL;
     }
-    vol.ih = get_ingest_header(rec);
+    vol.ih = get_ingest_header(hdr_rec, swap);
 
     /*
        Obtain number of data types in volume from data type mask. 
@@ -1112,18 +2097,22 @@ static enum SigmetStatus vol_good(FILE *f)
        Process data records.
      */
 
+    rec_src_init(&src, f);
     rec_idx = 1;
     sweep_num = 0;
-    while (fread(rec, 1, REC_LEN, f) == REC_LEN) {
+    sig_stat = SIGMET_OK;
+    while ( (rec = rec_src_next(&src)) ) {
 
 	/*
 	   Get record number and sweep number from <raw_prod_bhdr>.
 	 */
 
-	i = get_sint16(rec);
-	n = get_sint16(rec + 2);
+	rec_e = rec + REC_LEN;
+	i = get_sint16(rec, swap);
+	n = get_sint16(rec + 2, swap);
 	if (i != rec_idx + 1) {
-	    return SIGMET_BAD_FILE;
+	    sig_stat = SIGMET_BAD_FILE;
+	    goto done;
 	}
 	rec_idx = i;
 	if (n != sweep_num) {
@@ -1133,7 +2122,8 @@ static enum SigmetStatus vol_good(FILE *f)
 
 	    sweep_num = n;
 	    if (sweep_num > num_sweeps) {
-		return SIGMET_BAD_FILE;
+		sig_stat = SIGMET_BAD_FILE;
+		goto done;
 	    }
 	    s = sweep_num - 1;
 	    r = 0;
@@ -1143,7 +2133,7 @@ static enum SigmetStatus vol_good(FILE *f)
 	       there are no more sweeps in volume.
 	     */
 
-	    n = get_sint16(rec + 36);
+	    n = get_sint16(rec + 36, swap);
 	    if (n == 0) {
 		break;
 	    }
@@ -1152,14 +2142,15 @@ static enum SigmetStatus vol_good(FILE *f)
 	       Check sweep time and angle (from first <ingest_data_header>).
 	     */
 
-	    sec = get_sint32(rec + 24);
-	    msec = get_uint16(rec + 28);
+	    sec = get_sint32(rec + 24, swap);
+	    msec = get_uint16(rec + 28, swap);
 	    msec &= 0x3ff;
-	    year = get_sint16(rec + 30);
-	    month = get_sint16(rec + 32);
-	    day = get_sint16(rec + 34);
+	    year = get_sint16(rec + 30, swap);
+	    month = get_sint16(rec + 32, swap);
+	    day = get_sint16(rec + 34, swap);
 	    if (year == 0 || month == 0 || day == 0 || sec < 0 || msec > 1000) {
-		return SIGMET_BAD_FILE;
+		sig_stat = SIGMET_BAD_FILE;
+		goto done;
 	    }
 	    rec_p = rec + SZ_RAW_PROD_BHDR + num_types_fl * SZ_INGEST_DATA_HDR;
 	    yf = 0;
@@ -1178,7 +2169,7 @@ static enum SigmetStatus vol_good(FILE *f)
 
 	while (rec_p < rec_e) {
 
-	    cc = get_uint16(rec_p);
+	    cc = get_uint16(rec_p, swap);
 	    if ( (0x8000 & cc) == 0x8000 ) {
 		/*
 		   Run of data words
@@ -1189,15 +2180,18 @@ static enum SigmetStatus vol_good(FILE *f)
 		    if ( rec_p == rec_e ) {
 			/*
 			   Data run crosses record boundary.  
-			   Read the next record.
+			   Get the next record.
 			 */
 
-			if (fread(rec, 1, REC_LEN, f) != REC_LEN) {
-			    return SIGMET_BAD_FILE;
+			if ( !(rec = rec_src_next(&src)) ) {
+			    sig_stat = SIGMET_BAD_FILE;
+			    goto done;
 			}
-			i = get_sint16(rec);
+			rec_e = rec + REC_LEN;
+			i = get_sint16(rec, swap);
 			if (i != rec_idx + 1) {
-			    return SIGMET_BAD_FILE;
+			    sig_stat = SIGMET_BAD_FILE;
+			    goto done;
 			}
 			rec_idx = i;
 			rec_p = rec + SZ_RAW_PROD_BHDR;
@@ -1213,10 +2207,12 @@ static enum SigmetStatus vol_good(FILE *f)
 		 */
 
 		if (s > num_sweeps) {
-		    return SIGMET_BAD_FILE;
+		    sig_stat = SIGMET_BAD_FILE;
+		    goto done;
 		}
 		if (r > num_rays) {
-		    return SIGMET_BAD_FILE;
+		    sig_stat = SIGMET_BAD_FILE;
+		    goto done;
 		}
 		if (++yf == num_types_fl) {
 		    r++;
@@ -1234,488 +2230,652 @@ static enum SigmetStatus vol_good(FILE *f)
 	}
     }
     if ( r + 1 < num_rays ) {
-	return SIGMET_BAD_FILE;
-    }
-    if ( !feof(f) ) {
-	return SIGMET_BAD_FILE;
+	sig_stat = SIGMET_BAD_FILE;
+    } else if ( !rec_src_eof(&src) ) {
+	sig_stat = SIGMET_BAD_FILE;
     }
-    return SIGMET_OK;
+
+done:
+    rec_src_close(&src);
+    return sig_stat;
 }
 
-enum SigmetStatus Sigmet_Vol_Read(FILE *f, struct Sigmet_Vol *vol_p)
+/*
+   Initialize a data record decoder for volume vol_p, which must have
+   headers and data arrays.
+ */
+
+static void dcdr_init(struct rec_dcdr *d, struct Sigmet_Vol *vol_p)
 {
-    int sig_stat;
+    int yf;
+
+    d->vol_p = vol_p;
+    d->swap = vol_p->swap;
+    d->u2_cpy = d->swap ? u2_cpy_swap : u2_cpy;
+    d->num_types_fl = vol_p->num_types_fl;
+    for (yf = 0; yf < d->num_types_fl; yf++) {
+	if ( vol_p->types_fl[yf] == DB_XHDR ) {
+	    d->y_fl[yf] = -1;
+	} else {
+	    d->y_fl[yf] = Sigmet_Vol_GetFld(vol_p,
+		    Sigmet_DataType_Abbrv(vol_p->types_fl[yf]), NULL);
+	}
+    }
+    d->skip = 0;
+    d->num_sweeps = vol_p->ih.tc.tni.num_sweeps;
+    d->num_rays = vol_p->ih.ic.num_rays;
+    d->num_bins = vol_p->ih.tc.tri.num_bins_out;
+    d->rec_idx = 1;
+    d->sweep_num = 0;
+    d->s = d->r = d->yf = 0;
+    d->swp_tm = 0.0;
+    d->run = 0;
+    d->w = 0;
+    d->max_wds = (SZ_RAY_HDR + vol_p->ih.ic.extended_ray_headers_sz
+	    + (d->num_types_fl - vol_p->xhdr) * 2 * d->num_bins) / 2;
+    d->u1 = NULL;
+    d->u2 = NULL;
+    d->xhdr_ray = 0;
+    d->ray = NULL;
+    d->ray_fn = NULL;
+    d->ray_arg = NULL;
+    d->stop = DCDR_GO;
+}
 
-    U1BYT rec[REC_LEN];			/* Input record from file */
-    U1BYT *rec_p;			/* Pointer into rec */
-    U1BYT *rec_e = rec + REC_LEN;	/* End rec */
-    int rec_idx;			/* Current record index (0 is first) */
-    int sweep_num;			/* Current sweep number (1 is first) */
+/*
+   Prepare decoder d for the ray identified by its current sweep, ray,
+   and type indeces.
+ */
 
-    int num_sweeps;			/* Number of sweeps in vol_p */
-    int num_types_fl;			/* Number of types in the file will be
-					 * one more than num_types if the volume
-					 * contains extended headers. */
-    int num_types;			/* Number of types in the volume */
-    unsigned num_rays;			/* Number of rays per sweep */
-    int num_bins;			/* Number of output bins */
+static enum SigmetStatus dcdr_ray_start(struct rec_dcdr *d)
+{
+    struct Sigmet_Vol *vol_p = d->vol_p;
+    int y;
 
-    int year, month, day;
-    double sec;
-    unsigned msec;
-    double swpTm = 0.0;
-    double angle;			/* Sweep angle */
+    d->w = 0;
+    d->u1 = NULL;
+    d->u2 = NULL;
+    d->xhdr_ray = 0;
+    memset(d->ray_hdr, 0, sizeof(d->ray_hdr));
+    memset(d->xhdr, 0, sizeof(d->xhdr));
+    if ( vol_p->types_fl[d->yf] == DB_XHDR ) {
+	d->xhdr_ray = 1;
+	return SIGMET_OK;
+    }
+    if ( d->skip || d->r >= d->num_rays || (y = d->y_fl[d->yf]) == -1 ) {
+	return SIGMET_OK;
+    }
+    switch (vol_p->dat[y].stor_fmt) {
+	case SIGMET_U1:
+	    d->u1 = d->ray ? d->ray->vals[y].u1
+		: SIGMET_DAT_U1(vol_p->dat + y, d->s, d->r);
+	    break;
+	case SIGMET_U2:
+	    d->u2 = d->ray ? d->ray->vals[y].u2
+		: SIGMET_DAT_U2(vol_p->dat + y, d->s, d->r);
+	    break;
+	default:
+	    fprintf(stderr, "%d: volume has unknown data type.\n", getpid());
+	    return SIGMET_BAD_FILE;
+    }
+    return SIGMET_OK;
+}
 
-    U2BYT cc;				/* Compression code to navigate ray
-					   segment in rec */
-    unsigned az0_i, az1_i;		/* Initial and final ray azimuth, binary
-					   angle */
-    unsigned tilt0_i, tilt1_i;		/* Initial and final elevation, binary
-					   angle */
-    U1BYT *ray_buf = NULL;		/* Receive ray header and data */
-    U1BYT *ray_p = NULL;		/* Point into ray_buf */
-    U1BYT *ray_e = NULL;		/* End of allocation at ray_buf */
-
-    size_t raySz;			/* Allocation size for a ray_buf */
-    U1BYT *u1;				/* Pointer to start of data in
-					   ray_buf */
-    U2BYT *u2;				/* Pointer to start of data in
-					   ray_buf */
-    unsigned numWds;			/* Number of words in a run of data */
-    int s, r, b;			/* Sweep, ray, bin indeces */
-    int yf, y;				/* Indeces for data types in file,
-					   data type in dat */
-    int i, n;				/* Temporary values */
-    int nbins;				/* vol_p->ray_hdr[s][r]num_bins */
-    int tm_incr;			/* Ray time adjustment */
-    int *id_p;				/* Receive shared memory identifier */
-    size_t sz;
+/*
+   Give n data words at p to the current ray of decoder d. The first
+   words go into the ray header. The rest go straight into the data
+   array for the ray.
+ */
 
+static enum SigmetStatus dcdr_data(struct rec_dcdr *d, U1BYT *p, size_t n)
+{
+    size_t b, b1;			/* Bin indeces */
+    const size_t hdr_wds = SZ_RAY_HDR / 2;
 
-    if ( !f ) {
-	fprintf(stderr, "%d: read function called with bogus input stream.\n",
+    if ( n > d->max_wds - d->w ) {
+	fprintf(stderr, "%d: corrupt Sigmet raw product file: "
+		"record provided more data than could fit in a ray.\n",
 		getpid());
-	sig_stat = SIGMET_BAD_ARG;
-	goto error;
+	return SIGMET_BAD_FILE;
     }
-    if ( !vol_p ) {
-	return vol_good(f);
+    if ( d->w < hdr_wds ) {
+	b = (n < hdr_wds - d->w) ? n : hdr_wds - d->w;
+	memcpy(d->ray_hdr + 2 * d->w, p, 2 * b);
+	d->w += b;
+	p += 2 * b;
+	n -= b;
+    }
+    if ( n == 0 ) {
+	return SIGMET_OK;
+    }
+    b = d->w - hdr_wds;
+    if ( d->u1 ) {
+	b *= 2;
+	b1 = b + 2 * n;
+	b1 = (b1 > d->num_bins) ? d->num_bins : b1;
+	if ( b < b1 ) {
+	    memcpy(d->u1 + b, p, b1 - b);
+	}
+    } else if ( d->u2 ) {
+	b1 = b + n;
+	b1 = (b1 > d->num_bins) ? d->num_bins : b1;
+	if ( b < b1 ) {
+	    d->u2_cpy(d->u2 + b, p, b1 - b);
+	}
+    } else if ( d->xhdr_ray ) {
+	b *= 2;
+	b1 = b + 2 * n;
+	b1 = (b1 > sizeof(d->xhdr)) ? sizeof(d->xhdr) : b1;
+	if ( b < b1 ) {
+	    memcpy(d->xhdr + b, p, b1 - b);
+	}
     }
+    d->w += n;
+    return SIGMET_OK;
+}
 
-    s = r = b = 0;
-    yf = y = 0;
+/*
+   Copy n U2 words from record data at p to bins at u2. The decoder picks
+   one of these once per volume, so the loop over bins has no test for byte
+   order. u2_cpy_swap copies first, then swaps in place with shifts that
+   the compiler can vectorize, since p might not be aligned for U2BYT.
+ */
 
-    /*
-       Read headers. As a side effect, this initializes vol_p.
-     */
+static void u2_cpy(U2BYT *u2, const U1BYT *p, size_t n)
+{
+    memcpy(u2, p, n * sizeof(U2BYT));
+}
 
-    if ( (sig_stat = Sigmet_Vol_ReadHdr(f, vol_p)) != SIGMET_OK ) {
-	fprintf(stderr, "%d: could not read volume headers.\n", getpid());
-	Sigmet_Vol_Free(vol_p);
-	return sig_stat;
+static void u2_cpy_swap(U2BYT *u2, const U1BYT *p, size_t n)
+{
+    size_t b;
+
+    memcpy(u2, p, n * sizeof(U2BYT));
+    for (b = 0; b < n; b++) {
+	u2[b] = (U2BYT)((u2[b] << 8) | (u2[b] >> 8));
     }
+}
 
-    num_types = vol_p->num_types;
-    num_types_fl = num_types + vol_p->xhdr;
-    num_sweeps = vol_p->ih.tc.tni.num_sweeps;
-    num_rays = vol_p->ih.ic.num_rays;
-    num_bins = vol_p->ih.tc.tri.num_bins_out;
+/*
+   Give a run of n zero words to the current ray of decoder d.
+ */
 
-    /*
-       Allocate sweep and ray header arrays in vol_p.
-     */
+static enum SigmetStatus dcdr_zeros(struct rec_dcdr *d, size_t n)
+{
+    size_t b, b1;			/* Bin indeces */
+    const size_t hdr_wds = SZ_RAY_HDR / 2;
 
-    if ( vol_p->shm ) {
-	sz = num_sweeps * sizeof(*vol_p->sweep_hdr);
-	vol_p->sweep_hdr_id = shmget(IPC_PRIVATE, sz, S_IRUSR | S_IWUSR);
-	if ( vol_p->sweep_hdr_id == -1 ) {
-	    fprintf(stderr, "%d: could not create shared memory for "
-		    "sweep headers.\n%s\n", getpid(), strerror(errno));
-	    sig_stat = SIGMET_MEM_FAIL;
-	    goto error;
+    if ( n > d->max_wds - d->w ) {
+	fprintf(stderr, "%d: corrupt volume.\n"
+		"Run of zeros tried to go past end of ray.\n", getpid());
+	return SIGMET_BAD_FILE;
+    }
+    if ( d->w < hdr_wds ) {
+	b = (n < hdr_wds - d->w) ? n : hdr_wds - d->w;
+	d->w += b;
+	n -= b;
+    }
+    if ( n == 0 ) {
+	return SIGMET_OK;
+    }
+    b = d->w - hdr_wds;
+    if ( d->u1 ) {
+	b *= 2;
+	b1 = b + 2 * n;
+	b1 = (b1 > d->num_bins) ? d->num_bins : b1;
+	if ( b < b1 ) {
+	    memset(d->u1 + b, 0, b1 - b);
 	}
-	vol_p->sweep_hdr = shmat(vol_p->sweep_hdr_id, NULL, 0);
-	if ( vol_p->sweep_hdr == (void *)-1 ) {
-	    fprintf(stderr, "%d: could not attach to shared memory for "
-		    "sweep headers.\n%s\n", getpid(), strerror(errno));
-	    sig_stat = SIGMET_MEM_FAIL;
-	    goto error;
+    } else if ( d->u2 ) {
+	b1 = b + n;
+	b1 = (b1 > d->num_bins) ? d->num_bins : b1;
+	if ( b < b1 ) {
+	    memset(d->u2 + b, 0, (b1 - b) * sizeof(U2BYT));
 	}
-	vol_p->size += sz;
-	sz = num_sweeps * sizeof(struct Sigmet_Ray_Hdr *)
-	    + (num_sweeps * num_rays + 1) * sizeof(struct Sigmet_Ray_Hdr);
-	vol_p->ray_hdr_id = shmget(IPC_PRIVATE, sz, S_IRUSR | S_IWUSR);
-	if ( vol_p->ray_hdr_id == -1 ) {
-	    fprintf(stderr, "%d: could not create shared memory for "
-		    "ray headers.\n%s\n", getpid(), strerror(errno));
-	    goto error;
+    }
+    d->w += n;
+    return SIGMET_OK;
+}
+
+/*
+   Finish the current ray of decoder d. Store the ray header, and zero
+   the bins that the ray did not reach. Then move to the next ray.
+ */
+
+static enum SigmetStatus dcdr_ray_end(struct rec_dcdr *d)
+{
+    struct Sigmet_Vol *vol_p = d->vol_p;
+    struct Sigmet_Ray_Hdr *ray_hdr_p;
+    unsigned az0_i, az1_i;		/* Initial and final ray azimuth, binary
+					   angle */
+    unsigned tilt0_i, tilt1_i;		/* Initial and final elevation, binary
+					   angle */
+    int nbins;				/* Number of bins in ray */
+    size_t b;				/* Bins filled from the file */
+    size_t b1;				/* End of bins to zero */
+    const size_t hdr_wds = SZ_RAY_HDR / 2;
+
+    if ( d->s > d->num_sweeps ) {
+	fprintf(stderr, "%d: volume has more sweeps than reported "
+		"in header.\n", getpid());
+	return SIGMET_BAD_FILE;
+    }
+    if ( d->r > d->num_rays ) {
+	fprintf(stderr, "%d: volume has more rays than reported in "
+		"header.\n", getpid());
+	return SIGMET_BAD_FILE;
+    }
+    if ( !d->skip && d->r < d->num_rays ) {
+	/*
+	   Store ray angles. Mark ray as bad if ray starts and ends
+	   at same azimuth and tilt.
+	 */
+
+	az0_i = get_uint16(d->ray_hdr, d->swap);
+	tilt0_i = get_uint16(d->ray_hdr + 2, d->swap);
+	az1_i = get_uint16(d->ray_hdr + 4, d->swap);
+	tilt1_i = get_uint16(d->ray_hdr + 6, d->swap);
+	ray_hdr_p = d->ray ? &d->ray->hdr : vol_p->ray_hdr[d->s] + d->r;
+	ray_hdr_p->az0 = Sigmet_Bin2Rad(az0_i);
+	ray_hdr_p->tilt0 = GeogLatN(Sigmet_Bin2Rad(tilt0_i));
+	ray_hdr_p->az1 = Sigmet_Bin2Rad(az1_i);
+	ray_hdr_p->tilt1 = GeogLatN(Sigmet_Bin2Rad(tilt1_i));
+	nbins = get_sint16(d->ray_hdr + 8, d->swap);
+	if ( nbins > 0 && (size_t)nbins > d->num_bins ) {
+	    nbins = d->num_bins;
 	}
-	vol_p->ray_hdr = shmat(vol_p->ray_hdr_id, NULL, 0);
-	if ( vol_p->ray_hdr == (void *)-1 ) {
-	    fprintf(stderr, "%d: could not attach to shared memory for "
-		    "ray headers.\n%s\n", getpid(), strerror(errno));
-	    goto error;
+	ray_hdr_p->num_bins = nbins;
+	ray_hdr_p->ok = (nbins > 0);
+	if ( !vol_p->xhdr ) {
+	    unsigned sec = get_uint16(d->ray_hdr + 10, d->swap);
+
+	    ray_hdr_p->time = d->swp_tm + sec / 86400.0;
 	}
-	vol_p->size += sz;
-    } else {
-	vol_p->sweep_hdr = CALLOC(num_sweeps, sizeof(*vol_p->sweep_hdr));
-	if ( !vol_p->sweep_hdr ) {
-	    fprintf(stderr, "%d: could not allocate sweep header array.\n",
-		    getpid());
-	    sig_stat = SIGMET_MEM_FAIL;
-	    goto error;
+	if ( d->xhdr_ray ) {
+	    int tm_incr = get_sint32(d->xhdr, d->swap);
+
+	    ray_hdr_p->time = d->swp_tm + tm_incr * 0.001 / 86400.0;
 	}
-	vol_p->size += num_sweeps * sizeof(*vol_p->sweep_hdr);
-	sz = num_sweeps * sizeof(struct Sigmet_Ray_Hdr *)
-	    + (num_sweeps * num_rays + 1) * sizeof(struct Sigmet_Ray_Hdr);
-	vol_p->ray_hdr = (struct Sigmet_Ray_Hdr **)MALLOC(sz);
-	if ( !vol_p->ray_hdr ) {
-	    fprintf(stderr, "%d: could not allocate memory for ray header "
-		    "array.\n", getpid());
-	    goto error;
+
+	/*
+	   Zero the bins after the last run in the ray. Ray buffers for
+	   Sigmet_Vol_Scan still hold the previous ray, so zero them to
+	   the end.
+	 */
+
+	b = (d->w > hdr_wds) ? d->w - hdr_wds : 0;
+	b1 = d->ray ? d->num_bins : (nbins > 0) ? (size_t)nbins : 0;
+	if ( d->u1 ) {
+	    b *= 2;
+	    if ( b < b1 ) {
+		memset(d->u1 + b, 0, b1 - b);
+	    }
+	} else if ( d->u2 ) {
+	    if ( b < b1 ) {
+		memset(d->u2 + b, 0, (b1 - b) * sizeof(U2BYT));
+	    }
 	}
-	vol_p->size += sz;
-    }
-    vol_p->ray_hdr[0] = (struct Sigmet_Ray_Hdr *)(vol_p->ray_hdr + num_sweeps);
-    for (s = 1; s < num_sweeps; s++) {
-	vol_p->ray_hdr[s] = vol_p->ray_hdr[s - 1] + num_rays;
     }
 
     /*
-       Allocate data arrays in vol_p.
+       Reset for next ray. If the ray is complete and the caller is
+       scanning, give it to the callback.
      */
 
-    for (y = 0; y < vol_p->num_types; y++) {
-	id_p = vol_p->shm ? &vol_p->dat[y].vals_id : NULL;
-	switch (vol_p->dat[y].stor_fmt) {
-	    case SIGMET_U1:
-		vol_p->dat[y].vals.u1
-		    = malloc3_u1(num_sweeps, num_rays, num_bins, id_p);
-		if ( !vol_p->dat[y].vals.u1 ) {
-		    fprintf(stderr, "%d: could not allocate memory for %s\n",
-			    getpid(), vol_p->dat[y].data_type_s);
-		    sig_stat = SIGMET_MEM_FAIL;
-		    goto error;
-		}
-		vol_p->size += num_sweeps * num_rays * num_bins;
-		break;
-	    case SIGMET_U2:
-		vol_p->dat[y].vals.u2
-		    = malloc3_u2(num_sweeps, num_rays, num_bins, id_p);
-		if ( !vol_p->dat[y].vals.u2 ) {
-		    fprintf(stderr, "%d: could not allocate memory for %s\n",
-			    getpid(), vol_p->dat[y].data_type_s);
-		    sig_stat = SIGMET_MEM_FAIL;
-		    goto error;
-		}
-		vol_p->size += num_sweeps * num_rays * num_bins * 2;
-		break;
-	    case SIGMET_FLT:
-	    case SIGMET_DBL:
-	    case SIGMET_MT:
-		fprintf(stderr, "%d: volume in memory is corrupt. Unknown data "
-			"type in data array.", getpid());
-		sig_stat = SIGMET_BAD_VOL;
-		goto error;
-		break;
+    if ( ++d->yf == d->num_types_fl ) {
+	if ( d->ray && !d->skip && d->r < d->num_rays ) {
+	    d->ray->s = d->s;
+	    d->ray->r = d->r;
+	    if ( !d->ray_fn(vol_p, d->ray, d->ray_arg) ) {
+		d->stop = DCDR_DONE;
+	    }
+	    memset(&d->ray->hdr, 0, sizeof(d->ray->hdr));
 	}
+	d->r++;
+	d->yf = 0;
     }
+    return dcdr_ray_start(d);
+}
+
+/*
+   Store the header for sweep s of vol_p from rec, which must be the first
+   record of the sweep. If skip is true, the sweep will not be loaded, so
+   mark it bad. Return 0 if rec shows that there are no more sweeps in
+   the volume, otherwise 1.
+ */
+
+static int swp_start(struct Sigmet_Vol *vol_p, int s, U1BYT *rec, int skip)
+{
+    int year, month, day;
+    double sec;
+    unsigned msec;
+    double swp_tm;
+
+    vol_p->sweep_hdr[s].ok = 1;
 
     /*
-       Allocate and partition largest possible ray_buf buffer.
-       Data will be decompressed from rec and copied into ray_buf.
+       If sweep number from <ingest_data_header> has gone back to 0,
+       there are no more sweeps in volume.
      */
 
-    raySz = SZ_RAY_HDR + vol_p->ih.ic.extended_ray_headers_sz
-	+ vol_p->num_types * 2 * num_bins;
-    ray_buf = (U1BYT *)MALLOC(raySz);
-    if ( !ray_buf ) {
-	fprintf(stderr, "%d: could not allocate input ray buffer.\n", getpid());
-	sig_stat = SIGMET_MEM_FAIL;
-	goto error;
+    if (get_sint16(rec + 36, vol_p->swap) == 0) {
+	return 0;
     }
-    u1 = ray_buf + SZ_RAY_HDR;
-    u2 = (U2BYT *)(ray_buf + SZ_RAY_HDR);
-    ray_e = ray_buf + raySz;
 
     /*
-       Process data records.
+       Store sweep time and angle (from first <ingest_data_header>).
      */
 
-    rec_idx = 1;
-    sweep_num = 0;
-    while (fread(rec, 1, REC_LEN, f) == REC_LEN) {
+    sec = get_sint32(rec + 24, vol_p->swap);
+    msec = get_uint16(rec + 28, vol_p->swap);
+    msec &= 0x3ff;
+    year = get_sint16(rec + 30, vol_p->swap);
+    month = get_sint16(rec + 32, vol_p->swap);
+    day = get_sint16(rec + 34, vol_p->swap);
+    if (year < 1900 || month == 0 || day == 0) {
+	vol_p->sweep_hdr[s].ok = 0;
+    }
+    swp_tm = Tm_CalToJul(year, month, day, 0, 0, sec);
+    if ( swp_tm == 0.0 ) {
+	vol_p->sweep_hdr[s].ok = 0;
+    }
+    vol_p->sweep_hdr[s].time = swp_tm;
+    vol_p->sweep_hdr[s].angle
+	= Sigmet_Bin2Rad(get_uint16(rec + 46, vol_p->swap));
+    if ( skip ) {
+	vol_p->sweep_hdr[s].ok = 0;
+    }
+    return 1;
+}
 
-	/*
-	   Get record number and sweep number from <raw_prod_bhdr>.
-	 */
+/*
+   Decode data record rec with decoder d. If the record shows that the
+   volume has ended, set d->stop.
+ */
+
+static enum SigmetStatus dcdr_rec(struct rec_dcdr *d, U1BYT *rec)
+{
+    struct Sigmet_Vol *vol_p = d->vol_p;
+    U1BYT *rec_p;			/* Pointer into rec */
+    U1BYT *rec_e = rec + REC_LEN;	/* End rec */
+    U2BYT cc;				/* Compression code to navigate ray
+					   segment in rec */
+    size_t numWds;			/* Number of words in a run of data */
+    int s;
+    int i, n;				/* Temporary values */
+    enum SigmetStatus sig_stat;
 
-	i = get_sint16(rec);
-	n = get_sint16(rec + 2);
+    /*
+       Get record number and sweep number from <raw_prod_bhdr>.
+     */
 
-	if (i != rec_idx + 1) {
-	    fprintf(stderr, "%d: sigmet raw product file records out of "
-		    "sequence.\n", getpid());
-	    sig_stat = SIGMET_BAD_FILE;
-	    goto error;
-	}
-	rec_idx = i;
+    i = get_sint16(rec, d->swap);
+    n = get_sint16(rec + 2, d->swap);
+    if (i != d->rec_idx + 1) {
+	fprintf(stderr, "%d: sigmet raw product file records out of "
+		"sequence.\n", getpid());
+	return SIGMET_BAD_FILE;
+    }
+    d->rec_idx = i;
 
-	if (n != sweep_num) {
+    if (n != d->sweep_num) {
+
+	/*
+	   Sweep number has changed => record is start of new sweep.
+	 */
 
+	if ( n != d->sweep_num + 1 ) {
 	    /*
-	       Sweep number has changed => record is start of new sweep.
+	       Sweeps are out of order. If there is at least one sweep so
+	       far, stop. If no sweeps found, fail.
 	     */
 
-	    if ( n != sweep_num + 1 ) {
-		/*
-		   Sweeps are out of order. If there is at least one sweep so
-		   far, return. If no sweeps found, fail.
-		 */
-
-		if ( sweep_num > 0 ) {
-		    vol_p->truncated = 1;
-		    FREE(ray_buf);
-		    vol_p->num_sweeps_ax = sweep_num;
-		    return SIGMET_OK;
-		} else {
-		    fprintf(stderr, "%d: sweep number out of order in raw "
-			    "product file.\n", getpid());
-		    sig_stat = SIGMET_BAD_FILE;
-		    goto error;
-		}
-	    }
-	    sweep_num = n;
-	    s = sweep_num - 1;
-	    r = 0;
-	    vol_p->sweep_hdr[s].ok = 1;
-	    if (sweep_num > num_sweeps) {
-		fprintf(stderr, "%d: volume has excess sweeps.\n", getpid());
-		sig_stat = SIGMET_BAD_FILE;
-		goto error;
+	    if ( d->sweep_num > 0 ) {
+		d->stop = DCDR_TRUNC;
+		return SIGMET_OK;
+	    } else {
+		fprintf(stderr, "%d: sweep number out of order in raw "
+			"product file.\n", getpid());
+		return SIGMET_BAD_FILE;
 	    }
+	}
+	if (n > d->num_sweeps) {
+	    fprintf(stderr, "%d: volume has excess sweeps.\n", getpid());
+	    return SIGMET_BAD_FILE;
+	}
+	d->sweep_num = n;
+	s = d->s = n - 1;
+	d->r = 0;
+	d->skip = !sweep_ld(&vol_p->filter, s);
+	if ( !swp_start(vol_p, s, rec, d->skip) ) {
+	    d->stop = DCDR_DONE;
+	    return SIGMET_OK;
+	}
+	d->swp_tm = vol_p->sweep_hdr[s].time;
 
-	    /*
-	       If sweep number from <ingest_data_header> has gone back to 0,
-	       there are no more sweeps in volume.
-	     */
+	/*
+	   Initialize ray.
+	 */
 
-	    n = get_sint16(rec + 36);
-	    if (n == 0) {
-		break;
-	    }
+	rec_p = rec + SZ_RAW_PROD_BHDR + d->num_types_fl * SZ_INGEST_DATA_HDR;
+	d->yf = 0;
+	d->run = 0;
+	if ( (sig_stat = dcdr_ray_start(d)) != SIGMET_OK ) {
+	    return sig_stat;
+	}
+    } else {
+	/*
+	   Record continues a sweep started in an earlier record.
+	 */
 
-	    /*
-	       Store sweep time and angle (from first <ingest_data_header>).
-	     */
+	rec_p = rec + SZ_RAW_PROD_BHDR;
+    }
 
-	    sec = get_sint32(rec + 24);
-	    msec = get_uint16(rec + 28);
-	    msec &= 0x3ff;
-	    year = get_sint16(rec + 30);
-	    month = get_sint16(rec + 32);
-	    day = get_sint16(rec + 34);
-	    if (year < 1900 || month == 0 || day == 0) {
-		vol_p->sweep_hdr[s].ok = 0;
-	    }
+    /*
+       Finish a run of data words that crossed into this record from the
+       previous one.
+     */
+
+    if ( d->run > 0 ) {
+	numWds = d->run;
+	if ( numWds > (rec_e - rec_p) / 2 ) {
+	    numWds = (rec_e - rec_p) / 2;
+	}
+	if ( (sig_stat = dcdr_data(d, rec_p, numWds)) != SIGMET_OK ) {
+	    return sig_stat;
+	}
+	rec_p += 2 * numWds;
+	d->run -= numWds;
+    }
+
+    /*
+       Decompress ray data from rec into the volume.
+       See IRIS/Open Programmers Manual.
+     */
 
+    while (rec_p < rec_e && d->stop == DCDR_GO) {
+	cc = get_uint16(rec_p, d->swap);
+	rec_p += 2;
+	if ( (0x8000 & cc) == 0x8000 ) {
 	    /*
-	       Set sweep in volume.
+	       Run of data words. If the run crosses the record boundary,
+	       the rest will come from the next record.
 	     */
 
-	    swpTm = Tm_CalToJul(year, month, day, 0, 0, sec);
-	    if ( swpTm == 0.0 ) {
-		vol_p->sweep_hdr[s].ok = 0;
+	    numWds = 0x7FFF & cc;
+	    d->run = 0;
+	    if ( numWds > (rec_e - rec_p) / 2 ) {
+		d->run = numWds - (rec_e - rec_p) / 2;
+		numWds = (rec_e - rec_p) / 2;
 	    }
-	    angle = Sigmet_Bin2Rad(get_uint16(rec + 46));
-	    vol_p->sweep_hdr[s].time = swpTm;
-	    vol_p->sweep_hdr[s].angle = angle;
-
+	    if ( (sig_stat = dcdr_data(d, rec_p, numWds)) != SIGMET_OK ) {
+		return sig_stat;
+	    }
+	    rec_p += 2 * numWds;
+	} else if ( cc == 1 ) {
 	    /*
-	       Initialize ray.
+	       End of ray
 	     */
 
-	    rec_p = rec + SZ_RAW_PROD_BHDR + num_types_fl * SZ_INGEST_DATA_HDR;
-	    memset(ray_buf, 0, raySz);
-	    ray_p = ray_buf;
-	    yf = 0;
-
+	    if ( (sig_stat = dcdr_ray_end(d)) != SIGMET_OK ) {
+		return sig_stat;
+	    }
 	} else {
-
 	    /*
-	       Record continues a sweep started in an earlier record.
+	       Run of zeros
 	     */
 
-	    rec_p = rec + SZ_RAW_PROD_BHDR;
-
+	    if ( (sig_stat = dcdr_zeros(d, 0x7FFF & cc)) != SIGMET_OK ) {
+		return sig_stat;
+	    }
 	}
+    }
+    return SIGMET_OK;
+}
 
-	/*
-	   Decompress ray data from rec and store in ray_buf.
-	   See IRIS/Open Programmers Manual.
-	 */
-
-	while (rec_p < rec_e) {
-
-	    cc = get_uint16(rec_p);
-	    if ( (0x8000 & cc) == 0x8000 ) {
-		/*
-		   Run of data words
-		 */
-
-		numWds = 0x7FFF & cc;
-		for (rec_p += 2; numWds > 0 && ray_p < ray_e - 1; ) {
-		    if ( rec_p == rec_e ) {
-			/*
-			   Data run crosses record boundary.  
-			   Read the next record.
-			 */
-
-			if (fread(rec, 1, REC_LEN, f) != REC_LEN) {
-			    vol_p->truncated = 1;
-			    break;
-			}
-			i = get_sint16(rec);
-			if (i != rec_idx + 1) {
-			    fprintf(stderr, "%d: corrupt Sigmet raw product "
-				    "file: records  out of sequence.\n",
-				    getpid());
-			    sig_stat = SIGMET_BAD_FILE;
-			    goto error;
-			}
-			rec_idx = i;
-			rec_p = rec + SZ_RAW_PROD_BHDR;
-
-		    }
-		    *ray_p++ = *rec_p++;
-		    *ray_p++ = *rec_p++;
-		    numWds--;
-		}
-		if ( ray_p == ray_e && rec_p < rec_e ) {
-		    fprintf(stderr, "%d: corrupt Sigmet raw product file: "
-			    "record provided more data than could fit in a "
-			    "ray.\n", getpid());
-		    sig_stat = SIGMET_BAD_FILE;
-		    goto error;
-		}
-
-	    } else if ( cc == 1 ) {
-		/*
-		   End of ray
-		 */
-
-		if (s > num_sweeps) {
-		    fprintf(stderr, "%d: volume has more sweeps than reported "
-			    "in header.\n", getpid());
-		    sig_stat = SIGMET_BAD_FILE;
-		    goto error;
-		}
-		if (r > num_rays) {
-		    fprintf(stderr, "%d: volume has more rays than reported in "
-			    "header.\n", getpid());
-		    sig_stat = SIGMET_BAD_FILE;
-		    goto error;
-		}
-
-		/*
-		   Store ray angles. Mark ray as bad if ray starts and ends
-		   at same azimuth and tilt.
-		 */
+/*
+   Read a Sigmet raw product file from f into vol_p. If filt_p is not
+   NULL, load only the data types and sweeps it selects.
+ */
 
-		az0_i = get_uint16(ray_buf);
-		tilt0_i = get_uint16(ray_buf + 2);
-		az1_i = get_uint16(ray_buf + 4);
-		tilt1_i = get_uint16(ray_buf + 6);
+enum SigmetStatus Sigmet_Vol_Read(FILE *f, struct Sigmet_Vol *vol_p,
+	struct Sigmet_Vol_Filter *filt_p)
+{
+    return vol_read(f, vol_p, filt_p, 0);
+}
 
-		vol_p->ray_hdr[s][r].az0 = Sigmet_Bin2Rad(az0_i);
-		vol_p->ray_hdr[s][r].tilt0 = GeogLatN(Sigmet_Bin2Rad(tilt0_i));
-		vol_p->ray_hdr[s][r].az1 = Sigmet_Bin2Rad(az1_i);
-		vol_p->ray_hdr[s][r].tilt1 = GeogLatN(Sigmet_Bin2Rad(tilt1_i));
+/*
+   Read headers from f into vol_p, and make an index of the sweeps in the
+   file. Sweeps are decoded later, when something first asks for their
+   rays or data. If f is not a regular file that can be memory mapped,
+   such as a pipe from the decompressor for a compressed raw product
+   file, this is the same as Sigmet_Vol_Read.
+ */
 
-		nbins = vol_p->ray_hdr[s][r].num_bins = get_sint16(ray_buf + 8);
-		vol_p->ray_hdr[s][r].ok = (nbins > 0);
-		if ( !vol_p->xhdr ) {
-		    unsigned sec = get_uint16(ray_buf + 10);
+enum SigmetStatus Sigmet_Vol_ReadIdx(FILE *f, struct Sigmet_Vol *vol_p,
+	struct Sigmet_Vol_Filter *filt_p)
+{
+    return vol_read(f, vol_p, filt_p, 1);
+}
 
-		    vol_p->ray_hdr[s][r].time = swpTm + sec / 86400.0;
-		}
+/*
+   Decode a Sigmet raw product file from f one ray at a time. Give each
+   ray of the types and sweeps that filt_p selects to ray_fn, along with
+   arg. Memory for data is bounded by one ray, which is reused. When
+   done, vol_p has the volume and sweep headers, but no ray headers or
+   data arrays. Stop early if ray_fn returns false.
+ */
 
-		/*
-		   Store ray data.
-		 */
+enum SigmetStatus Sigmet_Vol_Scan(FILE *f, struct Sigmet_Vol *vol_p,
+	struct Sigmet_Vol_Filter *filt_p, Sigmet_RayFn ray_fn, void *arg)
+{
+    enum SigmetStatus sig_stat;
+    struct rec_src src;			/* Provide data records */
+    U1BYT *rec;				/* Current data record */
+    struct rec_dcdr dcdr;		/* Decode data records */
+    struct Sigmet_Ray ray;		/* Current ray */
+    U1BYT *ray_buf = NULL;		/* Data for ray */
+    int num_sweeps;			/* Number of sweeps in vol_p */
+    size_t num_bins;			/* Number of output bins */
+    size_t sz;				/* Storage for one ray of data */
+    int s, y;				/* Sweep, data type indeces */
 
-		y = yf - vol_p->xhdr;
-		if ( vol_p->types_fl[yf] == DB_XHDR ) {
-		    tm_incr = get_sint32(ray_buf + SZ_RAY_HDR);
-		    vol_p->ray_hdr[s][r].time
-			= swpTm + tm_incr * 0.001 / 86400.0;
-		} else {
-		    U1BYT *vol_u1;
-		    U2BYT *vol_u2;
-
-		    switch (Sigmet_DataType_StorFmt(vol_p->types_fl[yf])) {
-			case SIGMET_U1:
-			    vol_u1 = vol_p->dat[y].vals.u1[s][r];
-			    for (b = 0; b < nbins; b++)  {
-				vol_u1[b] = u1[b];
-			    }
-			    break;
-			case SIGMET_U2:
-			    vol_u2 = vol_p->dat[y].vals.u2[s][r];
-			    for (b = 0; b < nbins; b++)  {
-				vol_u2[b] = get_uint16(u2 + b);
-			    }
-			    break;
-			default:
-			    fprintf(stderr, "%d: volume has unknown data "
-				    "type.\n", getpid());
-			    sig_stat = SIGMET_BAD_FILE;
-			    goto error;
-			    break;
-		    }
-		}
+    if ( !f || !vol_p || !ray_fn ) {
+	fprintf(stderr, "%d: scan function called with bogus arguments.\n",
+		getpid());
+	return SIGMET_BAD_ARG;
+    }
+    if ( (sig_stat = Sigmet_Vol_ReadHdr(f, vol_p)) != SIGMET_OK ) {
+	fprintf(stderr, "%d: could not read volume headers.\n", getpid());
+	Sigmet_Vol_Free(vol_p);
+	return sig_stat;
+    }
+    if ( filt_p ) {
+	vol_p->filter = *filt_p;
+	vol_filter_types(vol_p);
+    }
+    num_sweeps = vol_p->ih.tc.tni.num_sweeps;
+    num_bins = vol_p->ih.tc.tri.num_bins_out;
+    vol_p->sweep_hdr = vol_pool_alloc(vol_p,
+	    num_sweeps * sizeof(*vol_p->sweep_hdr));
+    if ( !vol_p->sweep_hdr ) {
+	fprintf(stderr, "%d: could not allocate sweep header array.\n",
+		getpid());
+	sig_stat = SIGMET_MEM_FAIL;
+	goto error;
+    }
+    vol_p->size += num_sweeps * sizeof(*vol_p->sweep_hdr);
 
-		/*
-		   Reset for next ray.
-		 */
+    /*
+       One buffer receives a ray of every data type. U2 values come
+       first so that they stay aligned.
+     */
 
-		memset(ray_buf, 0, raySz);
-		ray_p = ray_buf;
-		if (++yf == num_types_fl) {
-		    r++;
-		    yf = 0;
-		}
-		rec_p += 2;
-	    } else {
-		/*
-		   Run of zeros
-		 */
+    memset(&ray, 0, sizeof(ray));
+    for (sz = 0, y = 0; y < vol_p->num_types; y++) {
+	switch (vol_p->dat[y].stor_fmt) {
+	    case SIGMET_U1:
+		sz += num_bins;
+		break;
+	    case SIGMET_U2:
+		sz += num_bins * sizeof(U2BYT);
+		break;
+	    case SIGMET_FLT:
+	    case SIGMET_F16:
+	    case SIGMET_DBL:
+	    case SIGMET_MT:
+		fprintf(stderr, "%d: volume in memory is corrupt. Unknown data "
+			"type in data array.", getpid());
+		sig_stat = SIGMET_BAD_VOL;
+		goto error;
+	}
+    }
+    if ( sz > 0 && !(ray_buf = MALLOC(sz)) ) {
+	fprintf(stderr, "%d: could not allocate ray buffer.\n", getpid());
+	sig_stat = SIGMET_MEM_FAIL;
+	goto error;
+    }
+    for (sz = 0, y = 0; y < vol_p->num_types; y++) {
+	if ( vol_p->dat[y].stor_fmt == SIGMET_U2 ) {
+	    ray.vals[y].u2 = (U2BYT *)(ray_buf + sz);
+	    sz += num_bins * sizeof(U2BYT);
+	}
+    }
+    for (y = 0; y < vol_p->num_types; y++) {
+	if ( vol_p->dat[y].stor_fmt == SIGMET_U1 ) {
+	    ray.vals[y].u1 = ray_buf + sz;
+	    sz += num_bins;
+	}
+    }
 
-		numWds = 0x7FFF & cc;
-		if ( numWds > ray_e - ray_p ) {
-		    fprintf(stderr, "%d: corrupt volume.\n"
-			    "Run of zeros tried to go past end of ray.\n",
-			    getpid());
-		    sig_stat = SIGMET_BAD_FILE;
-		    goto error;
-		}
-		ray_p += numWds * 2;
-		rec_p += 2;
-	    }
+    rec_src_init(&src, f);
+    dcdr_init(&dcdr, vol_p);
+    dcdr.ray = &ray;
+    dcdr.ray_fn = ray_fn;
+    dcdr.ray_arg = arg;
+    while ( dcdr.stop == DCDR_GO && (rec = rec_src_next(&src)) ) {
+	if ( (sig_stat = dcdr_rec(&dcdr, rec)) != SIGMET_OK ) {
+	    rec_src_close(&src);
+	    goto error;
 	}
     }
+    rec_src_close(&src);
+    FREE(ray_buf);
+    if ( dcdr.stop == DCDR_TRUNC ) {
+	vol_p->truncated = 1;
+	vol_p->num_sweeps_ax = dcdr.sweep_num;
+	return SIGMET_OK;
+    }
     for (s = 0;
-	    s < vol_p->ih.tc.tni.num_sweeps && vol_p->sweep_hdr[s].ok;
+	    s < num_sweeps
+	    && (vol_p->sweep_hdr[s].ok
+		|| (!sweep_ld(&vol_p->filter, s) && s < dcdr.sweep_num));
 	    s++) {
 	continue;
     }
-    vol_p->truncated = (r + 1 < num_rays || s + 1 < num_sweeps) ? 1 : 0;
-    if ( vol_p->truncated && feof(f) ) {
-	sig_stat = SIGMET_BAD_FILE;
-    }
-    FREE(ray_buf);
+    vol_p->truncated = (dcdr.r + 1 < vol_p->ih.ic.num_rays
+	    || s + 1 < num_sweeps) ? 1 : 0;
     vol_p->num_sweeps_ax = s;
-
     return SIGMET_OK;
 
 error:
@@ -1725,962 +2885,1352 @@ error:
 }
 
 /*
-   Make a lazy copy of src at dest, i.e. copy struct values and array
-   addresses, but not contents of arrays.
+   Read headers from f into vol_p, then keep decoding f on a new thread
+   as data arrives, i.e. as IRIS writes the raw product file, or as it
+   comes down a pipe or socket. Accessors that take a sweep index wait
+   until the last ray of that sweep has been decoded. Accessors for the
+   whole volume wait for the volume to end. If f is a regular file,
+   the volume ends when the file stops growing for idle seconds. Nothing
+   may have been read from f. Caller must keep f open until
+   Sigmet_Vol_FollowEnd or Sigmet_Vol_Free.
  */
 
-void Sigmet_Vol_LzCpy(struct Sigmet_Vol *dest, struct Sigmet_Vol *src)
+enum SigmetStatus Sigmet_Vol_Follow(FILE *f, struct Sigmet_Vol *vol_p,
+	struct Sigmet_Vol_Filter *filt_p, double idle)
 {
-    *dest = *src;
-}
+    enum SigmetStatus sig_stat;
+    struct sigmet_ingest *ing;		/* Ingest state for vol_p */
+    int fd;				/* Descriptor for f, or -1 */
+    int reg;				/* If true, f is a regular file */
+    struct stat sbuf;			/* Information about f */
+    struct timespec poll = {0, INGEST_POLL_NS};
+    double t;				/* Time spent waiting for headers */
+    int status;				/* Return from pthread function */
+
+    if ( !f || !vol_p || !(idle >= 0.0) ) {
+	fprintf(stderr, "%d: follow function called with bogus arguments.\n",
+		getpid());
+	return SIGMET_BAD_ARG;
+    }
 
-int Sigmet_Vol_NearSweep(struct Sigmet_Vol *vol_p, double ang)
-{
-    int s, s1;
-    double swp_ang;			/* Sweep angle */
-    double d_ang;			/* Sweep angle minus ang */
-    double d_ang_min;			/* Smallest d_ang */
+    /*
+       If IRIS has only just created the file, wait for the headers. A
+       stream from a decompressor in this process has no descriptor.
+     */
 
-    if ( !vol_p || !vol_p->sweep_hdr ) {
-	return -1;
+    if ( (fd = fileno(f)) != -1 && fstat(fd, &sbuf) == -1 ) {
+	fprintf(stderr, "%d: could not get information about volume input "
+		"stream.\n%s\n", getpid(), strerror(errno));
+	return SIGMET_IO_FAIL;
     }
-    for (d_ang_min = DBL_MAX, s1 = -1, s = 0; s < vol_p->num_sweeps_ax; s++) {
-	swp_ang = GeogLonR(vol_p->sweep_hdr[s].angle, ang);
-	d_ang = fabs(swp_ang - ang);
-	if ( d_ang < d_ang_min ) {
-	    d_ang_min = d_ang;
-	    s1 = s;
+    reg = (fd != -1 && S_ISREG(sbuf.st_mode));
+    if ( reg ) {
+	for (t = 0.0;
+		sbuf.st_size < 2 * REC_LEN && t < idle
+		&& fstat(fd, &sbuf) == 0;
+		t += INGEST_POLL_NS * 1.0e-9) {
+	    nanosleep(&poll, NULL);
 	}
     }
-    return s1;
-}
 
-/*
-   Get or set radar longitude, latitude. Angles in radian.
- */
+    /*
+       The ingest thread reads a pipe or socket with read, after poll
+       reports input, so that it can notice a request to stop while the
+       writer is quiet. The descriptor stays blocking, since other
+       processes might share it. Turn off buffering, so that no input
+       waits in f where poll cannot see it.
+     */
 
-double Sigmet_Vol_RadarLon(struct Sigmet_Vol *vol_p, double *lon_p)
-{
-    if ( !vol_p ) {
-	return NAN;
+    if ( !reg && fd != -1 && setvbuf(f, NULL, _IONBF, 0) != 0 ) {
+	fprintf(stderr, "%d: could not turn off buffering for volume input "
+		"stream.\n", getpid());
+	return SIGMET_IO_FAIL;
     }
-    if ( lon_p ) {
-	vol_p->ih.ic.longitude = Sigmet_RadBin4(GeogLonR(*lon_p, M_PI));
-	vol_p->mod = 1;
-	return *lon_p;
+    if ( (sig_stat = Sigmet_Vol_ReadHdr(f, vol_p)) != SIGMET_OK ) {
+	fprintf(stderr, "%d: could not read volume headers.\n", getpid());
+	Sigmet_Vol_Free(vol_p);
+	return sig_stat;
     }
-    return GeogLonR(Sigmet_Bin4Rad(vol_p->ih.ic.longitude), 0.0);
-}
-
-double Sigmet_Vol_RadarLat(struct Sigmet_Vol *vol_p, double *lat_p)
-{
-    if ( !vol_p ) {
-	return NAN;
+    if ( filt_p ) {
+	vol_p->filter = *filt_p;
+	vol_filter_types(vol_p);
     }
-    if ( lat_p ) {
-	vol_p->ih.ic.latitude = Sigmet_RadBin4(*lat_p);
-	vol_p->mod = 1;
-	return *lat_p;
+    if ( (sig_stat = vol_alloc(vol_p)) != SIGMET_OK ) {
+	Sigmet_Vol_Free(vol_p);
+	return sig_stat;
     }
-    return GeogLatN(Sigmet_Bin4Rad(vol_p->ih.ic.latitude));
-}
 
-int Sigmet_Vol_GoodRay(struct Sigmet_Vol *vol_p, int s, int r)
-{
-    switch (vol_p->ih.tc.tni.scan_mode) {
-	case PPI_S:
-	case PPI_C:
-	    return vol_p
-		&& s < vol_p->num_sweeps_ax
-		&& r < vol_p->ih.ic.num_rays
-		&& vol_p->ray_hdr[s][r].az0 != vol_p->ray_hdr[s][r].az1;
-	case RHI:
-	    return vol_p
-		&& s < vol_p->num_sweeps_ax
-		&& r < vol_p->ih.ic.num_rays
-		&& vol_p->ray_hdr[s][r].tilt0 != vol_p->ray_hdr[s][r].tilt1;
-	case MAN_SCAN:
-	case FILE_SCAN:
-	    return 0;
+    /*
+       Until the volume ends, it has the sweeps its headers promise.
+       Sweeps that have not arrived are not ok.
+     */
+
+    vol_p->num_sweeps_ax = vol_p->ih.tc.tni.num_sweeps;
+    vol_p->truncated = 0;
+
+    if ( !(ing = CALLOC(1, sizeof(struct sigmet_ingest))) ) {
+	fprintf(stderr, "%d: could not allocate ingest state.\n", getpid());
+	Sigmet_Vol_Free(vol_p);
+	return SIGMET_MEM_FAIL;
     }
-    return 0;
+    ing->f = f;
+    ing->reg = reg;
+    ing->fd = reg ? -1 : fd;
+    ing->idle = idle;
+    dcdr_init(&ing->dcdr, vol_p);
+    ing->status = SIGMET_OK;
+    if ( (status = pthread_mutex_init(&ing->mtx, NULL)) != 0 ) {
+	fprintf(stderr, "%d: could not initialize ingest mutex.\n%s\n",
+		getpid(), strerror(status));
+	FREE(ing);
+	Sigmet_Vol_Free(vol_p);
+	return SIGMET_MEM_FAIL;
+    }
+    if ( (status = pthread_cond_init(&ing->cond, NULL)) != 0 ) {
+	fprintf(stderr, "%d: could not initialize ingest condition.\n%s\n",
+		getpid(), strerror(status));
+	pthread_mutex_destroy(&ing->mtx);
+	FREE(ing);
+	Sigmet_Vol_Free(vol_p);
+	return SIGMET_MEM_FAIL;
+    }
+
+    vol_p->ingest = ing;
+    if ( (status = pthread_create(&ing->thr, NULL, ingest_thr, vol_p)) != 0 ) {
+	fprintf(stderr, "%d: could not start ingest thread.\n%s\n",
+		getpid(), strerror(status));
+	vol_p->ingest = NULL;
+	pthread_cond_destroy(&ing->cond);
+	pthread_mutex_destroy(&ing->mtx);
+	FREE(ing);
+	Sigmet_Vol_Free(vol_p);
+	return SIGMET_MEM_FAIL;
+    }
+    vol_p->size += sizeof(struct sigmet_ingest);
+    return SIGMET_OK;
 }
 
 /*
-   Fetch ray geometry for sweep s.  r00_p and dr_p get distance to first ray
-   and bin step, in meters. Arrays az0 and az1 get initial and final azimuths,
-   tilt1 and tilt1 get initial and final tilts, in radians. They must point
-   to storage for num_rays double values. If fill is true, eliminate gaps
-   between adjacent rays.
+   Wait for the thread from Sigmet_Vol_Follow to decode the rest of the
+   volume, and release it. Return its result. Afterward vol_p is an
+   ordinary volume, with the actual number of sweeps.
  */
 
-enum SigmetStatus Sigmet_Vol_RayGeom(struct Sigmet_Vol *vol_p, int s,
-	double *r00_p, double *dr_p, double *az0, double *az1,
-	double *tilt0, double *tilt1, int fill)
+enum SigmetStatus Sigmet_Vol_FollowEnd(struct Sigmet_Vol *vol_p)
 {
-    struct Sigmet_Ray_Hdr *ray_hdr;
-    int num_rays;
-    int r;
-    double m_per_cm = 0.01;
+    struct sigmet_ingest *ing;		/* Ingest state for vol_p */
+    enum SigmetStatus sig_stat;
 
-    if ( !vol_p ) {
-	return SIGMET_BAD_ARG;
-    }
-    num_rays = vol_p->ih.ic.num_rays;
-    for (r = 0; r < num_rays; r++) {
-	az0[r] = az1[r] = tilt0[r] = tilt1[r] = NAN;
-    }
-    if ( s >= vol_p->num_sweeps_ax || !vol_p->sweep_hdr[s].ok ) {
-	return SIGMET_BAD_ARG;
-    }
-    ray_hdr = vol_p->ray_hdr[s];
-    *r00_p = m_per_cm * vol_p->ih.tc.tri.rng_1st_bin;
-    *dr_p = m_per_cm * vol_p->ih.tc.tri.step_out;
-    if ( fill ) {
-	int r_prev, r_curr, r_next;	/* Previous, current, and next good
-					   rays */
+    if ( !vol_p || !vol_p->ingest ) {
+	return SIGMET_OK;
+    }
+    ing = vol_p->ingest;
+    pthread_join(ing->thr, NULL);
+    vol_p->truncated = ing->truncated;
+    vol_p->num_sweeps_ax = ing->num_sweeps_ax;
+    sig_stat = ing->status;
+    pthread_cond_destroy(&ing->cond);
+    pthread_mutex_destroy(&ing->mtx);
+    FREE(ing);
+    vol_p->ingest = NULL;
+    vol_p->size -= sizeof(struct sigmet_ingest);
+    return sig_stat;
+}
 
-	if ( Sigmet_Vol_IsPPI(vol_p) ) {
-	    double az1_prev, az0_curr, az1_curr, az0_next;
+/*
+   Read the next data record from the stream in ing into ing->rec. If
+   the stream is a regular file, wait for it to grow. If it has a
+   descriptor, wait with poll until the descriptor is readable, checking
+   for a request to stop every INGEST_POLL_NS nanoseconds, then read it.
+   A stream without a descriptor comes from a decompressor in this
+   process, which always reaches its end, so it is read with fread.
+   Return true if ing->rec has a whole record, false if input has ended.
+ */
 
-	    /* First ray */
-	    for (r_curr = 0;
-		    r_curr < num_rays && !ray_hdr[r_curr].ok;
-		    r_curr++ ) {
+static int ingest_rec(struct sigmet_ingest *ing)
+{
+    size_t n = 0, n1;			/* Bytes read in total, last fread */
+    ssize_t r;				/* Return from read */
+    double t = 0.0;			/* Time spent waiting for data */
+    struct timespec nap = {0, INGEST_POLL_NS};
+    struct pollfd pfd;			/* Wait for stream */
+    int p;				/* Return from poll */
+    int stop;
+
+    while ( n < REC_LEN ) {
+	pthread_mutex_lock(&ing->mtx);
+	stop = ing->stop;
+	pthread_mutex_unlock(&ing->mtx);
+	if ( stop || (ing->reg && t >= ing->idle) ) {
+	    return 0;
+	}
+	if ( ing->reg ) {
+	    n1 = fread(ing->rec + n, 1, REC_LEN - n, ing->f);
+	    n += n1;
+	    if ( ferror(ing->f) ) {
+		return 0;
 	    }
-	    if ( r_curr == num_rays ) {
-		return SIGMET_BAD_VOL;
+	    if ( n1 > 0 ) {
+		t = 0.0;
 	    }
-	    for (r_next = r_curr + 1;
-		    r_next < num_rays && !ray_hdr[r_next].ok;
-		    r_next++) {
+	    if ( n < REC_LEN ) {
+		clearerr(ing->f);
+		nanosleep(&nap, NULL);
+		t += INGEST_POLL_NS * 1.0e-9;
 	    }
-	    if ( r_next == num_rays ) {
-		return SIGMET_BAD_VOL;
+	} else if ( ing->fd == -1 ) {
+	    return fread(ing->rec, 1, REC_LEN, ing->f) == REC_LEN;
+	} else {
+	    pfd.fd = ing->fd;
+	    pfd.events = POLLIN;
+	    if ( (p = poll(&pfd, 1, INGEST_POLL_NS / 1000000)) == -1
+		    && errno != EINTR ) {
+		return 0;
 	    }
-	    az0[r_curr] = ray_hdr[r_curr].az0;
-	    az1_curr = ray_hdr[r_curr].az1;
-	    az0_next = GeogLonR(ray_hdr[r_next].az0, az1_curr);
-	    az1[r_curr] = (az1_curr + az0_next) / 2;
-	    tilt0[r_curr] = ray_hdr[r_curr].tilt0;
-	    tilt1[r_curr] = ray_hdr[r_curr].tilt1;
-
-	    /* Rest of the rays except last */
-	    r_prev = r_curr;
-	    r_curr = r_next;
-	    for (r_next = r_curr + 1;
-		    r_next < num_rays && !ray_hdr[r_next].ok;
-		    r_next++) {
+	    if ( p <= 0 ) {
+		continue;
 	    }
-	    while (r_next < num_rays) {
-		az0_curr = ray_hdr[r_curr].az0;
-		az1_prev = GeogLonR(ray_hdr[r_prev].az1, az0_curr);
-		az1_curr = ray_hdr[r_curr].az1;
-		az0_next = GeogLonR(ray_hdr[r_next].az0, az1_curr);
-		az0[r_curr] = (az1_prev + az0_curr) / 2;
-		az1[r_curr] = (az1_curr + az0_next) / 2;
-		tilt0[r_curr] = ray_hdr[r_curr].tilt0;
-		tilt1[r_curr] = ray_hdr[r_curr].tilt1;
-		r_prev = r_curr;
-		r_curr = r_next;
-		for (r_next = r_curr + 1;
-			r_next < num_rays && !ray_hdr[r_next].ok;
-			r_next++) {
-		}
+	    if ( (r = read(ing->fd, ing->rec + n, REC_LEN - n)) == -1
+		    && errno == EINTR ) {
+		continue;
 	    }
+	    if ( r <= 0 ) {
+		/*
+		   Writer closed the stream, or read failed.
+		 */
 
-	    /* Last ray */
-	    az0_curr = ray_hdr[r_curr].az0;
-	    az1_prev = GeogLonR(ray_hdr[r_prev].az1, az0_curr);
-	    az0[r_curr] = (az1_prev + az0_curr) / 2;
-	    az1[r_curr] = ray_hdr[r_curr].az1;
-	    tilt0[r_curr] = ray_hdr[r_curr].tilt0;
-	    tilt1[r_curr] = ray_hdr[r_curr].tilt1;
-	} else if ( Sigmet_Vol_IsRHI(vol_p) ) {
-	    double tilt1_prev, tilt0_curr, tilt1_curr, tilt0_next;
-
-	    /* First ray */
-	    for (r_curr = 0;
-		    r_curr < num_rays && !ray_hdr[r_curr].ok;
-		    r_curr++ ) {
-	    }
-	    if ( r_curr == num_rays ) {
-		return SIGMET_BAD_VOL;
-	    }
-	    for (r_next = r_curr + 1;
-		    r_next < num_rays && !ray_hdr[r_next].ok;
-		    r_next++) {
-	    }
-	    if ( r_next == num_rays ) {
-		return SIGMET_BAD_VOL;
+		return 0;
 	    }
-	    az0[r_curr] = ray_hdr[r_curr].az0;
-	    az1[r_curr] = ray_hdr[r_curr].az1;
-	    tilt0[r_curr] = ray_hdr[r_curr].tilt0;
-	    tilt1_curr = ray_hdr[r_curr].tilt1;
-	    tilt0_next = ray_hdr[r_next].tilt0;
-	    tilt1[r_curr] = (tilt1_curr + tilt0_next) / 2;
+	    n += r;
+	}
+    }
+    return 1;
+}
 
-	    /* Rest of rays except last */
-	    r_prev = r_curr;
-	    r_curr = r_next;
-	    for (r_next = r_curr + 1;
-		    r_next < num_rays && !ray_hdr[r_next].ok;
-		    r_next++) {
-	    }
-	    while (r_next < num_rays) {
-		az0[r_curr] = ray_hdr[r_curr].az0;
-		az1[r_curr] = ray_hdr[r_curr].az1;
-		tilt1_prev = ray_hdr[r_prev].tilt1;
-		tilt0_curr = ray_hdr[r_curr].tilt0;
-		tilt1_curr = ray_hdr[r_curr].tilt1;
-		tilt0_next = ray_hdr[r_next].tilt0;
-		tilt0[r_curr] = (tilt1_prev + tilt0_curr) / 2;
-		tilt1[r_curr] = (tilt1_curr + tilt0_next) / 2;
-		r_prev = r_curr;
-		r_curr = r_next;
-		for (r_next = r_curr + 1; !ray_hdr[r_next].ok; r_next++) {
-		}
-	    }
+/*
+   Decode records for a volume from Sigmet_Vol_Follow. After each
+   record, publish the number of complete sweeps.
+ */
 
-	    /* Last ray */
-	    az0[r_curr] = ray_hdr[r_curr].az0;
-	    az1[r_curr] = ray_hdr[r_curr].az1;
-	    tilt0[r_curr] = (tilt1[r_prev] + ray_hdr[r_curr].tilt0) / 2;
-	    tilt1[r_curr] = ray_hdr[r_curr].tilt1;
+static void *ingest_thr(void *arg)
+{
+    struct Sigmet_Vol *vol_p = (struct Sigmet_Vol *)arg;
+    struct sigmet_ingest *ing = vol_p->ingest;
+    struct rec_dcdr *d = &ing->dcdr;
+    enum SigmetStatus sig_stat = SIGMET_OK;
+    int num_sweeps = vol_p->ih.tc.tni.num_sweeps;
+    int num_sweeps_rd;			/* Number of sweeps complete */
+    int s;
+
+    while ( d->stop == DCDR_GO && ingest_rec(ing) ) {
+	if ( (sig_stat = dcdr_rec(d, ing->rec)) != SIGMET_OK ) {
+	    break;
+	}
+	if ( d->sweep_num == 0 ) {
+	    num_sweeps_rd = 0;
+	} else {
+	    num_sweeps_rd = (d->r >= d->num_rays) ? d->s + 1 : d->s;
 	}
+	if ( d->stop == DCDR_GO && num_sweeps_rd > ing->num_sweeps_rd ) {
+	    pthread_mutex_lock(&ing->mtx);
+	    ing->num_sweeps_rd = num_sweeps_rd;
+	    pthread_cond_broadcast(&ing->cond);
+	    pthread_mutex_unlock(&ing->mtx);
+	}
+    }
+
+    /*
+       Finish as vol_read does. If input ended in the middle of a ray,
+       discard the part of the ray that was decoded.
+     */
+
+    if ( sig_stat == SIGMET_OK && d->stop == DCDR_GO && d->w > 0 ) {
+	if ( d->u1 ) {
+	    memset(d->u1, 0, d->num_bins);
+	} else if ( d->u2 ) {
+	    memset(d->u2, 0, d->num_bins * sizeof(U2BYT));
+	}
+    }
+    pthread_mutex_lock(&ing->mtx);
+    if ( sig_stat != SIGMET_OK ) {
+	ing->truncated = 1;
+	ing->num_sweeps_ax = ing->num_sweeps_rd;
+    } else if ( d->stop == DCDR_TRUNC ) {
+	ing->truncated = 1;
+	ing->num_sweeps_ax = d->sweep_num;
     } else {
-	for (r = 0; r < num_rays; r++) {
-	    if ( ray_hdr[r].ok ) {
-		az0[r] = ray_hdr[r].az0;
-		az1[r] = ray_hdr[r].az1;
-		tilt0[r] = ray_hdr[r].tilt0;
-		tilt1[r] = ray_hdr[r].tilt1;
-	    }
+	for (s = 0;
+		s < num_sweeps
+		&& (vol_p->sweep_hdr[s].ok
+		    || (!sweep_ld(&vol_p->filter, s) && s < d->sweep_num));
+		s++) {
+	    continue;
 	}
+	ing->truncated = (d->r + 1 < d->num_rays || s + 1 < num_sweeps)
+	    ? 1 : 0;
+	ing->num_sweeps_ax = s;
+    }
+    ing->status = sig_stat;
+    ing->num_sweeps_rd = num_sweeps;
+    ing->done = 1;
+    pthread_cond_broadcast(&ing->cond);
+    pthread_mutex_unlock(&ing->mtx);
+    return NULL;
+}
+
+/*
+   If vol_p is being followed, wait until sweep s has been decoded. If s
+   is -1, wait for the whole volume. If s is -2, do not wait. In any case,
+   if the ingest thread has finished, end the ingest, so that vol_p gets
+   the actual number of sweeps.
+ */
+
+static void ingest_wait(struct Sigmet_Vol *vol_p, int s)
+{
+    struct sigmet_ingest *ing;		/* Ingest state for vol_p */
+    int done;				/* If true, ingest thread finished */
+
+    if ( !vol_p || !(ing = vol_p->ingest) ) {
+	return;
+    }
+    if ( s == -1 ) {
+	Sigmet_Vol_FollowEnd(vol_p);
+	return;
+    }
+    pthread_mutex_lock(&ing->mtx);
+    while ( s >= 0 && !ing->done && ing->num_sweeps_rd <= s ) {
+	pthread_cond_wait(&ing->cond, &ing->mtx);
+    }
+    done = ing->done;
+    pthread_mutex_unlock(&ing->mtx);
+    if ( done ) {
+	Sigmet_Vol_FollowEnd(vol_p);
     }
-    return SIGMET_OK;
 }
 
 /*
-   Add a new field to a volume.  This also allocates space for data in the
-   dat array.
+   Read a Sigmet raw product file from f into vol_p, loading the types
+   and sweeps that filt_p selects. If lazy is true and f can be memory
+   mapped, index the sweeps instead of decoding them.
  */
 
-enum SigmetStatus Sigmet_Vol_NewField(struct Sigmet_Vol *vol_p,
-	char *data_type_s, char *descr, char *unit)
+static enum SigmetStatus vol_read(FILE *f, struct Sigmet_Vol *vol_p,
+	struct Sigmet_Vol_Filter *filt_p, int lazy)
 {
-    struct Sigmet_Dat *dat_p;
-    float ***flt_p;
-    int num_sweeps, num_rays, num_bins;
-    int *id_p;
+    int sig_stat;
+    struct rec_src src;			/* Provide data records */
+    int have_src = 0;			/* If true, src must be closed */
+    U1BYT *rec;				/* Current data record */
+    struct rec_dcdr dcdr;		/* Decode data records */
+    int num_sweeps;			/* Number of sweeps in vol_p */
+    unsigned num_rays;			/* Number of rays per sweep */
+    int s;				/* Sweep index */
 
-    if ( !data_type_s ) {
-	fprintf(stderr, "%d: attempted to add bogus data type to a volume.\n",
+    if ( !f ) {
+	fprintf(stderr, "%d: read function called with bogus input stream.\n",
 		getpid());
-	return SIGMET_BAD_ARG;
+	sig_stat = SIGMET_BAD_ARG;
+	goto error;
     }
     if ( !vol_p ) {
-	fprintf(stderr, "%d: attempted to add data type to a bogus volume.\n",
-		getpid());
-	return SIGMET_BAD_ARG;
+	return vol_good(f);
     }
-    if ( Sigmet_DataType_GetN(data_type_s, NULL) ) {
-	fprintf(stderr, "%d: %s is a build in Sigmet data type. Please choose "
-		"another name.\n", getpid(), data_type_s);
-	return SIGMET_BAD_ARG;
+
+    /*
+       Read headers. As a side effect, this initializes vol_p.
+     */
+
+    if ( (sig_stat = Sigmet_Vol_ReadHdr(f, vol_p)) != SIGMET_OK ) {
+	fprintf(stderr, "%d: could not read volume headers.\n", getpid());
+	Sigmet_Vol_Free(vol_p);
+	return sig_stat;
     }
-    if ( Sigmet_Vol_GetFld(vol_p, data_type_s, &dat_p) >= 0 ) {
-	fprintf(stderr, "%d: data type %s already exists in volume.\n",
-		getpid(), data_type_s);
-	return SIGMET_BAD_ARG;
+    if ( filt_p ) {
+	vol_p->filter = *filt_p;
+	vol_filter_types(vol_p);
     }
-    if ( vol_p->num_types + 1 > SIGMET_MAX_TYPES ) {
-	fprintf(stderr, "%d: adding %s to volume would exceed maximum type "
-		"count.\n", getpid(), data_type_s);
-	return SIGMET_BAD_ARG;
+
+    num_sweeps = vol_p->ih.tc.tni.num_sweeps;
+    num_rays = vol_p->ih.ic.num_rays;
+    if ( (sig_stat = vol_alloc(vol_p)) != SIGMET_OK ) {
+	goto error;
     }
-    dat_p = vol_p->dat + vol_p->num_types;
-    strlcpy(dat_p->data_type_s, "", SIGMET_NAME_LEN);
-    strlcpy(dat_p->descr, "", SIGMET_DESCR_LEN);
-    strlcpy(dat_p->unit, "", SIGMET_NAME_LEN);
-    dat_p->stor_fmt = SIGMET_FLT;
-    dat_p->stor_to_comp = Sigmet_DblDbl;
-    dat_p->vals.f = NULL;
-    dat_p->vals_id = -1;
-    num_sweeps = vol_p->ih.tc.tni.num_sweeps;
-    num_rays = vol_p->ih.ic.num_rays;
-    num_bins = vol_p->ih.tc.tri.num_bins_out;
-    id_p = vol_p->shm ? &dat_p->vals_id : NULL;
-    flt_p = malloc3_flt(num_sweeps, num_rays, num_bins, id_p);
-    if ( !flt_p ) {
-	fprintf(stderr, "%d: could not allocate new field ", getpid());
-	return SIGMET_MEM_FAIL;
-    }
-    dat_p->vals.f = flt_p;
-    strlcpy(dat_p->data_type_s, data_type_s, SIGMET_NAME_LEN);
-    if ( descr ) {
-	strncpy(dat_p->descr, descr, SIGMET_NAME_LEN);
-    }
-    if ( unit ) {
-	strncpy(dat_p->unit, unit, SIGMET_NAME_LEN);
-    }
-    hash_add(vol_p, data_type_s, vol_p->num_types);
-    vol_p->size += num_sweeps * num_rays * num_bins * sizeof(float);
-    vol_p->num_types++;
-    vol_p->mod = 1;
-    return SIGMET_OK;
-}
 
-enum SigmetStatus Sigmet_Vol_DelField(struct Sigmet_Vol *vol_p,
-	char *data_type_s)
-{
-    struct Sigmet_Dat *dat_p, *dat1_p;
-    int num_sweeps, num_rays, num_bins;
-    int y;
+    /*
+       Decode the data records. If the input is a regular file, the
+       records come straight from a memory map of it.
+     */
 
-    if ( !data_type_s ) {
-	fprintf(stderr, "%d: attempted to remove a bogus field.\n", getpid());
-	return SIGMET_BAD_ARG;
-    }
-    if ( !vol_p ) {
-	fprintf(stderr, "%d: attempted to remove a field from a "
-		"bogus volume.\n", getpid());
-	return SIGMET_BAD_ARG;
-    }
-    if ( Sigmet_Vol_GetFld(vol_p, data_type_s, &dat_p) == -1 ) {
-	fprintf(stderr, "%d: data type %s not in volume.\n",
-		getpid(), data_type_s);
-	return SIGMET_BAD_ARG;
-    }
-    if ( vol_p->shm ) {
-	if ( shmdt(dat_p->vals.f) == -1 ) {
-	    fprintf(stderr, "%d: could not detach from shared memory for "
-		    "field %s.\n%s\n", getpid(), data_type_s, strerror(errno));
-	    return SIGMET_MEM_FAIL;
+    rec_src_init(&src, f);
+    have_src = 1;
+    if ( src.map
+	    && (lazy || vol_p->filter.num_threads > 1) ) {
+	if ( (sig_stat = vol_idx(vol_p, &src)) != SIGMET_OK ) {
+	    goto error;
 	}
-	if ( shmctl(dat_p->vals_id, IPC_RMID, NULL) == -1 ) {
-	    fprintf(stderr, "%d: could not remove shared memory for "
-		    "field %s.\n%s\n", getpid(), data_type_s, strerror(errno));
-	    return SIGMET_MEM_FAIL;
+
+	/*
+	   Volume keeps the memory map, so that it can decode sweeps later.
+	 */
+
+	fseeko(f, (off_t)(src.map_p - src.map), SEEK_SET);
+	vol_p->rec_map = src.map;
+	vol_p->rec_map_sz = src.map_sz;
+	have_src = 0;
+	if ( lazy ) {
+	    posix_madvise(src.map, src.map_sz, POSIX_MADV_NORMAL);
+	    return SIGMET_OK;
+	}
+
+	/*
+	   Decode all sweeps now, on several threads, then drop the index.
+	 */
+
+	posix_madvise(src.map, src.map_sz, POSIX_MADV_WILLNEED);
+	if ( (sig_stat = load_sweeps(vol_p)) != SIGMET_OK ) {
+	    goto error;
+	}
+	munmap(vol_p->rec_map, vol_p->rec_map_sz);
+	vol_p->rec_map = NULL;
+	vol_p->rec_map_sz = 0;
+	FREE(vol_p->sweep_idx);
+	vol_p->sweep_idx = NULL;
+	vol_p->size -= num_sweeps * sizeof(struct Sigmet_Sweep_Idx);
+	return SIGMET_OK;
+    }
+    dcdr_init(&dcdr, vol_p);
+    while ( dcdr.stop == DCDR_GO && (rec = rec_src_next(&src)) ) {
+	if ( (sig_stat = dcdr_rec(&dcdr, rec)) != SIGMET_OK ) {
+	    goto error;
 	}
-    } else {
-	FREE(dat_p->vals.f);
     }
-    memset(dat_p, 0, sizeof(struct Sigmet_Dat));
-    num_sweeps = vol_p->ih.tc.tni.num_sweeps;
-    num_rays = vol_p->ih.ic.num_rays;
-    num_bins = vol_p->ih.tc.tri.num_bins_out;
-    vol_p->size -= num_sweeps * num_rays * num_bins * sizeof(float);
+    rec_src_close(&src);
+    have_src = 0;
 
     /*
-       Slide the rest of the members of dat down one to fill the hole.
+       If input ended in the middle of a ray, discard the part of the ray
+       that was decoded.
      */
 
-    for (dat1_p = dat_p + 1;
-	    dat1_p < vol_p->dat + vol_p->num_types;
-	    dat_p++, dat1_p++) {
-	*dat_p = *dat1_p;
+    if ( dcdr.stop == DCDR_GO && dcdr.w > 0 ) {
+	if ( dcdr.u1 ) {
+	    memset(dcdr.u1, 0, dcdr.num_bins);
+	} else if ( dcdr.u2 ) {
+	    memset(dcdr.u2, 0, dcdr.num_bins * sizeof(U2BYT));
+	}
     }
-    vol_p->num_types--;
-    for (dat_p = vol_p->dat + vol_p->num_types;
-	    dat_p < vol_p->dat + SIGMET_MAX_TYPES;
-	    dat_p++) {
-	memset(dat_p, 0, sizeof(struct Sigmet_Dat));
-	dat_p->stor_fmt = SIGMET_MT;
-	dat_p->vals_id = -1;
+    if ( dcdr.stop == DCDR_TRUNC ) {
+	vol_p->truncated = 1;
+	vol_p->num_sweeps_ax = dcdr.sweep_num;
+	return SIGMET_OK;
     }
-    memset(vol_p->types_tbl, 0, sizeof(vol_p->types_tbl));
-    for (y = 0; y < vol_p->num_types; y++) {
-	hash_add(vol_p, vol_p->dat[y].data_type_s, y);
+    for (s = 0;
+	    s < vol_p->ih.tc.tni.num_sweeps
+	    && (vol_p->sweep_hdr[s].ok
+		|| (!sweep_ld(&vol_p->filter, s) && s < dcdr.sweep_num));
+	    s++) {
+	continue;
     }
-    vol_p->mod = 1;
+    vol_p->truncated = (dcdr.r + 1 < num_rays || s + 1 < num_sweeps) ? 1 : 0;
+    vol_p->num_sweeps_ax = s;
+
     return SIGMET_OK;
+
+error:
+    if ( have_src ) {
+	rec_src_close(&src);
+    }
+    Sigmet_Vol_Free(vol_p);
+    return sig_stat;
 }
 
 /*
-   Set data array to value v.
+   Allocate sweep header, ray header, and data arrays for the volume
+   described by the headers in vol_p. Caller should free vol_p if this
+   fails.
  */
 
-enum SigmetStatus Sigmet_Vol_Fld_SetVal(struct Sigmet_Vol *vol_p,
-	char *data_type_s, float v)
+static enum SigmetStatus vol_alloc(struct Sigmet_Vol *vol_p)
 {
-    struct Sigmet_Dat *dat_p;
-    int s, r;
-    float *dp, *dp1;
+    int num_sweeps;			/* Number of sweeps in vol_p */
+    unsigned num_rays;			/* Number of rays per sweep */
+    int num_bins;			/* Number of output bins */
+    long num_sweeps_l;			/* Number of sweeps loaded */
+    int s, y;				/* Sweep, data type indeces */
+    size_t sz;
 
-    if ( !vol_p || !data_type_s ) {
-	return SIGMET_BAD_ARG;
+    num_sweeps = vol_p->ih.tc.tni.num_sweeps;
+    num_rays = vol_p->ih.ic.num_rays;
+    num_bins = vol_p->ih.tc.tri.num_bins_out;
+    num_sweeps_l = num_sweeps_ld(&vol_p->filter, num_sweeps);
+
+    /*
+       Allocate sweep and ray header arrays in vol_p.
+     */
+
+    vol_p->sweep_hdr = vol_pool_alloc(vol_p,
+	    num_sweeps * sizeof(*vol_p->sweep_hdr));
+    if ( !vol_p->sweep_hdr ) {
+	fprintf(stderr, "%d: could not allocate sweep header array.\n",
+		getpid());
+	return SIGMET_MEM_FAIL;
     }
-    if ( Sigmet_Vol_GetFld(vol_p, data_type_s, &dat_p) == -1 ) {
-	fprintf(stderr, "%d: no field of %s in volume.\n",
-		getpid(), data_type_s);
-	return SIGMET_BAD_ARG;
+    vol_p->size += num_sweeps * sizeof(*vol_p->sweep_hdr);
+    sz = num_sweeps * sizeof(struct Sigmet_Ray_Hdr *)
+	+ (num_sweeps * num_rays + 1) * sizeof(struct Sigmet_Ray_Hdr);
+    vol_p->ray_hdr = (struct Sigmet_Ray_Hdr **)vol_pool_alloc(vol_p, sz);
+    if ( !vol_p->ray_hdr ) {
+	fprintf(stderr, "%d: could not allocate memory for ray header "
+		"array.\n", getpid());
+	return SIGMET_MEM_FAIL;
     }
-    dat_p->stor_fmt = SIGMET_FLT;
-    for (s = 0; s < vol_p->ih.ic.num_sweeps; s++) {
-	if ( vol_p->sweep_hdr[s].ok ) {
-	    for (r = 0; r < vol_p->ih.ic.num_rays; r++) {
-		if ( vol_p->ray_hdr[s][r].ok ) {
-		    dp = dat_p->vals.f[s][r];
-		    dp1 = dp + vol_p->ray_hdr[s][r].num_bins;
-		    for ( ; dp < dp1; dp++) {
-			*dp = v;
-		    }
+    vol_p->size += sz;
+    /*
+       Rays that are not loaded, or not in the file, keep the zero headers
+       that the allocation starts with, which mark them as not ok.
+     */
+
+    vol_p->ray_hdr[0] = (struct Sigmet_Ray_Hdr *)(vol_p->ray_hdr + num_sweeps);
+    for (s = 1; s < num_sweeps; s++) {
+	vol_p->ray_hdr[s] = vol_p->ray_hdr[s - 1] + num_rays;
+    }
+
+    /*
+       Allocate data arrays in vol_p.
+     */
+
+    for (y = 0; y < vol_p->num_types; y++) {
+	switch (vol_p->dat[y].stor_fmt) {
+	    case SIGMET_U1:
+	    case SIGMET_U2:
+		if ( !fld_alloc(vol_p, vol_p->dat + y, num_sweeps, num_rays,
+			    num_bins, &vol_p->filter) ) {
+		    fprintf(stderr, "%d: could not allocate memory for %s\n",
+			    getpid(), vol_p->dat[y].data_type_s);
+		    return SIGMET_MEM_FAIL;
 		}
-	    }
+		vol_p->size += vol_p->dat[y].vals_sz / num_sweeps
+		    * num_sweeps_l;
+		break;
+	    case SIGMET_FLT:
+	    case SIGMET_F16:
+	    case SIGMET_DBL:
+	    case SIGMET_MT:
+		fprintf(stderr, "%d: volume in memory is corrupt. Unknown data "
+			"type in data array.", getpid());
+		return SIGMET_BAD_VOL;
 	}
     }
-    vol_p->mod = 1;
     return SIGMET_OK;
 }
 
 /*
-   Initialize data array to distance along beam.
+   Make an index of the sweeps in the data records from src_p, and store
+   it in vol_p. Also store sweep headers, and the sweep count.
  */
 
-enum SigmetStatus Sigmet_Vol_Fld_SetRBeam(struct Sigmet_Vol *vol_p,
-	char *data_type_s)
+static enum SigmetStatus vol_idx(struct Sigmet_Vol *vol_p,
+	struct rec_src *src_p)
 {
-    struct Sigmet_Dat *dat_p;
-    float ***f;
-    int s, r, b;
-    double bin0;			/* Range to center of 1st bin */
-    double bin_step;
+    struct Sigmet_Sweep_Idx *idx;	/* Index for vol_p */
+    int num_sweeps;			/* Number of sweeps in vol_p */
+    U1BYT *rec;				/* Current data record */
+    int rec_idx;			/* Index of last record */
+    int sweep_num;			/* Current sweep number (1 is first) */
+    int done = 0;			/* If true, a sweep header with sweep
+					   number 0 ended the volume */
+    int trunc = 0;			/* If true, sweeps went out of order */
+    int num_rays;
+    int s, i, n;
 
-    if ( !vol_p || !data_type_s ) {
-	return SIGMET_BAD_ARG;
+    num_sweeps = vol_p->ih.tc.tni.num_sweeps;
+    num_rays = vol_p->ih.ic.num_rays;
+    idx = CALLOC(num_sweeps, sizeof(struct Sigmet_Sweep_Idx));
+    if ( !idx ) {
+	fprintf(stderr, "%d: could not allocate sweep index.\n", getpid());
+	return SIGMET_MEM_FAIL;
     }
-    if ( Sigmet_Vol_GetFld(vol_p, data_type_s, &dat_p) == -1 ) {
-	fprintf(stderr, "%d: no field of %s in volume.\n",
-		getpid(), data_type_s);
-	return SIGMET_BAD_ARG;
+    vol_p->sweep_idx = idx;
+    vol_p->size += num_sweeps * sizeof(struct Sigmet_Sweep_Idx);
+    for (s = 0; s < num_sweeps; s++) {
+	idx[s].ld = 1;
     }
-    dat_p->stor_fmt = SIGMET_FLT;
-    f = dat_p->vals.f;
-    bin_step = 0.01 * vol_p->ih.tc.tri.step_out;	/* cm -> meter */
-    bin0 = 0.01 * vol_p->ih.tc.tri.rng_1st_bin + bin_step / 2;
-    for (s = 0; s < vol_p->ih.ic.num_sweeps; s++) {
-	if ( vol_p->sweep_hdr[s].ok ) {
-	    for (r = 0; r < vol_p->ih.ic.num_rays; r++) {
-		if ( vol_p->ray_hdr[s][r].ok ) {
-		    for (b = 0; b < vol_p->ray_hdr[s][r].num_bins; b++)  {
-			f[s][r][b] = bin0 + b * bin_step;
-		    }
+
+    /*
+       Only look at <raw_prod_bhdr> of each record, and the
+       <ingest_data_header> at the start of each sweep.
+     */
+
+    for (rec_idx = 1, sweep_num = 0, s = -1;
+	    !done && !trunc && (rec = rec_src_next(src_p)); ) {
+	i = get_sint16(rec, vol_p->swap);
+	n = get_sint16(rec + 2, vol_p->swap);
+	if ( i != rec_idx + 1 ) {
+	    fprintf(stderr, "%d: sigmet raw product file records out of "
+		    "sequence.\n", getpid());
+	    return SIGMET_BAD_FILE;
+	}
+	rec_idx = i;
+	if ( n != sweep_num ) {
+	    if ( n != sweep_num + 1 ) {
+		if ( sweep_num > 0 ) {
+		    trunc = 1;
+		    continue;
+		} else {
+		    fprintf(stderr, "%d: sweep number out of order in raw "
+			    "product file.\n", getpid());
+		    return SIGMET_BAD_FILE;
 		}
 	    }
+	    if ( n > num_sweeps ) {
+		fprintf(stderr, "%d: volume has excess sweeps.\n", getpid());
+		return SIGMET_BAD_FILE;
+	    }
+	    if ( s >= 0 ) {
+		idx[s].last = 0;
+	    }
+	    sweep_num = n;
+	    s = n - 1;
+	    if ( !swp_start(vol_p, s, rec, !sweep_ld(&vol_p->filter, s)) ) {
+		done = 1;
+		continue;
+	    }
+	    idx[s].off = (size_t)(rec - src_p->map);
+	    idx[s].ld = !sweep_ld(&vol_p->filter, s);
+	    idx[s].last = 1;
 	}
+	idx[s].num_recs++;
     }
-    vol_p->mod = 1;
+    if ( trunc ) {
+	vol_p->truncated = 1;
+	vol_p->num_sweeps_ax = sweep_num;
+	return SIGMET_OK;
+    }
+    for (s = 0;
+	    s < num_sweeps
+	    && (vol_p->sweep_hdr[s].ok
+		|| (!sweep_ld(&vol_p->filter, s) && s < sweep_num));
+	    s++) {
+	continue;
+    }
+
+    /*
+       Derive the flag from the last ray and sweep, as vol_read does. When
+       a sweep header ends the volume, vol_read stops at ray 0 of the
+       empty sweep. Otherwise the last sweep runs to the end of the file,
+       and its last ray is not known until Sigmet_Vol_LoadSweep decodes
+       it and refines the flag.
+     */
+
+    vol_p->truncated = ((done && 1 < num_rays) || s + 1 < num_sweeps)
+	? 1 : 0;
+    vol_p->num_sweeps_ax = s;
     return SIGMET_OK;
 }
 
 /*
-   Replace contents of field abbrv1 with contents of field abbrv2.
+   Decode sweep s of vol_p, if vol_p was read with Sigmet_Vol_ReadIdx and
+   the sweep has not been decoded yet. If s is -1, decode all sweeps, with
+   as many threads as the volume filter allows. If vol_p is being followed,
+   wait for the ingest thread to finish sweep s, or the volume if s is -1,
+   instead.
  */
 
-enum SigmetStatus Sigmet_Vol_Fld_Copy(struct Sigmet_Vol *vol_p, char *abbrv1,
-	char *abbrv2)
+enum SigmetStatus Sigmet_Vol_LoadSweep(struct Sigmet_Vol *vol_p, int s)
 {
-    struct Sigmet_Dat *dat_p1, *dat_p2;
-    int s, r, b;
-    int num_sweeps, num_rays, num_bins;
-    size_t sz;
-    float v2;
+    int trunc;				/* If true, last sweep lacks rays */
+    enum SigmetStatus sig_stat;
 
     if ( !vol_p ) {
-	fprintf(stderr, "%d: attempted to add field to bogus volume.\n",
-		getpid());
-	return SIGMET_BAD_ARG;
-    }
-    if ( !abbrv1 || !abbrv2 ) {
-	fprintf(stderr, "%d: attempted to add bogus field.\n", getpid());
 	return SIGMET_BAD_ARG;
     }
-    if ( Sigmet_DataType_GetN(abbrv1, NULL) ) {
-	fprintf(stderr, "%d: %s is a built in Sigmet data type.\n"
-		" No modification allowed.\n", getpid(), abbrv1);
-	return SIGMET_BAD_ARG;
-    }
-    if ( Sigmet_Vol_GetFld(vol_p, abbrv1, &dat_p1) == -1 ) {
-	fprintf(stderr, "%d: no field of %s in volume.\n", getpid(), abbrv1);
-	return SIGMET_BAD_ARG;
+    if ( s < -1 || s >= vol_p->ih.tc.tni.num_sweeps ) {
+	fprintf(stderr, "%d: sweep index %d out of range.\n", getpid(), s);
+	return SIGMET_RNG_ERR;
     }
-    if ( dat_p1->stor_fmt != SIGMET_FLT ) {
-	fprintf(stderr, "%d: editable field in volume not in correct format.\n",
-		getpid());
-	return SIGMET_BAD_VOL;
+    if ( vol_p->ingest ) {
+	ingest_wait(vol_p, s);
+	return SIGMET_OK;
     }
-    if ( Sigmet_Vol_GetFld(vol_p, abbrv2, &dat_p2) == -1 ) {
-	fprintf(stderr, "%d: no field of %s in volume.\n", getpid(), abbrv2);
-	return SIGMET_BAD_ARG;
+    if ( s == -1 ) {
+	return load_sweeps(vol_p);
     }
-    switch (dat_p2->stor_fmt) {
-	case SIGMET_U1:
-	    for (s = 0; s < vol_p->ih.ic.num_sweeps; s++) {
-		if ( vol_p->sweep_hdr[s].ok ) {
-		    for (r = 0; r < vol_p->ih.ic.num_rays; r++) {
-			if ( vol_p->ray_hdr[s][r].ok ) {
-			    for (b = 0; b < vol_p->ray_hdr[s][r].num_bins; b++)
-			    {
-				v2 = dat_p2->vals.u1[s][r][b];
-				v2 = dat_p2->stor_to_comp(v2, vol_p);
-				dat_p1->vals.f[s][r][b] = v2;
-			    }
-			}
-		    }
-		}
-	    }
-	    break;
-	case SIGMET_U2:
-	    for (s = 0; s < vol_p->ih.ic.num_sweeps; s++) {
-		if ( vol_p->sweep_hdr[s].ok ) {
-		    for (r = 0; r < vol_p->ih.ic.num_rays; r++) {
-			if ( vol_p->ray_hdr[s][r].ok ) {
-			    for (b = 0; b < vol_p->ray_hdr[s][r].num_bins; b++)
-			    {
-				v2 = dat_p2->vals.u2[s][r][b];
-				v2 = dat_p2->stor_to_comp(v2, vol_p);
-				dat_p1->vals.f[s][r][b] = v2;
-			    }
-			}
-		    }
-		}
-	    }
-	    break;
-	case SIGMET_FLT:
-	    num_sweeps = vol_p->ih.tc.tni.num_sweeps;
-	    num_rays = vol_p->ih.ic.num_rays;
-	    num_bins = vol_p->ih.tc.tri.num_bins_out;
-	    sz = num_sweeps * num_rays * num_bins;
-	    memcpy(dat_p1->vals.f, dat_p2->vals.f, sz);
-	    break;
-	case SIGMET_DBL:
-	case SIGMET_MT:
-	    for (s = 0; s < vol_p->ih.ic.num_sweeps; s++) {
-		if ( vol_p->sweep_hdr[s].ok ) {
-		    for (r = 0; r < vol_p->ih.ic.num_rays; r++) {
-			if ( vol_p->ray_hdr[s][r].ok ) {
-			    for (b = 0; b < vol_p->ray_hdr[s][r].num_bins; b++)
-			    {
-				dat_p1->vals.f[s][r][b] = NAN;
-			    }
-			}
-		    }
-		}
-	    }
-	    break;
+    sig_stat = load_sweep(vol_p, s, &trunc);
+    if ( trunc ) {
+	vol_p->truncated = 1;
     }
-    vol_p->mod = 1;
-    return SIGMET_OK;
+    return sig_stat;
 }
 
 /*
-   Add scalar value v to a field.
+   Decode sweep s of vol_p, if it is waiting to be decoded. Set *trunc_p
+   to true if s is the last sweep in the file, and it lacks rays. This
+   function does not write vol_p->truncated, so threads in load_sweeps can
+   call it concurrently for different sweeps.
  */
 
-enum SigmetStatus Sigmet_Vol_Fld_AddVal(struct Sigmet_Vol *vol_p,
-	char *data_type_s, float v)
+static enum SigmetStatus load_sweep(struct Sigmet_Vol *vol_p, int s,
+	int *trunc_p)
 {
-    enum Sigmet_DataTypeN sig_type;
-    struct Sigmet_Dat *dat_p;
-    int s, r;
-    float *dp, *dp1;
+    struct Sigmet_Sweep_Idx *idx_p;
+    struct rec_dcdr dcdr;		/* Decode data records */
+    U1BYT *rec;				/* Current data record */
+    int num_rays;
+    int n;
+    enum SigmetStatus sig_stat;
 
-    if ( !vol_p ) {
-	fprintf(stderr, "%d: attempted to add field to bogus volume.\n",
-		getpid());
-	return SIGMET_BAD_ARG;
-    }
-    if ( !data_type_s ) {
-	fprintf(stderr, "%d: attempted to add bogus field.\n", getpid());
-	return SIGMET_BAD_ARG;
-    }
-    if ( Sigmet_DataType_GetN(data_type_s, &sig_type) ) {
-	fprintf(stderr, "%d: %s is a built in Sigmet data type.\n"
-		" No modification allowed.\n", getpid(), data_type_s);
-	return SIGMET_BAD_ARG;
-    }
-    if ( Sigmet_Vol_GetFld(vol_p, data_type_s, &dat_p) == -1 ) {
-	fprintf(stderr, "%d: no field of %s in volume.\n",
-		getpid(), data_type_s);
-	return SIGMET_BAD_ARG;
+    *trunc_p = 0;
+    num_rays = vol_p->ih.ic.num_rays;
+    if ( !vol_p->sweep_idx || vol_p->sweep_idx[s].ld ) {
+	return SIGMET_OK;
     }
-    if ( dat_p->stor_fmt != SIGMET_FLT ) {
-	fprintf(stderr, "%d: editable field in volume not in correct format.\n",
-		getpid());
-	return SIGMET_BAD_VOL;
+    idx_p = vol_p->sweep_idx + s;
+    idx_p->ld = 1;
+
+    /*
+       Set up the decoder as if it had just finished the previous sweep.
+     */
+
+    dcdr_init(&dcdr, vol_p);
+    rec = vol_p->rec_map + idx_p->off;
+    dcdr.rec_idx = get_sint16(rec, vol_p->swap) - 1;
+    dcdr.sweep_num = s;
+    for (n = 0; n < idx_p->num_recs && dcdr.stop == DCDR_GO; n++) {
+	if ( (sig_stat = dcdr_rec(&dcdr, rec)) != SIGMET_OK ) {
+	    goto error;
+	}
+	rec += REC_LEN;
     }
-    for (s = 0; s < vol_p->ih.ic.num_sweeps; s++) {
-	if ( vol_p->sweep_hdr[s].ok ) {
-	    for (r = 0; r < vol_p->ih.ic.num_rays; r++) {
-		if ( vol_p->ray_hdr[s][r].ok ) {
-		    dp = dat_p->vals.f[s][r];
-		    dp1 = dp + vol_p->ray_hdr[s][r].num_bins;
-		    for ( ; dp < dp1; dp++) {
-			*dp += v;
-		    }
-		}
-	    }
+
+    /*
+       If the sweep ended in the middle of a ray, discard the part of the
+       ray that was decoded.
+     */
+
+    if ( dcdr.stop == DCDR_GO && dcdr.w > 0 ) {
+	if ( dcdr.u1 ) {
+	    memset(dcdr.u1, 0, dcdr.num_bins);
+	} else if ( dcdr.u2 ) {
+	    memset(dcdr.u2, 0, dcdr.num_bins * sizeof(U2BYT));
 	}
     }
-    vol_p->mod = 1;
+    *trunc_p = (idx_p->last && dcdr.r + 1 < num_rays);
     return SIGMET_OK;
+
+error:
+    fprintf(stderr, "%d: could not load sweep %d.\n", getpid(), s);
+    vol_p->sweep_hdr[s].ok = 0;
+    memset(vol_p->ray_hdr[s], 0, num_rays * sizeof(struct Sigmet_Ray_Hdr));
+    return sig_stat;
 }
 
 /*
-   Add field abbrv2 to abbrv1.
+   Decode all sweeps of vol_p that are waiting to be decoded. Use up to
+   vol_p->filter.num_threads threads. Return the first failure, or
+   SIGMET_OK.
  */
 
-enum SigmetStatus Sigmet_Vol_Fld_AddFld(struct Sigmet_Vol *vol_p, char *abbrv1,
-	char *abbrv2)
+static enum SigmetStatus load_sweeps(struct Sigmet_Vol *vol_p)
 {
-    struct Sigmet_Dat *dat_p1, *dat_p2;
-    int sgn = 1;		/* -1 if *abbrv2 == '-' (negate the field) */
-    int s, r, b;
-    float v1, v2;
+    struct sweep_pool pool;
+    pthread_t *thr = NULL;		/* Decoding threads */
+    int num_thr;			/* Number of threads to start */
+    int num_waiting;			/* Number of sweeps to decode */
+    int n, s;
+
+    pool.vol_p = vol_p;
+    pool.num_sweeps = vol_p->ih.tc.tni.num_sweeps;
+    pool.s = 0;
+    pool.status = SIGMET_OK;
+    pool.truncated = 0;
+    if ( !vol_p->sweep_idx ) {
+	return SIGMET_OK;
+    }
+    for (num_waiting = 0, s = 0; s < pool.num_sweeps; s++) {
+	if ( !vol_p->sweep_idx[s].ld ) {
+	    num_waiting++;
+	}
+    }
+    num_thr = vol_p->filter.num_threads;
+    num_thr = (num_thr > num_waiting) ? num_waiting : num_thr;
+    if ( num_thr > 1 && (thr = CALLOC(num_thr, sizeof(pthread_t))) ) {
+	if ( pthread_mutex_init(&pool.mtx, NULL) != 0 ) {
+	    FREE(thr);
+	    thr = NULL;
+	}
+    }
+    if ( !thr ) {
+	/*
+	   Decode in this thread.
+	 */
 
-    if ( !vol_p ) {
-	fprintf(stderr, "%d: attempted to add field to bogus volume.\n",
-		getpid());
-	return SIGMET_BAD_ARG;
+	for (s = 0; s < pool.num_sweeps; s++) {
+	    enum SigmetStatus sig_stat = Sigmet_Vol_LoadSweep(vol_p, s);
+
+	    if ( sig_stat != SIGMET_OK && pool.status == SIGMET_OK ) {
+		pool.status = sig_stat;
+	    }
+	}
+	return pool.status;
     }
-    if ( !abbrv1 || !abbrv2 ) {
-	fprintf(stderr, "%d: attempted to add bogus field.\n", getpid());
-	return SIGMET_BAD_ARG;
+
+    /*
+       This thread decodes along with the others. If a thread cannot be
+       started, the threads that did start take its sweeps.
+     */
+
+    for (n = 1; n < num_thr; n++) {
+	if ( pthread_create(thr + n, NULL, sweep_thr, &pool) != 0 ) {
+	    break;
+	}
     }
-    if ( Sigmet_DataType_GetN(abbrv1, NULL) ) {
-	fprintf(stderr, "%d: %s is a built in Sigmet data type.\n"
-		" No modification allowed.\n", getpid(), abbrv1);
-	return SIGMET_BAD_ARG;
+    num_thr = n;
+    sweep_thr(&pool);
+    for (n = 1; n < num_thr; n++) {
+	pthread_join(thr[n], NULL);
     }
-    if ( Sigmet_Vol_GetFld(vol_p, abbrv1, &dat_p1) == -1 ) {
-	fprintf(stderr, "%d: no field of %s in volume.\n", getpid(), abbrv1);
-	return SIGMET_BAD_ARG;
+    FREE(thr);
+    pthread_mutex_destroy(&pool.mtx);
+    if ( pool.truncated ) {
+	vol_p->truncated = 1;
     }
-    if ( dat_p1->stor_fmt != SIGMET_FLT ) {
-	fprintf(stderr, "%d: editable field in volume not in correct format.\n",
-		getpid());
-	return SIGMET_BAD_VOL;
+    return pool.status;
+}
+
+/*
+   Thread start routine for load_sweeps. Decode sweeps from the pool at
+   arg until none are left. Each sweep only writes its own headers and
+   its own slice of the data arrays, so decoding needs no other locks.
+   Truncation goes to the pool, and load_sweeps applies it to the volume
+   after the threads finish.
+ */
+
+static void *sweep_thr(void *arg)
+{
+    struct sweep_pool *pool_p = arg;
+    enum SigmetStatus sig_stat;
+    int trunc;				/* If true, last sweep lacks rays */
+    int s;
+
+    while ( 1 ) {
+	pthread_mutex_lock(&pool_p->mtx);
+	s = pool_p->s++;
+	pthread_mutex_unlock(&pool_p->mtx);
+	if ( s >= pool_p->num_sweeps ) {
+	    return NULL;
+	}
+	sig_stat = load_sweep(pool_p->vol_p, s, &trunc);
+	if ( sig_stat != SIGMET_OK || trunc ) {
+	    pthread_mutex_lock(&pool_p->mtx);
+	    if ( sig_stat != SIGMET_OK && pool_p->status == SIGMET_OK ) {
+		pool_p->status = sig_stat;
+	    }
+	    pool_p->truncated = pool_p->truncated || trunc;
+	    pthread_mutex_unlock(&pool_p->mtx);
+	}
     }
-    if ( *abbrv2 == '-' ) {
-	sgn = -1;
-	abbrv2++;
+}
+
+/*
+   If sweep s of vol_p is waiting to be decoded, decode it now. If s is -1,
+   make sure all sweeps are decoded. If decoding fails, the sweep is marked
+   bad. If vol_p is being followed, wait for the ingest thread instead.
+ */
+
+static void sweep_ready(struct Sigmet_Vol *vol_p, int s)
+{
+    if ( vol_p && vol_p->ingest ) {
+	ingest_wait(vol_p, s);
+	return;
     }
-    if ( Sigmet_Vol_GetFld(vol_p, abbrv2, &dat_p2) == -1 ) {
-	fprintf(stderr, "%d: no field of %s in volume.\n", getpid(), abbrv2);
-	return SIGMET_BAD_ARG;
+    if ( !vol_p || !vol_p->sweep_idx ) {
+	return;
     }
-    switch (dat_p2->stor_fmt) {
-	case SIGMET_U1:
-	    for (s = 0; s < vol_p->ih.ic.num_sweeps; s++) {
-		if ( vol_p->sweep_hdr[s].ok ) {
-		    for (r = 0; r < vol_p->ih.ic.num_rays; r++) {
-			if ( vol_p->ray_hdr[s][r].ok ) {
-			    for (b = 0; b < vol_p->ray_hdr[s][r].num_bins; b++)
-			    {
-				v1 = dat_p1->vals.f[s][r][b];
-				v2 = dat_p2->vals.u1[s][r][b];
-				v2 = dat_p2->stor_to_comp(v2, vol_p);
-				dat_p1->vals.f[s][r][b] = v1 + sgn * v2;
-			    }
-			}
-		    }
-		}
-	    }
-	    break;
-	case SIGMET_U2:
-	    for (s = 0; s < vol_p->ih.ic.num_sweeps; s++) {
-		if ( vol_p->sweep_hdr[s].ok ) {
-		    for (r = 0; r < vol_p->ih.ic.num_rays; r++) {
-			if ( vol_p->ray_hdr[s][r].ok ) {
-			    for (b = 0; b < vol_p->ray_hdr[s][r].num_bins; b++)
-			    {
-				v1 = dat_p1->vals.f[s][r][b];
-				v2 = dat_p2->vals.u2[s][r][b];
-				v2 = dat_p2->stor_to_comp (v2, vol_p);
-				dat_p1->vals.f[s][r][b] = v1 + sgn * v2;
-			    }
-			}
-		    }
-		}
-	    }
-	    break;
-	case SIGMET_FLT:
-	    for (s = 0; s < vol_p->ih.ic.num_sweeps; s++) {
-		if ( vol_p->sweep_hdr[s].ok ) {
-		    for (r = 0; r < vol_p->ih.ic.num_rays; r++) {
-			if ( vol_p->ray_hdr[s][r].ok ) {
-			    for (b = 0; b < vol_p->ray_hdr[s][r].num_bins; b++)
-			    {
-				v1 = dat_p1->vals.f[s][r][b];
-				v2 = dat_p2->vals.f[s][r][b];
-				dat_p1->vals.f[s][r][b] = v1 + sgn * v2;
-			    }
-			}
-		    }
-		}
-	    }
-	    break;
-	case SIGMET_DBL:
-	case SIGMET_MT:
-	    for (s = 0; s < vol_p->ih.ic.num_sweeps; s++) {
-		if ( vol_p->sweep_hdr[s].ok ) {
-		    for (r = 0; r < vol_p->ih.ic.num_rays; r++) {
-			if ( vol_p->ray_hdr[s][r].ok ) {
-			    for (b = 0; b < vol_p->ray_hdr[s][r].num_bins; b++)
-			    {
-				dat_p1->vals.f[s][r][b] = NAN;
-			    }
-			}
-		    }
-		}
-	    }
-	    break;
+    if ( s == -1 ) {
+	Sigmet_Vol_LoadSweep(vol_p, -1);
+    } else if ( s >= 0 && s < vol_p->ih.tc.tni.num_sweeps
+	    && !vol_p->sweep_idx[s].ld ) {
+	Sigmet_Vol_LoadSweep(vol_p, s);
     }
-    vol_p->mod = 1;
-    return SIGMET_OK;
 }
 
 /*
-   Subtract scalar v from a field.
+   Make a lazy copy of src at dest, i.e. copy struct values and array
+   addresses, but not contents of arrays.
  */
 
-enum SigmetStatus Sigmet_Vol_Fld_SubVal(struct Sigmet_Vol *vol_p,
-	char *data_type_s, float v)
+void Sigmet_Vol_LzCpy(struct Sigmet_Vol *dest, struct Sigmet_Vol *src)
 {
-    enum Sigmet_DataTypeN sig_type;
-    struct Sigmet_Dat *dat_p;
-    int s, r;
-    float *dp, *dp1;
+    *dest = *src;
+}
 
-    if ( !vol_p ) {
-	fprintf(stderr, "%d: attempted to add field to bogus volume.\n",
-		getpid());
-	return SIGMET_BAD_ARG;
+int Sigmet_Vol_NearSweep(struct Sigmet_Vol *vol_p, double ang)
+{
+    int s, s1;
+    double swp_ang;			/* Sweep angle */
+    double d_ang;			/* Sweep angle minus ang */
+    double d_ang_min;			/* Smallest d_ang */
+
+    if ( !vol_p || !vol_p->sweep_hdr ) {
+	return -1;
     }
-    if ( !data_type_s ) {
-	fprintf(stderr, "%d: attempted to add bogus field.\n", getpid());
-	return SIGMET_BAD_ARG;
+    ingest_wait(vol_p, -1);
+    for (d_ang_min = DBL_MAX, s1 = -1, s = 0; s < vol_p->num_sweeps_ax; s++) {
+	swp_ang = GeogLonR(vol_p->sweep_hdr[s].angle, ang);
+	d_ang = fabs(swp_ang - ang);
+	if ( d_ang < d_ang_min ) {
+	    d_ang_min = d_ang;
+	    s1 = s;
+	}
     }
-    if ( Sigmet_DataType_GetN(data_type_s, &sig_type) ) {
-	fprintf(stderr, "%d: %s is a built in Sigmet data type.\n"
-		" No modification allowed.\n", getpid(), data_type_s);
-	return SIGMET_BAD_ARG;
+    return s1;
+}
+
+/*
+   Get or set radar longitude, latitude. Angles in radian.
+ */
+
+double Sigmet_Vol_RadarLon(struct Sigmet_Vol *vol_p, double *lon_p)
+{
+    if ( !vol_p ) {
+	return NAN;
     }
-    if ( Sigmet_Vol_GetFld(vol_p, data_type_s, &dat_p) == -1 ) {
-	fprintf(stderr, "%d: no field of %s in volume.\n",
-		getpid(), data_type_s);
-	return SIGMET_BAD_ARG;
+    if ( lon_p ) {
+	vol_p->ih.ic.longitude = Sigmet_RadBin4(GeogLonR(*lon_p, M_PI));
+	vol_p->mod = 1;
+	return *lon_p;
     }
-    if ( dat_p->stor_fmt != SIGMET_FLT ) {
-	fprintf(stderr, "%d: editable field in volume not in correct format.\n",
-		getpid());
-	return SIGMET_BAD_VOL;
+    return GeogLonR(Sigmet_Bin4Rad(vol_p->ih.ic.longitude), 0.0);
+}
+
+double Sigmet_Vol_RadarLat(struct Sigmet_Vol *vol_p, double *lat_p)
+{
+    if ( !vol_p ) {
+	return NAN;
     }
-    for (s = 0; s < vol_p->ih.ic.num_sweeps; s++) {
-	if ( vol_p->sweep_hdr[s].ok ) {
-	    for (r = 0; r < vol_p->ih.ic.num_rays; r++) {
-		if ( vol_p->ray_hdr[s][r].ok ) {
-		    dp = dat_p->vals.f[s][r];
-		    dp1 = dp + vol_p->ray_hdr[s][r].num_bins;
-		    for ( ; dp < dp1; dp++) {
-			*dp -= v;
-		    }
-		}
-	    }
-	}
+    if ( lat_p ) {
+	vol_p->ih.ic.latitude = Sigmet_RadBin4(*lat_p);
+	vol_p->mod = 1;
+	return *lat_p;
     }
-    vol_p->mod = 1;
-    return SIGMET_OK;
+    return GeogLatN(Sigmet_Bin4Rad(vol_p->ih.ic.latitude));
+}
+
+int Sigmet_Vol_GoodRay(struct Sigmet_Vol *vol_p, int s, int r)
+{
+    sweep_ready(vol_p, s);
+    switch (vol_p->ih.tc.tni.scan_mode) {
+	case PPI_S:
+	case PPI_C:
+	    return vol_p
+		&& s < vol_p->num_sweeps_ax
+		&& r < vol_p->ih.ic.num_rays
+		&& vol_p->ray_hdr[s][r].az0 != vol_p->ray_hdr[s][r].az1;
+	case RHI:
+	    return vol_p
+		&& s < vol_p->num_sweeps_ax
+		&& r < vol_p->ih.ic.num_rays
+		&& vol_p->ray_hdr[s][r].tilt0 != vol_p->ray_hdr[s][r].tilt1;
+	case MAN_SCAN:
+	case FILE_SCAN:
+	    return 0;
+    }
+    return 0;
 }
 
 /*
-   Replace field abbrv1 with abbrv1 - abbrv2.
+   Fetch ray geometry for sweep s.  r00_p and dr_p get distance to first ray
+   and bin step, in meters. Arrays az0 and az1 get initial and final azimuths,
+   tilt1 and tilt1 get initial and final tilts, in radians. They must point
+   to storage for num_rays double values. If fill is true, eliminate gaps
+   between adjacent rays.
  */
 
-enum SigmetStatus Sigmet_Vol_Fld_SubFld(struct Sigmet_Vol *vol_p, char *abbrv1,
-	char *abbrv2)
+enum SigmetStatus Sigmet_Vol_RayGeom(struct Sigmet_Vol *vol_p, int s,
+	double *r00_p, double *dr_p, double *az0, double *az1,
+	double *tilt0, double *tilt1, int fill)
 {
-    struct Sigmet_Dat *dat_p1, *dat_p2;
-    int sgn = 1;		/* -1 if *abbrv2 == '-' (negate the field) */
-    int s, r, b;
-    float v1, v2;
+    struct Sigmet_Ray_Hdr *ray_hdr;
+    int num_rays;
+    int r;
+    double m_per_cm = 0.01;
 
     if ( !vol_p ) {
-	fprintf(stderr, "%d: attempted to add field to bogus volume.\n",
-		getpid());
 	return SIGMET_BAD_ARG;
     }
-    if ( !abbrv1 || !abbrv2 ) {
-	fprintf(stderr, "%d: attempted to add bogus field.\n", getpid());
-	return SIGMET_BAD_ARG;
+    num_rays = vol_p->ih.ic.num_rays;
+    for (r = 0; r < num_rays; r++) {
+	az0[r] = az1[r] = tilt0[r] = tilt1[r] = NAN;
     }
-    if ( Sigmet_DataType_GetN(abbrv1, NULL) ) {
-	fprintf(stderr, "%d: %s is a built in Sigmet data type.\n"
-		" No modification allowed.\n", getpid(), abbrv1);
+    sweep_ready(vol_p, s);
+    if ( s >= vol_p->num_sweeps_ax || !vol_p->sweep_hdr[s].ok ) {
 	return SIGMET_BAD_ARG;
     }
-    if ( Sigmet_Vol_GetFld(vol_p, abbrv1, &dat_p1) == -1 ) {
-	fprintf(stderr, "%d: no field of %s in volume.\n", getpid(), abbrv1);
-	return SIGMET_BAD_ARG;
-    }
-    if ( dat_p1->stor_fmt != SIGMET_FLT ) {
-	fprintf(stderr, "%d: editable field in volume not in correct format.\n",
-		getpid());
-	return SIGMET_BAD_VOL;
-    }
-    if ( *abbrv2 == '-' ) {
-	sgn = -1;
-	abbrv2++;
-    }
-    if ( Sigmet_Vol_GetFld(vol_p, abbrv2, &dat_p2) == -1 ) {
-	fprintf(stderr, "%d: no field of %s in volume.\n", getpid(), abbrv2);
-	return SIGMET_BAD_ARG;
-    }
-    switch (dat_p2->stor_fmt) {
-	case SIGMET_U1:
-	    for (s = 0; s < vol_p->ih.ic.num_sweeps; s++) {
-		if ( vol_p->sweep_hdr[s].ok ) {
-		    for (r = 0; r < vol_p->ih.ic.num_rays; r++) {
-			if ( vol_p->ray_hdr[s][r].ok ) {
-			    for (b = 0; b < vol_p->ray_hdr[s][r].num_bins; b++)
-			    {
-				v1 = dat_p1->vals.f[s][r][b];
-				v2 = dat_p2->vals.u1[s][r][b];
-				v2 = dat_p2->stor_to_comp(v2, vol_p);
-				dat_p1->vals.f[s][r][b] = v1 - sgn * v2;
-			    }
-			}
-		    }
-		}
+    ray_hdr = vol_p->ray_hdr[s];
+    *r00_p = m_per_cm * vol_p->ih.tc.tri.rng_1st_bin;
+    *dr_p = m_per_cm * vol_p->ih.tc.tri.step_out;
+    if ( fill ) {
+	int r_prev, r_curr, r_next;	/* Previous, current, and next good
+					   rays */
+
+	if ( Sigmet_Vol_IsPPI(vol_p) ) {
+	    double az1_prev, az0_curr, az1_curr, az0_next;
+
+	    /* First ray */
+	    for (r_curr = 0;
+		    r_curr < num_rays && !ray_hdr[r_curr].ok;
+		    r_curr++ ) {
 	    }
-	    break;
-	case SIGMET_U2:
-	    for (s = 0; s < vol_p->ih.ic.num_sweeps; s++) {
-		if ( vol_p->sweep_hdr[s].ok ) {
-		    for (r = 0; r < vol_p->ih.ic.num_rays; r++) {
-			if ( vol_p->ray_hdr[s][r].ok ) {
-			    for (b = 0; b < vol_p->ray_hdr[s][r].num_bins; b++)
-			    {
-				v1 = dat_p1->vals.f[s][r][b];
-				v2 = dat_p2->vals.u2[s][r][b];
-				v2 = dat_p2->stor_to_comp(v2, vol_p);
-				dat_p1->vals.f[s][r][b] = v1 - sgn * v2;
-			    }
-			}
-		    }
-		}
+	    if ( r_curr == num_rays ) {
+		return SIGMET_BAD_VOL;
 	    }
-	    break;
-	case SIGMET_FLT:
-	    for (s = 0; s < vol_p->ih.ic.num_sweeps; s++) {
-		if ( vol_p->sweep_hdr[s].ok ) {
-		    for (r = 0; r < vol_p->ih.ic.num_rays; r++) {
-			if ( vol_p->ray_hdr[s][r].ok ) {
-			    for (b = 0; b < vol_p->ray_hdr[s][r].num_bins; b++)
-			    {
-				v1 = dat_p1->vals.f[s][r][b];
-				v2 = dat_p2->vals.f[s][r][b];
-				dat_p1->vals.f[s][r][b] = v1 - sgn * v2;
-			    }
-			}
-		    }
+	    for (r_next = r_curr + 1;
+		    r_next < num_rays && !ray_hdr[r_next].ok;
+		    r_next++) {
+	    }
+	    if ( r_next == num_rays ) {
+		return SIGMET_BAD_VOL;
+	    }
+	    az0[r_curr] = ray_hdr[r_curr].az0;
+	    az1_curr = ray_hdr[r_curr].az1;
+	    az0_next = GeogLonR(ray_hdr[r_next].az0, az1_curr);
+	    az1[r_curr] = (az1_curr + az0_next) / 2;
+	    tilt0[r_curr] = ray_hdr[r_curr].tilt0;
+	    tilt1[r_curr] = ray_hdr[r_curr].tilt1;
+
+	    /* Rest of the rays except last */
+	    r_prev = r_curr;
+	    r_curr = r_next;
+	    for (r_next = r_curr + 1;
+		    r_next < num_rays && !ray_hdr[r_next].ok;
+		    r_next++) {
+	    }
+	    while (r_next < num_rays) {
+		az0_curr = ray_hdr[r_curr].az0;
+		az1_prev = GeogLonR(ray_hdr[r_prev].az1, az0_curr);
+		az1_curr = ray_hdr[r_curr].az1;
+		az0_next = GeogLonR(ray_hdr[r_next].az0, az1_curr);
+		az0[r_curr] = (az1_prev + az0_curr) / 2;
+		az1[r_curr] = (az1_curr + az0_next) / 2;
+		tilt0[r_curr] = ray_hdr[r_curr].tilt0;
+		tilt1[r_curr] = ray_hdr[r_curr].tilt1;
+		r_prev = r_curr;
+		r_curr = r_next;
+		for (r_next = r_curr + 1;
+			r_next < num_rays && !ray_hdr[r_next].ok;
+			r_next++) {
 		}
 	    }
-	    break;
-	case SIGMET_DBL:
-	case SIGMET_MT:
-	    for (s = 0; s < vol_p->ih.ic.num_sweeps; s++) {
-		if ( vol_p->sweep_hdr[s].ok ) {
-		    for (r = 0; r < vol_p->ih.ic.num_rays; r++) {
-			if ( vol_p->ray_hdr[s][r].ok ) {
-			    for (b = 0; b < vol_p->ray_hdr[s][r].num_bins; b++)
-			    {
-				dat_p1->vals.f[s][r][b] = NAN;
-			    }
-			}
-		    }
+
+	    /* Last ray */
+	    az0_curr = ray_hdr[r_curr].az0;
+	    az1_prev = GeogLonR(ray_hdr[r_prev].az1, az0_curr);
+	    az0[r_curr] = (az1_prev + az0_curr) / 2;
+	    az1[r_curr] = ray_hdr[r_curr].az1;
+	    tilt0[r_curr] = ray_hdr[r_curr].tilt0;
+	    tilt1[r_curr] = ray_hdr[r_curr].tilt1;
+	} else if ( Sigmet_Vol_IsRHI(vol_p) ) {
+	    double tilt1_prev, tilt0_curr, tilt1_curr, tilt0_next;
+
+	    /* First ray */
+	    for (r_curr = 0;
+		    r_curr < num_rays && !ray_hdr[r_curr].ok;
+		    r_curr++ ) {
+	    }
+	    if ( r_curr == num_rays ) {
+		return SIGMET_BAD_VOL;
+	    }
+	    for (r_next = r_curr + 1;
+		    r_next < num_rays && !ray_hdr[r_next].ok;
+		    r_next++) {
+	    }
+	    if ( r_next == num_rays ) {
+		return SIGMET_BAD_VOL;
+	    }
+	    az0[r_curr] = ray_hdr[r_curr].az0;
+	    az1[r_curr] = ray_hdr[r_curr].az1;
+	    tilt0[r_curr] = ray_hdr[r_curr].tilt0;
+	    tilt1_curr = ray_hdr[r_curr].tilt1;
+	    tilt0_next = ray_hdr[r_next].tilt0;
+	    tilt1[r_curr] = (tilt1_curr + tilt0_next) / 2;
+
+	    /* Rest of rays except last */
+	    r_prev = r_curr;
+	    r_curr = r_next;
+	    for (r_next = r_curr + 1;
+		    r_next < num_rays && !ray_hdr[r_next].ok;
+		    r_next++) {
+	    }
+	    while (r_next < num_rays) {
+		az0[r_curr] = ray_hdr[r_curr].az0;
+		az1[r_curr] = ray_hdr[r_curr].az1;
+		tilt1_prev = ray_hdr[r_prev].tilt1;
+		tilt0_curr = ray_hdr[r_curr].tilt0;
+		tilt1_curr = ray_hdr[r_curr].tilt1;
+		tilt0_next = ray_hdr[r_next].tilt0;
+		tilt0[r_curr] = (tilt1_prev + tilt0_curr) / 2;
+		tilt1[r_curr] = (tilt1_curr + tilt0_next) / 2;
+		r_prev = r_curr;
+		r_curr = r_next;
+		for (r_next = r_curr + 1; !ray_hdr[r_next].ok; r_next++) {
 		}
 	    }
-	    break;
+
+	    /* Last ray */
+	    az0[r_curr] = ray_hdr[r_curr].az0;
+	    az1[r_curr] = ray_hdr[r_curr].az1;
+	    tilt0[r_curr] = (tilt1[r_prev] + ray_hdr[r_curr].tilt0) / 2;
+	    tilt1[r_curr] = ray_hdr[r_curr].tilt1;
+	}
+    } else {
+	for (r = 0; r < num_rays; r++) {
+	    if ( ray_hdr[r].ok ) {
+		az0[r] = ray_hdr[r].az0;
+		az1[r] = ray_hdr[r].az1;
+		tilt0[r] = ray_hdr[r].tilt0;
+		tilt1[r] = ray_hdr[r].tilt1;
+	    }
+	}
     }
-    vol_p->mod = 1;
     return SIGMET_OK;
 }
 
 /*
-   Multiply field by scalar v.
+   Add a new field to a volume.  This also allocates space for data in the
+   dat array.  Values are stored as floats.
  */
 
-enum SigmetStatus Sigmet_Vol_Fld_MulVal(struct Sigmet_Vol *vol_p,
-	char *data_type_s, float v)
+enum SigmetStatus Sigmet_Vol_NewField(struct Sigmet_Vol *vol_p,
+	char *data_type_s, char *descr, char *unit)
+{
+    return Sigmet_Vol_NewFieldFmt(vol_p, data_type_s, descr, unit,
+	    SIGMET_FLT, 0.0, 0.0);
+}
+
+/*
+   Add a new field to a volume, with values stored in format stor_fmt.
+   SIGMET_FLT and SIGMET_F16 store the values themselves.  SIGMET_U1 and
+   SIGMET_U2 store integers u that mean offset + scale * u, with 0 for
+   no data.  Values are rounded to the nearest integer and clipped to the
+   range of the format.
+ */
+
+enum SigmetStatus Sigmet_Vol_NewFieldFmt(struct Sigmet_Vol *vol_p,
+	char *data_type_s, char *descr, char *unit,
+	enum Sigmet_StorFmt stor_fmt, double scale, double offset)
 {
-    enum Sigmet_DataTypeN sig_type;
     struct Sigmet_Dat *dat_p;
-    int s, r;
-    float *dp, *dp1;
+    int num_sweeps, num_rays, num_bins;
 
-    if ( !vol_p ) {
-	fprintf(stderr, "%d: attempted to add field to bogus volume.\n",
+    if ( !data_type_s ) {
+	fprintf(stderr, "%d: attempted to add bogus data type to a volume.\n",
 		getpid());
 	return SIGMET_BAD_ARG;
     }
-    if ( !data_type_s ) {
-	fprintf(stderr, "%d: attempted to add bogus field.\n", getpid());
+    if ( !vol_p ) {
+	fprintf(stderr, "%d: attempted to add data type to a bogus volume.\n",
+		getpid());
 	return SIGMET_BAD_ARG;
     }
-    if ( Sigmet_DataType_GetN(data_type_s, &sig_type) ) {
-	fprintf(stderr, "%d: %s is a built in Sigmet data type.\n"
-		" No modification allowed.\n", getpid(), data_type_s);
+    if ( Sigmet_DataType_GetN(data_type_s, NULL) ) {
+	fprintf(stderr, "%d: %s is a build in Sigmet data type. Please choose "
+		"another name.\n", getpid(), data_type_s);
 	return SIGMET_BAD_ARG;
     }
-    if ( Sigmet_Vol_GetFld(vol_p, data_type_s, &dat_p) == -1 ) {
-	fprintf(stderr, "%d: no field of %s in volume.\n",
+    if ( Sigmet_Vol_GetFld(vol_p, data_type_s, &dat_p) >= 0 ) {
+	fprintf(stderr, "%d: data type %s already exists in volume.\n",
 		getpid(), data_type_s);
 	return SIGMET_BAD_ARG;
     }
-    if ( dat_p->stor_fmt != SIGMET_FLT ) {
-	fprintf(stderr, "%d: editable field in volume not in correct format.\n",
-		getpid());
-	return SIGMET_BAD_VOL;
-    }
-    for (s = 0; s < vol_p->ih.ic.num_sweeps; s++) {
-	if ( vol_p->sweep_hdr[s].ok ) {
-	    for (r = 0; r < vol_p->ih.ic.num_rays; r++) {
-		if ( vol_p->ray_hdr[s][r].ok ) {
-		    dp = dat_p->vals.f[s][r];
-		    dp1 = dp + vol_p->ray_hdr[s][r].num_bins;
-		    for ( ; dp < dp1; dp++) {
-			*dp *= v;
-		    }
-		}
+    switch (stor_fmt) {
+	case SIGMET_FLT:
+	case SIGMET_F16:
+	    scale = offset = 0.0;
+	    break;
+	case SIGMET_U1:
+	case SIGMET_U2:
+	    if ( scale == 0.0 || !isfinite(scale) || !isfinite(offset) ) {
+		fprintf(stderr, "%d: integer field %s needs a finite, non-zero "
+			"scale and a finite offset.\n", getpid(), data_type_s);
+		return SIGMET_BAD_ARG;
 	    }
-	}
+	    break;
+	case SIGMET_DBL:
+	case SIGMET_MT:
+	default:
+	    fprintf(stderr, "%d: new field %s cannot have requested storage "
+		    "format.\n", getpid(), data_type_s);
+	    return SIGMET_BAD_ARG;
+    }
+
+    /*
+       Growing dat might move it, so the ingest thread, if any, must be
+       done with it.
+     */
+
+    ingest_wait(vol_p, -1);
+    if ( !fld_reserve(vol_p, vol_p->num_types + 1) ) {
+	fprintf(stderr, "%d: could not make room for %s in volume.\n",
+		getpid(), data_type_s);
+	return SIGMET_MEM_FAIL;
+    }
+    dat_p = vol_p->dat + vol_p->num_types;
+    strlcpy(dat_p->data_type_s, "", SIGMET_NAME_LEN);
+    strlcpy(dat_p->descr, "", SIGMET_DESCR_LEN);
+    strlcpy(dat_p->unit, "", SIGMET_NAME_LEN);
+    dat_p->stor_fmt = stor_fmt;
+    dat_p->stor_to_comp = Sigmet_DblDbl;
+    dat_p->scale = scale;
+    dat_p->offset = offset;
+    dat_p->lut = NULL;
+    dat_p->vals.f = NULL;
+    num_sweeps = vol_p->ih.tc.tni.num_sweeps;
+    num_rays = vol_p->ih.ic.num_rays;
+    num_bins = vol_p->ih.tc.tri.num_bins_out;
+    if ( !fld_alloc(vol_p, dat_p, num_sweeps, num_rays, num_bins,
+		&vol_p->filter) ) {
+	fprintf(stderr, "%d: could not allocate new field ", getpid());
+	dat_p->stor_fmt = SIGMET_MT;
+	return SIGMET_MEM_FAIL;
+    }
+    strlcpy(dat_p->data_type_s, data_type_s, SIGMET_NAME_LEN);
+    if ( descr ) {
+	strncpy(dat_p->descr, descr, SIGMET_NAME_LEN);
+    }
+    if ( unit ) {
+	strncpy(dat_p->unit, unit, SIGMET_NAME_LEN);
     }
+    hash_add(vol_p, data_type_s, vol_p->num_types);
+    vol_p->size += dat_p->vals_sz / num_sweeps
+	* num_sweeps_ld(&vol_p->filter, num_sweeps)
+	+ sizeof(struct Sigmet_Dat);
+    vol_p->num_types++;
     vol_p->mod = 1;
     return SIGMET_OK;
 }
 
-/*
-   Replace field abbrv1 with abbrv1 * abbrv2.
- */
-
-enum SigmetStatus Sigmet_Vol_Fld_MulFld(struct Sigmet_Vol *vol_p, char *abbrv1,
-	char *abbrv2)
+enum SigmetStatus Sigmet_Vol_DelField(struct Sigmet_Vol *vol_p,
+	char *data_type_s)
 {
-    struct Sigmet_Dat *dat_p1, *dat_p2;
-    int sgn = 1;		/* -1 if *abbrv2 == '-' (negate the field) */
-    int s, r, b;
-    float v1, v2;
+    struct Sigmet_Dat *dat_p, *dat1_p;
+    int num_sweeps;
 
+    if ( !data_type_s ) {
+	fprintf(stderr, "%d: attempted to remove a bogus field.\n", getpid());
+	return SIGMET_BAD_ARG;
+    }
     if ( !vol_p ) {
-	fprintf(stderr, "%d: attempted to add field to bogus volume.\n",
-		getpid());
+	fprintf(stderr, "%d: attempted to remove a field from a "
+		"bogus volume.\n", getpid());
 	return SIGMET_BAD_ARG;
     }
-    if ( !abbrv1 || !abbrv2 ) {
-	fprintf(stderr, "%d: attempted to add bogus field.\n", getpid());
+    ingest_wait(vol_p, -1);
+    if ( Sigmet_Vol_GetFld(vol_p, data_type_s, &dat_p) == -1 ) {
+	fprintf(stderr, "%d: data type %s not in volume.\n",
+		getpid(), data_type_s);
+	return SIGMET_BAD_ARG;
+    }
+    num_sweeps = vol_p->ih.tc.tni.num_sweeps;
+    vol_p->size -= dat_p->vals_sz / num_sweeps
+	* num_sweeps_ld(&vol_p->filter, num_sweeps);
+    vol_pool_free(vol_p, dat_p->vals.f);
+    fld_lut_free(vol_p, dat_p);
+    memset(dat_p, 0, sizeof(struct Sigmet_Dat));
+
+    /*
+       Slide the rest of the members of dat down one to fill the hole.
+     */
+
+    for (dat1_p = dat_p + 1;
+	    dat1_p < vol_p->dat + vol_p->num_types;
+	    dat_p++, dat1_p++) {
+	*dat_p = *dat1_p;
+    }
+    vol_p->num_types--;
+    dat_p = vol_p->dat + vol_p->num_types;
+    memset(dat_p, 0, sizeof(struct Sigmet_Dat));
+    dat_p->stor_fmt = SIGMET_MT;
+    dat_p->stor_to_comp = Sigmet_DblDbl;
+    vol_p->size -= sizeof(struct Sigmet_Dat);
+    fld_tbl_fill(vol_p);
+    vol_p->mod = 1;
+    return SIGMET_OK;
+}
+
+/*
+   Set data array to value v.
+ */
+
+enum SigmetStatus Sigmet_Vol_Fld_SetVal(struct Sigmet_Vol *vol_p,
+	char *data_type_s, float v)
+{
+    struct Sigmet_Dat *dat_p;
+
+    if ( !vol_p || !data_type_s ) {
+	return SIGMET_BAD_ARG;
+    }
+    if ( Sigmet_Vol_GetFld(vol_p, data_type_s, &dat_p) == -1 ) {
+	fprintf(stderr, "%d: no field of %s in volume.\n",
+		getpid(), data_type_s);
+	return SIGMET_BAD_ARG;
+    }
+    if ( !fld_derived(dat_p) ) {
+	fprintf(stderr, "%d: editable field in volume not in correct format.\n",
+		getpid());
+	return SIGMET_BAD_VOL;
+    }
+    return fld_apply(vol_p, dat_p, NULL, kern_set, v);
+}
+
+/*
+   Initialize data array to distance along beam.
+ */
+
+enum SigmetStatus Sigmet_Vol_Fld_SetRBeam(struct Sigmet_Vol *vol_p,
+	char *data_type_s)
+{
+    struct Sigmet_Dat *dat_p;
+    enum SigmetStatus status;
+
+    if ( !vol_p || !data_type_s ) {
+	return SIGMET_BAD_ARG;
+    }
+    if ( Sigmet_Vol_GetFld(vol_p, data_type_s, &dat_p) == -1 ) {
+	fprintf(stderr, "%d: no field of %s in volume.\n",
+		getpid(), data_type_s);
+	return SIGMET_BAD_ARG;
+    }
+    if ( !fld_derived(dat_p) ) {
+	fprintf(stderr, "%d: editable field in volume not in correct format.\n",
+		getpid());
+	return SIGMET_BAD_VOL;
+    }
+    if ( (status = fld_sweeps(vol_p, &dat_p, 1, rbeam_swp, dat_p))
+	    != SIGMET_OK ) {
+	return status;
+    }
+    vol_p->mod = 1;
+    return SIGMET_OK;
+}
+
+/*
+   Replace contents of field abbrv1 with contents of field abbrv2.
+ */
+
+enum SigmetStatus Sigmet_Vol_Fld_Copy(struct Sigmet_Vol *vol_p, char *abbrv1,
+	char *abbrv2)
+{
+    struct Sigmet_Dat *dat_p1, *dat_p2;
+    int s, num_sweeps;
+    size_t sz;
+
+    if ( !vol_p ) {
+	fprintf(stderr, "%d: attempted to add field to bogus volume.\n",
+		getpid());
+	return SIGMET_BAD_ARG;
+    }
+    if ( !abbrv1 || !abbrv2 ) {
+	fprintf(stderr, "%d: attempted to add bogus field.\n", getpid());
 	return SIGMET_BAD_ARG;
     }
     if ( Sigmet_DataType_GetN(abbrv1, NULL) ) {
@@ -2692,101 +4242,47 @@ enum SigmetStatus Sigmet_Vol_Fld_MulFld(struct Sigmet_Vol *vol_p, char *abbrv1,
 	fprintf(stderr, "%d: no field of %s in volume.\n", getpid(), abbrv1);
 	return SIGMET_BAD_ARG;
     }
-    if ( dat_p1->stor_fmt != SIGMET_FLT ) {
+    if ( !fld_derived(dat_p1) ) {
 	fprintf(stderr, "%d: editable field in volume not in correct format.\n",
 		getpid());
 	return SIGMET_BAD_VOL;
     }
-    if ( *abbrv2 == '-' ) {
-	sgn = -1;
-	abbrv2++;
-    }
     if ( Sigmet_Vol_GetFld(vol_p, abbrv2, &dat_p2) == -1 ) {
 	fprintf(stderr, "%d: no field of %s in volume.\n", getpid(), abbrv2);
 	return SIGMET_BAD_ARG;
     }
-    switch (dat_p2->stor_fmt) {
-	case SIGMET_U1:
-	    for (s = 0; s < vol_p->ih.ic.num_sweeps; s++) {
-		if ( vol_p->sweep_hdr[s].ok ) {
-		    for (r = 0; r < vol_p->ih.ic.num_rays; r++) {
-			if ( vol_p->ray_hdr[s][r].ok ) {
-			    for (b = 0; b < vol_p->ray_hdr[s][r].num_bins; b++)
-			    {
-				v1 = dat_p1->vals.f[s][r][b];
-				v2 = dat_p2->vals.u1[s][r][b];
-				v2 = dat_p2->stor_to_comp(v2, vol_p);
-				dat_p1->vals.f[s][r][b] = v1 * sgn * v2;
-			    }
-			}
-		    }
-		}
-	    }
-	    break;
-	case SIGMET_U2:
-	    for (s = 0; s < vol_p->ih.ic.num_sweeps; s++) {
-		if ( vol_p->sweep_hdr[s].ok ) {
-		    for (r = 0; r < vol_p->ih.ic.num_rays; r++) {
-			if ( vol_p->ray_hdr[s][r].ok ) {
-			    for (b = 0; b < vol_p->ray_hdr[s][r].num_bins; b++)
-			    {
-				v1 = dat_p1->vals.f[s][r][b];
-				v2 = dat_p2->vals.u2[s][r][b];
-				v2 = dat_p2->stor_to_comp(v2, vol_p);
-				dat_p1->vals.f[s][r][b] = v1 * sgn * v2;
-			    }
-			}
-		    }
-		}
-	    }
-	    break;
-	case SIGMET_FLT:
-	    for (s = 0; s < vol_p->ih.ic.num_sweeps; s++) {
-		if ( vol_p->sweep_hdr[s].ok ) {
-		    for (r = 0; r < vol_p->ih.ic.num_rays; r++) {
-			if ( vol_p->ray_hdr[s][r].ok ) {
-			    for (b = 0; b < vol_p->ray_hdr[s][r].num_bins; b++)
-			    {
-				v1 = dat_p1->vals.f[s][r][b];
-				v2 = dat_p2->vals.f[s][r][b];
-				dat_p1->vals.f[s][r][b] = v1 * sgn * v2;
-			    }
-			}
-		    }
-		}
-	    }
-	    break;
-	case SIGMET_DBL:
-	case SIGMET_MT:
-	    for (s = 0; s < vol_p->ih.ic.num_sweeps; s++) {
-		if ( vol_p->sweep_hdr[s].ok ) {
-		    for (r = 0; r < vol_p->ih.ic.num_rays; r++) {
-			if ( vol_p->ray_hdr[s][r].ok ) {
-			    for (b = 0; b < vol_p->ray_hdr[s][r].num_bins; b++)
-			    {
-				dat_p1->vals.f[s][r][b] = NAN;
-			    }
-			}
-		    }
-		}
+    if ( dat_p2->stor_fmt == dat_p1->stor_fmt
+	    && dat_p2->scale == dat_p1->scale
+	    && dat_p2->offset == dat_p1->offset ) {
+
+	/*
+	   Both fields have the same layout and encoding. Copy loaded sweeps
+	   whole.
+	 */
+
+	sweep_ready(vol_p, -1);
+	num_sweeps = vol_p->ih.tc.tni.num_sweeps;
+	sz = dat_p1->vals_sz / num_sweeps;
+	for (s = 0; s < num_sweeps; s++) {
+	    if ( sweep_ld(&vol_p->filter, s) ) {
+		memcpy(dat_p1->vals.u1 + s * sz, dat_p2->vals.u1 + s * sz, sz);
 	    }
-	    break;
+	}
+	vol_p->mod = 1;
+	return SIGMET_OK;
     }
-    vol_p->mod = 1;
-    return SIGMET_OK;
+    return fld_apply(vol_p, dat_p1, dat_p2, kern_copy, 0.0);
 }
 
 /*
-   Divide field by scalar v.
+   Add scalar value v to a field.
  */
 
-enum SigmetStatus Sigmet_Vol_Fld_DivVal(struct Sigmet_Vol *vol_p,
+enum SigmetStatus Sigmet_Vol_Fld_AddVal(struct Sigmet_Vol *vol_p,
 	char *data_type_s, float v)
 {
     enum Sigmet_DataTypeN sig_type;
     struct Sigmet_Dat *dat_p;
-    int s, r;
-    float *dp, *dp1;
 
     if ( !vol_p ) {
 	fprintf(stderr, "%d: attempted to add field to bogus volume.\n",
@@ -2797,10 +4293,6 @@ enum SigmetStatus Sigmet_Vol_Fld_DivVal(struct Sigmet_Vol *vol_p,
 	fprintf(stderr, "%d: attempted to add bogus field.\n", getpid());
 	return SIGMET_BAD_ARG;
     }
-    if ( v == 0.0 ) {
-	fprintf(stderr, "%d: attempted to divide by zero.\n", getpid());
-	return SIGMET_BAD_ARG;
-    }
     if ( Sigmet_DataType_GetN(data_type_s, &sig_type) ) {
 	fprintf(stderr, "%d: %s is a built in Sigmet data type.\n"
 		" No modification allowed.\n", getpid(), data_type_s);
@@ -2811,39 +4303,23 @@ enum SigmetStatus Sigmet_Vol_Fld_DivVal(struct Sigmet_Vol *vol_p,
 		getpid(), data_type_s);
 	return SIGMET_BAD_ARG;
     }
-    if ( dat_p->stor_fmt != SIGMET_FLT ) {
+    if ( !fld_derived(dat_p) ) {
 	fprintf(stderr, "%d: editable field in volume not in correct format.\n",
 		getpid());
 	return SIGMET_BAD_VOL;
     }
-    for (s = 0; s < vol_p->ih.ic.num_sweeps; s++) {
-	if ( vol_p->sweep_hdr[s].ok ) {
-	    for (r = 0; r < vol_p->ih.ic.num_rays; r++) {
-		if ( vol_p->ray_hdr[s][r].ok ) {
-		    dp = dat_p->vals.f[s][r];
-		    dp1 = dp + vol_p->ray_hdr[s][r].num_bins;
-		    for ( ; dp < dp1; dp++) {
-			*dp /= v;
-		    }
-		}
-	    }
-	}
-    }
-    vol_p->mod = 1;
-    return SIGMET_OK;
+    return fld_apply(vol_p, dat_p, NULL, kern_add, v);
 }
 
 /*
-   Replace field abbrv1 with abbrv1 / abbrv2.
+   Add field abbrv2 to abbrv1.
  */
 
-enum SigmetStatus Sigmet_Vol_Fld_DivFld(struct Sigmet_Vol *vol_p, char *abbrv1,
+enum SigmetStatus Sigmet_Vol_Fld_AddFld(struct Sigmet_Vol *vol_p, char *abbrv1,
 	char *abbrv2)
 {
     struct Sigmet_Dat *dat_p1, *dat_p2;
     int sgn = 1;		/* -1 if *abbrv2 == '-' (negate the field) */
-    int s, r, b;
-    float v1, v2;
 
     if ( !vol_p ) {
 	fprintf(stderr, "%d: attempted to add field to bogus volume.\n",
@@ -2863,7 +4339,7 @@ enum SigmetStatus Sigmet_Vol_Fld_DivFld(struct Sigmet_Vol *vol_p, char *abbrv1,
 	fprintf(stderr, "%d: no field of %s in volume.\n", getpid(), abbrv1);
 	return SIGMET_BAD_ARG;
     }
-    if ( dat_p1->stor_fmt != SIGMET_FLT ) {
+    if ( !fld_derived(dat_p1) ) {
 	fprintf(stderr, "%d: editable field in volume not in correct format.\n",
 		getpid());
 	return SIGMET_BAD_VOL;
@@ -2876,88 +4352,18 @@ enum SigmetStatus Sigmet_Vol_Fld_DivFld(struct Sigmet_Vol *vol_p, char *abbrv1,
 	fprintf(stderr, "%d: no field of %s in volume.\n", getpid(), abbrv2);
 	return SIGMET_BAD_ARG;
     }
-    switch (dat_p2->stor_fmt) {
-	case SIGMET_U1:
-	    for (s = 0; s < vol_p->ih.ic.num_sweeps; s++) {
-		if ( vol_p->sweep_hdr[s].ok ) {
-		    for (r = 0; r < vol_p->ih.ic.num_rays; r++) {
-			if ( vol_p->ray_hdr[s][r].ok ) {
-			    for (b = 0; b < vol_p->ray_hdr[s][r].num_bins; b++)
-			    {
-				v1 = dat_p1->vals.f[s][r][b];
-				v2 = dat_p2->vals.u1[s][r][b];
-				v2 = dat_p2->stor_to_comp(v2, vol_p);
-				dat_p1->vals.f[s][r][b] = v1 / (sgn * v2);
-			    }
-			}
-		    }
-		}
-	    }
-	    break;
-	case SIGMET_U2:
-	    for (s = 0; s < vol_p->ih.ic.num_sweeps; s++) {
-		if ( vol_p->sweep_hdr[s].ok ) {
-		    for (r = 0; r < vol_p->ih.ic.num_rays; r++) {
-			if ( vol_p->ray_hdr[s][r].ok ) {
-			    for (b = 0; b < vol_p->ray_hdr[s][r].num_bins; b++)
-			    {
-				v1 = dat_p1->vals.f[s][r][b];
-				v2 = dat_p2->vals.u2[s][r][b];
-				v2 = dat_p2->stor_to_comp(v2, vol_p);
-				dat_p1->vals.f[s][r][b] = v1 / (sgn * v2);
-			    }
-			}
-		    }
-		}
-	    }
-	    break;
-	case SIGMET_FLT:
-	    for (s = 0; s < vol_p->ih.ic.num_sweeps; s++) {
-		if ( vol_p->sweep_hdr[s].ok ) {
-		    for (r = 0; r < vol_p->ih.ic.num_rays; r++) {
-			if ( vol_p->ray_hdr[s][r].ok ) {
-			    for (b = 0; b < vol_p->ray_hdr[s][r].num_bins; b++)
-			    {
-				v1 = dat_p1->vals.f[s][r][b];
-				v2 = dat_p2->vals.f[s][r][b];
-				dat_p1->vals.f[s][r][b] = v1 / (sgn * v2);
-			    }
-			}
-		    }
-		}
-	    }
-	    break;
-	case SIGMET_DBL:
-	case SIGMET_MT:
-	    for (s = 0; s < vol_p->ih.ic.num_sweeps; s++) {
-		if ( vol_p->sweep_hdr[s].ok ) {
-		    for (r = 0; r < vol_p->ih.ic.num_rays; r++) {
-			if ( vol_p->ray_hdr[s][r].ok ) {
-			    for (b = 0; b < vol_p->ray_hdr[s][r].num_bins; b++)
-			    {
-				dat_p1->vals.f[s][r][b] = NAN;
-			    }
-			}
-		    }
-		}
-	    }
-	    break;
-    }
-    vol_p->mod = 1;
-    return SIGMET_OK;
+    return fld_apply(vol_p, dat_p1, dat_p2, kern_add_fld, sgn);
 }
 
 /*
-   Replace field with its log10.
+   Subtract scalar v from a field.
  */
 
-enum SigmetStatus Sigmet_Vol_Fld_Log10(struct Sigmet_Vol *vol_p,
-	char *data_type_s)
+enum SigmetStatus Sigmet_Vol_Fld_SubVal(struct Sigmet_Vol *vol_p,
+	char *data_type_s, float v)
 {
     enum Sigmet_DataTypeN sig_type;
     struct Sigmet_Dat *dat_p;
-    int s, r;
-    float *dp, *dp1;
 
     if ( !vol_p ) {
 	fprintf(stderr, "%d: attempted to add field to bogus volume.\n",
@@ -2978,584 +4384,1187 @@ enum SigmetStatus Sigmet_Vol_Fld_Log10(struct Sigmet_Vol *vol_p,
 		getpid(), data_type_s);
 	return SIGMET_BAD_ARG;
     }
-    if ( dat_p->stor_fmt != SIGMET_FLT ) {
+    if ( !fld_derived(dat_p) ) {
 	fprintf(stderr, "%d: editable field in volume not in correct format.\n",
 		getpid());
 	return SIGMET_BAD_VOL;
     }
-    for (s = 0; s < vol_p->ih.ic.num_sweeps; s++) {
-	if ( vol_p->sweep_hdr[s].ok ) {
-	    for (r = 0; r < vol_p->ih.ic.num_rays; r++) {
-		if ( vol_p->ray_hdr[s][r].ok ) {
-		    dp = dat_p->vals.f[s][r];
-		    dp1 = dp + vol_p->ray_hdr[s][r].num_bins;
-		    for ( ; dp < dp1; dp++) {
-			*dp = (*dp > 0.0) ? log10(*dp) : NAN;
-		    }
-		}
-	    }
-	}
-    }
-    vol_p->mod = 1;
-    return SIGMET_OK;
+    return fld_apply(vol_p, dat_p, NULL, kern_add, -v);
 }
 
 /*
-   Add dt DAYS to all times in vol_p.
+   Replace field abbrv1 with abbrv1 - abbrv2.
  */
 
-enum SigmetStatus Sigmet_Vol_IncrTm(struct Sigmet_Vol *vol_p, double dt)
+enum SigmetStatus Sigmet_Vol_Fld_SubFld(struct Sigmet_Vol *vol_p, char *abbrv1,
+	char *abbrv2)
 {
-    struct Sigmet_Task_Sched_Info tsi;
-    int dt_i;
-    int s, num_sweeps, r, num_rays;
+    struct Sigmet_Dat *dat_p1, *dat_p2;
+    int sgn = 1;		/* -1 if *abbrv2 == '-' (negate the field) */
 
     if ( !vol_p ) {
-	fprintf(stderr, "%d: attempted to increment time on bogus volume.\n",
+	fprintf(stderr, "%d: attempted to add field to bogus volume.\n",
 		getpid());
 	return SIGMET_BAD_ARG;
     }
-    if (       !ymds_incr(&vol_p->ph.pc.gen_tm, dt)
-	    || !ymds_incr(&vol_p->ph.pc.ingest_sweep_tm, dt)
-	    || !ymds_incr(&vol_p->ph.pc.ingest_file_tm, dt)
-	    || !ymds_incr(&vol_p->ih.ic.vol_start_time, dt)
-	    || !ymds_incr(&vol_p->ih.tc.tei.data_time, dt) ) {
-	return SIGMET_BAD_VOL;
+    if ( !abbrv1 || !abbrv2 ) {
+	fprintf(stderr, "%d: attempted to add bogus field.\n", getpid());
+	return SIGMET_BAD_ARG;
     }
-    dt_i = round(dt * 86400);
-    tsi = vol_p->ih.tc.tsi;
-    if ( tsi.start_time >= 0 ) {
-	vol_p->ih.tc.tsi.start_time = (tsi.start_time + dt_i) % 86400;
+    if ( Sigmet_DataType_GetN(abbrv1, NULL) ) {
+	fprintf(stderr, "%d: %s is a built in Sigmet data type.\n"
+		" No modification allowed.\n", getpid(), abbrv1);
+	return SIGMET_BAD_ARG;
     }
-    if ( tsi.stop_time >= 0 ) {
-	vol_p->ih.tc.tsi.stop_time = (tsi.stop_time + dt_i) % 86400;
+    if ( Sigmet_Vol_GetFld(vol_p, abbrv1, &dat_p1) == -1 ) {
+	fprintf(stderr, "%d: no field of %s in volume.\n", getpid(), abbrv1);
+	return SIGMET_BAD_ARG;
     }
-    if ( tsi.time_last_run >= 0 ) {
-	vol_p->ih.tc.tsi.time_last_run = (tsi.time_last_run + dt_i) % 86400;
+    if ( !fld_derived(dat_p1) ) {
+	fprintf(stderr, "%d: editable field in volume not in correct format.\n",
+		getpid());
+	return SIGMET_BAD_VOL;
     }
-    if ( tsi.rel_day_last_run >= 0 ) {
-	vol_p->ih.tc.tsi.rel_day_last_run = tsi.rel_day_last_run + dt_i / 86400;
+    if ( *abbrv2 == '-' ) {
+	sgn = -1;
+	abbrv2++;
     }
-    num_sweeps = vol_p->ih.tc.tni.num_sweeps;
-    num_rays = vol_p->ih.ic.num_rays;
-    for (s = 0; s < num_sweeps; s++) {
-	vol_p->sweep_hdr[s].time += dt;
-	for (r = 0; r < num_rays; r++) {
-	    vol_p->ray_hdr[s][r].time += dt;
-	}
+    if ( Sigmet_Vol_GetFld(vol_p, abbrv2, &dat_p2) == -1 ) {
+	fprintf(stderr, "%d: no field of %s in volume.\n", getpid(), abbrv2);
+	return SIGMET_BAD_ARG;
     }
-    vol_p->mod = 1;
-    return SIGMET_OK;
+    return fld_apply(vol_p, dat_p1, dat_p2, kern_sub_fld, sgn);
 }
 
-enum SigmetStatus Sigmet_Vol_ShiftAz(struct Sigmet_Vol *vol_p, double daz)
+/*
+   Multiply field by scalar v.
+ */
+
+enum SigmetStatus Sigmet_Vol_Fld_MulVal(struct Sigmet_Vol *vol_p,
+	char *data_type_s, float v)
 {
-    unsigned long idaz;			/* Binary angle to add to each
-					   azimuth */
-    int s, r;				/* Loop indeces */
+    enum Sigmet_DataTypeN sig_type;
+    struct Sigmet_Dat *dat_p;
 
     if ( !vol_p ) {
+	fprintf(stderr, "%d: attempted to add field to bogus volume.\n",
+		getpid());
 	return SIGMET_BAD_ARG;
     }
-    idaz = Sigmet_RadBin4(GeogLonR(daz, M_PI));
-    switch (Sigmet_Vol_ScanMode(vol_p)) {
-	case RHI:
-	    for (s = 0; s < vol_p->num_sweeps_ax; s++) {
-		vol_p->ih.tc.tni.scan_info.rhi_info.az[s] += idaz;
-	    }
-	    break;
-	case PPI_S:
-	case PPI_C:
-	    for (s = 0; s < vol_p->num_sweeps_ax; s++) {
-		vol_p->ih.tc.tni.scan_info.ppi_info.left_az += idaz;
-		vol_p->ih.tc.tni.scan_info.ppi_info.right_az += idaz;
-	    }
-	    break;
-	case FILE_SCAN:
-	    vol_p->ih.tc.tni.scan_info.file_info.az0 += idaz;
-	case MAN_SCAN:
-	    break;
+    if ( !data_type_s ) {
+	fprintf(stderr, "%d: attempted to add bogus field.\n", getpid());
+	return SIGMET_BAD_ARG;
     }
-    for (s = 0; s < vol_p->num_sweeps_ax; s++) {
-	for (r = 0; r < Sigmet_Vol_NumRays(vol_p); r++) {
-	    vol_p->ray_hdr[s][r].az0
-		= GeogLonR(vol_p->ray_hdr[s][r].az0 + daz, M_PI);
-	    vol_p->ray_hdr[s][r].az1
-		= GeogLonR(vol_p->ray_hdr[s][r].az1 + daz, M_PI);
-	}
+    if ( Sigmet_DataType_GetN(data_type_s, &sig_type) ) {
+	fprintf(stderr, "%d: %s is a built in Sigmet data type.\n"
+		" No modification allowed.\n", getpid(), data_type_s);
+	return SIGMET_BAD_ARG;
     }
-    vol_p->mod = 1;
-    return SIGMET_OK;
+    if ( Sigmet_Vol_GetFld(vol_p, data_type_s, &dat_p) == -1 ) {
+	fprintf(stderr, "%d: no field of %s in volume.\n",
+		getpid(), data_type_s);
+	return SIGMET_BAD_ARG;
+    }
+    if ( !fld_derived(dat_p) ) {
+	fprintf(stderr, "%d: editable field in volume not in correct format.\n",
+		getpid());
+	return SIGMET_BAD_VOL;
+    }
+    return fld_apply(vol_p, dat_p, NULL, kern_mul, v);
 }
 
 /*
-   Nyquist velocity
+   Replace field abbrv1 with abbrv1 * abbrv2.
  */
 
-double Sigmet_Vol_VNyquist(struct Sigmet_Vol *vol_p)
+enum SigmetStatus Sigmet_Vol_Fld_MulFld(struct Sigmet_Vol *vol_p, char *abbrv1,
+	char *abbrv2)
 {
-    double wav_len, prf;
+    struct Sigmet_Dat *dat_p1, *dat_p2;
+    int sgn = 1;		/* -1 if *abbrv2 == '-' (negate the field) */
 
-    prf = vol_p->ih.tc.tdi.prf;
-    wav_len = 0.01 * 0.01 * vol_p->ih.tc.tmi.wave_len;
-    switch (vol_p->ih.tc.tdi.m_prf_mode) {
-	case ONE_ONE:
-	    return 0.25 * wav_len * prf;
-	case TWO_THREE:
-	    return 2 * 0.25 * wav_len * prf;
-	case THREE_FOUR:
-	    return 3 * 0.25 * wav_len * prf;
-	case FOUR_FIVE:
-	    return 3 * 0.25 * wav_len * prf;
+    if ( !vol_p ) {
+	fprintf(stderr, "%d: attempted to add field to bogus volume.\n",
+		getpid());
+	return SIGMET_BAD_ARG;
     }
-    return NAN;
-}
-/*
-   Fetch a value from a Sigmet volume
- */
-
-float Sigmet_Vol_GetDatum(struct Sigmet_Vol *vol_p, int y, int s, int r, int b)
-{
-    float v = NAN;
-
-    if ( !vol_p
-	    || y < 0 || y >= vol_p->num_types
-	    || s < 0 || s >= vol_p->num_sweeps_ax
-	    || r < 0 || r >= vol_p->ih.ic.num_rays
-	    || !vol_p->ray_hdr
-	    || b < 0 || b >= vol_p->ray_hdr[s][r].num_bins ) {
-	return NAN;
+    if ( !abbrv1 || !abbrv2 ) {
+	fprintf(stderr, "%d: attempted to add bogus field.\n", getpid());
+	return SIGMET_BAD_ARG;
     }
-    switch (vol_p->dat[y].stor_fmt) {
-	case SIGMET_U1:
-	    v = vol_p->dat[y].vals.u1[s][r][b];
-	    break;
-	case SIGMET_U2:
-	    v = vol_p->dat[y].vals.u2[s][r][b];
-	    break;
-	case SIGMET_FLT:
-	    v = vol_p->dat[y].vals.f[s][r][b];
-	    break;
-	case SIGMET_DBL:
-	case SIGMET_MT:
-	    return NAN;
+    if ( Sigmet_DataType_GetN(abbrv1, NULL) ) {
+	fprintf(stderr, "%d: %s is a built in Sigmet data type.\n"
+		" No modification allowed.\n", getpid(), abbrv1);
+	return SIGMET_BAD_ARG;
+    }
+    if ( Sigmet_Vol_GetFld(vol_p, abbrv1, &dat_p1) == -1 ) {
+	fprintf(stderr, "%d: no field of %s in volume.\n", getpid(), abbrv1);
+	return SIGMET_BAD_ARG;
+    }
+    if ( !fld_derived(dat_p1) ) {
+	fprintf(stderr, "%d: editable field in volume not in correct format.\n",
+		getpid());
+	return SIGMET_BAD_VOL;
+    }
+    if ( *abbrv2 == '-' ) {
+	sgn = -1;
+	abbrv2++;
+    }
+    if ( Sigmet_Vol_GetFld(vol_p, abbrv2, &dat_p2) == -1 ) {
+	fprintf(stderr, "%d: no field of %s in volume.\n", getpid(), abbrv2);
+	return SIGMET_BAD_ARG;
     }
-    return vol_p->dat[y].stor_to_comp(v, vol_p);
+    return fld_apply(vol_p, dat_p1, dat_p2, kern_mul_fld, sgn);
 }
 
 /*
-   Place values for a ray from a Sigmet volume at ray_p, which should have
-   space for the number of bins in the ray.
+   Divide field by scalar v.
  */
 
-enum SigmetStatus Sigmet_Vol_GetRayDat(struct Sigmet_Vol *vol_p, int y, int s,
-	int r, float **ray_p)
+enum SigmetStatus Sigmet_Vol_Fld_DivVal(struct Sigmet_Vol *vol_p,
+	char *data_type_s, float v)
 {
-    int ray_num_bins;
-    U1BYT *u1_p, *u1_e;
-    U2BYT *u2_p, *u2_e;
-    float *f_p, *f_e;
-    float *r_p;
+    enum Sigmet_DataTypeN sig_type;
+    struct Sigmet_Dat *dat_p;
 
     if ( !vol_p ) {
+	fprintf(stderr, "%d: attempted to add field to bogus volume.\n",
+		getpid());
 	return SIGMET_BAD_ARG;
     }
-    if ( !vol_p->ray_hdr ) {
-	return SIGMET_BAD_VOL;
+    if ( !data_type_s ) {
+	fprintf(stderr, "%d: attempted to add bogus field.\n", getpid());
+	return SIGMET_BAD_ARG;
     }
-    if ( s < 0 || s >= vol_p->ih.ic.num_sweeps ) {
-	fprintf(stderr, "%d: sweep index out of bounds.\n", getpid());
-	return SIGMET_RNG_ERR;
+    if ( v == 0.0 ) {
+	fprintf(stderr, "%d: attempted to divide by zero.\n", getpid());
+	return SIGMET_BAD_ARG;
     }
-    if ( r < 0 || r >= vol_p->ih.ic.num_rays ) {
-	fprintf(stderr, "%d: ray index out of bounds.\n", getpid());
-	return SIGMET_RNG_ERR;
+    if ( Sigmet_DataType_GetN(data_type_s, &sig_type) ) {
+	fprintf(stderr, "%d: %s is a built in Sigmet data type.\n"
+		" No modification allowed.\n", getpid(), data_type_s);
+	return SIGMET_BAD_ARG;
     }
-    ray_num_bins = vol_p->ray_hdr[s][r].num_bins;
-    switch (vol_p->dat[y].stor_fmt) {
-	case SIGMET_U1:
-	    u1_p = vol_p->dat[y].vals.u1[s][r];
-	    u1_e = u1_p + ray_num_bins;
-	    r_p = *ray_p;
-	    for ( ; u1_p < u1_e; u1_p++, r_p++) {
-		*r_p = vol_p->dat[y].stor_to_comp(*u1_p, vol_p);
-	    }
-	    break;
-	case SIGMET_U2:
-	    u2_p = vol_p->dat[y].vals.u2[s][r];
-	    u2_e = u2_p + ray_num_bins;
-	    r_p = *ray_p;
-	    for ( ; u2_p < u2_e; u2_p++, r_p++) {
-		*r_p = vol_p->dat[y].stor_to_comp(*u2_p, vol_p);
-	    }
-	    break;
-	case SIGMET_FLT:
-	    f_p = vol_p->dat[y].vals.f[s][r];
-	    f_e = f_p + ray_num_bins;
-	    r_p = *ray_p;
-	    for ( ; f_p < f_e; f_p++, r_p++) {
-		*r_p = *f_p;
-	    }
-	    break;
-	case SIGMET_DBL:
-	case SIGMET_MT:
-	    return SIGMET_BAD_VOL;
+    if ( Sigmet_Vol_GetFld(vol_p, data_type_s, &dat_p) == -1 ) {
+	fprintf(stderr, "%d: no field of %s in volume.\n",
+		getpid(), data_type_s);
+	return SIGMET_BAD_ARG;
     }
-    return SIGMET_OK;
+    if ( !fld_derived(dat_p) ) {
+	fprintf(stderr, "%d: editable field in volume not in correct format.\n",
+		getpid());
+	return SIGMET_BAD_VOL;
+    }
+    return fld_apply(vol_p, dat_p, NULL, kern_div, v);
 }
 
 /*
-   Return distance in meters along beam to start of bin
+   Replace field abbrv1 with abbrv1 / abbrv2.
  */
 
-double Sigmet_Vol_BinStart(struct Sigmet_Vol *vol_p, int b)
-{
-    return vol_p ?
-	0.01 * (vol_p->ih.tc.tri.rng_1st_bin + b * vol_p->ih.tc.tri.step_out)
-	: NAN;
-}
-
-enum SigmetStatus Sigmet_Vol_PPI_BinOutl(struct Sigmet_Vol *vol_p,
-	int s, int r, int b,
-	int (*lonlat_to_xy)(double, double, double *, double *),
-	double *cnr)
+enum SigmetStatus Sigmet_Vol_Fld_DivFld(struct Sigmet_Vol *vol_p, char *abbrv1,
+	char *abbrv2)
 {
-    double re;				/* Earth radius */
-    double lon_r, lat_r;		/* Radar longitude latitude */
-    double az0, az1;			/* Azimuth limits of bin */
-    double r00, dr;			/* Range to first bin, bin length, m */
-    double r0, r1;			/* Beam distance to bin start, end */
-    double r0_g, r1_g;			/* Ground distance to bin start, end */
-    double tilt;			/* Mean tilt */
-    double lon, lat;			/* Corner coordinates */
+    struct Sigmet_Dat *dat_p1, *dat_p2;
+    int sgn = 1;		/* -1 if *abbrv2 == '-' (negate the field) */
 
     if ( !vol_p ) {
+	fprintf(stderr, "%d: attempted to add field to bogus volume.\n",
+		getpid());
 	return SIGMET_BAD_ARG;
     }
-    if ( vol_p->ih.tc.tni.scan_mode != PPI_S
-	    && vol_p->ih.tc.tni.scan_mode != PPI_C ) {
-	fprintf(stderr, "%d: volume must be PPI.\n", getpid());
+    if ( !abbrv1 || !abbrv2 ) {
+	fprintf(stderr, "%d: attempted to add bogus field.\n", getpid());
 	return SIGMET_BAD_ARG;
     }
-    if ( s < 0 || s >= vol_p->ih.ic.num_sweeps ) {
-	fprintf(stderr, "%d: sweep index out of bounds.\n", getpid());
-	return SIGMET_RNG_ERR;
+    if ( Sigmet_DataType_GetN(abbrv1, NULL) ) {
+	fprintf(stderr, "%d: %s is a built in Sigmet data type.\n"
+		" No modification allowed.\n", getpid(), abbrv1);
+	return SIGMET_BAD_ARG;
     }
-    if ( r < 0 || r >= vol_p->ih.ic.num_rays ) {
-	fprintf(stderr, "%d: ray index out of bounds.\n", getpid());
-	return SIGMET_RNG_ERR;
+    if ( Sigmet_Vol_GetFld(vol_p, abbrv1, &dat_p1) == -1 ) {
+	fprintf(stderr, "%d: no field of %s in volume.\n", getpid(), abbrv1);
+	return SIGMET_BAD_ARG;
     }
-    if ( b < 0 || b >= vol_p->ray_hdr[s][r].num_bins ) {
-	fprintf(stderr, "%d: bin index out of bounds.\n", getpid());
-	return SIGMET_RNG_ERR;
+    if ( !fld_derived(dat_p1) ) {
+	fprintf(stderr, "%d: editable field in volume not in correct format.\n",
+		getpid());
+	return SIGMET_BAD_VOL;
     }
-    az0 = vol_p->ray_hdr[s][r].az0;
-    az1 = vol_p->ray_hdr[s][r].az1;
-    if ( GeogLonR(az1, az0) > az0 ) {
-	double t = az1;
-	az1 = az0;
-	az0 = t;
+    if ( *abbrv2 == '-' ) {
+	sgn = -1;
+	abbrv2++;
     }
-    tilt = (vol_p->ray_hdr[s][r].tilt0 + vol_p->ray_hdr[s][r].tilt1) / 2;
-    r00 = 0.01 * vol_p->ih.tc.tri.rng_1st_bin;	/* 0.01 converts cm -> m */
-    dr = 0.01 * vol_p->ih.tc.tri.step_out;
-    r0 = r00 + b * dr;
-    r1 = r0 + dr;
-    re = GeogREarth(NULL);
-    r0_g = atan(r0 * cos(tilt) / (re + r0 * sin(tilt)));
-    r1_g = atan(r1 * cos(tilt) / (re + r1 * sin(tilt)));
-    lon_r = Sigmet_Bin4Rad(vol_p->ih.ic.longitude);
-    lat_r = Sigmet_Bin4Rad(vol_p->ih.ic.latitude);
-    GeogStep(lon_r, lat_r, az0, r0_g, &lon, &lat);
-    lonlat_to_xy(lon, lat, cnr + 0, cnr + 1);
-    GeogStep(lon_r, lat_r, az0, r1_g, &lon, &lat);
-    lonlat_to_xy(lon, lat, cnr + 2, cnr + 3);
-    GeogStep(lon_r, lat_r, az1, r1_g, &lon, &lat);
-    lonlat_to_xy(lon, lat, cnr + 4, cnr + 5);
-    GeogStep(lon_r, lat_r, az1, r0_g, &lon, &lat);
-    lonlat_to_xy(lon, lat, cnr + 6, cnr + 7);
-    return SIGMET_OK;
+    if ( Sigmet_Vol_GetFld(vol_p, abbrv2, &dat_p2) == -1 ) {
+	fprintf(stderr, "%d: no field of %s in volume.\n", getpid(), abbrv2);
+	return SIGMET_BAD_ARG;
+    }
+    return fld_apply(vol_p, dat_p1, dat_p2, kern_div_fld, sgn);
 }
 
 /*
-   Return limits of ppi sweep for given map projection.
+   Replace field with its log10.
  */
 
-enum SigmetStatus Sigmet_Vol_PPI_Bnds(struct Sigmet_Vol *vol_p, int s,
-	int (*lonlat_to_xy)(double, double, double *, double *),
-	double *x_min_p, double *x_max_p, double *y_min_p, double *y_max_p)
+enum SigmetStatus Sigmet_Vol_Fld_Log10(struct Sigmet_Vol *vol_p,
+	char *data_type_s)
 {
-    double x_min, x_max, y_min, y_max;	/* PPI limits */
-    double rlon, rlat;			/* Radar location */
-    double rearth;			/* Earth radius */
-    double rng_1st_bin, step_out;	/* Range to first bin, output bin step,
-					   meters */
-    int num_bins;
-    double ray_len;			/* Ray length, meters */
-    int r;				/* Ray index */
-    double az0, az1, az;		/* Ray azimuth */
-    double tilt0, tilt1, tilt;		/* Ray tilt */
-    double ray_len_g;			/* Ray length along ground */
-    double lon, lat;			/* Geographic coordinates of ray end */
-    double x, y;			/* Map coordinates of ray end */
+    enum Sigmet_DataTypeN sig_type;
+    struct Sigmet_Dat *dat_p;
 
     if ( !vol_p ) {
-	fprintf(stderr, "%d: bogus volume.\n", getpid());
+	fprintf(stderr, "%d: attempted to add field to bogus volume.\n",
+		getpid());
 	return SIGMET_BAD_ARG;
     }
-    if ( vol_p->ih.tc.tni.scan_mode != PPI_S
-	    && vol_p->ih.tc.tni.scan_mode != PPI_C ) {
-	fprintf(stderr, "%d: volume must be PPI.\n", getpid());
+    if ( !data_type_s ) {
+	fprintf(stderr, "%d: attempted to add bogus field.\n", getpid());
 	return SIGMET_BAD_ARG;
     }
-    if ( s >= vol_p->num_sweeps_ax ) {
-	fprintf(stderr, "%d: sweep index out of range for volume.\n", getpid());
-	return SIGMET_RNG_ERR;
-    }
-    if ( !vol_p->sweep_hdr[s].ok ) {
-	fprintf(stderr, "%d: sweep not valid in volume.\n", getpid());
-	return SIGMET_RNG_ERR;
-    }
-    rlon = Sigmet_Bin4Rad(vol_p->ih.ic.longitude);
-    rlat = Sigmet_Bin4Rad(vol_p->ih.ic.latitude);
-    rearth = GeogREarth(NULL);
-    rng_1st_bin = 0.01 * vol_p->ih.tc.tri.rng_1st_bin;
-    step_out = 0.01 * vol_p->ih.tc.tri.step_out;
-    num_bins = vol_p->ih.tc.tri.num_bins_out;
-    ray_len = rng_1st_bin + (num_bins + 0.5) * step_out;
-    x_min = y_min = DBL_MAX;
-    x_max = y_max = -DBL_MAX;
-    if ( lonlat_to_xy(rlon, rlat, &x, &y) ) {
-	x_min = (x < x_min) ? x : x_min;
-	x_max = (x > x_max) ? x : x_max;
-	y_min = (y < y_min) ? y : y_min;
-	y_max = (y > y_max) ? y : y_max;
+    if ( Sigmet_DataType_GetN(data_type_s, &sig_type) ) {
+	fprintf(stderr, "%d: %s is a built in Sigmet data type.\n"
+		" No modification allowed.\n", getpid(), data_type_s);
+	return SIGMET_BAD_ARG;
     }
-    for (r = 0; r < vol_p->ih.ic.num_rays; r++) {
-	if ( vol_p->ray_hdr[s][r].ok ) {
-	    az0 = vol_p->ray_hdr[s][r].az0;
-	    az1 = GeogLonR(vol_p->ray_hdr[s][r].az1, az0);
-	    az = (az0 + az1) / 2;
-	    tilt0 = vol_p->ray_hdr[s][r].tilt0;
-	    tilt1 = vol_p->ray_hdr[s][r].tilt1;
-	    tilt = (tilt0 + tilt1) / 2;
-	    ray_len_g
-		= atan(ray_len * cos(tilt) / (rearth + ray_len * sin(tilt)));
-	    GeogStep(rlon, rlat, az, ray_len_g, &lon, &lat);
-	    if ( lonlat_to_xy(lon, lat, &x, &y) ) {
-		x_min = (x < x_min) ? x : x_min;
-		x_max = (x > x_max) ? x : x_max;
-		y_min = (y < y_min) ? y : y_min;
-		y_max = (y > y_max) ? y : y_max;
-	    }
-	}
+    if ( Sigmet_Vol_GetFld(vol_p, data_type_s, &dat_p) == -1 ) {
+	fprintf(stderr, "%d: no field of %s in volume.\n",
+		getpid(), data_type_s);
+	return SIGMET_BAD_ARG;
     }
-    if ( x_min == DBL_MAX || y_min == DBL_MAX
-	    || x_max == -DBL_MAX || y_max == -DBL_MAX ) {
+    if ( !fld_derived(dat_p) ) {
+	fprintf(stderr, "%d: editable field in volume not in correct format.\n",
+		getpid());
 	return SIGMET_BAD_VOL;
     }
-    *x_min_p = x_min;
-    *x_max_p = x_max;
-    *y_min_p = y_min;
-    *y_max_p = y_max;
-    return SIGMET_OK;
+    return fld_apply(vol_p, dat_p, NULL, kern_log10, 0.0);
 }
 
-enum SigmetStatus Sigmet_Vol_RHI_BinOutl(struct Sigmet_Vol *vol_p,
-	int s, int r, int b, double *cnr)
+/*
+   Set field data_type_s to the value of expression expr, which is
+   evaluated for every bin in one pass over the volume. See sigmet_vol (3)
+   for the syntax.
+ */
+
+enum SigmetStatus Sigmet_Vol_Fld_Calc(struct Sigmet_Vol *vol_p,
+	char *data_type_s, char *expr)
 {
-    double re;				/* Earth radius, meters */
-    double r00;				/* Range to first bin, meters */
-    double dr;				/* Bin size, meters */
-    double r0, r1;			/* Beam distance to bin start, stop */
-    double tilt0, tilt1;		/* Start, end of current tilt */
-    double abs, ord;			/* Abscissa, ordinate of a point */
+    struct Sigmet_Dat *dat_p;
+    struct calc_prog prog;
+    struct Sigmet_Dat **dats = NULL;	/* Fields the expression reads, and
+					   the result field */
+    int f;
+    enum SigmetStatus status;
 
     if ( !vol_p ) {
+	fprintf(stderr, "%d: attempted to calculate field in bogus volume.\n",
+		getpid());
 	return SIGMET_BAD_ARG;
     }
-    if ( vol_p->ih.tc.tni.scan_mode != RHI ) {
-	fprintf(stderr, "%d: volume must be RHI.\n", getpid());
+    if ( !data_type_s || !expr ) {
+	fprintf(stderr, "%d: attempted to calculate bogus field.\n", getpid());
 	return SIGMET_BAD_ARG;
     }
-    if ( s < 0 || s >= vol_p->ih.ic.num_sweeps ) {
-	fprintf(stderr, "%d: sweep index out of bounds.\n", getpid());
-	return SIGMET_RNG_ERR;
+    if ( Sigmet_DataType_GetN(data_type_s, NULL) ) {
+	fprintf(stderr, "%d: %s is a built in Sigmet data type.\n"
+		" No modification allowed.\n", getpid(), data_type_s);
+	return SIGMET_BAD_ARG;
     }
-    if ( r < 0 || r >= vol_p->ih.ic.num_rays ) {
-	fprintf(stderr, "%d: ray index out of bounds.\n", getpid());
-	return SIGMET_RNG_ERR;
+    if ( Sigmet_Vol_GetFld(vol_p, data_type_s, &dat_p) == -1 ) {
+	fprintf(stderr, "%d: no field of %s in volume.\n",
+		getpid(), data_type_s);
+	return SIGMET_BAD_ARG;
     }
-    if ( b < 0 || b >= vol_p->ray_hdr[s][r].num_bins ) {
-	fprintf(stderr, "%d: bin index out of bounds.\n", getpid());
-	return SIGMET_RNG_ERR;
+    if ( !fld_derived(dat_p) ) {
+	fprintf(stderr, "%d: editable field in volume not in correct format.\n",
+		getpid());
+	return SIGMET_BAD_VOL;
     }
-    tilt0 = vol_p->ray_hdr[s][r].tilt0;
-    tilt1 = vol_p->ray_hdr[s][r].tilt1;
-    if ( tilt1 < tilt0 ) {
-	double t = tilt1;
-	tilt1 = tilt0;
-	tilt0 = t;
+    if ( !calc_compile(vol_p, expr, &prog) ) {
+	calc_free(&prog);
+	return SIGMET_BAD_ARG;
     }
-    r00 = 0.01 * vol_p->ih.tc.tri.rng_1st_bin;	/* 0.01 converts cm -> m */
-    dr = 0.01 * vol_p->ih.tc.tri.step_out;
-    r0 = r00 + b * dr;
-    r1 = r0 + dr;
-    re = GeogREarth(NULL) * FOUR_THIRD;
-    cnr[1] = ord = GeogBeamHt(r0, tilt0, re);
-    cnr[0] = abs = re * asin(r0 * cos(tilt0) / (re + ord));
-    cnr[3] = ord = GeogBeamHt(r1, tilt0, re);
-    cnr[2] = abs = re * asin(r1 * cos(tilt0) / (re + ord));
-    cnr[5] = ord = GeogBeamHt(r1, tilt1, re);
-    cnr[4] = abs = re * asin(r1 * cos(tilt1) / (re + ord));
-    cnr[7] = ord = GeogBeamHt(r0, tilt1, re);
-    cnr[6] = abs = re * asin(r0 * cos(tilt1) / (re + ord));
+    if ( !(dats = CALLOC(prog.n_fld + 1, sizeof(struct Sigmet_Dat *))) ) {
+	fprintf(stderr, "%d: could not allocate field list for expression.\n",
+		getpid());
+	status = SIGMET_MEM_FAIL;
+	goto error;
+    }
+    for (f = 0; f < prog.n_fld; f++) {
+	dats[f] = vol_p->dat + prog.fld[f];
+    }
+    dats[f] = dat_p;
+    prog.dat_p = dat_p;
+    if ( (status = fld_sweeps(vol_p, dats, prog.n_fld + 1, calc_swp, &prog))
+	    != SIGMET_OK ) {
+	goto error;
+    }
+    FREE(dats);
+    calc_free(&prog);
+    vol_p->mod = 1;
     return SIGMET_OK;
+
+error:
+    FREE(dats);
+    calc_free(&prog);
+    return status;
 }
 
 /*
-   Return limits of rhi sweep - distance along ground down range and height
-   above radar level.
+   Blank field abbrv wherever field ctl_abbrv compares to thr as cmp, which
+   must be one of "<", "<=", ">", ">=", "==", or "!=". Bins where ctl_abbrv
+   has no data are left alone. If ctl_abbrv stores 1 or 2 byte values,
+   the comparison is made once for every storage value, so the pass over
+   the volume only looks up raw values in a table.
  */
 
-enum SigmetStatus Sigmet_Vol_RHI_Bnds(struct Sigmet_Vol *vol_p, int s,
-	double *x_max_p, double *y_max_p)
+enum SigmetStatus Sigmet_Vol_Fld_Mask(struct Sigmet_Vol *vol_p, char *abbrv,
+	char *ctl_abbrv, char *cmp, double thr)
 {
-    double x_max, y_max;		/* RHI limits */
-    double rng_1st_bin, step_out;	/* Range to first bin, output bin step,
-					   meters */
-    int num_bins;
-    double ray_len;			/* Ray length, meters */
-    int r;				/* Ray index */
-    double tilt0, tilt1, tilt;		/* Ray tilt */
-    double rearth;			/* Earth radius */
-    double x, y;			/* Map coordinates of ray end */
+    struct mask_arg arg;
+    struct {
+	char *s;
+	enum mask_op op;
+    } ops[] = {
+	{"<", MASK_LT}, {"<=", MASK_LE}, {">", MASK_GT},
+	{">=", MASK_GE}, {"==", MASK_EQ}, {"!=", MASK_NE}
+    };
+    int n, n_ops = sizeof(ops) / sizeof(ops[0]);
+    float *lut;
+    size_t u, num_u;
+    enum SigmetStatus status;
 
     if ( !vol_p ) {
-	fprintf(stderr, "%d: bogus volume.\n", getpid());
+	fprintf(stderr, "%d: attempted to mask field in bogus volume.\n",
+		getpid());
 	return SIGMET_BAD_ARG;
     }
-    if ( vol_p->ih.tc.tni.scan_mode != RHI ) {
-	fprintf(stderr, "%d: volume must be RHI.\n", getpid());
+    if ( !abbrv || !ctl_abbrv || !cmp ) {
+	fprintf(stderr, "%d: attempted to mask bogus field.\n", getpid());
 	return SIGMET_BAD_ARG;
     }
-    if ( s >= vol_p->num_sweeps_ax ) {
-	fprintf(stderr, "%d: sweep index out of range for volume.\n", getpid());
-	return SIGMET_RNG_ERR;
+    if ( Sigmet_Vol_GetFld(vol_p, abbrv, &arg.dat_p) == -1 ) {
+	fprintf(stderr, "%d: no field of %s in volume.\n", getpid(), abbrv);
+	return SIGMET_BAD_ARG;
     }
-    if ( !vol_p->sweep_hdr[s].ok ) {
-	fprintf(stderr, "%d: sweep not valid in volume.\n", getpid());
-	return SIGMET_RNG_ERR;
+    if ( Sigmet_Vol_GetFld(vol_p, ctl_abbrv, &arg.ctl_p) == -1 ) {
+	fprintf(stderr, "%d: no field of %s in volume.\n",
+		getpid(), ctl_abbrv);
+	return SIGMET_BAD_ARG;
     }
-    rearth = GeogREarth(NULL);
-    rng_1st_bin = 0.01 * vol_p->ih.tc.tri.rng_1st_bin;
-    step_out = 0.01 * vol_p->ih.tc.tri.step_out;
-    num_bins = vol_p->ih.tc.tri.num_bins_out;
-    ray_len = rng_1st_bin + (num_bins + 0.5) * step_out;
-    x_max = y_max = -DBL_MAX;
-    for (r = 0; r < vol_p->ih.ic.num_rays; r++) {
-	if ( vol_p->ray_hdr[s][r].ok ) {
-	    tilt0 = vol_p->ray_hdr[s][r].tilt0;
-	    tilt1 = vol_p->ray_hdr[s][r].tilt1;
-	    tilt = (tilt0 + tilt1) / 2;
-	    x = rearth
-		* atan2(ray_len * cos(tilt), rearth + ray_len * sin(tilt));
-	    y = (sqrt(rearth * rearth + 2 * rearth * ray_len * sin(tilt)
-			    + ray_len * ray_len) - rearth);
-	    x_max = (x > x_max) ? x : x_max;
-	    y_max = (y > y_max) ? y : y_max;
+    if ( arg.dat_p->stor_fmt == SIGMET_DBL || arg.dat_p->stor_fmt == SIGMET_MT
+	    || arg.ctl_p->stor_fmt == SIGMET_DBL
+	    || arg.ctl_p->stor_fmt == SIGMET_MT ) {
+	fprintf(stderr, "%d: cannot mask %s with %s. Storage format not "
+		"supported.\n", getpid(), abbrv, ctl_abbrv);
+	return SIGMET_BAD_VOL;
+    }
+    for (n = 0; n < n_ops && strcmp(cmp, ops[n].s) != 0; n++) {
+    }
+    if ( n == n_ops ) {
+	fprintf(stderr, "%d: unknown comparison %s. Must be <, <=, >, >=, "
+		"==, or !=.\n", getpid(), cmp);
+	return SIGMET_BAD_ARG;
+    }
+    arg.op = ops[n].op;
+    arg.thr = thr;
+    arg.tbl = NULL;
+    ingest_wait(vol_p, -1);
+
+    /*
+       Compare every storage value of the control field to the threshold
+       now, so that the pass over the volume does not convert anything.
+     */
+
+    if ( arg.ctl_p->stor_fmt != SIGMET_FLT ) {
+	if ( !(lut = fld_lut(vol_p, arg.ctl_p)) ) {
+	    fprintf(stderr, "%d: could not make conversion table for %s.\n",
+		    getpid(), ctl_abbrv);
+	    return SIGMET_MEM_FAIL;
+	}
+	num_u = (arg.ctl_p->stor_fmt == SIGMET_U1) ? 0x100 : 0x10000;
+	if ( !(arg.tbl = MALLOC(num_u)) ) {
+	    fprintf(stderr, "%d: could not allocate comparison table for "
+		    "%s.\n", getpid(), ctl_abbrv);
+	    return SIGMET_MEM_FAIL;
+	}
+	for (u = 0; u < num_u; u++) {
+	    arg.tbl[u] = mask_cmp(lut[u], arg.op, thr);
 	}
     }
-    if ( x_max == -DBL_MAX || y_max == -DBL_MAX ) {
-	return SIGMET_BAD_VOL;
+    status = fld_sweeps(vol_p, NULL, 0, mask_swp, &arg);
+    FREE(arg.tbl);
+    if ( status != SIGMET_OK ) {
+	return status;
     }
-    *x_max_p = x_max;
-    *y_max_p = y_max;
+    vol_p->mod = 1;
     return SIGMET_OK;
 }
 
 /*
-   get product_hdr (raw volume record 1).
+   Remove speckle from field abbrv. A gate with data is set to no data if
+   fewer than min_count gates in the window of 2 * d_bin + 1 bins by
+   2 * d_ray + 1 rays around it, including itself, have data. Each sweep
+   is one pass over the field. Rays wrap around in continuous PPI sweeps.
  */
 
-struct Sigmet_Product_Hdr get_product_hdr(char *rec)
+enum SigmetStatus Sigmet_Vol_Fld_Despeckle(struct Sigmet_Vol *vol_p,
+	char *abbrv, int d_bin, int d_ray, int min_count)
 {
-    struct Sigmet_Product_Hdr ph;
+    struct despeckle_arg arg;
+    float *lut;
+    size_t u, num_u;
+    enum SigmetStatus status;
 
-    ph.sh = get_structure_header(rec);
-    ph.pc = get_product_configuration(rec);
-    rec += 12;
-    ph.pe = get_product_end(rec);
-    rec += 320;
-    return ph;
-}
+    if ( !vol_p ) {
+	fprintf(stderr, "%d: attempted to despeckle field in bogus volume.\n",
+		getpid());
+	return SIGMET_BAD_ARG;
+    }
+    if ( !abbrv ) {
+	fprintf(stderr, "%d: attempted to despeckle bogus field.\n", getpid());
+	return SIGMET_BAD_ARG;
+    }
+    if ( d_bin < 0 || d_ray < 0 || min_count < 1 ) {
+	fprintf(stderr, "%d: despeckle window sizes must not be negative, "
+		"and minimum count must be positive.\n", getpid());
+	return SIGMET_BAD_ARG;
+    }
+    if ( Sigmet_Vol_GetFld(vol_p, abbrv, &arg.dat_p) == -1 ) {
+	fprintf(stderr, "%d: no field of %s in volume.\n", getpid(), abbrv);
+	return SIGMET_BAD_ARG;
+    }
+    if ( arg.dat_p->stor_fmt == SIGMET_DBL
+	    || arg.dat_p->stor_fmt == SIGMET_MT ) {
+	fprintf(stderr, "%d: cannot despeckle %s. Storage format not "
+		"supported.\n", getpid(), abbrv);
+	return SIGMET_BAD_VOL;
+    }
+    arg.d_bin = d_bin;
+    arg.d_ray = d_ray;
+    arg.min_count = min_count;
+    arg.tbl = NULL;
+    ingest_wait(vol_p, -1);
 
-void print_product_hdr(FILE *out, char *prefix, struct Sigmet_Product_Hdr ph)
-{
-    print_structure_header(out, prefix, ph.sh);
-    print_product_configuration(out, prefix,  ph.pc);
-    print_product_end(out, prefix, ph.pe);
+    /*
+       Decide once which storage values are data.
+     */
+
+    if ( arg.dat_p->stor_fmt != SIGMET_FLT ) {
+	if ( !(lut = fld_lut(vol_p, arg.dat_p)) ) {
+	    fprintf(stderr, "%d: could not make conversion table for %s.\n",
+		    getpid(), abbrv);
+	    return SIGMET_MEM_FAIL;
+	}
+	num_u = (arg.dat_p->stor_fmt == SIGMET_U1) ? 0x100 : 0x10000;
+	if ( !(arg.tbl = MALLOC(num_u)) ) {
+	    fprintf(stderr, "%d: could not allocate data table for %s.\n",
+		    getpid(), abbrv);
+	    return SIGMET_MEM_FAIL;
+	}
+	for (u = 0; u < num_u; u++) {
+	    arg.tbl[u] = !isnan(lut[u]);
+	}
+    }
+    status = fld_sweeps(vol_p, NULL, 0, despeckle_swp, &arg);
+    FREE(arg.tbl);
+    if ( status != SIGMET_OK ) {
+	return status;
+    }
+    vol_p->mod = 1;
+    return SIGMET_OK;
 }
 
 /*
-   get / print product_configuration.
+   Replace each bin of field abbrv with the mean, if filter is
+   SIGMET_BOXCAR, or the median, if filter is SIGMET_MEDIAN, of the values
+   in the window of 2 * d_bin + 1 bins by 2 * d_ray + 1 rays around it.
+   Bins with no data are skipped, and stay empty. Put the result in field
+   out_abbrv, or in abbrv if out_abbrv is NULL.
  */
 
-struct Sigmet_Product_Configuration get_product_configuration(char *rec)
-{
-    struct Sigmet_Product_Configuration pc;
-
-    pc.sh = get_structure_header(rec);
-    pc.type = get_uint16(rec + 12);
-    pc.schedule = get_uint16(rec + 14);
-    pc.skip = get_sint32(rec + 16);
-    pc.gen_tm = get_ymds_time(rec + 20);
-    pc.ingest_sweep_tm = get_ymds_time(rec + 32);
-    pc.ingest_file_tm = get_ymds_time(rec + 44);
-    memcpy(pc.config_file, rec + 62, 12);
-    trimRight(pc.config_file, 12);
-    memcpy(pc.task_name, rec + 74, 12);
-    trimRight(pc.task_name, 12);
-    pc.flag = get_uint16(rec + 86);
-    pc.x_scale = get_sint32(rec + 88);
-    pc.y_scale = get_sint32(rec + 92);
-    pc.z_scale = get_sint32(rec + 96);
-    pc.x_size = get_sint32(rec + 100);
-    pc.y_size = get_sint32(rec + 104);
-    pc.z_size = get_sint32(rec + 108);
-    pc.x_loc = get_sint32(rec + 112);
-    pc.y_loc = get_sint32(rec + 116);
-    pc.z_loc = get_sint32(rec + 120);
-    pc.max_rng = get_sint32(rec + 124);
-    pc.data_type = get_uint16(rec + 130);
-    memcpy(pc.proj, rec + 132, 12);
-    trimRight(pc.proj, 12);
-    pc.inp_data_type = get_uint16(rec + 144);
-    pc.proj_type = *(unsigned char *)(rec + 146);
-    pc.rad_smoother = get_sint16(rec + 148);
-    pc.num_runs = get_sint16(rec + 150);
-    pc.zr_const = get_sint32(rec + 152);
-    pc.zr_exp = get_sint32(rec + 156);
-    pc.x_smooth = get_sint16(rec + 160);
-    pc.y_smooth = get_sint16(rec + 162);
-    pc.psi = get_product_specific_info(rec + 80);
-    memcpy(pc.suffixes, rec + 244, 16);
-    trimRight(pc.suffixes, 16);
-    pc.csd = get_color_scale_def(rec + 272);
-    return pc;
-}
-
-void print_product_configuration(FILE *out, char *pfx,
-	struct Sigmet_Product_Configuration pc)
+enum SigmetStatus Sigmet_Vol_Fld_Filter(struct Sigmet_Vol *vol_p,
+	char *abbrv, char *out_abbrv, enum Sigmet_FldFilter filter,
+	int d_bin, int d_ray)
 {
-    char prefix[STR_LEN];
+    struct filter_arg arg;
+    struct Sigmet_Dat *dats[2];
+    enum SigmetStatus status;
 
-    snprintf(prefix, STR_LEN, "%s%s", pfx, "<product_configuration>.");
-    print_structure_header(out, prefix, pc.sh);
-    print_u(out, pc.type, prefix, "type",
-	    "Product type code: 1:PPI 2:RHI 3:CAPPI 4:CROSS 5:TOPS 6:TRACK"
-	    " 7:RAIN1 8:RAINN 9:VVP 10:VIL 11:SHEAR 12:WARN 13:CATCH 14:RTI"
-	    " 15:RAW 16:MAX 17:USER 18:USERV 19:OTHER 20:STATUS 21:SLINE"
+    if ( !vol_p ) {
+	fprintf(stderr, "%d: attempted to filter field in bogus volume.\n",
+		getpid());
+	return SIGMET_BAD_ARG;
+    }
+    if ( !abbrv ) {
+	fprintf(stderr, "%d: attempted to filter bogus field.\n", getpid());
+	return SIGMET_BAD_ARG;
+    }
+    if ( filter != SIGMET_BOXCAR && filter != SIGMET_MEDIAN ) {
+	fprintf(stderr, "%d: unknown filter.\n", getpid());
+	return SIGMET_BAD_ARG;
+    }
+    if ( d_bin < 0 || d_ray < 0 ) {
+	fprintf(stderr, "%d: filter window sizes must not be negative.\n",
+		getpid());
+	return SIGMET_BAD_ARG;
+    }
+    if ( Sigmet_Vol_GetFld(vol_p, abbrv, &arg.dat_p) == -1 ) {
+	fprintf(stderr, "%d: no field of %s in volume.\n", getpid(), abbrv);
+	return SIGMET_BAD_ARG;
+    }
+    if ( arg.dat_p->stor_fmt == SIGMET_DBL
+	    || arg.dat_p->stor_fmt == SIGMET_MT ) {
+	fprintf(stderr, "%d: cannot filter %s. Storage format not "
+		"supported.\n", getpid(), abbrv);
+	return SIGMET_BAD_VOL;
+    }
+    if ( !out_abbrv ) {
+	out_abbrv = abbrv;
+    }
+    if ( Sigmet_Vol_GetFld(vol_p, out_abbrv, &arg.out_p) == -1 ) {
+	fprintf(stderr, "%d: no field of %s in volume.\n",
+		getpid(), out_abbrv);
+	return SIGMET_BAD_ARG;
+    }
+    if ( !fld_derived(arg.out_p) ) {
+	fprintf(stderr, "%d: editable field in volume not in correct format.\n",
+		getpid());
+	return SIGMET_BAD_VOL;
+    }
+    arg.filter = filter;
+    arg.d_bin = d_bin;
+    arg.d_ray = d_ray;
+    dats[0] = arg.dat_p;
+    dats[1] = arg.out_p;
+    if ( (status = fld_sweeps(vol_p, dats, 2, filter_swp, &arg))
+	    != SIGMET_OK ) {
+	return status;
+    }
+    vol_p->mod = 1;
+    return SIGMET_OK;
+}
+
+/*
+   Unfold the aliased velocities in field abbrv of the volume at vol_p into
+   field out_abbrv, which must be a field made with Sigmet_Vol_NewField.
+   Each gate is shifted by the multiple of twice the Nyquist velocity that
+   brings it closest to its neighbors that are already unfolded, the
+   previous gate along the ray and the same gate in the previous ray. If
+   these have no data, the same gate in the nearest ray of the previous PPI
+   sweep, or the last unfolded gate along the ray, is used. Gates with no
+   reference at all, such as the first gates of the first sweep, are
+   assumed not to be aliased.
+
+   Sweeps are done in order, one pass each, since each sweep starts from
+   the one before it. Extra memory is a few rays.
+ */
+
+enum SigmetStatus Sigmet_Vol_Fld_Dealias(struct Sigmet_Vol *vol_p,
+	char *abbrv, char *out_abbrv)
+{
+    struct dealias_arg arg;
+    int num_rays, num_bins;
+    int s, s_prev;
+    enum SigmetStatus status = SIGMET_OK;
+
+    if ( !vol_p ) {
+	fprintf(stderr, "%d: attempted to dealias field in bogus volume.\n",
+		getpid());
+	return SIGMET_BAD_ARG;
+    }
+    if ( !abbrv || !out_abbrv ) {
+	fprintf(stderr, "%d: attempted to dealias bogus field.\n", getpid());
+	return SIGMET_BAD_ARG;
+    }
+    if ( Sigmet_Vol_GetFld(vol_p, abbrv, &arg.dat_p) == -1 ) {
+	fprintf(stderr, "%d: no field of %s in volume.\n", getpid(), abbrv);
+	return SIGMET_BAD_ARG;
+    }
+    if ( arg.dat_p->stor_fmt == SIGMET_DBL
+	    || arg.dat_p->stor_fmt == SIGMET_MT ) {
+	fprintf(stderr, "%d: cannot dealias %s. Storage format not "
+		"supported.\n", getpid(), abbrv);
+	return SIGMET_BAD_VOL;
+    }
+    if ( Sigmet_Vol_GetFld(vol_p, out_abbrv, &arg.out_p) == -1 ) {
+	fprintf(stderr, "%d: no field of %s in volume.\n",
+		getpid(), out_abbrv);
+	return SIGMET_BAD_ARG;
+    }
+    if ( !fld_derived(arg.out_p) || arg.out_p == arg.dat_p ) {
+	fprintf(stderr, "%d: editable field in volume not in correct format.\n",
+		getpid());
+	return SIGMET_BAD_VOL;
+    }
+    arg.nyq2 = 2.0 * Sigmet_Vol_VNyquist(vol_p);
+    if ( !isfinite(arg.nyq2) || arg.nyq2 <= 0.0 ) {
+	fprintf(stderr, "%d: cannot dealias %s. Nyquist velocity not "
+		"known.\n", getpid(), abbrv);
+	return SIGMET_BAD_VOL;
+    }
+    num_rays = vol_p->ih.ic.num_rays;
+    num_bins = vol_p->ih.tc.tri.num_bins_out;
+    arg.in_buf = MALLOC(num_bins * sizeof(float));
+    arg.cur = MALLOC(num_bins * sizeof(float));
+    arg.prev_buf = MALLOC(num_bins * sizeof(float));
+    arg.ref_buf = MALLOC(num_bins * sizeof(float));
+    arg.near = MALLOC(num_rays * sizeof(int));
+    if ( !arg.in_buf || !arg.cur || !arg.prev_buf || !arg.ref_buf
+	    || !arg.near ) {
+	fprintf(stderr, "%d: could not allocate buffers to dealias %s.\n",
+		getpid(), abbrv);
+	status = SIGMET_MEM_FAIL;
+	goto done;
+    }
+    sweep_ready(vol_p, -1);
+    fld_lut(vol_p, arg.dat_p);
+    fld_lut(vol_p, arg.out_p);
+    for (s_prev = -1, s = 0; s < vol_p->ih.ic.num_sweeps; s++) {
+	if ( vol_p->sweep_hdr[s].ok ) {
+	    dealias_swp(vol_p, s, s_prev, &arg);
+	    s_prev = s;
+	}
+    }
+    vol_p->mod = 1;
+
+done:
+    FREE(arg.near);
+    FREE(arg.ref_buf);
+    FREE(arg.prev_buf);
+    FREE(arg.cur);
+    FREE(arg.in_buf);
+    return status;
+}
+
+/*
+   Add dt DAYS to all times in vol_p.
+ */
+
+enum SigmetStatus Sigmet_Vol_IncrTm(struct Sigmet_Vol *vol_p, double dt)
+{
+    struct Sigmet_Task_Sched_Info tsi;
+    int dt_i;
+    int s, num_sweeps, r, num_rays;
+
+    if ( !vol_p ) {
+	fprintf(stderr, "%d: attempted to increment time on bogus volume.\n",
+		getpid());
+	return SIGMET_BAD_ARG;
+    }
+    sweep_ready(vol_p, -1);
+    if (       !ymds_incr(&vol_p->ph.pc.gen_tm, dt)
+	    || !ymds_incr(&vol_p->ph.pc.ingest_sweep_tm, dt)
+	    || !ymds_incr(&vol_p->ph.pc.ingest_file_tm, dt)
+	    || !ymds_incr(&vol_p->ih.ic.vol_start_time, dt)
+	    || !ymds_incr(&vol_p->ih.tc.tei.data_time, dt) ) {
+	return SIGMET_BAD_VOL;
+    }
+    dt_i = round(dt * 86400);
+    tsi = vol_p->ih.tc.tsi;
+    if ( tsi.start_time >= 0 ) {
+	vol_p->ih.tc.tsi.start_time = (tsi.start_time + dt_i) % 86400;
+    }
+    if ( tsi.stop_time >= 0 ) {
+	vol_p->ih.tc.tsi.stop_time = (tsi.stop_time + dt_i) % 86400;
+    }
+    if ( tsi.time_last_run >= 0 ) {
+	vol_p->ih.tc.tsi.time_last_run = (tsi.time_last_run + dt_i) % 86400;
+    }
+    if ( tsi.rel_day_last_run >= 0 ) {
+	vol_p->ih.tc.tsi.rel_day_last_run = tsi.rel_day_last_run + dt_i / 86400;
+    }
+    num_sweeps = vol_p->ih.tc.tni.num_sweeps;
+    num_rays = vol_p->ih.ic.num_rays;
+    for (s = 0; s < num_sweeps; s++) {
+	vol_p->sweep_hdr[s].time += dt;
+	for (r = 0; r < num_rays; r++) {
+	    vol_p->ray_hdr[s][r].time += dt;
+	}
+    }
+    vol_p->mod = 1;
+    return SIGMET_OK;
+}
+
+enum SigmetStatus Sigmet_Vol_ShiftAz(struct Sigmet_Vol *vol_p, double daz)
+{
+    unsigned long idaz;			/* Binary angle to add to each
+					   azimuth */
+    int s, r;				/* Loop indeces */
+
+    if ( !vol_p ) {
+	return SIGMET_BAD_ARG;
+    }
+    sweep_ready(vol_p, -1);
+    idaz = Sigmet_RadBin4(GeogLonR(daz, M_PI));
+    switch (Sigmet_Vol_ScanMode(vol_p)) {
+	case RHI:
+	    for (s = 0; s < vol_p->num_sweeps_ax; s++) {
+		vol_p->ih.tc.tni.scan_info.rhi_info.az[s] += idaz;
+	    }
+	    break;
+	case PPI_S:
+	case PPI_C:
+	    for (s = 0; s < vol_p->num_sweeps_ax; s++) {
+		vol_p->ih.tc.tni.scan_info.ppi_info.left_az += idaz;
+		vol_p->ih.tc.tni.scan_info.ppi_info.right_az += idaz;
+	    }
+	    break;
+	case FILE_SCAN:
+	    vol_p->ih.tc.tni.scan_info.file_info.az0 += idaz;
+	case MAN_SCAN:
+	    break;
+    }
+    for (s = 0; s < vol_p->num_sweeps_ax; s++) {
+	for (r = 0; r < Sigmet_Vol_NumRays(vol_p); r++) {
+	    vol_p->ray_hdr[s][r].az0
+		= GeogLonR(vol_p->ray_hdr[s][r].az0 + daz, M_PI);
+	    vol_p->ray_hdr[s][r].az1
+		= GeogLonR(vol_p->ray_hdr[s][r].az1 + daz, M_PI);
+	}
+    }
+    vol_p->mod = 1;
+    return SIGMET_OK;
+}
+
+/*
+   Nyquist velocity
+ */
+
+double Sigmet_Vol_VNyquist(struct Sigmet_Vol *vol_p)
+{
+    double wav_len, prf;
+
+    prf = vol_p->ih.tc.tdi.prf;
+    wav_len = 0.01 * 0.01 * vol_p->ih.tc.tmi.wave_len;
+    switch (vol_p->ih.tc.tdi.m_prf_mode) {
+	case ONE_ONE:
+	    return 0.25 * wav_len * prf;
+	case TWO_THREE:
+	    return 2 * 0.25 * wav_len * prf;
+	case THREE_FOUR:
+	    return 3 * 0.25 * wav_len * prf;
+	case FOUR_FIVE:
+	    return 3 * 0.25 * wav_len * prf;
+    }
+    return NAN;
+}
+/*
+   Fetch a value from a Sigmet volume
+ */
+
+float Sigmet_Vol_GetDatum(struct Sigmet_Vol *vol_p, int y, int s, int r, int b)
+{
+    sweep_ready(vol_p, s);
+    if ( !vol_p
+	    || y < 0 || y >= vol_p->num_types
+	    || s < 0 || s >= vol_p->num_sweeps_ax
+	    || r < 0 || r >= vol_p->ih.ic.num_rays
+	    || !vol_p->ray_hdr
+	    || b < 0 || b >= vol_p->ray_hdr[s][r].num_bins ) {
+	return NAN;
+    }
+    return fld_get(vol_p, vol_p->dat + y, s, r, b);
+}
+
+/*
+   Place values for a ray from a Sigmet volume at ray_p, which should have
+   space for the number of bins in the ray.
+ */
+
+enum SigmetStatus Sigmet_Vol_GetRayDat(struct Sigmet_Vol *vol_p, int y, int s,
+	int r, float **ray_p)
+{
+    int ray_num_bins;
+    float *f_p;
+
+    if ( !vol_p ) {
+	return SIGMET_BAD_ARG;
+    }
+    if ( !vol_p->ray_hdr ) {
+	return SIGMET_BAD_VOL;
+    }
+    if ( s < 0 || s >= vol_p->ih.ic.num_sweeps ) {
+	fprintf(stderr, "%d: sweep index out of bounds.\n", getpid());
+	return SIGMET_RNG_ERR;
+    }
+    if ( r < 0 || r >= vol_p->ih.ic.num_rays ) {
+	fprintf(stderr, "%d: ray index out of bounds.\n", getpid());
+	return SIGMET_RNG_ERR;
+    }
+    sweep_ready(vol_p, s);
+    if ( !sweep_ld(&vol_p->filter, s) ) {
+	fprintf(stderr, "%d: sweep %d not loaded.\n", getpid(), s);
+	return SIGMET_RNG_ERR;
+    }
+    if ( vol_p->dat[y].stor_fmt == SIGMET_DBL
+	    || vol_p->dat[y].stor_fmt == SIGMET_MT ) {
+	return SIGMET_BAD_VOL;
+    }
+    ray_num_bins = vol_p->ray_hdr[s][r].num_bins;
+    f_p = fld_ray_get(vol_p, vol_p->dat + y, s, r, *ray_p);
+    if ( f_p != *ray_p ) {
+	memcpy(*ray_p, f_p, ray_num_bins * sizeof(float));
+    }
+    return SIGMET_OK;
+}
+
+/*
+   Return distance in meters along beam to start of bin
+ */
+
+double Sigmet_Vol_BinStart(struct Sigmet_Vol *vol_p, int b)
+{
+    return vol_p ?
+	0.01 * (vol_p->ih.tc.tri.rng_1st_bin + b * vol_p->ih.tc.tri.step_out)
+	: NAN;
+}
+
+enum SigmetStatus Sigmet_Vol_PPI_BinOutl(struct Sigmet_Vol *vol_p,
+	int s, int r, int b,
+	int (*lonlat_to_xy)(double, double, double *, double *, void *),
+	void *proj_p, double *cnr)
+{
+    double re;				/* Earth radius */
+    double lon_r, lat_r;		/* Radar longitude latitude */
+    double az0, az1;			/* Azimuth limits of bin */
+    double r00, dr;			/* Range to first bin, bin length, m */
+    double r0, r1;			/* Beam distance to bin start, end */
+    double r0_g, r1_g;			/* Ground distance to bin start, end */
+    double tilt;			/* Mean tilt */
+    double lon, lat;			/* Corner coordinates */
+
+    if ( !vol_p ) {
+	return SIGMET_BAD_ARG;
+    }
+    if ( vol_p->ih.tc.tni.scan_mode != PPI_S
+	    && vol_p->ih.tc.tni.scan_mode != PPI_C ) {
+	fprintf(stderr, "%d: volume must be PPI.\n", getpid());
+	return SIGMET_BAD_ARG;
+    }
+    if ( s < 0 || s >= vol_p->ih.ic.num_sweeps ) {
+	fprintf(stderr, "%d: sweep index out of bounds.\n", getpid());
+	return SIGMET_RNG_ERR;
+    }
+    if ( r < 0 || r >= vol_p->ih.ic.num_rays ) {
+	fprintf(stderr, "%d: ray index out of bounds.\n", getpid());
+	return SIGMET_RNG_ERR;
+    }
+    sweep_ready(vol_p, s);
+    if ( b < 0 || b >= vol_p->ray_hdr[s][r].num_bins ) {
+	fprintf(stderr, "%d: bin index out of bounds.\n", getpid());
+	return SIGMET_RNG_ERR;
+    }
+    az0 = vol_p->ray_hdr[s][r].az0;
+    az1 = vol_p->ray_hdr[s][r].az1;
+    if ( GeogLonR(az1, az0) > az0 ) {
+	double t = az1;
+	az1 = az0;
+	az0 = t;
+    }
+    tilt = (vol_p->ray_hdr[s][r].tilt0 + vol_p->ray_hdr[s][r].tilt1) / 2;
+    r00 = 0.01 * vol_p->ih.tc.tri.rng_1st_bin;	/* 0.01 converts cm -> m */
+    dr = 0.01 * vol_p->ih.tc.tri.step_out;
+    r0 = r00 + b * dr;
+    r1 = r0 + dr;
+    re = GeogREarth(NULL);
+    r0_g = atan(r0 * cos(tilt) / (re + r0 * sin(tilt)));
+    r1_g = atan(r1 * cos(tilt) / (re + r1 * sin(tilt)));
+    lon_r = Sigmet_Bin4Rad(vol_p->ih.ic.longitude);
+    lat_r = Sigmet_Bin4Rad(vol_p->ih.ic.latitude);
+    GeogStep(lon_r, lat_r, az0, r0_g, &lon, &lat);
+    lonlat_to_xy(lon, lat, cnr + 0, cnr + 1, proj_p);
+    GeogStep(lon_r, lat_r, az0, r1_g, &lon, &lat);
+    lonlat_to_xy(lon, lat, cnr + 2, cnr + 3, proj_p);
+    GeogStep(lon_r, lat_r, az1, r1_g, &lon, &lat);
+    lonlat_to_xy(lon, lat, cnr + 4, cnr + 5, proj_p);
+    GeogStep(lon_r, lat_r, az1, r0_g, &lon, &lat);
+    lonlat_to_xy(lon, lat, cnr + 6, cnr + 7, proj_p);
+    return SIGMET_OK;
+}
+
+/*
+   Return limits of ppi sweep for given map projection. lonlat_to_xy
+   receives proj_p as its last argument.
+ */
+
+enum SigmetStatus Sigmet_Vol_PPI_Bnds(struct Sigmet_Vol *vol_p, int s,
+	int (*lonlat_to_xy)(double, double, double *, double *, void *),
+	void *proj_p, double *x_min_p, double *x_max_p, double *y_min_p, double *y_max_p)
+{
+    double x_min, x_max, y_min, y_max;	/* PPI limits */
+    double rlon, rlat;			/* Radar location */
+    double rearth;			/* Earth radius */
+    double rng_1st_bin, step_out;	/* Range to first bin, output bin step,
+					   meters */
+    int num_bins;
+    double ray_len;			/* Ray length, meters */
+    int r;				/* Ray index */
+    double az0, az1, az;		/* Ray azimuth */
+    double tilt0, tilt1, tilt;		/* Ray tilt */
+    double ray_len_g;			/* Ray length along ground */
+    double lon, lat;			/* Geographic coordinates of ray end */
+    double x, y;			/* Map coordinates of ray end */
+
+    if ( !vol_p ) {
+	fprintf(stderr, "%d: bogus volume.\n", getpid());
+	return SIGMET_BAD_ARG;
+    }
+    if ( vol_p->ih.tc.tni.scan_mode != PPI_S
+	    && vol_p->ih.tc.tni.scan_mode != PPI_C ) {
+	fprintf(stderr, "%d: volume must be PPI.\n", getpid());
+	return SIGMET_BAD_ARG;
+    }
+    if ( s >= vol_p->num_sweeps_ax ) {
+	fprintf(stderr, "%d: sweep index out of range for volume.\n", getpid());
+	return SIGMET_RNG_ERR;
+    }
+    sweep_ready(vol_p, s);
+    if ( !vol_p->sweep_hdr[s].ok ) {
+	fprintf(stderr, "%d: sweep not valid in volume.\n", getpid());
+	return SIGMET_RNG_ERR;
+    }
+    rlon = Sigmet_Bin4Rad(vol_p->ih.ic.longitude);
+    rlat = Sigmet_Bin4Rad(vol_p->ih.ic.latitude);
+    rearth = GeogREarth(NULL);
+    rng_1st_bin = 0.01 * vol_p->ih.tc.tri.rng_1st_bin;
+    step_out = 0.01 * vol_p->ih.tc.tri.step_out;
+    num_bins = vol_p->ih.tc.tri.num_bins_out;
+    ray_len = rng_1st_bin + (num_bins + 0.5) * step_out;
+    x_min = y_min = DBL_MAX;
+    x_max = y_max = -DBL_MAX;
+    if ( lonlat_to_xy(rlon, rlat, &x, &y, proj_p) ) {
+	x_min = (x < x_min) ? x : x_min;
+	x_max = (x > x_max) ? x : x_max;
+	y_min = (y < y_min) ? y : y_min;
+	y_max = (y > y_max) ? y : y_max;
+    }
+    for (r = 0; r < vol_p->ih.ic.num_rays; r++) {
+	if ( vol_p->ray_hdr[s][r].ok ) {
+	    az0 = vol_p->ray_hdr[s][r].az0;
+	    az1 = GeogLonR(vol_p->ray_hdr[s][r].az1, az0);
+	    az = (az0 + az1) / 2;
+	    tilt0 = vol_p->ray_hdr[s][r].tilt0;
+	    tilt1 = vol_p->ray_hdr[s][r].tilt1;
+	    tilt = (tilt0 + tilt1) / 2;
+	    ray_len_g
+		= atan(ray_len * cos(tilt) / (rearth + ray_len * sin(tilt)));
+	    GeogStep(rlon, rlat, az, ray_len_g, &lon, &lat);
+	    if ( lonlat_to_xy(lon, lat, &x, &y, proj_p) ) {
+		x_min = (x < x_min) ? x : x_min;
+		x_max = (x > x_max) ? x : x_max;
+		y_min = (y < y_min) ? y : y_min;
+		y_max = (y > y_max) ? y : y_max;
+	    }
+	}
+    }
+    if ( x_min == DBL_MAX || y_min == DBL_MAX
+	    || x_max == -DBL_MAX || y_max == -DBL_MAX ) {
+	return SIGMET_BAD_VOL;
+    }
+    *x_min_p = x_min;
+    *x_max_p = x_max;
+    *y_min_p = y_min;
+    *y_max_p = y_max;
+    return SIGMET_OK;
+}
+
+enum SigmetStatus Sigmet_Vol_RHI_BinOutl(struct Sigmet_Vol *vol_p,
+	int s, int r, int b, double *cnr)
+{
+    double re;				/* Earth radius, meters */
+    double r00;				/* Range to first bin, meters */
+    double dr;				/* Bin size, meters */
+    double r0, r1;			/* Beam distance to bin start, stop */
+    double tilt0, tilt1;		/* Start, end of current tilt */
+    double abs, ord;			/* Abscissa, ordinate of a point */
+
+    if ( !vol_p ) {
+	return SIGMET_BAD_ARG;
+    }
+    if ( vol_p->ih.tc.tni.scan_mode != RHI ) {
+	fprintf(stderr, "%d: volume must be RHI.\n", getpid());
+	return SIGMET_BAD_ARG;
+    }
+    if ( s < 0 || s >= vol_p->ih.ic.num_sweeps ) {
+	fprintf(stderr, "%d: sweep index out of bounds.\n", getpid());
+	return SIGMET_RNG_ERR;
+    }
+    if ( r < 0 || r >= vol_p->ih.ic.num_rays ) {
+	fprintf(stderr, "%d: ray index out of bounds.\n", getpid());
+	return SIGMET_RNG_ERR;
+    }
+    sweep_ready(vol_p, s);
+    if ( b < 0 || b >= vol_p->ray_hdr[s][r].num_bins ) {
+	fprintf(stderr, "%d: bin index out of bounds.\n", getpid());
+	return SIGMET_RNG_ERR;
+    }
+    tilt0 = vol_p->ray_hdr[s][r].tilt0;
+    tilt1 = vol_p->ray_hdr[s][r].tilt1;
+    if ( tilt1 < tilt0 ) {
+	double t = tilt1;
+	tilt1 = tilt0;
+	tilt0 = t;
+    }
+    r00 = 0.01 * vol_p->ih.tc.tri.rng_1st_bin;	/* 0.01 converts cm -> m */
+    dr = 0.01 * vol_p->ih.tc.tri.step_out;
+    r0 = r00 + b * dr;
+    r1 = r0 + dr;
+    re = GeogREarth(NULL) * FOUR_THIRD;
+    cnr[1] = ord = GeogBeamHt(r0, tilt0, re);
+    cnr[0] = abs = re * asin(r0 * cos(tilt0) / (re + ord));
+    cnr[3] = ord = GeogBeamHt(r1, tilt0, re);
+    cnr[2] = abs = re * asin(r1 * cos(tilt0) / (re + ord));
+    cnr[5] = ord = GeogBeamHt(r1, tilt1, re);
+    cnr[4] = abs = re * asin(r1 * cos(tilt1) / (re + ord));
+    cnr[7] = ord = GeogBeamHt(r0, tilt1, re);
+    cnr[6] = abs = re * asin(r0 * cos(tilt1) / (re + ord));
+    return SIGMET_OK;
+}
+
+/*
+   Return limits of rhi sweep - distance along ground down range and height
+   above radar level.
+ */
+
+enum SigmetStatus Sigmet_Vol_RHI_Bnds(struct Sigmet_Vol *vol_p, int s,
+	double *x_max_p, double *y_max_p)
+{
+    double x_max, y_max;		/* RHI limits */
+    double rng_1st_bin, step_out;	/* Range to first bin, output bin step,
+					   meters */
+    int num_bins;
+    double ray_len;			/* Ray length, meters */
+    int r;				/* Ray index */
+    double tilt0, tilt1, tilt;		/* Ray tilt */
+    double rearth;			/* Earth radius */
+    double x, y;			/* Map coordinates of ray end */
+
+    if ( !vol_p ) {
+	fprintf(stderr, "%d: bogus volume.\n", getpid());
+	return SIGMET_BAD_ARG;
+    }
+    if ( vol_p->ih.tc.tni.scan_mode != RHI ) {
+	fprintf(stderr, "%d: volume must be RHI.\n", getpid());
+	return SIGMET_BAD_ARG;
+    }
+    if ( s >= vol_p->num_sweeps_ax ) {
+	fprintf(stderr, "%d: sweep index out of range for volume.\n", getpid());
+	return SIGMET_RNG_ERR;
+    }
+    sweep_ready(vol_p, s);
+    if ( !vol_p->sweep_hdr[s].ok ) {
+	fprintf(stderr, "%d: sweep not valid in volume.\n", getpid());
+	return SIGMET_RNG_ERR;
+    }
+    rearth = GeogREarth(NULL);
+    rng_1st_bin = 0.01 * vol_p->ih.tc.tri.rng_1st_bin;
+    step_out = 0.01 * vol_p->ih.tc.tri.step_out;
+    num_bins = vol_p->ih.tc.tri.num_bins_out;
+    ray_len = rng_1st_bin + (num_bins + 0.5) * step_out;
+    x_max = y_max = -DBL_MAX;
+    for (r = 0; r < vol_p->ih.ic.num_rays; r++) {
+	if ( vol_p->ray_hdr[s][r].ok ) {
+	    tilt0 = vol_p->ray_hdr[s][r].tilt0;
+	    tilt1 = vol_p->ray_hdr[s][r].tilt1;
+	    tilt = (tilt0 + tilt1) / 2;
+	    x = rearth
+		* atan2(ray_len * cos(tilt), rearth + ray_len * sin(tilt));
+	    y = (sqrt(rearth * rearth + 2 * rearth * ray_len * sin(tilt)
+			    + ray_len * ray_len) - rearth);
+	    x_max = (x > x_max) ? x : x_max;
+	    y_max = (y > y_max) ? y : y_max;
+	}
+    }
+    if ( x_max == -DBL_MAX || y_max == -DBL_MAX ) {
+	return SIGMET_BAD_VOL;
+    }
+    *x_max_p = x_max;
+    *y_max_p = y_max;
+    return SIGMET_OK;
+}
+
+/*
+   get product_hdr (raw volume record 1).
+ */
+
+struct Sigmet_Product_Hdr get_product_hdr(char *rec, int swap)
+{
+    struct Sigmet_Product_Hdr ph;
+
+    ph.sh = get_structure_header(rec, swap);
+    ph.pc = get_product_configuration(rec, swap);
+    rec += 12;
+    ph.pe = get_product_end(rec, swap);
+    rec += 320;
+    return ph;
+}
+
+void print_product_hdr(FILE *out, char *prefix, struct Sigmet_Product_Hdr ph)
+{
+    print_structure_header(out, prefix, ph.sh);
+    print_product_configuration(out, prefix,  ph.pc);
+    print_product_end(out, prefix, ph.pe);
+}
+
+/*
+   get / print product_configuration.
+ */
+
+struct Sigmet_Product_Configuration get_product_configuration(char *rec, int swap)
+{
+    struct Sigmet_Product_Configuration pc;
+
+    pc.sh = get_structure_header(rec, swap);
+    pc.type = get_uint16(rec + 12, swap);
+    pc.schedule = get_uint16(rec + 14, swap);
+    pc.skip = get_sint32(rec + 16, swap);
+    pc.gen_tm = get_ymds_time(rec + 20, swap);
+    pc.ingest_sweep_tm = get_ymds_time(rec + 32, swap);
+    pc.ingest_file_tm = get_ymds_time(rec + 44, swap);
+    memcpy(pc.config_file, rec + 62, 12);
+    trimRight(pc.config_file, 12);
+    memcpy(pc.task_name, rec + 74, 12);
+    trimRight(pc.task_name, 12);
+    pc.flag = get_uint16(rec + 86, swap);
+    pc.x_scale = get_sint32(rec + 88, swap);
+    pc.y_scale = get_sint32(rec + 92, swap);
+    pc.z_scale = get_sint32(rec + 96, swap);
+    pc.x_size = get_sint32(rec + 100, swap);
+    pc.y_size = get_sint32(rec + 104, swap);
+    pc.z_size = get_sint32(rec + 108, swap);
+    pc.x_loc = get_sint32(rec + 112, swap);
+    pc.y_loc = get_sint32(rec + 116, swap);
+    pc.z_loc = get_sint32(rec + 120, swap);
+    pc.max_rng = get_sint32(rec + 124, swap);
+    pc.data_type = get_uint16(rec + 130, swap);
+    memcpy(pc.proj, rec + 132, 12);
+    trimRight(pc.proj, 12);
+    pc.inp_data_type = get_uint16(rec + 144, swap);
+    pc.proj_type = *(unsigned char *)(rec + 146);
+    pc.rad_smoother = get_sint16(rec + 148, swap);
+    pc.num_runs = get_sint16(rec + 150, swap);
+    pc.zr_const = get_sint32(rec + 152, swap);
+    pc.zr_exp = get_sint32(rec + 156, swap);
+    pc.x_smooth = get_sint16(rec + 160, swap);
+    pc.y_smooth = get_sint16(rec + 162, swap);
+    pc.psi = get_product_specific_info(rec + 80, swap);
+    memcpy(pc.suffixes, rec + 244, 16);
+    trimRight(pc.suffixes, 16);
+    pc.csd = get_color_scale_def(rec + 272, swap);
+    return pc;
+}
+
+void print_product_configuration(FILE *out, char *pfx,
+	struct Sigmet_Product_Configuration pc)
+{
+    char prefix[STR_LEN];
+
+    snprintf(prefix, STR_LEN, "%s%s", pfx, "<product_configuration>.");
+    print_structure_header(out, prefix, pc.sh);
+    print_u(out, pc.type, prefix, "type",
+	    "Product type code: 1:PPI 2:RHI 3:CAPPI 4:CROSS 5:TOPS 6:TRACK"
+	    " 7:RAIN1 8:RAINN 9:VVP 10:VIL 11:SHEAR 12:WARN 13:CATCH 14:RTI"
+	    " 15:RAW 16:MAX 17:USER 18:USERV 19:OTHER 20:STATUS 21:SLINE"
 	    " 22:WIND 23:BEAM 24:TEXT 25:FCAST 26:NDOP 27:IMAGE 28:COMP"
 	    " 29:TDWR 30:GAGE 31:DWELL 32:SRI 33:BASE 34:HMAX");
     print_u(out, pc.schedule, prefix, "schedule",
@@ -3626,1566 +5635,3691 @@ void print_product_configuration(FILE *out, char *pfx,
 }
 
 /*
-   get / print product_specific_info.
+   get / print product_specific_info.
+ */
+
+struct Sigmet_Product_Specific_Info get_product_specific_info(char *rec, int swap)
+{
+    struct Sigmet_Product_Specific_Info psi;
+
+    psi.data_type_mask = get_uint32(rec + 0, swap);
+    psi.rng_last_bin = get_sint32(rec + 4, swap);
+    psi.format_conv_flag = get_uint32(rec + 8, swap);
+    psi.flag = get_uint32(rec + 12, swap);
+    psi.sweep_num = get_sint32(rec + 16, swap);
+    psi.xhdr_type = get_uint32(rec + 20, swap);
+    psi.data_type_mask1 = get_uint32(rec + 24, swap);
+    psi.data_type_mask2 = get_uint32(rec + 28, swap);
+    psi.data_type_mask3 = get_uint32(rec + 32, swap);
+    psi.data_type_mask4 = get_uint32(rec + 36, swap);
+    psi.playback_vsn = get_uint32(rec + 40, swap);
+    return psi;
+}
+
+void print_product_specific_info(FILE *out, char *pfx,
+	struct Sigmet_Product_Specific_Info psi)
+{
+    char prefix[STR_LEN];
+
+    snprintf(prefix, STR_LEN, "%s%s", pfx, "<product_specific_info>.");
+    print_x(out, psi.data_type_mask, prefix, "data_type_mask",
+	    "Data type mask word 0");
+    print_i(out, psi.rng_last_bin, prefix, "rng_last_bin",
+	    "Range of last bin in cm");
+    print_u(out, psi.format_conv_flag, prefix, "format_conv_flag",
+	    "Format conversion flag: 0=Preserve all ingest data"
+	    " 1=Convert 8-bit data to 16-bit data"
+	    " 2=Convert 16-bit data to 8-bit data");
+    print_x(out, psi.flag, prefix, "flag",
+	    "Flag word: Bit 0=Separate product files by sweep Bit 1=Mask data"
+	    " by supplied mask");
+    print_i(out, psi.sweep_num, prefix, "sweep_num",
+	    "Sweep number if separate files, origin 1");
+    print_u(out, psi.xhdr_type, prefix, "xhdr_type",
+	    "Xhdr type (unused)");
+    print_x(out, psi.data_type_mask1, prefix, "data_type_mask1",
+	    "Data type mask 1");
+    print_x(out, psi.data_type_mask2, prefix, "data_type_mask2",
+	    "Data type mask 2");
+    print_x(out, psi.data_type_mask3, prefix, "data_type_mask3",
+	    "Data type mask 3");
+    print_x(out, psi.data_type_mask4, prefix, "data_type_mask4",
+	    "Data type mask 4");
+    print_u(out, psi.playback_vsn, prefix, "playback_vsn",
+	    "Playback version (low 16-bits)");
+}
+
+/*
+   get / print color_scale_def.
+ */
+
+struct Sigmet_Color_Scale_Def get_color_scale_def(char *rec, int swap)
+{
+    struct Sigmet_Color_Scale_Def csd;
+    char *p, *p1;
+    unsigned *q;
+
+    csd.flags = get_uint32(rec + 0, swap);
+    csd.istart = get_sint32(rec + 4, swap);
+    csd.istep = get_sint32(rec + 8, swap);
+    csd.icolcnt = get_sint16(rec + 12, swap);
+    csd.iset_and_scale = get_uint16(rec + 14, swap);
+    q = csd.ilevel_seams;
+    p = rec + 16;
+    p1 = p + sizeof(*csd.ilevel_seams) * 16;
+    for ( ; p < p1; p += sizeof(*csd.ilevel_seams), q++) {
+	*q = get_uint16(p, swap);
+    }
+    return csd;
+}
+
+void print_color_scale_def(FILE *out, char *pfx,
+	struct Sigmet_Color_Scale_Def csd)
+{
+    int n;
+    char prefix[STR_LEN];
+    char struct_path[STR_LEN];
+
+    snprintf(prefix, STR_LEN, "%s%s", pfx, "<color_scale_def>.");
+    print_x(out, csd.flags, prefix, "flags",
+	    "iflags: Bit 8=COLOR_SCALE_VARIABLE Bit 10=COLOR_SCALE_TOP_SAT Bit"
+	    " 11=COLOR_SCALE_BOT_SAT");
+    print_i(out, csd.istart, prefix, "istart",
+	    "istart: Starting level");
+    print_i(out, csd.istep, prefix, "istep",
+	    "istep: Level step");
+    print_i(out, csd.icolcnt, prefix, "icolcnt",
+	    "icolcnt: Number of colors in scale");
+    print_u(out, csd.iset_and_scale, prefix, "iset_and_scale",
+	    "iset_and_scale: Color set number in low byte, color scale number"
+	    " in high byte.");
+    for (n = 0; n < 16; n++) {
+	snprintf(struct_path, STR_LEN, "%s%s%d%s", prefix,
+		"ilevel_seams[", n, "]");
+	fprintf(out, "%u" FS "%s" FS "%s\n", csd.ilevel_seams[n], struct_path,
+		"ilevel_seams: Variable level starting values");
+    }
+}
+
+/*
+   get / print product_end.
+ */
+
+struct Sigmet_Product_End get_product_end(char *rec, int swap)
+{
+    struct Sigmet_Product_End pe;
+
+    memcpy(pe.site_name_prod, rec + 0, 16);
+    trimRight(pe.site_name_prod, 16);
+    memcpy(pe.iris_prod_vsn, rec + 16, 8);
+    trimRight(pe.iris_prod_vsn, 8);
+    memcpy(pe.iris_ing_vsn, rec + 24, 8);
+    trimRight(pe.iris_ing_vsn, 8);
+    pe.local_wgmt = get_sint16(rec + 72, swap);
+    memcpy(pe.hw_name, rec + 74, 16);
+    trimRight(pe.hw_name, 16);
+    memcpy(pe.site_name_ing, rec + 90, 16);
+    trimRight(pe.site_name_ing, 16);
+    pe.rec_wgmt = get_sint16(rec + 106, swap);
+    pe.center_latitude = get_uint32(rec + 108, swap);
+    pe.center_longitude = get_uint32(rec + 112, swap);
+    pe.ground_elev = get_sint16(rec + 116, swap);
+    pe.radar_ht = get_sint16(rec + 118, swap);
+    pe.prf = get_sint32(rec + 120, swap);
+    pe.pulse_w = get_sint32(rec + 124, swap);
+    pe.proc_type = get_uint16(rec + 128, swap);
+    pe.trigger_rate_scheme = get_uint16(rec + 130, swap);
+    pe.num_samples = get_sint16(rec + 132, swap);
+    memcpy(pe.clutter_filter, rec + 134, 12);
+    trimRight(pe.clutter_filter, 12);
+    pe.lin_filter = get_uint16(rec + 146, swap);
+    pe.wave_len = get_sint32(rec + 148, swap);
+    pe.trunc_ht = get_sint32(rec + 152, swap);
+    pe.rng_bin0 = get_sint32(rec + 156, swap);
+    pe.rng_last_bin = get_sint32(rec + 160, swap);
+    pe.num_bins_out = get_sint32(rec + 164, swap);
+    pe.flag = get_uint16(rec + 168, swap);
+    pe.polarization = get_uint16(rec + 172, swap);
+    pe.hpol_io_cal = get_sint16(rec + 174, swap);
+    pe.hpol_cal_noise = get_sint16(rec + 176, swap);
+    pe.hpol_radar_const = get_sint16(rec + 178, swap);
+    pe.recv_bandw = get_uint16(rec + 180, swap);
+    pe.hpol_noise = get_sint16(rec + 182, swap);
+    pe.vpol_noise = get_sint16(rec + 184, swap);
+    pe.ldr_offset = get_sint16(rec + 186, swap);
+    pe.zdr_offset = get_sint16(rec + 188, swap);
+    pe.tcf_cal_flags = get_uint16(rec + 190, swap);
+    pe.tcf_cal_flags2 = get_uint16(rec + 192, swap);
+    pe.std_parallel1 = get_uint32(rec + 212, swap);
+    pe.std_parallel2 = get_uint32(rec + 216, swap);
+    pe.rearth = get_uint32(rec + 220, swap);
+    pe.flatten = get_uint32(rec + 224, swap);
+    pe.fault = get_uint32(rec + 228, swap);
+    pe.insites_mask = get_uint32(rec + 232, swap);
+    pe.logfilter_num = get_uint16(rec + 236, swap);
+    pe.cluttermap_used = get_uint16(rec + 238, swap);
+    pe.proj_lat = get_uint32(rec + 240, swap);
+    pe.proj_lon = get_uint32(rec + 244, swap);
+    pe.i_prod = get_sint16(rec + 248, swap);
+    pe.melt_level = get_sint16(rec + 282, swap);
+    pe.radar_ht_ref = get_sint16(rec + 284, swap);
+    pe.num_elem = get_sint16(rec + 286, swap);
+    pe.wind_spd = *(unsigned char *)(rec + 288);
+    pe.wind_dir = *(unsigned char *)(rec + 289);
+    memcpy(pe.tz, rec + 292, 8);
+    trimRight(pe.tz, 8);
+    return pe;
+}
+
+void print_product_end(FILE *out, char *pfx, struct Sigmet_Product_End pe)
+{
+    char prefix[STR_LEN];
+
+    snprintf(prefix, STR_LEN, "%s%s", pfx, "<product_end>.");
+    print_s(out, pe.site_name_prod, prefix, "site_name_prod",
+	    "Site name -- where product was made (space padded)");
+    print_s(out, pe.iris_prod_vsn, prefix, "iris_prod_vsn",
+	    "IRIS version where product was made (null terminated)");
+    print_s(out, pe.iris_ing_vsn, prefix, "iris_ing_vsn",
+	    "IRIS version where ingest data came from");
+    print_i(out, pe.local_wgmt, prefix, "local_wgmt",
+	    "Number of minutes local standard time is west of GMT");
+    print_s(out, pe.hw_name, prefix, "hw_name",
+	    "Hardware name where ingest data came from (space padded)");
+    print_s(out, pe.site_name_ing, prefix, "site_name_ing",
+	    "Site name where ingest data came from (space padded)");
+    print_i(out, pe.rec_wgmt, prefix, "rec_wgmt",
+	    "Number of minutes recorded standard time is west of GMT");
+    print_u(out, pe.center_latitude, prefix, "center_latitude",
+	    "Latitude of center (binary angle) *");
+    print_u(out, pe.center_longitude, prefix, "center_longitude",
+	    "Longitude of center (binary angle) *");
+    print_i(out, pe.ground_elev, prefix, "ground_elev",
+	    "Signed ground height in meters relative to sea level");
+    print_i(out, pe.radar_ht, prefix, "radar_ht",
+	    "Height of radar above the ground in meters");
+    print_i(out, pe.prf, prefix, "prf",
+	    "PRF in hertz");
+    print_i(out, pe.pulse_w, prefix, "pulse_w",
+	    "Pulse width in 1/100 of microseconds");
+    print_u(out, pe.proc_type, prefix, "proc_type",
+	    "Type of signal processor used");
+    print_u(out, pe.trigger_rate_scheme, prefix, "trigger_rate_scheme",
+	    "Trigger rate scheme");
+    print_i(out, pe.num_samples, prefix, "num_samples",
+	    "Number of samples used");
+    print_s(out, pe.clutter_filter, prefix, "clutter_filter",
+	    "Clutter filter file name");
+    print_u(out, pe.lin_filter, prefix, "lin_filter",
+	    "Number of linear based filter for the first bin");
+    print_i(out, pe.wave_len, prefix, "wave_len",
+	    "Wavelength in 1/100 of centimeters");
+    print_i(out, pe.trunc_ht, prefix, "trunc_ht",
+	    "Truncation height (cm above the radar)");
+    print_i(out, pe.rng_bin0, prefix, "rng_bin0",
+	    "Range of the first bin in cm");
+    print_i(out, pe.rng_last_bin, prefix, "rng_last_bin",
+	    "Range of the last bin in cm");
+    print_i(out, pe.num_bins_out, prefix, "num_bins_out",
+	    "Number of output bins");
+    print_x(out, pe.flag, prefix, "flag",
+	    "Flag word Bit0:Disdrometer failed, we used setup for Z/R source"
+	    " instead");
+    print_u(out, pe.polarization, prefix, "polarization",
+	    "Type of polarization used");
+    print_i(out, pe.hpol_io_cal, prefix, "hpol_io_cal",
+	    "I0 cal value, horizontal pol, in 1/100 dBm");
+    print_i(out, pe.hpol_cal_noise, prefix, "hpol_cal_noise",
+	    "Noise at calibration, horizontal pol, in 1/100 dBm");
+    print_i(out, pe.hpol_radar_const, prefix, "hpol_radar_const",
+	    "Radar constant, horizontal pol, in 1/100 dB");
+    print_u(out, pe.recv_bandw, prefix, "recv_bandw",
+	    "Receiver bandwidth in kHz");
+    print_i(out, pe.hpol_noise, prefix, "hpol_noise",
+	    "Current noise level, horizontal pol, in 1/100 dBm");
+    print_i(out, pe.vpol_noise, prefix, "vpol_noise",
+	    "Current noise level, vertical pol, in 1/100 dBm");
+    print_i(out, pe.ldr_offset, prefix, "ldr_offset",
+	    "LDR offset, in 1/100 dB");
+    print_i(out, pe.zdr_offset, prefix, "zdr_offset",
+	    "ZDR offset, in 1/100 dB");
+    print_u(out, pe.tcf_cal_flags, prefix, "tcf_cal_flags",
+	    "TCF Cal flags, see struct task_calib_info (added in 8.12.3)");
+    print_u(out, pe.tcf_cal_flags2, prefix, "tcf_cal_flags2",
+	    "TCF Cal flags2, see struct task_calib_info (added in 8.12.3)");
+    print_u(out, pe.std_parallel1, prefix, "std_parallel1",
+	    "More projection info these 4 words: Standard parallel #1");
+    print_u(out, pe.std_parallel2, prefix, "std_parallel2",
+	    "Standard parallel #2");
+    print_u(out, pe.rearth, prefix, "rearth",
+	    "Equatorial radius of the earth, cm (zero = 6371km sphere)");
+    print_u(out, pe.flatten, prefix, "flatten",
+	    "1/Flattening in 1/1000000 (zero = sphere)");
+    print_u(out, pe.fault, prefix, "fault",
+	    "Fault status of task, see ingest_configuration 3.2.14 "
+	    " for details");
+    print_u(out, pe.insites_mask, prefix, "insites_mask",
+	    "Mask of input sites used in a composite");
+    print_u(out, pe.logfilter_num, prefix, "logfilter_num",
+	    "Number of log based filter for the first bin");
+    print_u(out, pe.cluttermap_used, prefix, "cluttermap_used",
+	    "Nonzero if cluttermap applied to the ingest data");
+    print_u(out, pe.proj_lat, prefix, "proj_lat",
+	    "Latitude of projection reference *");
+    print_u(out, pe.proj_lon, prefix, "proj_lon",
+	    "Longitude of projection reference *");
+    print_i(out, pe.i_prod, prefix, "i_prod",
+	    "Product sequence number");
+    print_i(out, pe.melt_level, prefix, "melt_level",
+	    "Melting level in meters, msb complemented (0=unknown)");
+    print_i(out, pe.radar_ht_ref, prefix, "radar_ht_ref",
+	    "Height of radar above reference height in meters");
+    print_i(out, pe.num_elem, prefix, "num_elem",
+	    "Number of elements in product results array");
+    print_u(out, pe.wind_spd, prefix, "wind_spd",
+	    "Mean wind speed");
+    print_u(out, pe.wind_dir, prefix, "wind_dir",
+	    "Mean wind direction (unknown if speed and direction 0)");
+    print_s(out, pe.tz, prefix, "tz",
+	    "TZ Name of recorded data");
+}
+
+/*
+   get ingest header (raw volume record 2).
+ */
+
+struct Sigmet_Ingest_Header get_ingest_header(char *rec, int swap)
+{
+    struct Sigmet_Ingest_Header ih;
+
+    ih.sh = get_structure_header(rec, swap);
+    rec += 12;
+    ih.ic = get_ingest_configuration(rec, swap);
+    rec += 480;
+    ih.tc = get_task_configuration(rec, swap);
+    return ih;
+}
+
+void print_ingest_header(FILE *out, char *prefix,
+	struct Sigmet_Ingest_Header ih)
+{
+    print_structure_header(out, prefix, ih.sh);
+    print_ingest_configuration(out, prefix, ih.ic);
+    print_task_configuration(out, prefix, ih.tc);
+}
+
+/*
+   get / print ingest_configuration.
+ */
+
+struct Sigmet_Ingest_Configuration get_ingest_configuration(char *rec, int swap)
+{
+    struct Sigmet_Ingest_Configuration ic;
+    char *p, *p1;
+    int *q;
+
+    memcpy(ic.file_name, rec + 0, 80);
+    trimRight(ic.file_name, 80);
+    ic.num_assoc_files = get_sint16(rec + 80, swap);
+    ic.num_sweeps = get_sint16(rec + 82, swap);
+    ic.size_files = get_sint32(rec + 84, swap);
+    ic.vol_start_time = get_ymds_time(rec + 88, swap);
+    ic.ray_headers_sz = get_sint16(rec + 112, swap);
+    ic.extended_ray_headers_sz = get_sint16(rec + 114, swap);
+    ic.task_config_table_num = get_sint16(rec + 116, swap);
+    ic.playback_vsn = get_sint16(rec + 118, swap);
+    memcpy(ic.IRIS_vsn, rec + 124, 8);
+    trimRight(ic.IRIS_vsn, 8);
+    memcpy(ic.hw_site_name, rec + 132, 16);
+    trimRight(ic.hw_site_name, 16);
+    ic.local_wgmt = get_sint16(rec + 148, swap);
+    memcpy(ic.su_site_name, rec + 150, 16);
+    trimRight(ic.su_site_name, 16);
+    ic.rec_wgmt = get_sint16(rec + 166, swap);
+    ic.latitude = get_uint32(rec + 168, swap);
+    ic.longitude = get_uint32(rec + 172, swap);
+    ic.ground_elev = get_sint16(rec + 176, swap);
+    ic.radar_ht = get_sint16(rec + 178, swap);
+    ic.resolution = get_uint16(rec + 180, swap);
+    ic.index_first_ray = get_uint16(rec + 182, swap);
+    ic.num_rays = get_uint16(rec + 184, swap);
+    ic.num_bytes_gparam = get_sint16(rec + 186, swap);
+    ic.altitude = get_sint32(rec + 188, swap);
+    q = ic.velocity;
+    p = rec + 192;
+    p1 = p + sizeof(*ic.velocity) * 3;
+    for ( ; p < p1; p += sizeof(*ic.velocity), q++) {
+	*q = get_sint32(p, swap);
+    }
+    q = ic.offset_inu;
+    p = rec + 204;
+    p1 = p + sizeof(*ic.velocity) * 3;
+    for ( ; p < p1; p += sizeof(*ic.offset_inu), q++) {
+	*q = get_sint32(p, swap);
+    }
+    ic.fault = get_uint32(rec + 216, swap);
+    ic.melt_level = get_sint16(rec + 220, swap);
+    memcpy(ic.tz, rec + 224, 8);
+    trimRight(ic.tz, 8);
+    ic.flags = get_uint32(rec + 232, swap);
+    memcpy(ic.config_name, rec + 236, 16);
+    trimRight(ic.config_name, 16);
+    return ic;
+}
+
+void print_ingest_configuration(FILE *out, char *pfx,
+	struct Sigmet_Ingest_Configuration ic)
+{
+    char prefix[STR_LEN];
+
+    snprintf(prefix, STR_LEN, "%s%s", pfx, "<ingest_configuration>.");
+    print_s(out, ic.file_name, prefix, "file_name",
+	    "Name of file on disk");
+    print_i(out, ic.num_assoc_files, prefix, "num_assoc_files",
+	    "Number of associated data files extant");
+    print_i(out, ic.num_sweeps, prefix, "num_sweeps",
+	    "Number of sweeps completed so far");
+    print_i(out, ic.size_files, prefix, "size_files",
+	    "Total size of all files in bytes");
+    print_ymds_time(out, ic.vol_start_time, prefix, "vol_start_time",
+	    "Time that volume scan was started, TZ spec in bytes 166 & 224");
+    print_i(out, ic.ray_headers_sz, prefix, "ray_headers_sz",
+	    "Number of bytes in the ray headers");
+    print_i(out, ic.extended_ray_headers_sz, prefix, "extended_ray_headers_sz",
+	    "Number of bytes in extended ray headers"
+	    " (includes normal ray header)");
+    print_i(out, ic.task_config_table_num, prefix, "task_config_table_num",
+	    "Number of task configuration table");
+    print_i(out, ic.playback_vsn, prefix, "playback_vsn",
+	    "Playback version number");
+    print_s(out, ic.IRIS_vsn, prefix, "IRIS_vsn",
+	    "IRIS version, null terminated");
+    print_s(out, ic.hw_site_name, prefix, "hw_site_name",
+	    "Hardware name of site");
+    print_i(out, ic.local_wgmt, prefix, "local_wgmt",
+	    "Time zone of local standard time, minutes west of GMT");
+    print_s(out, ic.su_site_name, prefix, "su_site_name",
+	    "Name of site, from setup utility");
+    print_i(out, ic.rec_wgmt, prefix, "rec_wgmt",
+	    "Time zone of recorded standard time, minutes west of GMT");
+    print_u(out, ic.latitude, prefix, "latitude",
+	    "Latitude of radar (binary angle: 20000000 hex is 45_ North)");
+    print_u(out, ic.longitude, prefix, "longitude",
+	    "Longitude of radar (binary angle: 20000000 hex is 45_ East)");
+    print_i(out, ic.ground_elev, prefix, "ground_elev",
+	    "Height of ground at site (meters above sea level)");
+    print_i(out, ic.radar_ht, prefix, "radar_ht",
+	    "Height of radar above ground (meters)");
+    print_u(out, ic.resolution, prefix, "resolution",
+	    "Resolution specified in number of rays in a 360_ sweep");
+    print_u(out, ic.index_first_ray, prefix, "index_first_ray",
+	    "Index of first ray from above set of rays");
+    print_u(out, ic.num_rays, prefix, "num_rays",
+	    "Number of rays in a sweep");
+    print_i(out, ic.num_bytes_gparam, prefix, "num_bytes_gparam",
+	    "Number of bytes in each gparam");
+    print_i(out, ic.altitude, prefix, "altitude",
+	    "Altitude of radar (cm above sea level)");
+    print_i(out, ic.velocity[0], prefix, "velocity east",
+	    "Velocity of radar platform (cm/sec) east");
+    print_i(out, ic.velocity[1], prefix, "velocity north",
+	    "Velocity of radar platform (cm/sec) north");
+    print_i(out, ic.velocity[2], prefix, "velocity up",
+	    "Velocity of radar platform (cm/sec) up");
+    print_i(out, ic.offset_inu[0], prefix, "offset_inu starboard",
+	    "Antenna offset from INU (cm) starboard");
+    print_i(out, ic.offset_inu[1], prefix, "offset_inu bow",
+	    "Antenna offset from INU (cm) bow");
+    print_i(out, ic.offset_inu[2], prefix, "offset_inu up",
+	    "Antenna offset from INU (cm) up");
+    print_u(out, ic.fault, prefix, "fault",
+	    "Fault status at the time the task was started, bits:"
+	    " 0:Normal BITE 1:Critical BITE 2:Normal RCP 3:Critical RCP"
+	    " 4:Critical system 5:Product gen. 6:Output 7:Normal system ");
+    print_i(out, ic.melt_level, prefix, "melt_level",
+	    "Height of melting layer (meters above sea level) MSB is"
+	    " complemented, zero=Unknown");
+    print_s(out, ic.tz, prefix, "tz",
+	    "Local timezone string, null terminated");
+    print_x(out, ic.flags, prefix, "flags",
+	    "Flags, Bit 0=First ray not centered on zero degrees");
+    print_s(out, ic.config_name, prefix, "config_name",
+	    "Configuration name in the dpolapp.conf file, null terminated");
+}
+
+/*
+   get / print task_configuration.
+ */
+
+struct Sigmet_Task_Configuration get_task_configuration(char *rec, int swap)
+{
+    struct Sigmet_Task_Configuration tc;
+
+    tc.sh = get_structure_header(rec, swap);
+    rec += 12;
+    tc.tsi = get_task_sched_info(rec, swap);
+    rec += 120;
+    tc.tdi = get_task_dsp_info(rec, swap);
+    rec += 320;
+    tc.tci = get_task_calib_info(rec, swap);
+    rec += 320;
+    tc.tri = get_task_range_info(rec, swap);
+    rec += 160;
+    tc.tni = get_task_scan_info(rec, swap);
+    rec += 320;
+    tc.tmi = get_task_misc_info(rec, swap);
+    rec += 320;
+    tc.tei = get_task_end_info(rec, swap);
+    return tc;
+}
+
+void print_task_configuration(FILE *out, char *pfx,
+	struct Sigmet_Task_Configuration tc)
+{
+    char prefix[STR_LEN];
+
+    snprintf(prefix, STR_LEN, "%s%s", pfx, "<task_configuration>.");
+    print_structure_header(out, prefix, tc.sh);
+    print_task_sched_info(out, prefix, tc.tsi);
+    print_task_dsp_info(out, prefix, tc.tdi);
+    print_task_calib_info(out, prefix, tc.tci);
+    print_task_range_info(out, prefix, tc.tri);
+    print_task_scan_info(out, prefix, tc.tni);
+    print_task_misc_info(out, prefix, tc.tmi);
+    print_task_end_info(out, prefix, tc.tei);
+}
+
+/*
+   get / print task_sched_info.
+ */
+
+struct Sigmet_Task_Sched_Info get_task_sched_info(char *rec, int swap)
+{
+    struct Sigmet_Task_Sched_Info tsi;
+
+    tsi.start_time = get_sint32(rec + 0, swap);
+    tsi.stop_time = get_sint32(rec + 4, swap);
+    tsi.skip = get_sint32(rec + 8, swap);
+    tsi.time_last_run = get_sint32(rec + 12, swap);
+    tsi.time_used_last_run = get_sint32(rec + 16, swap);
+    tsi.rel_day_last_run = get_sint32(rec + 20, swap);
+    tsi.flag = get_uint16(rec + 24, swap);
+    return tsi;
+}
+
+void print_task_sched_info(FILE *out, char *pfx,
+	struct Sigmet_Task_Sched_Info tsi)
+{
+    char prefix[STR_LEN];
+
+    snprintf(prefix, STR_LEN, "%s%s", pfx, "<task_sched_info>.");
+    print_i(out, tsi.start_time, prefix, "start_time",
+	    "Start time (seconds within a day)");
+    print_i(out, tsi.stop_time, prefix, "stop_time",
+	    "Stop time (seconds within a day)");
+    print_i(out, tsi.skip, prefix, "skip",
+	    "Desired skip time (seconds)");
+    print_i(out, tsi.time_last_run, prefix, "time_last_run",
+	    "Time last run (seconds within a day)(0 for passive ingest)");
+    print_i(out, tsi.time_used_last_run, prefix, "time_used_last_run",
+	    "Time used on last run (seconds) (in file time to write out)");
+    print_i(out, tsi.rel_day_last_run, prefix, "rel_day_last_run",
+	    "Relative day of last run (zero for passive ingest)");
+    print_x(out, tsi.flag, prefix, "flag",
+	    "Flag: Bit 0 = ASAP Bit 1 = Mandatory Bit 2 = Late skip"
+	    " Bit 3 = Time used has been measured Bit 4 = Stop after running");
+}
+
+/*
+   get / print task_dsp_mode_batch.
+ */
+
+struct Sigmet_Task_DSP_Mode_Batch get_task_dsp_mode_batch(char *rec, int swap)
+{
+    struct Sigmet_Task_DSP_Mode_Batch tdmb;
+
+    tdmb.lo_prf = get_uint16(rec + 0, swap);
+    tdmb.lo_prf_frac = get_uint16(rec + 2, swap);
+    tdmb.lo_prf_sampl = get_sint16(rec + 4, swap);
+    tdmb.lo_prf_avg = get_sint16(rec + 6, swap);
+    tdmb.dz_unfold_thresh = get_sint16(rec + 8, swap);
+    tdmb.vr_unfold_thresh = get_sint16(rec + 10, swap);
+    tdmb.sw_unfold_thresh = get_sint16(rec + 12, swap);
+    return tdmb;
+}
+
+void print_task_dsp_mode_batch(FILE *out, char *pfx,
+	struct Sigmet_Task_DSP_Mode_Batch tdmb)
+{
+    char prefix[STR_LEN];
+
+    snprintf(prefix, STR_LEN, "%s%s", pfx, "<task_dsp_mode_batch>.");
+    print_u(out, tdmb.lo_prf, prefix, "lo_prf",
+	    "Low PRF in Hz");
+    print_u(out, tdmb.lo_prf_frac, prefix, "lo_prf_frac",
+	    "Low PRF fraction part, scaled by 2**16");
+    print_i(out, tdmb.lo_prf_sampl, prefix, "lo_prf_sampl",
+	    "Low PRF sample size");
+    print_i(out, tdmb.lo_prf_avg, prefix, "lo_prf_avg",
+	    "Low PRF range averaging in bins");
+    print_i(out, tdmb.dz_unfold_thresh, prefix, "dz_unfold_thresh",
+	    "Threshold for reflectivity unfolding in 1/100 of dB");
+    print_i(out, tdmb.vr_unfold_thresh, prefix, "vr_unfold_thresh",
+	    "Threshold for velocity unfolding in 1/100 of dB");
+    print_i(out, tdmb.sw_unfold_thresh, prefix, "sw_unfold_thresh",
+	    "Threshold for width unfolding in 1/100 of dB");
+}
+
+/*
+   get / print task_dsp_info.
+ */
+
+struct Sigmet_Task_DSP_Info get_task_dsp_info(char *rec, int swap)
+{
+    struct Sigmet_Task_DSP_Info tdi;
+
+    tdi.major_mode = get_uint16(rec + 0, swap);
+    tdi.dsp_type = get_uint16(rec + 2, swap);
+    tdi.curr_data_mask = get_dsp_data_mask(rec + 4, swap);
+    tdi.orig_data_mask = get_dsp_data_mask(rec + 28, swap);
+    tdi.mb = get_task_dsp_mode_batch(rec + 52, swap);
+    tdi.prf = get_sint32(rec + 136, swap);
+    tdi.pulse_w = get_sint32(rec + 140, swap);
+    tdi.m_prf_mode = (enum Sigmet_Multi_PRF)get_uint16(rec + 144, swap);
+    tdi.dual_prf = get_sint16(rec + 146, swap);
+    tdi.agc_feebk = get_uint16(rec + 148, swap);
+    tdi.sampl_sz = get_sint16(rec + 150, swap);
+    tdi.gain_flag = get_uint16(rec + 152, swap);
+    memcpy(tdi.clutter_file, rec + 154, 12);
+    trimRight(tdi.clutter_file, 12);
+    tdi.lin_filter_num = *(unsigned char *)(rec + 166);
+    tdi.log_filter_num = *(unsigned char *)(rec + 167);
+    tdi.attenuation = get_sint16(rec + 168, swap);
+    tdi.gas_attenuation = get_uint16(rec + 170, swap);
+    tdi.clutter_flag = get_uint16(rec + 172, swap);
+    tdi.xmt_phase = get_uint16(rec + 174, swap);
+    tdi.ray_hdr_mask = get_uint32(rec + 176, swap);
+    tdi.time_series_flag = get_uint16(rec + 180, swap);
+    memcpy(tdi.custom_ray_hdr, rec + 184, 16);
+    trimRight(tdi.custom_ray_hdr, 16);
+    return tdi;
+}
+
+void print_task_dsp_info(FILE *out, char *pfx,
+	struct Sigmet_Task_DSP_Info tdi)
+{
+    char prefix[STR_LEN];
+
+    snprintf(prefix, STR_LEN, "%s%s", pfx, "<task_dsp_info>.");
+    print_u(out, tdi.major_mode, prefix, "major_mode",
+	    "Major mode");
+    print_u(out, tdi.dsp_type, prefix, "dsp_type",
+	    "DSP type");
+    print_dsp_data_mask(out, prefix, tdi.curr_data_mask,
+	    "Current Data type mask");
+    print_dsp_data_mask(out, prefix, tdi.orig_data_mask,
+	    "Original Data type mask");
+    print_task_dsp_mode_batch(out, prefix, tdi.mb);
+    print_i(out, tdi.prf, prefix, "prf",
+	    "PRF in Hertz");
+    print_i(out, tdi.pulse_w, prefix, "pulse_w",
+	    "Pulse width in 1/100 of microseconds");
+    print_i(out, tdi.m_prf_mode, prefix, "m_prf_mode",
+	    "Multi PRF mode flag: 0=1:1, 1=2:3, 2=3:4, 3=4:5");
+    print_i(out, tdi.dual_prf, prefix, "dual_prf",
+	    "Dual PRF delay");
+    print_u(out, tdi.agc_feebk, prefix, "agc_feebk",
+	    "AGC feedback code");
+    print_i(out, tdi.sampl_sz, prefix, "sampl_sz",
+	    "Sample size");
+    print_u(out, tdi.gain_flag, prefix, "gain_flag",
+	    "Gain Control flag (0=fixed, 1=STC, 2=AGC)");
+    print_s(out, tdi.clutter_file, prefix, "clutter_file",
+	    "Name of file used for clutter filter");
+    print_u(out, tdi.lin_filter_num, prefix, "lin_filter_num",
+	    "Linear based filter number for first bin");
+    print_u(out, tdi.log_filter_num, prefix, "log_filter_num",
+	    "Log based filter number for first bin");
+    print_i(out, tdi.attenuation, prefix, "attenuation",
+	    "Attenuation in 1/10 dB applied in fixed gain mode");
+    print_u(out, tdi.gas_attenuation, prefix, "gas_attenuation",
+	    "Gas attenuation in 1/100000 dB/km for first 10000, then"
+	    " stepping in 1/10000 dB/km");
+    print_u(out, tdi.clutter_flag, prefix, "clutter_flag",
+	    "Flag nonzero means cluttermap used");
+    print_u(out, tdi.xmt_phase, prefix, "xmt_phase",
+	    "XMT phase sequence: 0:Fixed, 1:Random, 3:SZ8/64");
+    print_x(out, tdi.ray_hdr_mask, prefix, "ray_hdr_mask",
+	    "Mask used for to configure the ray header.");
+    print_u(out, tdi.time_series_flag, prefix, "time_series_flag",
+	    "Time series playback flags, see OPTS_* in dsp.h");
+    print_s(out, tdi.custom_ray_hdr, prefix, "custom_ray_hdr",
+	    "Name of custom ray header");
+}
+
+/*
+   get / print task_calib_info.
+ */
+
+struct Sigmet_Task_Calib_Info get_task_calib_info(char *rec, int swap)
+{
+    struct Sigmet_Task_Calib_Info tci;
+
+    tci.dbz_slope = get_sint16(rec + 0, swap);
+    tci.dbz_noise_thresh = get_sint16(rec + 2, swap);
+    tci.clutter_corr_thesh = get_sint16(rec + 4, swap);
+    tci.sqi_thresh = get_sint16(rec + 6, swap);
+    tci.pwr_thresh = get_sint16(rec + 8, swap);
+    tci.cal_dbz = get_sint16(rec + 18, swap);
+    tci.dbt_flags = get_uint16(rec + 20, swap);
+    tci.dbz_flags = get_uint16(rec + 22, swap);
+    tci.vel_flags = get_uint16(rec + 24, swap);
+    tci.sw_flags = get_uint16(rec + 26, swap);
+    tci.zdr_flags = get_uint16(rec + 28, swap);
+    tci.flags = get_uint16(rec + 36, swap);
+    tci.ldr_bias = get_sint16(rec + 40, swap);
+    tci.zdr_bias = get_sint16(rec + 42, swap);
+    tci.nx_clutter_thresh = get_sint16(rec + 44, swap);
+    tci.nx_clutter_skip = get_uint16(rec + 46, swap);
+    tci.hpol_io_cal = get_sint16(rec + 48, swap);
+    tci.vpol_io_cal = get_sint16(rec + 50, swap);
+    tci.hpol_noise = get_sint16(rec + 52, swap);
+    tci.vpol_noise = get_sint16(rec + 54, swap);
+    tci.hpol_radar_const = get_sint16(rec + 56, swap);
+    tci.vpol_radar_const = get_sint16(rec + 58, swap);
+    tci.bandwidth = get_uint16(rec + 60, swap);
+    tci.flags2 = get_uint16(rec + 62, swap);
+    return tci;
+}
+
+void print_task_calib_info(FILE *out, char *pfx,
+	struct Sigmet_Task_Calib_Info tci)
+{
+    char prefix[STR_LEN];
+    char *desc;
+
+    snprintf(prefix, STR_LEN, "%s%s", pfx, "<task_calib_info>.");
+    print_i(out, tci.dbz_slope, prefix, "dbz_slope",
+	    "Reflectivity slope (4096*dB/ A/D count)");
+    print_i(out, tci.dbz_noise_thresh, prefix, "dbz_noise_thresh",
+	    "Reflectivity noise threshold (1/16 dB above Noise)");
+    print_i(out, tci.clutter_corr_thesh, prefix, "clutter_corr_thesh",
+	    "Clutter Correction threshold (1/16 dB)");
+    print_i(out, tci.sqi_thresh, prefix, "sqi_thresh",
+	    "SQI threshold (01)*256");
+    print_i(out, tci.pwr_thresh, prefix, "pwr_thresh",
+	    "Power threshold (1/16 dBZ)");
+    print_i(out, tci.cal_dbz, prefix, "cal_dbz",
+	    "Calibration Reflectivity (1/16 dBZ at 1 km)");
+    print_u(out, tci.dbt_flags, prefix, "dbt_flags",
+	    "Threshold flags for uncorrected reflectivity");
+    print_u(out, tci.dbz_flags, prefix, "dbz_flags",
+	    "Threshold flags for corrected reflectivity");
+    print_u(out, tci.vel_flags, prefix, "vel_flags",
+	    "Threshold flags for velocity");
+    print_u(out, tci.sw_flags, prefix, "sw_flags",
+	    "Threshold flags for width");
+    print_u(out, tci.zdr_flags, prefix, "zdr_flags",
+	    "Threshold flags for ZDR");
+    desc = "Flags. Bits: 0: Speckle remover for log channel 3: Speckle"
+	" remover for linear channel 4:  data is range normalized 5:  pulse"
+	" at beginning of ray 6:  pulse at end of ray 7: Vary number of"
+	" pulses in dual PRF 8: Use 3 lag processing in PP02 9: Apply vel"
+	" correction for ship motion 10: Vc is unfolded 11: Vc has fallspeed"
+	" correction 12: Zc has beam blockage correction 13: Zc has Z-based"
+	" attenuation correction 14: Zc has target detection 15: Vc has storm"
+	" relative vel correction";
+    print_u(out, tci.flags, prefix, "flags", desc);
+    print_i(out, tci.ldr_bias, prefix, "ldr_bias",
+	    "LDR bias in signed 1/100 dB");
+    print_i(out, tci.zdr_bias, prefix, "zdr_bias",
+	    "ZDR bias in signed 1/16 dB");
+    print_i(out, tci.nx_clutter_thresh, prefix, "nx_clutter_thresh",
+	    "NEXRAD point clutter threshold in 1/100 of dB");
+    print_u(out, tci.nx_clutter_skip, prefix, "nx_clutter_skip",
+	    "NEXRAD point clutter bin skip in low 4 bits");
+    print_i(out, tci.hpol_io_cal, prefix, "hpol_io_cal",
+	    "I0 cal value, horizontal pol, in 1/100 dBm");
+    print_i(out, tci.vpol_io_cal, prefix, "vpol_io_cal",
+	    "I0 cal value, vertical pol, in 1/100 dBm");
+    print_i(out, tci.hpol_noise, prefix, "hpol_noise",
+	    "Noise at calibration, horizontal pol, in 1/100 dBm");
+    print_i(out, tci.vpol_noise, prefix, "vpol_noise",
+	    "Noise at calibration, vertical pol, in 1/100 dBm");
+    print_i(out, tci.hpol_radar_const, prefix, "hpol_radar_const",
+	    "Radar constant, horizontal pol, in 1/100 dB");
+    print_i(out, tci.vpol_radar_const, prefix, "vpol_radar_const",
+	    "Radar constant, vertical pol, in 1/100 dB");
+    print_u(out, tci.bandwidth, prefix, "bandwidth",
+	    "Receiver bandwidth in kHz");
+    print_x(out, tci.flags2, prefix, "flags2",
+	    "Flags2: Bit 0: Zc and ZDRc has DP attenuation correction"
+	    " Bit 1: Z and ZDR has DP attenuation correction");
+}
+
+/*
+   get / print task_range_info.
+ */
+
+struct Sigmet_Task_Range_Info get_task_range_info(char *rec, int swap)
+{
+    struct Sigmet_Task_Range_Info tri;
+
+    tri.rng_1st_bin = get_sint32(rec + 0, swap);
+    tri.rng_last_bin = get_sint32(rec + 4, swap);
+    tri.num_bins_in = get_sint16(rec + 8, swap);
+    tri.num_bins_out = get_sint16(rec + 10, swap);
+    tri.step_in = get_sint32(rec + 12, swap);
+    tri.step_out = get_sint32(rec + 16, swap);
+    tri.flag = get_uint16(rec + 20, swap);
+    tri.rng_avg_flag = get_sint16(rec + 22, swap);
+    return tri;
+}
+
+void print_task_range_info(FILE *out, char *pfx,
+	struct Sigmet_Task_Range_Info tri)
+{
+    char prefix[STR_LEN];
+
+    snprintf(prefix, STR_LEN, "%s%s", pfx, "<task_range_info>.");
+    print_i(out, tri.rng_1st_bin, prefix, "rng_1st_bin",
+	    "Range of first bin in centimeters");
+    print_i(out, tri.rng_last_bin, prefix, "rng_last_bin",
+	    "Range of last bin in centimeters");
+    print_i(out, tri.num_bins_in, prefix, "num_bins_in",
+	    "Number of input bins");
+    print_i(out, tri.num_bins_out, prefix, "num_bins_out",
+	    "Number of output range bins");
+    print_i(out, tri.step_in, prefix, "step_in",
+	    "Step between input bins");
+    print_i(out, tri.step_out, prefix, "step_out",
+	    "Step between output bins (in centimeters)");
+    print_u(out, tri.flag, prefix, "flag",
+	    "Flag for variable range bin spacing (1=var, 0=fixed)");
+    print_i(out, tri.rng_avg_flag, prefix, "rng_avg_flag",
+	    "Range bin averaging flag");
+}
+
+/*
+   get / print task_scan_info.
+ */
+
+struct Sigmet_Task_Scan_Info get_task_scan_info(char *rec, int swap)
+{
+    struct Sigmet_Task_Scan_Info tsi;
+
+    tsi.scan_mode = get_uint16(rec + 0, swap);
+    tsi.resoln = get_sint16(rec + 2, swap);
+    tsi.num_sweeps = get_sint16(rec + 6, swap);
+    switch (tsi.scan_mode) {
+	case RHI:
+	    tsi.scan_info.rhi_info = get_task_rhi_scan_info(rec + 8, swap);
+	    break;
+	case PPI_S:
+	case PPI_C:
+	    tsi.scan_info.ppi_info = get_task_ppi_scan_info(rec + 8, swap);
+	    break;
+	case FILE_SCAN:
+	    tsi.scan_info.file_info = get_task_file_scan_info(rec + 8, swap);
+	    break;
+	case MAN_SCAN:
+	    tsi.scan_info.man_info = get_task_manual_scan_info(rec + 8, swap);
+	    break;
+    }
+    return tsi;
+}
+
+void print_task_scan_info(FILE *out, char *pfx,
+	struct Sigmet_Task_Scan_Info tsi)
+{
+    char prefix[STR_LEN];
+
+    snprintf(prefix, STR_LEN, "%s%s", pfx, "<task_scan_info>.");
+    print_u(out, tsi.scan_mode, prefix, "scan_mode",
+	    "Antenna scan mode 1:PPI sector, 2:RHI, 3:Manual,"
+	    " 4:PPI cont, 5:file");
+    print_i(out, tsi.resoln, prefix, "resoln",
+	    "Desired angular resolution in 1/1000 of degrees");
+    print_i(out, tsi.num_sweeps, prefix, "num_sweeps",
+	    "Number of sweeps to perform");
+    switch (tsi.scan_mode) {
+	case RHI:
+	    print_task_rhi_scan_info(out, prefix, tsi.scan_info.rhi_info);
+	    break;
+	case PPI_S:
+	case PPI_C:
+	    print_task_ppi_scan_info(out, prefix, tsi.scan_info.ppi_info);
+	    break;
+	case FILE_SCAN:
+	    print_task_file_scan_info(out, prefix, tsi.scan_info.file_info);
+	    break;
+	case MAN_SCAN:
+	    print_task_manual_scan_info(out, prefix, tsi.scan_info.man_info);
+	    break;
+    }
+}
+
+/*
+   get / print task_rhi_scan_info.
+ */
+
+struct Sigmet_Task_RHI_Scan_Info get_task_rhi_scan_info(char *rec, int swap)
+{
+    struct Sigmet_Task_RHI_Scan_Info trsi;
+    char *p, *p1;
+    unsigned *q;
+
+    trsi.lo_elev = get_uint16(rec + 0, swap);
+    trsi.hi_elev = get_uint16(rec + 2, swap);
+    q = trsi.az;
+    p = rec + 4;
+    p1 = p + sizeof(U16BIT) * 40;
+    for ( ; p < p1; p += sizeof(U16BIT), q++) {
+	*q = get_uint16(p, swap);
+    }
+    trsi.start = *(unsigned char *)(rec + 199);
+    return trsi;
+}
+
+void print_task_rhi_scan_info(FILE *out, char *pfx,
+	struct Sigmet_Task_RHI_Scan_Info trsi)
+{
+    int n;
+    char prefix[STR_LEN];
+
+    snprintf(prefix, STR_LEN, "%s%s", pfx, "<rhi_scan_info>.");
+    print_u(out, trsi.lo_elev, prefix, "lo_elev",
+	    "Lower elevation limit (binary angle, only for sector)");
+    print_u(out, trsi.hi_elev, prefix, "hi_elev",
+	    "Upper elevation limit (binary angle, only for sector)");
+    for (n = 0; n < 40; n++) {
+	fprintf(out, "%u" FS "%s%s%d%s" FS "%s\n", trsi.az[n], prefix,
+		"az[", n, "]", "List of azimuths (binary angles) to scan at");
+    }
+    print_u(out, trsi.start, prefix, "start",
+	    "Start of first sector sweep: 0=Nearest, 1=Lower,"
+	    " 2=Upper Sector sweeps alternate in direction.");
+}
+
+/*
+   get / print task_ppi_scan_info.
+ */
+
+struct Sigmet_Task_PPI_Scan_Info get_task_ppi_scan_info(char *rec, int swap)
+{
+    struct Sigmet_Task_PPI_Scan_Info tpsi;
+    char *p, *p1;
+    unsigned *q;
+
+    tpsi.left_az = get_uint16(rec + 0, swap);
+    tpsi.right_az = get_uint16(rec + 2, swap);
+    q = tpsi.elevs;
+    p = rec + 4;
+    p1 = p + sizeof(U16BIT) * 40;
+    for ( ; p < p1; p += sizeof(U16BIT), q++) {
+	*q = get_uint16(p, swap);
+    }
+    tpsi.start = *(unsigned char *)(rec + 199);
+    return tpsi;
+}
+
+void print_task_ppi_scan_info(FILE *out, char *pfx,
+	struct Sigmet_Task_PPI_Scan_Info tpsi)
+{
+    int n;
+    char prefix[STR_LEN];
+    char struct_path[STR_LEN];
+
+    snprintf(prefix, STR_LEN, "%s%s", pfx, "<task_ppi_scan_info>.");
+    print_u(out, tpsi.left_az, prefix, "left_az",
+	    "Left azimuth limit (binary angle, only for sector)");
+    print_u(out, tpsi.right_az, prefix, "right_az",
+	    "Right azimuth limit (binary angle, only for sector)");
+    for (n = 0; n < 40; n++) {
+	snprintf(struct_path, STR_LEN, "%s%s%d%s", prefix, "elevs[", n,
+		"]");
+	fprintf(out, "%u" FS "%s" FS "%s\n", tpsi.elevs[n], struct_path,
+		"List of elevations (binary angles) to scan at");
+    }
+    print_u(out, tpsi.start, prefix, "start",
+	    "Start of first sector sweep: 0=Nearest, 1=Left, 2=Right Sector"
+	    " sweeps alternate in direction.");
+}
+
+/*
+   get / print task_file_scan_info.
+ */
+
+struct Sigmet_Task_File_Scan_Info get_task_file_scan_info(char *rec, int swap)
+{
+    struct Sigmet_Task_File_Scan_Info tfsi;
+
+    tfsi.az0 = get_uint16(rec + 0, swap);
+    tfsi.elev0 = get_uint16(rec + 2, swap);
+    memcpy(tfsi.ant_ctrl, rec + 4, 12);
+    trimRight(tfsi.ant_ctrl, 12);
+    return tfsi;
+}
+
+void print_task_file_scan_info(FILE *out, char *pfx,
+	struct Sigmet_Task_File_Scan_Info tfsi)
+{
+    char prefix[STR_LEN];
+
+    snprintf(prefix, STR_LEN, "%s%s", pfx, "<task_file_scan_info>.");
+    print_u(out, tfsi.az0, prefix, "az0",
+	    "First azimuth angle (binary angle)");
+    print_u(out, tfsi.elev0, prefix, "elev0",
+	    "First elevation angle (binary angle)");
+    print_s(out, tfsi.ant_ctrl, prefix, "ant_ctrl",
+	    "Filename for antenna control");
+}
+
+/*
+   get / print task_manual_scan_info.
+ */
+
+struct Sigmet_Task_Manual_Scan_Info get_task_manual_scan_info(char *rec, int swap)
+{
+    struct Sigmet_Task_Manual_Scan_Info tmsi;
+
+    tmsi.flags = get_uint16(rec + 0, swap);
+    return tmsi;
+}
+
+void print_task_manual_scan_info(FILE *out, char *pfx,
+	struct Sigmet_Task_Manual_Scan_Info tmsi)
+{
+    char prefix[STR_LEN];
+
+    snprintf(prefix, STR_LEN, "%s%s", pfx, "<task_manual_scan_info>.");
+    print_x(out, tmsi.flags, prefix, "flags",
+	    "Flags: bit 0=Continuous recording");
+}
+
+/*
+   get / print task_misc_info.
+ */
+
+struct Sigmet_Task_Misc_Info get_task_misc_info(char *rec, int swap)
+{
+    struct Sigmet_Task_Misc_Info tmi;
+    char *p, *p1;
+    unsigned *q;
+
+    tmi.wave_len = get_sint32(rec + 0, swap);
+    memcpy(tmi.tr_ser, rec + 4, 16);
+    trimRight(tmi.tr_ser, 16);
+    tmi.power = get_sint32(rec + 20, swap);
+    tmi.flags = get_uint16(rec + 24, swap);
+    tmi.polarization = get_uint16(rec + 26, swap);
+    tmi.trunc_ht = get_sint32(rec + 28, swap);
+    tmi.comment_sz = get_sint16(rec + 62, swap);
+    tmi.horiz_beam_width = get_uint32(rec + 64, swap);
+    tmi.vert_beam_width = get_uint32(rec + 68, swap);
+    q = tmi.custom;
+    p = rec + 72;
+    p1 = p + sizeof(*tmi.custom) * 10;
+    for ( ; p < p1; p += sizeof(*tmi.custom), q++) {
+	*q = get_uint32(p, swap);
+    }
+    return tmi;
+}
+
+void print_task_misc_info(FILE *out, char *pfx,
+	struct Sigmet_Task_Misc_Info tmi)
+{
+    int n;
+    char prefix[STR_LEN];
+    char struct_path[STR_LEN];
+
+    snprintf(prefix, STR_LEN, "%s%s", pfx, "<task_misc_info>.");
+    print_i(out, tmi.wave_len, prefix, "wave_len",
+	    "Wavelength in 1/100 of cm");
+    print_s(out, tmi.tr_ser, prefix, "tr_ser",
+	    "T/R Serial Number");
+    print_i(out, tmi.power, prefix, "power",
+	    "Transmit Power in watts");
+    print_x(out, tmi.flags, prefix, "flags",
+	    "Flags: Bit 0: Digital signal simulator in use"
+	    " Bit 1: Polarization in use Bit 4: Keep bit");
+    print_u(out, tmi.polarization, prefix, "polarization",
+	    "Type of polarization");
+    print_i(out, tmi.trunc_ht, prefix, "trunc_ht",
+	    "Truncation height (centimeters above the radar)");
+    print_i(out, tmi.comment_sz, prefix, "comment_sz",
+	    "Number of bytes of comments entered");
+    print_u(out, tmi.horiz_beam_width, prefix, "horiz_beam_width",
+	    "Horizontal beamwidth (binary angle, starting in 7.18)");
+    print_u(out, tmi.vert_beam_width, prefix, "vert_beam_width",
+	    "Vertical beamwidth (binary angle, starting in 7.18)");
+    for (n = 0; n < 10; n++) {
+	snprintf(struct_path, STR_LEN, "%s%s%d%s", prefix, "custom[", n, "]");
+	fprintf(out, "%u" FS "%s" FS "%s\n", tmi.custom[n], struct_path,
+		"Customer defined storage (starting in 7.27)");
+    }
+}
+
+struct Sigmet_Task_End_Info get_task_end_info(char *rec, int swap)
+{
+    struct Sigmet_Task_End_Info tei;
+
+    tei.task_major = get_sint16(rec + 0, swap);
+    tei.task_minor = get_sint16(rec + 2, swap);
+    memcpy(tei.task_config, rec + 4, 12);
+    trimRight(tei.task_config, 12);
+    memcpy(tei.task_descr, rec + 16, 80);
+    trimRight(tei.task_descr, 80);
+    tei.hybrid_ntasks = get_sint32(rec + 96, swap);
+    tei.task_state = get_uint16(rec + 100, swap);
+    tei.data_time = get_ymds_time(rec + 104, swap);
+    return tei;
+}
+
+void print_task_end_info(FILE *out, char *pfx,
+	struct Sigmet_Task_End_Info tei)
+{
+    char prefix[STR_LEN];
+
+    snprintf(prefix, STR_LEN, "%s%s", pfx, "<task_end_info>.");
+    print_i(out, tei.task_major, prefix, "task_major",
+	    "Task major number");
+    print_i(out, tei.task_minor, prefix, "task_minor",
+	    "Task minor number");
+    print_s(out, tei.task_config, prefix, "task_config",
+	    "Name of task configuration file");
+    print_s(out, tei.task_descr, prefix, "task_descr",
+	    "Task description");
+    print_i(out, tei.hybrid_ntasks, prefix, "hybrid_ntasks",
+	    "Number of tasks in hybrid task");
+    print_u(out, tei.task_state, prefix, "task_state",
+	    "Task state: 0=no task; 1=task being modified; 2=inactive;"
+	    " 3=scheduled, 4=running.");
+    print_ymds_time(out, tei.data_time, prefix, "data_time",
+	    "Data time of task (TZ flexible)");
+}
+
+/*
+   get / print dsp_data_mask.
+ */
+
+struct Sigmet_DSP_Data_Mask get_dsp_data_mask(char *rec, int swap)
+{
+    struct Sigmet_DSP_Data_Mask ddm;
+
+    ddm.mask_word_0 = get_uint32(rec + 0, swap);
+    ddm.ext_hdr_type = get_uint32(rec + 4, swap);
+    ddm.mask_word_1 = get_uint32(rec + 8, swap);
+    ddm.mask_word_2 = get_uint32(rec + 12, swap);
+    ddm.mask_word_3 = get_uint32(rec + 16, swap);
+    ddm.mask_word_4 = get_uint32(rec + 20, swap);
+    return ddm;
+}
+
+void print_dsp_data_mask(FILE *out, char *pfx, struct Sigmet_DSP_Data_Mask ddm,
+	char *suffix)
+{
+    char prefix[STR_LEN];
+    char struct_path[STR_LEN];
+
+    snprintf(prefix, STR_LEN, "%s%s", pfx, "<dsp_data_mask>.");
+    snprintf(struct_path, STR_LEN, "%s%s",
+	    prefix, "mask_word_0");
+    fprintf(out, "%#X" FS "%s" FS "%s.  %s\n",
+	    ddm.mask_word_0, struct_path, "Mask word 0", suffix);
+    snprintf(struct_path, STR_LEN, "%s%s",
+	    prefix, "ext_hdr_type");
+    fprintf(out, "%u" FS "%s" FS "%s.  %s\n",
+	    ddm.ext_hdr_type, struct_path, "Extended header type", suffix);
+    snprintf(struct_path, STR_LEN, "%s%s",
+	    prefix, "mask_word_1");
+    fprintf(out, "%#X" FS "%s" FS "%s.  %s\n", ddm.mask_word_1, struct_path,
+	    "Mask word 1 Contains bits set for all data recorded.", suffix);
+    snprintf(struct_path, STR_LEN, "%s%s",
+	    prefix, "mask_word_2");
+    fprintf(out, "%#X" FS "%s" FS "%s.  %s\n", ddm.mask_word_2, struct_path,
+	    "Mask word 2 See parameter DB_* in Table 36 for", suffix);
+    snprintf(struct_path, STR_LEN, "%s%s", prefix,
+	    "mask_word_3");
+    fprintf(out, "%#X" FS "%s" FS "%s.  %s\n", ddm.mask_word_3, struct_path,
+	    "Mask word 3 bit specification.", suffix);
+    snprintf(struct_path, STR_LEN, "%s%s", prefix, "mask_word_4");
+    fprintf(out, "%#X" FS "%s" FS "%s.  %s\n", ddm.mask_word_4, struct_path,
+	    "Mask word 4", suffix);
+}
+
+/*
+   get / print structure_header.
+ */
+
+struct Sigmet_Structure_Header get_structure_header(char *rec, int swap)
+{
+    struct Sigmet_Structure_Header sh;
+
+    sh.id = get_sint16(rec + 0, swap);
+    sh.format = get_sint16(rec + 2, swap);
+    sh.sz = get_sint32(rec + 4, swap);
+    sh.flags = get_sint16(rec + 10, swap);
+    return sh;
+}
+
+void print_structure_header(FILE *out, char *prefix,
+	struct Sigmet_Structure_Header sh)
+{
+    print_i(out, sh.id, prefix, "<structure_header>.id",
+	    "Structure identifier: 22 => Task_configuration."
+	    " 23 => Ingest_header. 24 => Ingest_data_header."
+	    " 25 => Tape_inventory. 26 => Product_configuration."
+	    " 27 => Product_hdr. 28 => Tape_header_record");
+    print_i(out, sh.format, prefix, "<structure_header>.format",
+	    "Format version number (see headers.h)");
+    print_i(out, sh.sz, prefix, "<structure_header>.sz",
+	    "Number of bytes in the entire structure");
+    print_x(out, (unsigned)sh.flags, prefix, "<structure_header>.flags",
+	    "Flags: bit0=structure complete");
+}
+
+/*
+   get / print ymds_time.
+ */
+
+struct Sigmet_YMDS_Time get_ymds_time(char *b, int swap)
+{
+    unsigned msec;
+    struct Sigmet_YMDS_Time tm;
+
+    tm.sec = get_sint32(b, swap);
+    msec = get_uint16(b + 4, swap);
+    tm.msec = (msec & 0x3ff);
+    tm.utc = (msec & 0x800);
+    tm.year = get_sint16(b + 6, swap);
+    tm.month = get_sint16(b + 8, swap);
+    tm.day = get_sint16(b + 10, swap);
+    return tm;
+}
+
+void print_ymds_time(FILE *out, struct Sigmet_YMDS_Time tm, char *prefix,
+	char *mmb, char *desc)
+{
+    double fhour, fmin;
+    double ihour, imin;
+    double sec;
+    char struct_path[STR_LEN];
+
+    sec = tm.sec + 0.001 * tm.msec;
+    fhour = modf(sec / 3600.0, &ihour);
+    fmin = modf(fhour * 60.0, &imin);
+    snprintf(struct_path, STR_LEN, "%s%s", prefix, mmb);
+    fprintf(out, "%04d/%02d/%02d %02d:%02d:%05.2f" FS "%s" FS "%s\n",
+	    tm.year, tm.month, tm.day,
+	    (int)ihour, (int)imin, fmin * 60.0,
+	    struct_path, desc);
+}
+
+/*
+   Print unsigned integer u (a struct value), prefix (a struct hierarchy),
+   mmb (the struct member with value u), and desc (descriptor) to stream out.
+ */
+
+void print_u(FILE *out, unsigned u, char *prefix, char *mmb, char *desc)
+{
+    char struct_path[STR_LEN];
+
+    snprintf(struct_path, STR_LEN, "%s%s", prefix, mmb);
+    fprintf(out, "%u" FS "%s" FS "%s\n", u, struct_path, desc);
+}
+
+/*
+   Print unsigned integer u (a struct value) in hex format, prefix (a struct
+   hierarchy), mmb (the struct member with value u), and desc (descriptor) to
+   stream out.
+ */
+
+void print_x(FILE *out, unsigned u, char *prefix, char *mmb, char *desc)
+{
+    char struct_path[STR_LEN];
+
+    snprintf(struct_path, STR_LEN, "%s%s", prefix, mmb);
+    fprintf(out, "%#X" FS "%s" FS "%s\n", u, struct_path, desc);
+}
+
+/*
+   Print integer i (a struct value), prefix (a struct hierarchy),
+   mmb (the struct member with value i), and desc (descriptor) to stream out.
+ */
+
+void print_i(FILE *out, int i, char *prefix, char *mmb, char *desc)
+{
+    char struct_path[STR_LEN];
+
+    snprintf(struct_path, STR_LEN, "%s%s", prefix, mmb);
+    fprintf(out, "%d" FS "%s" FS "%s\n", i, struct_path, desc);
+}
+
+/*
+   Print string s (a struct value), prefix (a struct hierarchy),
+   mmb (the struct member with value s), and desc (descriptor) to stream out.
+ */
+
+void print_s(FILE *out, char *s, char *prefix, char *mmb, char *desc)
+{
+    char struct_path[STR_LEN];
+
+    snprintf(struct_path, STR_LEN, "%s%s", prefix, mmb);
+    fprintf(out, "%s" FS "%s" FS "%s\n", s, struct_path, desc);
+}
+
+/*
+   Trim spaces off the end of a character array
+   Returns the input string with a nul character at the start of any
+   trailing spaces and at end of string. The input string is modified.
+ */
+
+static char *trimRight(char *s, int n)
+{
+    char *c, *e, *end;
+
+    for (c = e = s, end = s + n; c < end; c++) {
+	if ( !isspace((int)*c) ) {
+	    e = c;
+	}
+    }
+    if (e + 1 != end) {
+	*(e + 1) = '\0';
+    }
+    *(end - 1) = '\0';
+    return s;
+}
+
+/*
+   Retrieve a 16 bit signed integer from an address. These functions copy
+   the value out of the buffer before swapping it, so the buffer, which
+   might be a read only memory map, is not modified.
+ */
+
+static int get_sint16(void *b, int swap) {
+    I16BIT s;
+
+    memcpy(&s, b, sizeof(s));
+    if ( swap ) {
+	Swap_16Bit(&s);
+    }
+    return s;
+}
+
+/*
+   Retrieve a 16 bit unsigned integer from an address
  */
 
-struct Sigmet_Product_Specific_Info get_product_specific_info(char *rec)
-{
-    struct Sigmet_Product_Specific_Info psi;
+static unsigned get_uint16(void *b, int swap) {
+    U16BIT s;
 
-    psi.data_type_mask = get_uint32(rec + 0);
-    psi.rng_last_bin = get_sint32(rec + 4);
-    psi.format_conv_flag = get_uint32(rec + 8);
-    psi.flag = get_uint32(rec + 12);
-    psi.sweep_num = get_sint32(rec + 16);
-    psi.xhdr_type = get_uint32(rec + 20);
-    psi.data_type_mask1 = get_uint32(rec + 24);
-    psi.data_type_mask2 = get_uint32(rec + 28);
-    psi.data_type_mask3 = get_uint32(rec + 32);
-    psi.data_type_mask4 = get_uint32(rec + 36);
-    psi.playback_vsn = get_uint32(rec + 40);
-    return psi;
+    memcpy(&s, b, sizeof(s));
+    if ( swap ) {
+	Swap_16Bit(&s);
+    }
+    return s;
 }
 
-void print_product_specific_info(FILE *out, char *pfx,
-	struct Sigmet_Product_Specific_Info psi)
-{
-    char prefix[STR_LEN];
+/*
+   Retrieve a 32 bit signed integer from an address
+ */
 
-    snprintf(prefix, STR_LEN, "%s%s", pfx, "<product_specific_info>.");
-    print_x(out, psi.data_type_mask, prefix, "data_type_mask",
-	    "Data type mask word 0");
-    print_i(out, psi.rng_last_bin, prefix, "rng_last_bin",
-	    "Range of last bin in cm");
-    print_u(out, psi.format_conv_flag, prefix, "format_conv_flag",
-	    "Format conversion flag: 0=Preserve all ingest data"
-	    " 1=Convert 8-bit data to 16-bit data"
-	    " 2=Convert 16-bit data to 8-bit data");
-    print_x(out, psi.flag, prefix, "flag",
-	    "Flag word: Bit 0=Separate product files by sweep Bit 1=Mask data"
-	    " by supplied mask");
-    print_i(out, psi.sweep_num, prefix, "sweep_num",
-	    "Sweep number if separate files, origin 1");
-    print_u(out, psi.xhdr_type, prefix, "xhdr_type",
-	    "Xhdr type (unused)");
-    print_x(out, psi.data_type_mask1, prefix, "data_type_mask1",
-	    "Data type mask 1");
-    print_x(out, psi.data_type_mask2, prefix, "data_type_mask2",
-	    "Data type mask 2");
-    print_x(out, psi.data_type_mask3, prefix, "data_type_mask3",
-	    "Data type mask 3");
-    print_x(out, psi.data_type_mask4, prefix, "data_type_mask4",
-	    "Data type mask 4");
-    print_u(out, psi.playback_vsn, prefix, "playback_vsn",
-	    "Playback version (low 16-bits)");
+static int get_sint32(void *b, int swap) {
+    I32BIT s;
+
+    memcpy(&s, b, sizeof(s));
+    if ( swap ) {
+	Swap_32Bit(&s);
+    }
+    return s;
 }
 
 /*
-   get / print color_scale_def.
+   Retrieve a 32 bit unsigned integer from an address
+ */
+
+static unsigned get_uint32(void *b, int swap) {
+    U32BIT s;
+
+    memcpy(&s, b, sizeof(s));
+    if ( swap ) {
+	Swap_32Bit(&s);
+    }
+    return s;
+}
+
+/*
+   Return true if filter filt_p selects sweep s. A NULL filter selects
+   everything.
  */
 
-struct Sigmet_Color_Scale_Def get_color_scale_def(char *rec)
+static int sweep_ld(const struct Sigmet_Vol_Filter *filt_p, long s)
 {
-    struct Sigmet_Color_Scale_Def csd;
-    char *p, *p1;
-    unsigned *q;
+    return !filt_p || s < 0 || s >= SIGMET_MAX_SWEEPS || filt_p->sweeps[s];
+}
 
-    csd.flags = get_uint32(rec + 0);
-    csd.istart = get_sint32(rec + 4);
-    csd.istep = get_sint32(rec + 8);
-    csd.icolcnt = get_sint16(rec + 12);
-    csd.iset_and_scale = get_uint16(rec + 14);
-    q = csd.ilevel_seams;
-    p = rec + 16;
-    p1 = p + sizeof(*csd.ilevel_seams) * 16;
-    for ( ; p < p1; p += sizeof(*csd.ilevel_seams), q++) {
-	*q = get_uint16(p);
+/*
+   Return the number of sweeps that filter filt_p selects from a volume
+   with num_sweeps sweeps.
+ */
+
+static long num_sweeps_ld(const struct Sigmet_Vol_Filter *filt_p,
+	long num_sweeps)
+{
+    long s, n;
+
+    for (s = n = 0; s < num_sweeps; s++) {
+	if ( sweep_ld(filt_p, s) ) {
+	    n++;
+	}
     }
-    return csd;
+    return n;
 }
 
-void print_color_scale_def(FILE *out, char *pfx,
-	struct Sigmet_Color_Scale_Def csd)
+/*
+   Headers and field values of a volume come from chunks of memory that
+   belong to the volume. Allocation bumps an offset in the newest chunk.
+   Nothing is returned to a chunk. Sigmet_Vol_Free unmaps the chunks,
+   which is a few system calls no matter how many arrays were allocated.
+
+   Chunks are mapped from /dev/zero, so they are outside the heap, start
+   out as zeros, and take no memory until they are written. They are
+   aligned to, and sized in multiples of, POOL_CHUNK, a common huge page
+   size. A request of at least POOL_CHUNK / 4 bytes, such as a field,
+   gets a chunk of its own, so that Sigmet_Vol_DelField can unmap it.
+   The newest small chunk stays at the head of the list.
+ */
+
+#define POOL_CHUNK (2UL * 1024UL * 1024UL)
+#define POOL_ALIGN 64
+struct sigmet_chunk {
+    struct sigmet_chunk *next;		/* Next chunk for volume */
+    size_t sz;				/* Size of chunk, including this
+					   struct */
+    size_t used;			/* Bytes in use, including this
+					   struct */
+    int own;				/* If true, chunk has one allocation,
+					   and nothing else may go in it */
+};
+
+/*
+   Map a chunk of at least sz bytes, aligned to POOL_CHUNK. Return NULL
+   on failure.
+ */
+
+static struct sigmet_chunk *chunk_new(size_t sz)
 {
-    int n;
-    char prefix[STR_LEN];
-    char struct_path[STR_LEN];
+    int fd;
+    char *p, *c;			/* Mapping, aligned start of chunk */
+    size_t hd, tl;			/* Excess at head and tail */
+    struct sigmet_chunk *chunk;
+
+    sz = (sz + POOL_CHUNK - 1) / POOL_CHUNK * POOL_CHUNK;
+    if ( (fd = open("/dev/zero", O_RDWR)) == -1 ) {
+	fprintf(stderr, "%d: could not open /dev/zero.\n%s\n",
+		getpid(), strerror(errno));
+	return NULL;
+    }
+    p = mmap(NULL, sz + POOL_CHUNK, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+	    fd, 0);
+    close(fd);
+    if ( p == MAP_FAILED ) {
+	fprintf(stderr, "%d: could not map %lu bytes for volume.\n%s\n",
+		getpid(), (unsigned long)sz, strerror(errno));
+	return NULL;
+    }
 
-    snprintf(prefix, STR_LEN, "%s%s", pfx, "<color_scale_def>.");
-    print_x(out, csd.flags, prefix, "flags",
-	    "iflags: Bit 8=COLOR_SCALE_VARIABLE Bit 10=COLOR_SCALE_TOP_SAT Bit"
-	    " 11=COLOR_SCALE_BOT_SAT");
-    print_i(out, csd.istart, prefix, "istart",
-	    "istart: Starting level");
-    print_i(out, csd.istep, prefix, "istep",
-	    "istep: Level step");
-    print_i(out, csd.icolcnt, prefix, "icolcnt",
-	    "icolcnt: Number of colors in scale");
-    print_u(out, csd.iset_and_scale, prefix, "iset_and_scale",
-	    "iset_and_scale: Color set number in low byte, color scale number"
-	    " in high byte.");
-    for (n = 0; n < 16; n++) {
-	snprintf(struct_path, STR_LEN, "%s%s%d%s", prefix,
-		"ilevel_seams[", n, "]");
-	fprintf(out, "%u" FS "%s" FS "%s\n", csd.ilevel_seams[n], struct_path,
-		"ilevel_seams: Variable level starting values");
+    /*
+       Trim the mapping to an aligned chunk.
+     */
+
+    c = (char *)(((unsigned long)p + POOL_CHUNK - 1) / POOL_CHUNK
+	    * POOL_CHUNK);
+    hd = c - p;
+    tl = POOL_CHUNK - hd;
+    if ( hd > 0 ) {
+	munmap(p, hd);
+    }
+    if ( tl > 0 ) {
+	munmap(c + sz, tl);
+    }
+    chunk = (struct sigmet_chunk *)c;
+    chunk->next = NULL;
+    chunk->sz = sz;
+    chunk->used = (sizeof(struct sigmet_chunk) + POOL_ALIGN - 1)
+	/ POOL_ALIGN * POOL_ALIGN;
+    chunk->own = 0;
+    return chunk;
+}
+
+/*
+   Allocate sz bytes of zeros for vol_p. Return NULL on failure.
+ */
+
+static void *vol_pool_alloc(struct Sigmet_Vol *vol_p, size_t sz)
+{
+    struct sigmet_chunk *chunk = vol_p->chunks;
+    size_t hd_sz;			/* Space for chunk header */
+    void *p;
+
+    sz = (sz + POOL_ALIGN - 1) / POOL_ALIGN * POOL_ALIGN;
+    if ( chunk && !chunk->own && chunk->used + sz <= chunk->sz ) {
+	p = (char *)chunk + chunk->used;
+	chunk->used += sz;
+	return p;
+    }
+    hd_sz = (sizeof(struct sigmet_chunk) + POOL_ALIGN - 1)
+	/ POOL_ALIGN * POOL_ALIGN;
+    if ( !(chunk = chunk_new(hd_sz + sz)) ) {
+	return NULL;
     }
+    p = (char *)chunk + chunk->used;
+    chunk->used += sz;
+    chunk->own = (sz >= POOL_CHUNK / 4);
+    if ( chunk->own && vol_p->chunks ) {
+	chunk->next = vol_p->chunks->next;
+	vol_p->chunks->next = chunk;
+    } else {
+	chunk->next = vol_p->chunks;
+	vol_p->chunks = chunk;
+    }
+    return p;
 }
 
 /*
-   get / print product_end.
+   If p has a chunk of its own in vol_p, unmap the chunk. Otherwise, p
+   stays allocated until the volume is freed.
  */
 
-struct Sigmet_Product_End get_product_end(char *rec)
+static void vol_pool_free(struct Sigmet_Vol *vol_p, void *p)
 {
-    struct Sigmet_Product_End pe;
+    struct sigmet_chunk **chunk_pp, *chunk;
+    size_t hd_sz;			/* Space for chunk header */
+
+    hd_sz = (sizeof(struct sigmet_chunk) + POOL_ALIGN - 1)
+	/ POOL_ALIGN * POOL_ALIGN;
+    for (chunk_pp = &vol_p->chunks;
+	    *chunk_pp;
+	    chunk_pp = &(*chunk_pp)->next) {
+	chunk = *chunk_pp;
+	if ( chunk->own && (char *)chunk + hd_sz == (char *)p ) {
+	    *chunk_pp = chunk->next;
+	    munmap(chunk, chunk->sz);
+	    return;
+	}
+    }
+}
 
-    memcpy(pe.site_name_prod, rec + 0, 16);
-    trimRight(pe.site_name_prod, 16);
-    memcpy(pe.iris_prod_vsn, rec + 16, 8);
-    trimRight(pe.iris_prod_vsn, 8);
-    memcpy(pe.iris_ing_vsn, rec + 24, 8);
-    trimRight(pe.iris_ing_vsn, 8);
-    pe.local_wgmt = get_sint16(rec + 72);
-    memcpy(pe.hw_name, rec + 74, 16);
-    trimRight(pe.hw_name, 16);
-    memcpy(pe.site_name_ing, rec + 90, 16);
-    trimRight(pe.site_name_ing, 16);
-    pe.rec_wgmt = get_sint16(rec + 106);
-    pe.center_latitude = get_uint32(rec + 108);
-    pe.center_longitude = get_uint32(rec + 112);
-    pe.ground_elev = get_sint16(rec + 116);
-    pe.radar_ht = get_sint16(rec + 118);
-    pe.prf = get_sint32(rec + 120);
-    pe.pulse_w = get_sint32(rec + 124);
-    pe.proc_type = get_uint16(rec + 128);
-    pe.trigger_rate_scheme = get_uint16(rec + 130);
-    pe.num_samples = get_sint16(rec + 132);
-    memcpy(pe.clutter_filter, rec + 134, 12);
-    trimRight(pe.clutter_filter, 12);
-    pe.lin_filter = get_uint16(rec + 146);
-    pe.wave_len = get_sint32(rec + 148);
-    pe.trunc_ht = get_sint32(rec + 152);
-    pe.rng_bin0 = get_sint32(rec + 156);
-    pe.rng_last_bin = get_sint32(rec + 160);
-    pe.num_bins_out = get_sint32(rec + 164);
-    pe.flag = get_uint16(rec + 168);
-    pe.polarization = get_uint16(rec + 172);
-    pe.hpol_io_cal = get_sint16(rec + 174);
-    pe.hpol_cal_noise = get_sint16(rec + 176);
-    pe.hpol_radar_const = get_sint16(rec + 178);
-    pe.recv_bandw = get_uint16(rec + 180);
-    pe.hpol_noise = get_sint16(rec + 182);
-    pe.vpol_noise = get_sint16(rec + 184);
-    pe.ldr_offset = get_sint16(rec + 186);
-    pe.zdr_offset = get_sint16(rec + 188);
-    pe.tcf_cal_flags = get_uint16(rec + 190);
-    pe.tcf_cal_flags2 = get_uint16(rec + 192);
-    pe.std_parallel1 = get_uint32(rec + 212);
-    pe.std_parallel2 = get_uint32(rec + 216);
-    pe.rearth = get_uint32(rec + 220);
-    pe.flatten = get_uint32(rec + 224);
-    pe.fault = get_uint32(rec + 228);
-    pe.insites_mask = get_uint32(rec + 232);
-    pe.logfilter_num = get_uint16(rec + 236);
-    pe.cluttermap_used = get_uint16(rec + 238);
-    pe.proj_lat = get_uint32(rec + 240);
-    pe.proj_lon = get_uint32(rec + 244);
-    pe.i_prod = get_sint16(rec + 248);
-    pe.melt_level = get_sint16(rec + 282);
-    pe.radar_ht_ref = get_sint16(rec + 284);
-    pe.num_elem = get_sint16(rec + 286);
-    pe.wind_spd = *(unsigned char *)(rec + 288);
-    pe.wind_dir = *(unsigned char *)(rec + 289);
-    memcpy(pe.tz, rec + 292, 8);
-    trimRight(pe.tz, 8);
-    return pe;
+/*
+   Unmap all chunks of vol_p.
+ */
+
+static void vol_pool_release(struct Sigmet_Vol *vol_p)
+{
+    struct sigmet_chunk *chunk, *next;
+
+    for (chunk = vol_p->chunks; chunk; chunk = next) {
+	next = chunk->next;
+	munmap(chunk, chunk->sz);
+    }
+    vol_p->chunks = NULL;
 }
 
-void print_product_end(FILE *out, char *pfx, struct Sigmet_Product_End pe)
+/*
+   Allocate values for data array dat_p in vol_p, whose stor_fmt must be
+   set, as one block with storage for kmax sweeps of jmax rays of imax
+   bins. Set the strides and size in dat_p. Return true on success.
+
+   Integer values start as zeros. Floating point values, including
+   SIGMET_F16, are initialized to NAN in the sweeps selected by filt_p,
+   or in every sweep if filt_p is NULL. Other sweeps are not touched, so
+   they take no space until something writes to them.
+ */
+
+static int fld_alloc(struct Sigmet_Vol *vol_p, struct Sigmet_Dat *dat_p,
+	long kmax, long jmax, long imax, const struct Sigmet_Vol_Filter *filt_p)
 {
-    char prefix[STR_LEN];
+    void *dat;
+    size_t kk, jj, ii;
+    size_t elem_sz;			/* Size of one value */
+    size_t sz;
+    long k;
+    float *d, *d_e;
+    U2BYT *h, *h_e;
 
-    snprintf(prefix, STR_LEN, "%s%s", pfx, "<product_end>.");
-    print_s(out, pe.site_name_prod, prefix, "site_name_prod",
-	    "Site name -- where product was made (space padded)");
-    print_s(out, pe.iris_prod_vsn, prefix, "iris_prod_vsn",
-	    "IRIS version where product was made (null terminated)");
-    print_s(out, pe.iris_ing_vsn, prefix, "iris_ing_vsn",
-	    "IRIS version where ingest data came from");
-    print_i(out, pe.local_wgmt, prefix, "local_wgmt",
-	    "Number of minutes local standard time is west of GMT");
-    print_s(out, pe.hw_name, prefix, "hw_name",
-	    "Hardware name where ingest data came from (space padded)");
-    print_s(out, pe.site_name_ing, prefix, "site_name_ing",
-	    "Site name where ingest data came from (space padded)");
-    print_i(out, pe.rec_wgmt, prefix, "rec_wgmt",
-	    "Number of minutes recorded standard time is west of GMT");
-    print_u(out, pe.center_latitude, prefix, "center_latitude",
-	    "Latitude of center (binary angle) *");
-    print_u(out, pe.center_longitude, prefix, "center_longitude",
-	    "Longitude of center (binary angle) *");
-    print_i(out, pe.ground_elev, prefix, "ground_elev",
-	    "Signed ground height in meters relative to sea level");
-    print_i(out, pe.radar_ht, prefix, "radar_ht",
-	    "Height of radar above the ground in meters");
-    print_i(out, pe.prf, prefix, "prf",
-	    "PRF in hertz");
-    print_i(out, pe.pulse_w, prefix, "pulse_w",
-	    "Pulse width in 1/100 of microseconds");
-    print_u(out, pe.proc_type, prefix, "proc_type",
-	    "Type of signal processor used");
-    print_u(out, pe.trigger_rate_scheme, prefix, "trigger_rate_scheme",
-	    "Trigger rate scheme");
-    print_i(out, pe.num_samples, prefix, "num_samples",
-	    "Number of samples used");
-    print_s(out, pe.clutter_filter, prefix, "clutter_filter",
-	    "Clutter filter file name");
-    print_u(out, pe.lin_filter, prefix, "lin_filter",
-	    "Number of linear based filter for the first bin");
-    print_i(out, pe.wave_len, prefix, "wave_len",
-	    "Wavelength in 1/100 of centimeters");
-    print_i(out, pe.trunc_ht, prefix, "trunc_ht",
-	    "Truncation height (cm above the radar)");
-    print_i(out, pe.rng_bin0, prefix, "rng_bin0",
-	    "Range of the first bin in cm");
-    print_i(out, pe.rng_last_bin, prefix, "rng_last_bin",
-	    "Range of the last bin in cm");
-    print_i(out, pe.num_bins_out, prefix, "num_bins_out",
-	    "Number of output bins");
-    print_x(out, pe.flag, prefix, "flag",
-	    "Flag word Bit0:Disdrometer failed, we used setup for Z/R source"
-	    " instead");
-    print_u(out, pe.polarization, prefix, "polarization",
-	    "Type of polarization used");
-    print_i(out, pe.hpol_io_cal, prefix, "hpol_io_cal",
-	    "I0 cal value, horizontal pol, in 1/100 dBm");
-    print_i(out, pe.hpol_cal_noise, prefix, "hpol_cal_noise",
-	    "Noise at calibration, horizontal pol, in 1/100 dBm");
-    print_i(out, pe.hpol_radar_const, prefix, "hpol_radar_const",
-	    "Radar constant, horizontal pol, in 1/100 dB");
-    print_u(out, pe.recv_bandw, prefix, "recv_bandw",
-	    "Receiver bandwidth in kHz");
-    print_i(out, pe.hpol_noise, prefix, "hpol_noise",
-	    "Current noise level, horizontal pol, in 1/100 dBm");
-    print_i(out, pe.vpol_noise, prefix, "vpol_noise",
-	    "Current noise level, vertical pol, in 1/100 dBm");
-    print_i(out, pe.ldr_offset, prefix, "ldr_offset",
-	    "LDR offset, in 1/100 dB");
-    print_i(out, pe.zdr_offset, prefix, "zdr_offset",
-	    "ZDR offset, in 1/100 dB");
-    print_u(out, pe.tcf_cal_flags, prefix, "tcf_cal_flags",
-	    "TCF Cal flags, see struct task_calib_info (added in 8.12.3)");
-    print_u(out, pe.tcf_cal_flags2, prefix, "tcf_cal_flags2",
-	    "TCF Cal flags2, see struct task_calib_info (added in 8.12.3)");
-    print_u(out, pe.std_parallel1, prefix, "std_parallel1",
-	    "More projection info these 4 words: Standard parallel #1");
-    print_u(out, pe.std_parallel2, prefix, "std_parallel2",
-	    "Standard parallel #2");
-    print_u(out, pe.rearth, prefix, "rearth",
-	    "Equatorial radius of the earth, cm (zero = 6371km sphere)");
-    print_u(out, pe.flatten, prefix, "flatten",
-	    "1/Flattening in 1/1000000 (zero = sphere)");
-    print_u(out, pe.fault, prefix, "fault",
-	    "Fault status of task, see ingest_configuration 3.2.14 "
-	    " for details");
-    print_u(out, pe.insites_mask, prefix, "insites_mask",
-	    "Mask of input sites used in a composite");
-    print_u(out, pe.logfilter_num, prefix, "logfilter_num",
-	    "Number of log based filter for the first bin");
-    print_u(out, pe.cluttermap_used, prefix, "cluttermap_used",
-	    "Nonzero if cluttermap applied to the ingest data");
-    print_u(out, pe.proj_lat, prefix, "proj_lat",
-	    "Latitude of projection reference *");
-    print_u(out, pe.proj_lon, prefix, "proj_lon",
-	    "Longitude of projection reference *");
-    print_i(out, pe.i_prod, prefix, "i_prod",
-	    "Product sequence number");
-    print_i(out, pe.melt_level, prefix, "melt_level",
-	    "Melting level in meters, msb complemented (0=unknown)");
-    print_i(out, pe.radar_ht_ref, prefix, "radar_ht_ref",
-	    "Height of radar above reference height in meters");
-    print_i(out, pe.num_elem, prefix, "num_elem",
-	    "Number of elements in product results array");
-    print_u(out, pe.wind_spd, prefix, "wind_spd",
-	    "Mean wind speed");
-    print_u(out, pe.wind_dir, prefix, "wind_dir",
-	    "Mean wind direction (unknown if speed and direction 0)");
-    print_s(out, pe.tz, prefix, "tz",
-	    "TZ Name of recorded data");
+    switch (dat_p->stor_fmt) {
+	case SIGMET_U1:
+	    elem_sz = sizeof(U1BYT);
+	    break;
+	case SIGMET_U2:
+	case SIGMET_F16:
+	    elem_sz = sizeof(U2BYT);
+	    break;
+	case SIGMET_FLT:
+	    elem_sz = sizeof(float);
+	    break;
+	case SIGMET_DBL:
+	case SIGMET_MT:
+	default:
+	    fprintf(stderr, "%d: cannot allocate values for unknown storage "
+		    "format.\n", getpid());
+	    return 0;
+    }
+
+    /*
+       Make sure casting to size_t does not overflow anything.
+     */
+
+    if ( kmax <= 0 || jmax <= 0 || imax <= 0 ) {
+	fprintf(stderr, "%d: array dimensions must be positive.\n", getpid());
+	return 0;
+    }
+    kk = (size_t)kmax;
+    jj = (size_t)jmax;
+    ii = (size_t)imax;
+    if ( (kk * jj) / kk != jj || (kk * jj * ii) / (kk * jj) != ii
+	    || (kk * jj * ii * elem_sz) / elem_sz != kk * jj * ii ) {
+	fprintf(stderr, "%d: dimensions too big for pointer arithmetic.\n",
+		getpid());
+	return 0;
+    }
+    sz = kk * jj * ii * elem_sz;
+    dat = vol_pool_alloc(vol_p, sz);
+    if ( !dat ) {
+	fprintf(stderr, "%d: could not allocate %lu bytes for field.\n",
+		getpid(), (unsigned long)sz);
+	return 0;
+    }
+    dat_p->vals.u1 = dat;
+    dat_p->sweep_stride = jj * ii;
+    dat_p->ray_stride = ii;
+    dat_p->vals_sz = sz;
+    if ( dat_p->stor_fmt == SIGMET_FLT ) {
+	for (k = 0; k < kmax; k++) {
+	    if ( sweep_ld(filt_p, k) ) {
+		d = SIGMET_DAT_FLT(dat_p, k, 0);
+		for (d_e = d + dat_p->sweep_stride; d < d_e; d++) {
+		    *d = NAN;
+		}
+	    }
+	}
+    } else if ( dat_p->stor_fmt == SIGMET_F16 ) {
+	for (k = 0; k < kmax; k++) {
+	    if ( sweep_ld(filt_p, k) ) {
+		h = SIGMET_DAT_U2(dat_p, k, 0);
+		for (h_e = h + dat_p->sweep_stride; h < h_e; h++) {
+		    *h = HALF_NAN;
+		}
+	    }
+	}
+    }
+    return 1;
 }
 
 /*
-   get ingest header (raw volume record 2).
+   Return true if dat_p is a field that is not a Sigmet data type, which
+   functions such as Sigmet_Vol_Fld_AddVal may modify.
  */
 
-struct Sigmet_Ingest_Header get_ingest_header(char *rec)
+static int fld_derived(struct Sigmet_Dat *dat_p)
 {
-    struct Sigmet_Ingest_Header ih;
+    switch (dat_p->stor_fmt) {
+	case SIGMET_FLT:
+	case SIGMET_F16:
+	    return 1;
+	case SIGMET_U1:
+	case SIGMET_U2:
+	    return dat_p->scale != 0.0;
+	case SIGMET_DBL:
+	case SIGMET_MT:
+	    return 0;
+    }
+    return 0;
+}
 
-    ih.sh = get_structure_header(rec);
-    rec += 12;
-    ih.ic = get_ingest_configuration(rec);
-    rec += 480;
-    ih.tc = get_task_configuration(rec);
-    return ih;
+/*
+   Convert float to IEEE 754 half precision, rounding to nearest even.
+   Values beyond the range of half precision become infinite.
+ */
+
+static U2BYT flt_to_half(float f)
+{
+    union {
+	float f;
+	U32BIT u;
+    } x;
+    U32BIT u, sgn, m, h, rem, half;
+    int shift;
+
+    x.f = f;
+    sgn = (x.u >> 16) & 0x8000;
+    u = x.u & 0x7fffffff;
+    if ( u >= 0x7f800000 ) {
+	return sgn | ((u > 0x7f800000) ? HALF_NAN : 0x7c00);
+    }
+    if ( u >= 0x477ff000 ) {
+	return sgn | 0x7c00;
+    }
+    if ( u < 0x38800000 ) {
+
+	/*
+	   Subnormal half, or zero.
+	 */
+
+	if ( u < 0x33000000 ) {
+	    return sgn;
+	}
+	m = (u & 0x7fffff) | 0x800000;
+	shift = 126 - (int)(u >> 23);
+	h = m >> shift;
+	rem = m & ((1U << shift) - 1);
+	half = 1U << (shift - 1);
+	if ( rem > half || (rem == half && (h & 1)) ) {
+	    h++;
+	}
+	return sgn | h;
+    }
+    h = (u - 0x38000000) >> 13;
+    rem = u & 0x1fff;
+    if ( rem > 0x1000 || (rem == 0x1000 && (h & 1)) ) {
+	h++;
+    }
+    return sgn | h;
 }
 
-void print_ingest_header(FILE *out, char *prefix,
-	struct Sigmet_Ingest_Header ih)
+/*
+   Convert IEEE 754 half precision to float.
+ */
+
+static float half_to_flt(U2BYT h)
 {
-    print_structure_header(out, prefix, ih.sh);
-    print_ingest_configuration(out, prefix, ih.ic);
-    print_task_configuration(out, prefix, ih.tc);
+    union {
+	float f;
+	U32BIT u;
+    } x;
+    U32BIT sgn, e, m;
+
+    sgn = (U32BIT)(h & 0x8000) << 16;
+    e = (h >> 10) & 0x1f;
+    m = h & 0x3ff;
+    if ( e == 0x1f ) {
+	x.u = sgn | 0x7f800000 | (m << 13);
+    } else if ( e == 0 ) {
+	x.f = m * 5.9604644775390625e-8f;		/* 2^-24 */
+	x.u |= sgn;
+    } else {
+	x.u = sgn | ((e + 112) << 23) | (m << 13);
+    }
+    return x.f;
 }
 
 /*
-   get / print ingest_configuration.
+   Return the conversion table for field dat_p of vol_p, building it if
+   the field does not have one yet, or if headers that the Sigmet
+   conversion functions read have changed since it was built. lut[u] is
+   the computation value for storage value u. Return NULL if the field
+   does not store U1, U2, or F16 values, or if memory is short, in which
+   case the caller should convert values itself.
  */
 
-struct Sigmet_Ingest_Configuration get_ingest_configuration(char *rec)
+static float *fld_lut(struct Sigmet_Vol *vol_p, struct Sigmet_Dat *dat_p)
 {
-    struct Sigmet_Ingest_Configuration ic;
-    char *p, *p1;
-    int *q;
+    int prf, wave_len;
+    enum Sigmet_Multi_PRF prf_mode;
+    size_t n, u;
+    float *lut;
 
-    memcpy(ic.file_name, rec + 0, 80);
-    trimRight(ic.file_name, 80);
-    ic.num_assoc_files = get_sint16(rec + 80);
-    ic.num_sweeps = get_sint16(rec + 82);
-    ic.size_files = get_sint32(rec + 84);
-    ic.vol_start_time = get_ymds_time(rec + 88);
-    ic.ray_headers_sz = get_sint16(rec + 112);
-    ic.extended_ray_headers_sz = get_sint16(rec + 114);
-    ic.task_config_table_num = get_sint16(rec + 116);
-    ic.playback_vsn = get_sint16(rec + 118);
-    memcpy(ic.IRIS_vsn, rec + 124, 8);
-    trimRight(ic.IRIS_vsn, 8);
-    memcpy(ic.hw_site_name, rec + 132, 16);
-    trimRight(ic.hw_site_name, 16);
-    ic.local_wgmt = get_sint16(rec + 148);
-    memcpy(ic.su_site_name, rec + 150, 16);
-    trimRight(ic.su_site_name, 16);
-    ic.rec_wgmt = get_sint16(rec + 166);
-    ic.latitude = get_uint32(rec + 168);
-    ic.longitude = get_uint32(rec + 172);
-    ic.ground_elev = get_sint16(rec + 176);
-    ic.radar_ht = get_sint16(rec + 178);
-    ic.resolution = get_uint16(rec + 180);
-    ic.index_first_ray = get_uint16(rec + 182);
-    ic.num_rays = get_uint16(rec + 184);
-    ic.num_bytes_gparam = get_sint16(rec + 186);
-    ic.altitude = get_sint32(rec + 188);
-    q = ic.velocity;
-    p = rec + 192;
-    p1 = p + sizeof(*ic.velocity) * 3;
-    for ( ; p < p1; p += sizeof(*ic.velocity), q++) {
-	*q = get_sint32(p);
+    prf = vol_p->ih.tc.tdi.prf;
+    wave_len = vol_p->ih.tc.tmi.wave_len;
+    prf_mode = vol_p->ih.tc.tdi.m_prf_mode;
+    if ( dat_p->lut && dat_p->lut_prf == prf
+	    && dat_p->lut_wave_len == wave_len
+	    && dat_p->lut_prf_mode == prf_mode ) {
+	return dat_p->lut;
+    }
+    switch (dat_p->stor_fmt) {
+	case SIGMET_U1:
+	    n = 0x100;
+	    break;
+	case SIGMET_U2:
+	case SIGMET_F16:
+	    n = 0x10000;
+	    break;
+	case SIGMET_FLT:
+	case SIGMET_DBL:
+	case SIGMET_MT:
+	default:
+	    return NULL;
     }
-    q = ic.offset_inu;
-    p = rec + 204;
-    p1 = p + sizeof(*ic.velocity) * 3;
-    for ( ; p < p1; p += sizeof(*ic.offset_inu), q++) {
-	*q = get_sint32(p);
+    if ( !dat_p->lut ) {
+	if ( !(dat_p->lut = MALLOC(n * sizeof(float))) ) {
+	    return NULL;
+	}
+	vol_p->size += n * sizeof(float);
     }
-    ic.fault = get_uint32(rec + 216);
-    ic.melt_level = get_sint16(rec + 220);
-    memcpy(ic.tz, rec + 224, 8);
-    trimRight(ic.tz, 8);
-    ic.flags = get_uint32(rec + 232);
-    memcpy(ic.config_name, rec + 236, 16);
-    trimRight(ic.config_name, 16);
-    return ic;
+    lut = dat_p->lut;
+    if ( dat_p->stor_fmt == SIGMET_F16 ) {
+	for (u = 0; u < n; u++) {
+	    lut[u] = half_to_flt(u);
+	}
+    } else if ( dat_p->scale == 0.0 ) {
+	for (u = 0; u < n; u++) {
+	    lut[u] = dat_p->stor_to_comp(u, vol_p);
+	}
+    } else {
+	lut[0] = NAN;
+	for (u = 1; u < n; u++) {
+	    lut[u] = dat_p->offset + dat_p->scale * u;
+	}
+    }
+    dat_p->lut_prf = prf;
+    dat_p->lut_wave_len = wave_len;
+    dat_p->lut_prf_mode = prf_mode;
+    return lut;
 }
 
-void print_ingest_configuration(FILE *out, char *pfx,
-	struct Sigmet_Ingest_Configuration ic)
+/*
+   Return the number of bytes in the conversion table of field dat_p.
+ */
+
+static size_t fld_lut_sz(struct Sigmet_Dat *dat_p)
 {
-    char prefix[STR_LEN];
+    if ( !dat_p->lut ) {
+	return 0;
+    }
+    return (dat_p->stor_fmt == SIGMET_U1 ? 0x100 : 0x10000) * sizeof(float);
+}
 
-    snprintf(prefix, STR_LEN, "%s%s", pfx, "<ingest_configuration>.");
-    print_s(out, ic.file_name, prefix, "file_name",
-	    "Name of file on disk");
-    print_i(out, ic.num_assoc_files, prefix, "num_assoc_files",
-	    "Number of associated data files extant");
-    print_i(out, ic.num_sweeps, prefix, "num_sweeps",
-	    "Number of sweeps completed so far");
-    print_i(out, ic.size_files, prefix, "size_files",
-	    "Total size of all files in bytes");
-    print_ymds_time(out, ic.vol_start_time, prefix, "vol_start_time",
-	    "Time that volume scan was started, TZ spec in bytes 166 & 224");
-    print_i(out, ic.ray_headers_sz, prefix, "ray_headers_sz",
-	    "Number of bytes in the ray headers");
-    print_i(out, ic.extended_ray_headers_sz, prefix, "extended_ray_headers_sz",
-	    "Number of bytes in extended ray headers"
-	    " (includes normal ray header)");
-    print_i(out, ic.task_config_table_num, prefix, "task_config_table_num",
-	    "Number of task configuration table");
-    print_i(out, ic.playback_vsn, prefix, "playback_vsn",
-	    "Playback version number");
-    print_s(out, ic.IRIS_vsn, prefix, "IRIS_vsn",
-	    "IRIS version, null terminated");
-    print_s(out, ic.hw_site_name, prefix, "hw_site_name",
-	    "Hardware name of site");
-    print_i(out, ic.local_wgmt, prefix, "local_wgmt",
-	    "Time zone of local standard time, minutes west of GMT");
-    print_s(out, ic.su_site_name, prefix, "su_site_name",
-	    "Name of site, from setup utility");
-    print_i(out, ic.rec_wgmt, prefix, "rec_wgmt",
-	    "Time zone of recorded standard time, minutes west of GMT");
-    print_u(out, ic.latitude, prefix, "latitude",
-	    "Latitude of radar (binary angle: 20000000 hex is 45_ North)");
-    print_u(out, ic.longitude, prefix, "longitude",
-	    "Longitude of radar (binary angle: 20000000 hex is 45_ East)");
-    print_i(out, ic.ground_elev, prefix, "ground_elev",
-	    "Height of ground at site (meters above sea level)");
-    print_i(out, ic.radar_ht, prefix, "radar_ht",
-	    "Height of radar above ground (meters)");
-    print_u(out, ic.resolution, prefix, "resolution",
-	    "Resolution specified in number of rays in a 360_ sweep");
-    print_u(out, ic.index_first_ray, prefix, "index_first_ray",
-	    "Index of first ray from above set of rays");
-    print_u(out, ic.num_rays, prefix, "num_rays",
-	    "Number of rays in a sweep");
-    print_i(out, ic.num_bytes_gparam, prefix, "num_bytes_gparam",
-	    "Number of bytes in each gparam");
-    print_i(out, ic.altitude, prefix, "altitude",
-	    "Altitude of radar (cm above sea level)");
-    print_i(out, ic.velocity[0], prefix, "velocity east",
-	    "Velocity of radar platform (cm/sec) east");
-    print_i(out, ic.velocity[1], prefix, "velocity north",
-	    "Velocity of radar platform (cm/sec) north");
-    print_i(out, ic.velocity[2], prefix, "velocity up",
-	    "Velocity of radar platform (cm/sec) up");
-    print_i(out, ic.offset_inu[0], prefix, "offset_inu starboard",
-	    "Antenna offset from INU (cm) starboard");
-    print_i(out, ic.offset_inu[1], prefix, "offset_inu bow",
-	    "Antenna offset from INU (cm) bow");
-    print_i(out, ic.offset_inu[2], prefix, "offset_inu up",
-	    "Antenna offset from INU (cm) up");
-    print_u(out, ic.fault, prefix, "fault",
-	    "Fault status at the time the task was started, bits:"
-	    " 0:Normal BITE 1:Critical BITE 2:Normal RCP 3:Critical RCP"
-	    " 4:Critical system 5:Product gen. 6:Output 7:Normal system ");
-    print_i(out, ic.melt_level, prefix, "melt_level",
-	    "Height of melting layer (meters above sea level) MSB is"
-	    " complemented, zero=Unknown");
-    print_s(out, ic.tz, prefix, "tz",
-	    "Local timezone string, null terminated");
-    print_x(out, ic.flags, prefix, "flags",
-	    "Flags, Bit 0=First ray not centered on zero degrees");
-    print_s(out, ic.config_name, prefix, "config_name",
-	    "Configuration name in the dpolapp.conf file, null terminated");
+/*
+   Free the conversion table of field dat_p in vol_p, if any.
+ */
+
+static void fld_lut_free(struct Sigmet_Vol *vol_p, struct Sigmet_Dat *dat_p)
+{
+    vol_p->size -= fld_lut_sz(dat_p);
+    FREE(dat_p->lut);
+    dat_p->lut = NULL;
+}
+
+/*
+   Return the value of field dat_p at sweep s, ray r, bin b of vol_p.
+ */
+
+static float fld_get(struct Sigmet_Vol *vol_p, struct Sigmet_Dat *dat_p,
+	int s, int r, int b)
+{
+    unsigned u;
+    float *lut;
+
+    switch (dat_p->stor_fmt) {
+	case SIGMET_U1:
+	    u = SIGMET_DAT_U1(dat_p, s, r)[b];
+	    break;
+	case SIGMET_U2:
+	    u = SIGMET_DAT_U2(dat_p, s, r)[b];
+	    break;
+	case SIGMET_F16:
+	    u = SIGMET_DAT_U2(dat_p, s, r)[b];
+	    if ( (lut = fld_lut(vol_p, dat_p)) ) {
+		return lut[u];
+	    }
+	    return half_to_flt(u);
+	case SIGMET_FLT:
+	    return SIGMET_DAT_FLT(dat_p, s, r)[b];
+	case SIGMET_DBL:
+	case SIGMET_MT:
+	default:
+	    return NAN;
+    }
+    if ( (lut = fld_lut(vol_p, dat_p)) ) {
+	return lut[u];
+    }
+    if ( dat_p->scale == 0.0 ) {
+	return dat_p->stor_to_comp(u, vol_p);
+    }
+    return u ? dat_p->offset + dat_p->scale * u : NAN;
+}
+
+/*
+   Return the values of field dat_p for sweep s, ray r of vol_p as floats.
+   If the field stores floats, the return value points into the field, and
+   modifications apply to the field. Otherwise, values are converted into
+   buf, which must have space for num_bins_out values, and buf is returned.
+   Fields with no values give NAN.
+ */
+
+static float *fld_ray_get(struct Sigmet_Vol *vol_p, struct Sigmet_Dat *dat_p,
+	int s, int r, float *buf)
+{
+    int b, num_bins;
+    U1BYT *u1;
+    U2BYT *u2;
+    double scale, offset;
+    float *lut;
+
+    num_bins = vol_p->ray_hdr[s][r].num_bins;
+    scale = dat_p->scale;
+    offset = dat_p->offset;
+    lut = fld_lut(vol_p, dat_p);
+    switch (dat_p->stor_fmt) {
+	case SIGMET_FLT:
+	    return SIGMET_DAT_FLT(dat_p, s, r);
+	case SIGMET_U1:
+	    u1 = SIGMET_DAT_U1(dat_p, s, r);
+	    if ( lut ) {
+		for (b = 0; b < num_bins; b++) {
+		    buf[b] = lut[u1[b]];
+		}
+	    } else if ( scale == 0.0 ) {
+		for (b = 0; b < num_bins; b++) {
+		    buf[b] = dat_p->stor_to_comp(u1[b], vol_p);
+		}
+	    } else {
+		for (b = 0; b < num_bins; b++) {
+		    buf[b] = u1[b] ? offset + scale * u1[b] : NAN;
+		}
+	    }
+	    break;
+	case SIGMET_U2:
+	    u2 = SIGMET_DAT_U2(dat_p, s, r);
+	    if ( lut ) {
+		for (b = 0; b < num_bins; b++) {
+		    buf[b] = lut[u2[b]];
+		}
+	    } else if ( scale == 0.0 ) {
+		for (b = 0; b < num_bins; b++) {
+		    buf[b] = dat_p->stor_to_comp(u2[b], vol_p);
+		}
+	    } else {
+		for (b = 0; b < num_bins; b++) {
+		    buf[b] = u2[b] ? offset + scale * u2[b] : NAN;
+		}
+	    }
+	    break;
+	case SIGMET_F16:
+	    u2 = SIGMET_DAT_U2(dat_p, s, r);
+	    if ( lut ) {
+		for (b = 0; b < num_bins; b++) {
+		    buf[b] = lut[u2[b]];
+		}
+	    } else {
+		for (b = 0; b < num_bins; b++) {
+		    buf[b] = half_to_flt(u2[b]);
+		}
+	    }
+	    break;
+	case SIGMET_DBL:
+	case SIGMET_MT:
+	    for (b = 0; b < num_bins; b++) {
+		buf[b] = NAN;
+	    }
+	    break;
+    }
+    return buf;
+}
+
+/*
+   Store num_bins values from f into sweep s, ray r of field dat_p, which
+   must satisfy fld_derived. If f came from fld_ray_get for a float field,
+   the values are already there.
+ */
+
+static void fld_ray_put(struct Sigmet_Dat *dat_p, int s, int r,
+	const float *f, int num_bins)
+{
+    int b;
+    float *d;
+    U1BYT *u1;
+    U2BYT *u2;
+    double u, u_max;
+    double scale, offset;
+    int ok;				/* If true, value is not NAN */
+
+    scale = dat_p->scale;
+    offset = dat_p->offset;
+    switch (dat_p->stor_fmt) {
+	case SIGMET_FLT:
+	    d = SIGMET_DAT_FLT(dat_p, s, r);
+	    if ( d != f ) {
+		memcpy(d, f, num_bins * sizeof(float));
+	    }
+	    break;
+	case SIGMET_U1:
+	    u1 = SIGMET_DAT_U1(dat_p, s, r);
+	    u_max = UCHAR_MAX;
+	    for (b = 0; b < num_bins; b++) {
+		ok = (f[b] == f[b]);
+		u = (f[b] - offset) / scale + 0.5;
+		u = ok ? u : 1.0;
+		u = (u < 1.0) ? 1.0 : u;
+		u = (u > u_max) ? u_max : u;
+		u1[b] = ok ? (U1BYT)(int)u : 0;
+	    }
+	    break;
+	case SIGMET_U2:
+	    u2 = SIGMET_DAT_U2(dat_p, s, r);
+	    u_max = USHRT_MAX;
+	    for (b = 0; b < num_bins; b++) {
+		ok = (f[b] == f[b]);
+		u = (f[b] - offset) / scale + 0.5;
+		u = ok ? u : 1.0;
+		u = (u < 1.0) ? 1.0 : u;
+		u = (u > u_max) ? u_max : u;
+		u2[b] = ok ? (U2BYT)(int)u : 0;
+	    }
+	    break;
+	case SIGMET_F16:
+	    u2 = SIGMET_DAT_U2(dat_p, s, r);
+	    for (b = 0; b < num_bins; b++) {
+		u2[b] = flt_to_half(f[b]);
+	    }
+	    break;
+	case SIGMET_DBL:
+	case SIGMET_MT:
+	    break;
+    }
 }
 
 /*
-   get / print task_configuration.
+   Apply kern to every loaded ray of field dat_p1 in vol_p. kern receives
+   the values of dat_p1, the corresponding values of dat_p2 or NULL if
+   dat_p2 is NULL, the number of bins, and v. kern modifies the values of
+   dat_p1 in place, and fld_apply stores them back into the field.
  */
 
-struct Sigmet_Task_Configuration get_task_configuration(char *rec)
-{
-    struct Sigmet_Task_Configuration tc;
+struct fld_apply_arg {
+    struct Sigmet_Dat *dat_p1, *dat_p2;
+    fld_kern *kern;
+    float v;
+};
 
-    tc.sh = get_structure_header(rec);
-    rec += 12;
-    tc.tsi = get_task_sched_info(rec);
-    rec += 120;
-    tc.tdi = get_task_dsp_info(rec);
-    rec += 320;
-    tc.tci = get_task_calib_info(rec);
-    rec += 320;
-    tc.tri = get_task_range_info(rec);
-    rec += 160;
-    tc.tni = get_task_scan_info(rec);
-    rec += 320;
-    tc.tmi = get_task_misc_info(rec);
-    rec += 320;
-    tc.tei = get_task_end_info(rec);
-    return tc;
+static enum SigmetStatus fld_apply(struct Sigmet_Vol *vol_p,
+	struct Sigmet_Dat *dat_p1, struct Sigmet_Dat *dat_p2, fld_kern *kern,
+	float v)
+{
+    struct fld_apply_arg arg;
+    struct Sigmet_Dat *dats[2];
+    enum SigmetStatus status;
+
+    arg.dat_p1 = dats[0] = dat_p1;
+    arg.dat_p2 = dats[1] = dat_p2;
+    arg.kern = kern;
+    arg.v = v;
+    status = fld_sweeps(vol_p, dats, dat_p2 ? 2 : 1, apply_swp, &arg);
+    if ( status != SIGMET_OK ) {
+	return status;
+    }
+    vol_p->mod = 1;
+    return SIGMET_OK;
 }
 
-void print_task_configuration(FILE *out, char *pfx,
-	struct Sigmet_Task_Configuration tc)
+/*
+   fld_swp_fn for fld_apply. arg points to a struct fld_apply_arg.
+ */
+
+static enum SigmetStatus apply_swp(struct Sigmet_Vol *vol_p, int s,
+	void *arg)
 {
-    char prefix[STR_LEN];
+    struct fld_apply_arg *arg_p = arg;
+    int r, n;
+    int num_bins;
+    float *buf1, *buf2;			/* Conversion buffers */
+    float *f1, *f2;			/* Values for a ray */
 
-    snprintf(prefix, STR_LEN, "%s%s", pfx, "<task_configuration>.");
-    print_structure_header(out, prefix, tc.sh);
-    print_task_sched_info(out, prefix, tc.tsi);
-    print_task_dsp_info(out, prefix, tc.tdi);
-    print_task_calib_info(out, prefix, tc.tci);
-    print_task_range_info(out, prefix, tc.tri);
-    print_task_scan_info(out, prefix, tc.tni);
-    print_task_misc_info(out, prefix, tc.tmi);
-    print_task_end_info(out, prefix, tc.tei);
+    num_bins = vol_p->ih.tc.tri.num_bins_out;
+    if ( !(buf1 = CALLOC(2 * num_bins, sizeof(float))) ) {
+	fprintf(stderr, "%d: could not allocate ray buffers.\n", getpid());
+	return SIGMET_MEM_FAIL;
+    }
+    buf2 = buf1 + num_bins;
+    for (r = 0; r < vol_p->ih.ic.num_rays; r++) {
+	if ( vol_p->ray_hdr[s][r].ok ) {
+	    n = vol_p->ray_hdr[s][r].num_bins;
+	    f1 = fld_ray_get(vol_p, arg_p->dat_p1, s, r, buf1);
+	    f2 = arg_p->dat_p2
+		? fld_ray_get(vol_p, arg_p->dat_p2, s, r, buf2) : NULL;
+	    arg_p->kern(f1, f2, n, arg_p->v);
+	    fld_ray_put(arg_p->dat_p1, s, r, f1, n);
+	}
+    }
+    FREE(buf1);
+    return SIGMET_OK;
 }
 
 /*
-   get / print task_sched_info.
+   fld_swp_fn for Sigmet_Vol_Fld_SetRBeam. arg is the field to set.
  */
 
-struct Sigmet_Task_Sched_Info get_task_sched_info(char *rec)
+static enum SigmetStatus rbeam_swp(struct Sigmet_Vol *vol_p, int s,
+	void *arg)
 {
-    struct Sigmet_Task_Sched_Info tsi;
+    struct Sigmet_Dat *dat_p = arg;
+    float *f, *buf;
+    int r, b, n;
+    int num_bins;
+    double bin0;			/* Range to center of 1st bin */
+    double bin_step;
 
-    tsi.start_time = get_sint32(rec + 0);
-    tsi.stop_time = get_sint32(rec + 4);
-    tsi.skip = get_sint32(rec + 8);
-    tsi.time_last_run = get_sint32(rec + 12);
-    tsi.time_used_last_run = get_sint32(rec + 16);
-    tsi.rel_day_last_run = get_sint32(rec + 20);
-    tsi.flag = get_uint16(rec + 24);
-    return tsi;
+    num_bins = vol_p->ih.tc.tri.num_bins_out;
+    if ( !(buf = CALLOC(num_bins, sizeof(float))) ) {
+	fprintf(stderr, "%d: could not allocate ray buffer.\n", getpid());
+	return SIGMET_MEM_FAIL;
+    }
+    bin_step = 0.01 * vol_p->ih.tc.tri.step_out;	/* cm -> meter */
+    bin0 = 0.01 * vol_p->ih.tc.tri.rng_1st_bin + bin_step / 2;
+    for (r = 0; r < vol_p->ih.ic.num_rays; r++) {
+	if ( vol_p->ray_hdr[s][r].ok ) {
+	    n = vol_p->ray_hdr[s][r].num_bins;
+	    f = fld_ray_get(vol_p, dat_p, s, r, buf);
+	    for (b = 0; b < n; b++)  {
+		f[b] = bin0 + b * bin_step;
+	    }
+	    fld_ray_put(dat_p, s, r, f, n);
+	}
+    }
+    FREE(buf);
+    return SIGMET_OK;
 }
 
-void print_task_sched_info(FILE *out, char *pfx,
-	struct Sigmet_Task_Sched_Info tsi)
+/*
+   Call fn for every good sweep of vol_p, with arg. Fields dats[0] ...
+   dats[n_dats - 1] are the fields that fn reads or writes. Their
+   conversion tables are built here, since building one from several
+   threads at once would not be safe. If they are ready, sweeps are
+   divided among vol_p->filter.num_threads threads. Otherwise, or if
+   threads cannot be started, this thread does the work. Return the first
+   failure, or SIGMET_OK.
+ */
+
+static enum SigmetStatus fld_sweeps(struct Sigmet_Vol *vol_p,
+	struct Sigmet_Dat **dats, int n_dats, fld_swp_fn *fn, void *arg)
 {
-    char prefix[STR_LEN];
+    struct fld_pool pool;
+    pthread_t *thr = NULL;		/* Threads */
+    int num_thr;			/* Number of threads to start */
+    int n, s;
+
+    sweep_ready(vol_p, -1);
+    pool.vol_p = vol_p;
+    pool.fn = fn;
+    pool.arg = arg;
+    pool.s = 0;
+    pool.status = SIGMET_OK;
+    num_thr = vol_p->filter.num_threads;
+    num_thr = (num_thr > vol_p->ih.ic.num_sweeps)
+	? vol_p->ih.ic.num_sweeps : num_thr;
+    for (n = 0; n < n_dats; n++) {
+	switch (dats[n]->stor_fmt) {
+	    case SIGMET_U1:
+	    case SIGMET_U2:
+	    case SIGMET_F16:
+		if ( !fld_lut(vol_p, dats[n]) ) {
+		    num_thr = 1;
+		}
+		break;
+	    case SIGMET_FLT:
+	    case SIGMET_DBL:
+	    case SIGMET_MT:
+		break;
+	}
+    }
+    if ( num_thr > 1 && (thr = CALLOC(num_thr, sizeof(pthread_t))) ) {
+	if ( pthread_mutex_init(&pool.mtx, NULL) != 0 ) {
+	    FREE(thr);
+	    thr = NULL;
+	}
+    }
+    if ( !thr ) {
+	for (s = 0; s < vol_p->ih.ic.num_sweeps; s++) {
+	    if ( vol_p->sweep_hdr[s].ok ) {
+		enum SigmetStatus sig_stat = fn(vol_p, s, arg);
 
-    snprintf(prefix, STR_LEN, "%s%s", pfx, "<task_sched_info>.");
-    print_i(out, tsi.start_time, prefix, "start_time",
-	    "Start time (seconds within a day)");
-    print_i(out, tsi.stop_time, prefix, "stop_time",
-	    "Stop time (seconds within a day)");
-    print_i(out, tsi.skip, prefix, "skip",
-	    "Desired skip time (seconds)");
-    print_i(out, tsi.time_last_run, prefix, "time_last_run",
-	    "Time last run (seconds within a day)(0 for passive ingest)");
-    print_i(out, tsi.time_used_last_run, prefix, "time_used_last_run",
-	    "Time used on last run (seconds) (in file time to write out)");
-    print_i(out, tsi.rel_day_last_run, prefix, "rel_day_last_run",
-	    "Relative day of last run (zero for passive ingest)");
-    print_x(out, tsi.flag, prefix, "flag",
-	    "Flag: Bit 0 = ASAP Bit 1 = Mandatory Bit 2 = Late skip"
-	    " Bit 3 = Time used has been measured Bit 4 = Stop after running");
+		if ( sig_stat != SIGMET_OK && pool.status == SIGMET_OK ) {
+		    pool.status = sig_stat;
+		}
+	    }
+	}
+	return pool.status;
+    }
+    for (n = 1; n < num_thr; n++) {
+	if ( pthread_create(thr + n, NULL, fld_thr, &pool) != 0 ) {
+	    break;
+	}
+    }
+    num_thr = n;
+    fld_thr(&pool);
+    for (n = 1; n < num_thr; n++) {
+	pthread_join(thr[n], NULL);
+    }
+    FREE(thr);
+    pthread_mutex_destroy(&pool.mtx);
+    return pool.status;
 }
 
 /*
-   get / print task_dsp_mode_batch.
+   Thread start routine for fld_sweeps. Process sweeps from the pool at
+   arg until none are left. Each sweep only touches its own slice of the
+   field arrays.
  */
 
-struct Sigmet_Task_DSP_Mode_Batch get_task_dsp_mode_batch(char *rec)
+static void *fld_thr(void *arg)
 {
-    struct Sigmet_Task_DSP_Mode_Batch tdmb;
+    struct fld_pool *pool_p = arg;
+    struct Sigmet_Vol *vol_p = pool_p->vol_p;
+    enum SigmetStatus sig_stat;
+    int s;
 
-    tdmb.lo_prf = get_uint16(rec + 0);
-    tdmb.lo_prf_frac = get_uint16(rec + 2);
-    tdmb.lo_prf_sampl = get_sint16(rec + 4);
-    tdmb.lo_prf_avg = get_sint16(rec + 6);
-    tdmb.dz_unfold_thresh = get_sint16(rec + 8);
-    tdmb.vr_unfold_thresh = get_sint16(rec + 10);
-    tdmb.sw_unfold_thresh = get_sint16(rec + 12);
-    return tdmb;
+    while ( 1 ) {
+	pthread_mutex_lock(&pool_p->mtx);
+	s = pool_p->s++;
+	pthread_mutex_unlock(&pool_p->mtx);
+	if ( s >= vol_p->ih.ic.num_sweeps ) {
+	    return NULL;
+	}
+	if ( !vol_p->sweep_hdr[s].ok ) {
+	    continue;
+	}
+	sig_stat = pool_p->fn(vol_p, s, pool_p->arg);
+	if ( sig_stat != SIGMET_OK ) {
+	    pthread_mutex_lock(&pool_p->mtx);
+	    if ( pool_p->status == SIGMET_OK ) {
+		pool_p->status = sig_stat;
+	    }
+	    pthread_mutex_unlock(&pool_p->mtx);
+	}
+    }
 }
 
-void print_task_dsp_mode_batch(FILE *out, char *pfx,
-	struct Sigmet_Task_DSP_Mode_Batch tdmb)
+/*
+   Return true if x compares to thr as op. NAN compares false.
+ */
+
+static int mask_cmp(float x, enum mask_op op, double thr)
 {
-    char prefix[STR_LEN];
+    if ( isnan(x) ) {
+	return 0;
+    }
+    switch (op) {
+	case MASK_LT:
+	    return x < thr;
+	case MASK_LE:
+	    return x <= thr;
+	case MASK_GT:
+	    return x > thr;
+	case MASK_GE:
+	    return x >= thr;
+	case MASK_EQ:
+	    return x == thr;
+	case MASK_NE:
+	    return x != thr;
+    }
+    return 0;
+}
 
-    snprintf(prefix, STR_LEN, "%s%s", pfx, "<task_dsp_mode_batch>.");
-    print_u(out, tdmb.lo_prf, prefix, "lo_prf",
-	    "Low PRF in Hz");
-    print_u(out, tdmb.lo_prf_frac, prefix, "lo_prf_frac",
-	    "Low PRF fraction part, scaled by 2**16");
-    print_i(out, tdmb.lo_prf_sampl, prefix, "lo_prf_sampl",
-	    "Low PRF sample size");
-    print_i(out, tdmb.lo_prf_avg, prefix, "lo_prf_avg",
-	    "Low PRF range averaging in bins");
-    print_i(out, tdmb.dz_unfold_thresh, prefix, "dz_unfold_thresh",
-	    "Threshold for reflectivity unfolding in 1/100 of dB");
-    print_i(out, tdmb.vr_unfold_thresh, prefix, "vr_unfold_thresh",
-	    "Threshold for velocity unfolding in 1/100 of dB");
-    print_i(out, tdmb.sw_unfold_thresh, prefix, "sw_unfold_thresh",
-	    "Threshold for width unfolding in 1/100 of dB");
+/*
+   fld_swp_fn for Sigmet_Vol_Fld_Mask. arg points to a struct mask_arg.
+   For each ray, find the bins to blank from the raw values of the control
+   field, then write the no data value of the target field's storage
+   format into them.
+ */
+
+static enum SigmetStatus mask_swp(struct Sigmet_Vol *vol_p, int s, void *arg)
+{
+    struct mask_arg *arg_p = arg;
+    struct Sigmet_Dat *dat_p = arg_p->dat_p, *ctl_p = arg_p->ctl_p;
+    U1BYT *blank;			/* If blank[b], blank bin b */
+    U1BYT *tbl = arg_p->tbl, *c1;
+    U2BYT *c2;
+    float *cf;
+    int r, b, n;
+
+    if ( !(blank = MALLOC(vol_p->ih.tc.tri.num_bins_out)) ) {
+	fprintf(stderr, "%d: could not allocate mask for ray.\n", getpid());
+	return SIGMET_MEM_FAIL;
+    }
+    for (r = 0; r < vol_p->ih.ic.num_rays; r++) {
+	if ( !vol_p->ray_hdr[s][r].ok ) {
+	    continue;
+	}
+	n = vol_p->ray_hdr[s][r].num_bins;
+	switch (ctl_p->stor_fmt) {
+	    case SIGMET_U1:
+		c1 = SIGMET_DAT_U1(ctl_p, s, r);
+		for (b = 0; b < n; b++) {
+		    blank[b] = tbl[c1[b]];
+		}
+		break;
+	    case SIGMET_U2:
+	    case SIGMET_F16:
+		c2 = SIGMET_DAT_U2(ctl_p, s, r);
+		for (b = 0; b < n; b++) {
+		    blank[b] = tbl[c2[b]];
+		}
+		break;
+	    case SIGMET_FLT:
+		cf = SIGMET_DAT_FLT(ctl_p, s, r);
+		for (b = 0; b < n; b++) {
+		    blank[b] = mask_cmp(cf[b], arg_p->op, arg_p->thr);
+		}
+		break;
+	    case SIGMET_DBL:
+	    case SIGMET_MT:
+		memset(blank, 0, n);
+		break;
+	}
+	fld_blank(dat_p, s, r, blank, n);
+    }
+    FREE(blank);
+    return SIGMET_OK;
 }
 
 /*
-   get / print task_dsp_info.
+   Set bins b of sweep s, ray r of field dat_p for which blank[b] is true
+   to the no data value of the field's storage format. n is the number of
+   bins in the ray.
  */
 
-struct Sigmet_Task_DSP_Info get_task_dsp_info(char *rec)
+static void fld_blank(struct Sigmet_Dat *dat_p, int s, int r,
+	const U1BYT *blank, int n)
 {
-    struct Sigmet_Task_DSP_Info tdi;
+    int b;
+    U1BYT *u1;
+    U2BYT *u2, u2_no_data;
+    float *f;
 
-    tdi.major_mode = get_uint16(rec + 0);
-    tdi.dsp_type = get_uint16(rec + 2);
-    tdi.curr_data_mask = get_dsp_data_mask(rec + 4);
-    tdi.orig_data_mask = get_dsp_data_mask(rec + 28);
-    tdi.mb = get_task_dsp_mode_batch(rec + 52);
-    tdi.prf = get_sint32(rec + 136);
-    tdi.pulse_w = get_sint32(rec + 140);
-    tdi.m_prf_mode = (enum Sigmet_Multi_PRF)get_uint16(rec + 144);
-    tdi.dual_prf = get_sint16(rec + 146);
-    tdi.agc_feebk = get_uint16(rec + 148);
-    tdi.sampl_sz = get_sint16(rec + 150);
-    tdi.gain_flag = get_uint16(rec + 152);
-    memcpy(tdi.clutter_file, rec + 154, 12);
-    trimRight(tdi.clutter_file, 12);
-    tdi.lin_filter_num = *(unsigned char *)(rec + 166);
-    tdi.log_filter_num = *(unsigned char *)(rec + 167);
-    tdi.attenuation = get_sint16(rec + 168);
-    tdi.gas_attenuation = get_uint16(rec + 170);
-    tdi.clutter_flag = get_uint16(rec + 172);
-    tdi.xmt_phase = get_uint16(rec + 174);
-    tdi.ray_hdr_mask = get_uint32(rec + 176);
-    tdi.time_series_flag = get_uint16(rec + 180);
-    memcpy(tdi.custom_ray_hdr, rec + 184, 16);
-    trimRight(tdi.custom_ray_hdr, 16);
-    return tdi;
+    switch (dat_p->stor_fmt) {
+	case SIGMET_U1:
+	    u1 = SIGMET_DAT_U1(dat_p, s, r);
+	    for (b = 0; b < n; b++) {
+		u1[b] = blank[b] ? 0 : u1[b];
+	    }
+	    break;
+	case SIGMET_U2:
+	case SIGMET_F16:
+	    u2 = SIGMET_DAT_U2(dat_p, s, r);
+	    u2_no_data = (dat_p->stor_fmt == SIGMET_F16) ? HALF_NAN : 0;
+	    for (b = 0; b < n; b++) {
+		u2[b] = blank[b] ? u2_no_data : u2[b];
+	    }
+	    break;
+	case SIGMET_FLT:
+	    f = SIGMET_DAT_FLT(dat_p, s, r);
+	    for (b = 0; b < n; b++) {
+		f[b] = blank[b] ? NAN : f[b];
+	    }
+	    break;
+	case SIGMET_DBL:
+	case SIGMET_MT:
+	    break;
+    }
 }
 
-void print_task_dsp_info(FILE *out, char *pfx,
-	struct Sigmet_Task_DSP_Info tdi)
+/*
+   fld_swp_fn for Sigmet_Vol_Fld_Filter. arg points to a struct
+   filter_arg. The input values of sweep s are copied first, so that the
+   field can receive the result as each ray is done.
+ */
+
+static enum SigmetStatus filter_swp(struct Sigmet_Vol *vol_p, int s,
+	void *arg)
 {
-    char prefix[STR_LEN];
+    struct filter_arg *arg_p = arg;
+    int num_rays, num_bins;
+    float *vals = NULL;			/* vals[r * num_bins + b] is the value
+					   at ray r, bin b */
+    float *out = NULL;			/* Result for a ray */
+    float *f, *v;
+    int r, b, n;
+    enum SigmetStatus status = SIGMET_OK;
 
-    snprintf(prefix, STR_LEN, "%s%s", pfx, "<task_dsp_info>.");
-    print_u(out, tdi.major_mode, prefix, "major_mode",
-	    "Major mode");
-    print_u(out, tdi.dsp_type, prefix, "dsp_type",
-	    "DSP type");
-    print_dsp_data_mask(out, prefix, tdi.curr_data_mask,
-	    "Current Data type mask");
-    print_dsp_data_mask(out, prefix, tdi.orig_data_mask,
-	    "Original Data type mask");
-    print_task_dsp_mode_batch(out, prefix, tdi.mb);
-    print_i(out, tdi.prf, prefix, "prf",
-	    "PRF in Hertz");
-    print_i(out, tdi.pulse_w, prefix, "pulse_w",
-	    "Pulse width in 1/100 of microseconds");
-    print_i(out, tdi.m_prf_mode, prefix, "m_prf_mode",
-	    "Multi PRF mode flag: 0=1:1, 1=2:3, 2=3:4, 3=4:5");
-    print_i(out, tdi.dual_prf, prefix, "dual_prf",
-	    "Dual PRF delay");
-    print_u(out, tdi.agc_feebk, prefix, "agc_feebk",
-	    "AGC feedback code");
-    print_i(out, tdi.sampl_sz, prefix, "sampl_sz",
-	    "Sample size");
-    print_u(out, tdi.gain_flag, prefix, "gain_flag",
-	    "Gain Control flag (0=fixed, 1=STC, 2=AGC)");
-    print_s(out, tdi.clutter_file, prefix, "clutter_file",
-	    "Name of file used for clutter filter");
-    print_u(out, tdi.lin_filter_num, prefix, "lin_filter_num",
-	    "Linear based filter number for first bin");
-    print_u(out, tdi.log_filter_num, prefix, "log_filter_num",
-	    "Log based filter number for first bin");
-    print_i(out, tdi.attenuation, prefix, "attenuation",
-	    "Attenuation in 1/10 dB applied in fixed gain mode");
-    print_u(out, tdi.gas_attenuation, prefix, "gas_attenuation",
-	    "Gas attenuation in 1/100000 dB/km for first 10000, then"
-	    " stepping in 1/10000 dB/km");
-    print_u(out, tdi.clutter_flag, prefix, "clutter_flag",
-	    "Flag nonzero means cluttermap used");
-    print_u(out, tdi.xmt_phase, prefix, "xmt_phase",
-	    "XMT phase sequence: 0:Fixed, 1:Random, 3:SZ8/64");
-    print_x(out, tdi.ray_hdr_mask, prefix, "ray_hdr_mask",
-	    "Mask used for to configure the ray header.");
-    print_u(out, tdi.time_series_flag, prefix, "time_series_flag",
-	    "Time series playback flags, see OPTS_* in dsp.h");
-    print_s(out, tdi.custom_ray_hdr, prefix, "custom_ray_hdr",
-	    "Name of custom ray header");
+    num_rays = vol_p->ih.ic.num_rays;
+    num_bins = vol_p->ih.tc.tri.num_bins_out;
+    vals = MALLOC((size_t)num_rays * num_bins * sizeof(float));
+    out = MALLOC((size_t)num_rays * num_bins * sizeof(float));
+    if ( !vals || !out ) {
+	fprintf(stderr, "%d: could not allocate filter buffers for "
+		"sweep %d.\n", getpid(), s);
+	status = SIGMET_MEM_FAIL;
+	goto done;
+    }
+    for (r = 0; r < num_rays; r++) {
+	v = vals + (size_t)r * num_bins;
+	n = vol_p->ray_hdr[s][r].ok ? vol_p->ray_hdr[s][r].num_bins : 0;
+	if ( n > 0 ) {
+	    f = fld_ray_get(vol_p, arg_p->dat_p, s, r, v);
+	    if ( f != v ) {
+		memcpy(v, f, n * sizeof(float));
+	    }
+	}
+	for (b = n; b < num_bins; b++) {
+	    v[b] = NAN;
+	}
+	for (b = 0; b < n; b++) {
+	    v[b] = isfinite(v[b]) ? v[b] : NAN;
+	}
+    }
+    if ( !(arg_p->filter == SIGMET_BOXCAR
+		? filter_boxcar(vol_p, s, arg_p, vals, out)
+		: filter_median(vol_p, s, arg_p, vals, out)) ) {
+	fprintf(stderr, "%d: could not allocate filter for sweep %d.\n",
+		getpid(), s);
+	status = SIGMET_MEM_FAIL;
+	goto done;
+    }
+    for (r = 0; r < num_rays; r++) {
+	if ( vol_p->ray_hdr[s][r].ok ) {
+	    fld_ray_put(arg_p->out_p, s, r, out + (size_t)r * num_bins,
+		    vol_p->ray_hdr[s][r].num_bins);
+	}
+    }
+
+done:
+    FREE(out);
+    FREE(vals);
+    return status;
 }
 
 /*
-   get / print task_calib_info.
+   Return the index of ray r of a sweep of vol_p, where r may be outside
+   the sweep. Rays wrap around in continuous PPI sweeps. Return -1 if there
+   is no such ray.
  */
 
-struct Sigmet_Task_Calib_Info get_task_calib_info(char *rec)
-{
-    struct Sigmet_Task_Calib_Info tci;
-
-    tci.dbz_slope = get_sint16(rec + 0);
-    tci.dbz_noise_thresh = get_sint16(rec + 2);
-    tci.clutter_corr_thesh = get_sint16(rec + 4);
-    tci.sqi_thresh = get_sint16(rec + 6);
-    tci.pwr_thresh = get_sint16(rec + 8);
-    tci.cal_dbz = get_sint16(rec + 18);
-    tci.dbt_flags = get_uint16(rec + 20);
-    tci.dbz_flags = get_uint16(rec + 22);
-    tci.vel_flags = get_uint16(rec + 24);
-    tci.sw_flags = get_uint16(rec + 26);
-    tci.zdr_flags = get_uint16(rec + 28);
-    tci.flags = get_uint16(rec + 36);
-    tci.ldr_bias = get_sint16(rec + 40);
-    tci.zdr_bias = get_sint16(rec + 42);
-    tci.nx_clutter_thresh = get_sint16(rec + 44);
-    tci.nx_clutter_skip = get_uint16(rec + 46);
-    tci.hpol_io_cal = get_sint16(rec + 48);
-    tci.vpol_io_cal = get_sint16(rec + 50);
-    tci.hpol_noise = get_sint16(rec + 52);
-    tci.vpol_noise = get_sint16(rec + 54);
-    tci.hpol_radar_const = get_sint16(rec + 56);
-    tci.vpol_radar_const = get_sint16(rec + 58);
-    tci.bandwidth = get_uint16(rec + 60);
-    tci.flags2 = get_uint16(rec + 62);
-    return tci;
-}
-
-void print_task_calib_info(FILE *out, char *pfx,
-	struct Sigmet_Task_Calib_Info tci)
+static int filter_ray(struct Sigmet_Vol *vol_p, int r)
 {
-    char prefix[STR_LEN];
-    char *desc;
+    int num_rays = vol_p->ih.ic.num_rays;
 
-    snprintf(prefix, STR_LEN, "%s%s", pfx, "<task_calib_info>.");
-    print_i(out, tci.dbz_slope, prefix, "dbz_slope",
-	    "Reflectivity slope (4096*dB/ A/D count)");
-    print_i(out, tci.dbz_noise_thresh, prefix, "dbz_noise_thresh",
-	    "Reflectivity noise threshold (1/16 dB above Noise)");
-    print_i(out, tci.clutter_corr_thesh, prefix, "clutter_corr_thesh",
-	    "Clutter Correction threshold (1/16 dB)");
-    print_i(out, tci.sqi_thresh, prefix, "sqi_thresh",
-	    "SQI threshold (01)*256");
-    print_i(out, tci.pwr_thresh, prefix, "pwr_thresh",
-	    "Power threshold (1/16 dBZ)");
-    print_i(out, tci.cal_dbz, prefix, "cal_dbz",
-	    "Calibration Reflectivity (1/16 dBZ at 1 km)");
-    print_u(out, tci.dbt_flags, prefix, "dbt_flags",
-	    "Threshold flags for uncorrected reflectivity");
-    print_u(out, tci.dbz_flags, prefix, "dbz_flags",
-	    "Threshold flags for corrected reflectivity");
-    print_u(out, tci.vel_flags, prefix, "vel_flags",
-	    "Threshold flags for velocity");
-    print_u(out, tci.sw_flags, prefix, "sw_flags",
-	    "Threshold flags for width");
-    print_u(out, tci.zdr_flags, prefix, "zdr_flags",
-	    "Threshold flags for ZDR");
-    desc = "Flags. Bits: 0: Speckle remover for log channel 3: Speckle"
-	" remover for linear channel 4:  data is range normalized 5:  pulse"
-	" at beginning of ray 6:  pulse at end of ray 7: Vary number of"
-	" pulses in dual PRF 8: Use 3 lag processing in PP02 9: Apply vel"
-	" correction for ship motion 10: Vc is unfolded 11: Vc has fallspeed"
-	" correction 12: Zc has beam blockage correction 13: Zc has Z-based"
-	" attenuation correction 14: Zc has target detection 15: Vc has storm"
-	" relative vel correction";
-    print_u(out, tci.flags, prefix, "flags", desc);
-    print_i(out, tci.ldr_bias, prefix, "ldr_bias",
-	    "LDR bias in signed 1/100 dB");
-    print_i(out, tci.zdr_bias, prefix, "zdr_bias",
-	    "ZDR bias in signed 1/16 dB");
-    print_i(out, tci.nx_clutter_thresh, prefix, "nx_clutter_thresh",
-	    "NEXRAD point clutter threshold in 1/100 of dB");
-    print_u(out, tci.nx_clutter_skip, prefix, "nx_clutter_skip",
-	    "NEXRAD point clutter bin skip in low 4 bits");
-    print_i(out, tci.hpol_io_cal, prefix, "hpol_io_cal",
-	    "I0 cal value, horizontal pol, in 1/100 dBm");
-    print_i(out, tci.vpol_io_cal, prefix, "vpol_io_cal",
-	    "I0 cal value, vertical pol, in 1/100 dBm");
-    print_i(out, tci.hpol_noise, prefix, "hpol_noise",
-	    "Noise at calibration, horizontal pol, in 1/100 dBm");
-    print_i(out, tci.vpol_noise, prefix, "vpol_noise",
-	    "Noise at calibration, vertical pol, in 1/100 dBm");
-    print_i(out, tci.hpol_radar_const, prefix, "hpol_radar_const",
-	    "Radar constant, horizontal pol, in 1/100 dB");
-    print_i(out, tci.vpol_radar_const, prefix, "vpol_radar_const",
-	    "Radar constant, vertical pol, in 1/100 dB");
-    print_u(out, tci.bandwidth, prefix, "bandwidth",
-	    "Receiver bandwidth in kHz");
-    print_x(out, tci.flags2, prefix, "flags2",
-	    "Flags2: Bit 0: Zc and ZDRc has DP attenuation correction"
-	    " Bit 1: Z and ZDR has DP attenuation correction");
+    if ( vol_p->ih.tc.tni.scan_mode == PPI_C ) {
+	return (r % num_rays + num_rays) % num_rays;
+    }
+    return (r >= 0 && r < num_rays) ? r : -1;
 }
 
 /*
-   get / print task_range_info.
+   Return the number of rays on either side of a gate in a filter window
+   d_ray rays wide in vol_p. A window that wraps around a continuous PPI
+   sweep must not include a ray twice.
  */
 
-struct Sigmet_Task_Range_Info get_task_range_info(char *rec)
+static int filter_d_ray(struct Sigmet_Vol *vol_p, int d_ray)
 {
-    struct Sigmet_Task_Range_Info tri;
+    int num_rays = vol_p->ih.ic.num_rays;
 
-    tri.rng_1st_bin = get_sint32(rec + 0);
-    tri.rng_last_bin = get_sint32(rec + 4);
-    tri.num_bins_in = get_sint16(rec + 8);
-    tri.num_bins_out = get_sint16(rec + 10);
-    tri.step_in = get_sint32(rec + 12);
-    tri.step_out = get_sint32(rec + 16);
-    tri.flag = get_uint16(rec + 20);
-    tri.rng_avg_flag = get_sint16(rec + 22);
-    return tri;
+    if ( vol_p->ih.tc.tni.scan_mode == PPI_C && 2 * d_ray + 1 > num_rays ) {
+	d_ray = (num_rays - 1) / 2;
+    }
+    return d_ray;
 }
 
-void print_task_range_info(FILE *out, char *pfx,
-	struct Sigmet_Task_Range_Info tri)
+/*
+   Add (c = 1) or subtract (c = -1) the values in ray r of vals, which has
+   rays of num_bins values, to colsum and colcnt for filter_boxcar. Do
+   nothing if r is -1.
+ */
+
+static void filter_box_ray(const float *vals, int r, int num_bins,
+	double *colsum, int *colcnt, int c)
 {
-    char prefix[STR_LEN];
+    const float *v;
+    int b;
 
-    snprintf(prefix, STR_LEN, "%s%s", pfx, "<task_range_info>.");
-    print_i(out, tri.rng_1st_bin, prefix, "rng_1st_bin",
-	    "Range of first bin in centimeters");
-    print_i(out, tri.rng_last_bin, prefix, "rng_last_bin",
-	    "Range of last bin in centimeters");
-    print_i(out, tri.num_bins_in, prefix, "num_bins_in",
-	    "Number of input bins");
-    print_i(out, tri.num_bins_out, prefix, "num_bins_out",
-	    "Number of output range bins");
-    print_i(out, tri.step_in, prefix, "step_in",
-	    "Step between input bins");
-    print_i(out, tri.step_out, prefix, "step_out",
-	    "Step between output bins (in centimeters)");
-    print_u(out, tri.flag, prefix, "flag",
-	    "Flag for variable range bin spacing (1=var, 0=fixed)");
-    print_i(out, tri.rng_avg_flag, prefix, "rng_avg_flag",
-	    "Range bin averaging flag");
+    if ( r == -1 ) {
+	return;
+    }
+    v = vals + (size_t)r * num_bins;
+    for (b = 0; b < num_bins; b++) {
+	if ( v[b] == v[b] ) {
+	    colsum[b] += c * v[b];
+	    colcnt[b] += c;
+	}
+    }
 }
 
 /*
-   get / print task_scan_info.
+   Boxcar filter for filter_swp. vals has the values for sweep s, with
+   NAN for no data. Put the means into out, which has the same shape.
+   colsum[b] and colcnt[b] hold the total and the number of values at bin
+   b in the rays of the window. They slide from ray to ray by adding one
+   ray and dropping another, and the window slides along each ray with a
+   running total, so cost does not depend on the size of the window. The
+   totals are doubles, so rounding from sliding them stays far below float
+   precision. Return false if memory is short.
  */
 
-struct Sigmet_Task_Scan_Info get_task_scan_info(char *rec)
+static int filter_boxcar(struct Sigmet_Vol *vol_p, int s,
+	struct filter_arg *arg_p, const float *vals, float *out)
 {
-    struct Sigmet_Task_Scan_Info tsi;
+    int num_rays, num_bins;
+    int d_bin = arg_p->d_bin, d_ray;
+    double *colsum, sum;
+    int *colcnt, cnt;
+    const float *v;
+    float *o;
+    int r, b, k, n;
+    int status = 0;
 
-    tsi.scan_mode = get_uint16(rec + 0);
-    tsi.resoln = get_sint16(rec + 2);
-    tsi.num_sweeps = get_sint16(rec + 6);
-    switch (tsi.scan_mode) {
-	case RHI:
-	    tsi.scan_info.rhi_info = get_task_rhi_scan_info(rec + 8);
-	    break;
-	case PPI_S:
-	case PPI_C:
-	    tsi.scan_info.ppi_info = get_task_ppi_scan_info(rec + 8);
-	    break;
-	case FILE_SCAN:
-	    tsi.scan_info.file_info = get_task_file_scan_info(rec + 8);
-	    break;
-	case MAN_SCAN:
-	    tsi.scan_info.man_info = get_task_manual_scan_info(rec + 8);
-	    break;
+    num_rays = vol_p->ih.ic.num_rays;
+    num_bins = vol_p->ih.tc.tri.num_bins_out;
+    d_ray = filter_d_ray(vol_p, arg_p->d_ray);
+    colsum = CALLOC(num_bins, sizeof(double));
+    colcnt = CALLOC(num_bins, sizeof(int));
+    if ( !colsum || !colcnt ) {
+	goto done;
     }
-    return tsi;
+    for (k = -d_ray; k <= d_ray; k++) {
+	filter_box_ray(vals, filter_ray(vol_p, k), num_bins,
+		colsum, colcnt, 1);
+    }
+    for (r = 0; r < num_rays; r++) {
+	if ( vol_p->ray_hdr[s][r].ok ) {
+	    v = vals + (size_t)r * num_bins;
+	    o = out + (size_t)r * num_bins;
+	    n = vol_p->ray_hdr[s][r].num_bins;
+	    for (sum = 0.0, cnt = 0, b = 0; b < d_bin && b < num_bins; b++) {
+		sum += colsum[b];
+		cnt += colcnt[b];
+	    }
+	    for (b = 0; b < n; b++) {
+		if ( b + d_bin < num_bins ) {
+		    sum += colsum[b + d_bin];
+		    cnt += colcnt[b + d_bin];
+		}
+		if ( b - d_bin - 1 >= 0 ) {
+		    sum -= colsum[b - d_bin - 1];
+		    cnt -= colcnt[b - d_bin - 1];
+		}
+		o[b] = (v[b] == v[b] && cnt > 0) ? sum / cnt : NAN;
+	    }
+	}
+
+	/*
+	   Slide the column totals to ray r + 1.
+	 */
+
+	filter_box_ray(vals, filter_ray(vol_p, r + d_ray + 1), num_bins,
+		colsum, colcnt, 1);
+	filter_box_ray(vals, filter_ray(vol_p, r - d_ray), num_bins,
+		colsum, colcnt, -1);
+    }
+    status = 1;
+
+done:
+    FREE(colcnt);
+    FREE(colsum);
+    return status;
 }
 
-void print_task_scan_info(FILE *out, char *pfx,
-	struct Sigmet_Task_Scan_Info tsi)
+/*
+   Add (c = 1) or remove (c = -1) the values in bins b0 through b1 of ray r
+   to or from the window of m. Bins outside the sweep are ignored. Do
+   nothing if r is -1.
+ */
+
+static void flt_med_add(struct flt_med *m, int r, int b0, int b1, int c)
 {
-    char prefix[STR_LEN];
+    const int *q;
+    int b, j;
 
-    snprintf(prefix, STR_LEN, "%s%s", pfx, "<task_scan_info>.");
-    print_u(out, tsi.scan_mode, prefix, "scan_mode",
-	    "Antenna scan mode 1:PPI sector, 2:RHI, 3:Manual,"
-	    " 4:PPI cont, 5:file");
-    print_i(out, tsi.resoln, prefix, "resoln",
-	    "Desired angular resolution in 1/1000 of degrees");
-    print_i(out, tsi.num_sweeps, prefix, "num_sweeps",
-	    "Number of sweeps to perform");
-    switch (tsi.scan_mode) {
-	case RHI:
-	    print_task_rhi_scan_info(out, prefix, tsi.scan_info.rhi_info);
-	    break;
-	case PPI_S:
-	case PPI_C:
-	    print_task_ppi_scan_info(out, prefix, tsi.scan_info.ppi_info);
-	    break;
-	case FILE_SCAN:
-	    print_task_file_scan_info(out, prefix, tsi.scan_info.file_info);
-	    break;
-	case MAN_SCAN:
-	    print_task_manual_scan_info(out, prefix, tsi.scan_info.man_info);
-	    break;
+    if ( r == -1 ) {
+	return;
+    }
+    b0 = (b0 > 0) ? b0 : 0;
+    b1 = (b1 < m->num_bins - 1) ? b1 : m->num_bins - 1;
+    for (q = m->rank + (size_t)r * m->num_bins, b = b0; b <= b1; b++) {
+	if ( q[b] >= 0 ) {
+	    for (j = q[b] + 1; j <= m->n_srt; j += j & -j) {
+		m->tree[j] += c;
+	    }
+	    m->cnt += c;
+	}
     }
 }
 
 /*
-   get / print task_rhi_scan_info.
+   Move the window of m, centered at ray r, bin b of a sweep in vol_p,
+   one step. Exactly one of dr and db is 1 or -1, and the other is 0. A
+   step along the rays touches 2 * d_bin + 1 bins in each of two rays, and
+   a step along the bins touches one bin in each of 2 * (2 * d_ray + 1)
+   rays.
  */
 
-struct Sigmet_Task_RHI_Scan_Info get_task_rhi_scan_info(char *rec)
+static void flt_med_move(struct Sigmet_Vol *vol_p, struct flt_med *m,
+	int r, int b, int d_ray, int d_bin, int dr, int db)
 {
-    struct Sigmet_Task_RHI_Scan_Info trsi;
-    char *p, *p1;
-    unsigned *q;
+    int k, q;
 
-    trsi.lo_elev = get_uint16(rec + 0);
-    trsi.hi_elev = get_uint16(rec + 2);
-    q = trsi.az;
-    p = rec + 4;
-    p1 = p + sizeof(U16BIT) * 40;
-    for ( ; p < p1; p += sizeof(U16BIT), q++) {
-	*q = get_uint16(p);
+    if ( dr != 0 ) {
+	flt_med_add(m, filter_ray(vol_p, r + dr * (d_ray + 1)),
+		b - d_bin, b + d_bin, 1);
+	flt_med_add(m, filter_ray(vol_p, r - dr * d_ray),
+		b - d_bin, b + d_bin, -1);
+    } else {
+	for (k = -d_ray; k <= d_ray; k++) {
+	    q = filter_ray(vol_p, r + k);
+	    flt_med_add(m, q, b + db * (d_bin + 1), b + db * (d_bin + 1), 1);
+	    flt_med_add(m, q, b - db * d_bin, b - db * d_bin, -1);
+	}
     }
-    trsi.start = *(unsigned char *)(rec + 199);
-    return trsi;
 }
 
-void print_task_rhi_scan_info(FILE *out, char *pfx,
-	struct Sigmet_Task_RHI_Scan_Info trsi)
+/*
+   Return the median of the values in the window of m, or NAN if it is
+   empty. The values with 0 based ranks (cnt - 1) / 2 and cnt / 2 in the
+   window are found by descending the tree. They are the same if cnt is
+   odd.
+ */
+
+static float flt_med_get(struct flt_med *m)
 {
-    int n;
-    char prefix[STR_LEN];
+    int kth[2], c, j, w, q;
 
-    snprintf(prefix, STR_LEN, "%s%s", pfx, "<rhi_scan_info>.");
-    print_u(out, trsi.lo_elev, prefix, "lo_elev",
-	    "Lower elevation limit (binary angle, only for sector)");
-    print_u(out, trsi.hi_elev, prefix, "hi_elev",
-	    "Upper elevation limit (binary angle, only for sector)");
-    for (n = 0; n < 40; n++) {
-	fprintf(out, "%u" FS "%s%s%d%s" FS "%s\n", trsi.az[n], prefix,
-		"az[", n, "]", "List of azimuths (binary angles) to scan at");
+    if ( m->cnt == 0 ) {
+	return NAN;
     }
-    print_u(out, trsi.start, prefix, "start",
-	    "Start of first sector sweep: 0=Nearest, 1=Lower,"
-	    " 2=Upper Sector sweeps alternate in direction.");
+    kth[0] = (m->cnt - 1) / 2;
+    kth[1] = m->cnt / 2;
+    for (c = 0; c < 2 - (m->cnt % 2); c++) {
+	for (j = 0, w = m->top, q = kth[c]; w > 0; w /= 2) {
+	    if ( j + w <= m->n_srt && m->tree[j + w] <= q ) {
+		j += w;
+		q -= m->tree[j];
+	    }
+	}
+	kth[c] = j;
+    }
+    kth[1] = (m->cnt % 2) ? kth[0] : kth[1];
+    return (m->srt[kth[0]] + m->srt[kth[1]]) / 2;
 }
 
 /*
-   get / print task_ppi_scan_info.
+   Median filter for filter_swp. vals has the values for sweep s, with NAN
+   for no data. Put the medians into out, which has the same shape.
+
+   The distinct values in the sweep are sorted once, and each bin is
+   replaced with the rank of its value (see flt_rank). The window is a
+   Fenwick tree of counts indexed by rank. Adding or removing a value,
+   and finding the k-th smallest value in the window, cost O(log n),
+   where n is the number of distinct values.
+
+   The window is filled once, and then slides over the whole sweep in a
+   serpentine path, one gate at a time, so it is never rebuilt. The path
+   runs along the shorter side of the window, so each step adds and
+   removes 2 * min(d_bin, d_ray) + 1 values. For a window that is one bin
+   or one ray wide, cost does not depend on the size of the window.
+   Return false if memory is short.
  */
 
-struct Sigmet_Task_PPI_Scan_Info get_task_ppi_scan_info(char *rec)
+static int filter_median(struct Sigmet_Vol *vol_p, int s,
+	struct filter_arg *arg_p, const float *vals, float *out)
 {
-    struct Sigmet_Task_PPI_Scan_Info tpsi;
-    char *p, *p1;
-    unsigned *q;
+    int num_rays, num_bins;
+    size_t num_vals;
+    int d_bin = arg_p->d_bin, d_ray;
+    struct flt_med m;
+    int *rank = NULL;
+    int along_bins;			/* If true, path runs along rays */
+    int n_out, n_in;			/* Path length across and along */
+    int r, b, i, j, k, dir;
+    size_t g;
+    int status = 0;
 
-    tpsi.left_az = get_uint16(rec + 0);
-    tpsi.right_az = get_uint16(rec + 2);
-    q = tpsi.elevs;
-    p = rec + 4;
-    p1 = p + sizeof(U16BIT) * 40;
-    for ( ; p < p1; p += sizeof(U16BIT), q++) {
-	*q = get_uint16(p);
+    num_rays = vol_p->ih.ic.num_rays;
+    num_bins = vol_p->ih.tc.tri.num_bins_out;
+    num_vals = (size_t)num_rays * num_bins;
+    d_ray = filter_d_ray(vol_p, arg_p->d_ray);
+    m.srt = MALLOC(num_vals * sizeof(float));
+    m.tree = NULL;
+    rank = MALLOC(num_vals * sizeof(int));
+    if ( !m.srt || !rank
+	    || (m.n_srt = flt_rank(vals, num_vals, m.srt, rank)) == -1 ) {
+	goto done;
     }
-    tpsi.start = *(unsigned char *)(rec + 199);
-    return tpsi;
+    if ( !(m.tree = CALLOC(m.n_srt + 1, sizeof(int))) ) {
+	goto done;
+    }
+    for (m.top = 1; m.top * 2 <= m.n_srt; m.top *= 2) {
+    }
+    m.rank = rank;
+    m.num_bins = num_bins;
+    m.cnt = 0;
+
+    /*
+       Fill the window at ray 0, bin 0, then walk the sweep. The path
+       turns around at the end of each ray (or bin), so that the window
+       only moves one gate at a time.
+     */
+
+    for (k = -d_ray; k <= d_ray; k++) {
+	flt_med_add(&m, filter_ray(vol_p, k), -d_bin, d_bin, 1);
+    }
+    along_bins = (d_ray <= d_bin);
+    n_out = along_bins ? num_rays : num_bins;
+    n_in = along_bins ? num_bins : num_rays;
+    for (r = 0, b = 0, i = 0; i < n_out; i++) {
+	dir = (i % 2 == 0) ? 1 : -1;
+	for (j = 0; j < n_in; j++) {
+	    g = (size_t)r * num_bins + b;
+	    out[g] = (rank[g] >= 0) ? flt_med_get(&m) : NAN;
+	    if ( j + 1 < n_in ) {
+		if ( along_bins ) {
+		    flt_med_move(vol_p, &m, r, b, d_ray, d_bin, 0, dir);
+		    b += dir;
+		} else {
+		    flt_med_move(vol_p, &m, r, b, d_ray, d_bin, dir, 0);
+		    r += dir;
+		}
+	    }
+	}
+	if ( i + 1 < n_out ) {
+	    if ( along_bins ) {
+		flt_med_move(vol_p, &m, r, b, d_ray, d_bin, 1, 0);
+		r++;
+	    } else {
+		flt_med_move(vol_p, &m, r, b, d_ray, d_bin, 0, 1);
+		b++;
+	    }
+	}
+    }
+    status = 1;
+
+done:
+    FREE(m.tree);
+    FREE(rank);
+    FREE(m.srt);
+    return status;
 }
 
-void print_task_ppi_scan_info(FILE *out, char *pfx,
-	struct Sigmet_Task_PPI_Scan_Info tpsi)
-{
-    int n;
-    char prefix[STR_LEN];
-    char struct_path[STR_LEN];
+/*
+   Put the distinct values of the n values in vals, which may include NAN,
+   into srt in ascending order. Put the index in srt of vals[i] into
+   rank[i], or -1 if vals[i] is NAN. Return the number of distinct values,
+   or -1 if memory is short.
+
+   Values are sorted with their indeces by a radix sort of their bits, which
+   takes O(n) time. Flipping the bits of negative values, and the sign bit of
+   others, makes the bits sort in the same order as the values.
+ */
 
-    snprintf(prefix, STR_LEN, "%s%s", pfx, "<task_ppi_scan_info>.");
-    print_u(out, tpsi.left_az, prefix, "left_az",
-	    "Left azimuth limit (binary angle, only for sector)");
-    print_u(out, tpsi.right_az, prefix, "right_az",
-	    "Right azimuth limit (binary angle, only for sector)");
-    for (n = 0; n < 40; n++) {
-	snprintf(struct_path, STR_LEN, "%s%s%d%s", prefix, "elevs[", n,
-		"]");
-	fprintf(out, "%u" FS "%s" FS "%s\n", tpsi.elevs[n], struct_path,
-		"List of elevations (binary angles) to scan at");
+static int flt_rank(const float *vals, size_t n, float *srt, int *rank)
+{
+    unsigned long long *ki = NULL, *ki2 = NULL, *t;
+					/* Bits of value in high word, index
+					   in low word */
+    size_t cnt[256], sum, m, i;
+    U32BIT u, u0 = 0;
+    float v;
+    int d, n_srt = -1;
+
+    ki = MALLOC(n * sizeof(unsigned long long));
+    ki2 = MALLOC(n * sizeof(unsigned long long));
+    if ( !ki || !ki2 ) {
+	goto done;
+    }
+    for (m = 0, i = 0; i < n; i++) {
+	rank[i] = -1;
+	if ( vals[i] == vals[i] ) {
+	    v = (vals[i] == 0.0) ? 0.0 : vals[i];
+	    memcpy(&u, &v, sizeof(u));
+	    u = (u & 0x80000000U) ? ~u : u | 0x80000000U;
+	    ki[m++] = (unsigned long long)u << 32 | i;
+	}
+    }
+    for (d = 32; d < 64; d += 8) {
+	memset(cnt, 0, sizeof(cnt));
+	for (i = 0; i < m; i++) {
+	    cnt[(ki[i] >> d) & 0xFF]++;
+	}
+	for (sum = 0, i = 0; i < 256; i++) {
+	    sum += cnt[i];
+	    cnt[i] = sum - cnt[i];
+	}
+	for (i = 0; i < m; i++) {
+	    ki2[cnt[(ki[i] >> d) & 0xFF]++] = ki[i];
+	}
+	t = ki;
+	ki = ki2;
+	ki2 = t;
+    }
+    for (n_srt = 0, i = 0; i < m; i++) {
+	u = ki[i] >> 32;
+	if ( n_srt == 0 || u != u0 ) {
+	    srt[n_srt++] = vals[ki[i] & 0xFFFFFFFFU];
+	    u0 = u;
+	}
+	rank[ki[i] & 0xFFFFFFFFU] = n_srt - 1;
     }
-    print_u(out, tpsi.start, prefix, "start",
-	    "Start of first sector sweep: 0=Nearest, 1=Left, 2=Right Sector"
-	    " sweeps alternate in direction.");
+
+done:
+    FREE(ki2);
+    FREE(ki);
+    return n_srt;
 }
 
 /*
-   get / print task_file_scan_info.
+   Unfold velocities in sweep s for Sigmet_Vol_Fld_Dealias. s_prev is the
+   previous good sweep, already unfolded, or -1.
  */
 
-struct Sigmet_Task_File_Scan_Info get_task_file_scan_info(char *rec)
+static void dealias_swp(struct Sigmet_Vol *vol_p, int s, int s_prev,
+	struct dealias_arg *arg_p)
 {
-    struct Sigmet_Task_File_Scan_Info tfsi;
+    int num_rays, num_bins;
+    int seed;				/* If true, use previous sweep */
+    double nyq2 = arg_p->nyq2;
+    float *cur = arg_p->cur;
+    float *v;				/* Input velocities */
+    float *prev;			/* Unfolded previous ray, or NULL */
+    float *ps;				/* Unfolded ray from previous sweep,
+					   or NULL */
+    float u, last;			/* Unfolded value, last one in ray */
+    double ref, sum;			/* Reference value */
+    int r, r_p, b, n, k;
 
-    tfsi.az0 = get_uint16(rec + 0);
-    tfsi.elev0 = get_uint16(rec + 2);
-    memcpy(tfsi.ant_ctrl, rec + 4, 12);
-    trimRight(tfsi.ant_ctrl, 12);
-    return tfsi;
+    num_rays = vol_p->ih.ic.num_rays;
+    num_bins = vol_p->ih.tc.tri.num_bins_out;
+    seed = s_prev >= 0 && (vol_p->ih.tc.tni.scan_mode == PPI_S
+	    || vol_p->ih.tc.tni.scan_mode == PPI_C)
+	&& dealias_near(vol_p, s_prev, arg_p->near);
+    for (prev = NULL, r = 0; r < num_rays; r++) {
+	for (b = 0; b < num_bins; b++) {
+	    cur[b] = NAN;
+	}
+	if ( !vol_p->ray_hdr[s][r].ok ) {
+	    fld_ray_put(arg_p->out_p, s, r, cur, num_bins);
+	    prev = NULL;
+	    continue;
+	}
+	n = vol_p->ray_hdr[s][r].num_bins;
+	v = fld_ray_get(vol_p, arg_p->dat_p, s, r, arg_p->in_buf);
+	ps = NULL;
+	if ( seed ) {
+	    r_p = arg_p->near[dealias_cell(vol_p, s, r)];
+	    if ( r_p >= 0 ) {
+		ps = fld_ray_get(vol_p, arg_p->out_p, s_prev, r_p,
+			arg_p->ref_buf);
+	    }
+	}
+	for (last = NAN, b = 0; b < n; b++) {
+	    if ( !isfinite(v[b]) ) {
+		continue;
+	    }
+	    sum = 0.0;
+	    k = 0;
+	    if ( b > 0 && isfinite(cur[b - 1]) ) {
+		sum += cur[b - 1];
+		k++;
+	    }
+	    if ( prev && isfinite(prev[b]) ) {
+		sum += prev[b];
+		k++;
+	    }
+	    if ( k > 0 ) {
+		ref = sum / k;
+	    } else if ( ps && isfinite(ps[b]) ) {
+		ref = ps[b];
+	    } else {
+		ref = last;
+	    }
+	    u = v[b];
+	    if ( isfinite(ref) ) {
+		u += nyq2 * floor((ref - u) / nyq2 + 0.5);
+	    }
+	    cur[b] = last = u;
+	}
+	fld_ray_put(arg_p->out_p, s, r, cur, num_bins);
+	prev = fld_ray_get(vol_p, arg_p->out_p, s, r, arg_p->prev_buf);
+    }
 }
 
-void print_task_file_scan_info(FILE *out, char *pfx,
-	struct Sigmet_Task_File_Scan_Info tfsi)
+/*
+   Fill near with the rays of sweep s nearest to each of num_rays azimuths
+   around the circle. Return false if the sweep has no good rays.
+ */
+
+static int dealias_near(struct Sigmet_Vol *vol_p, int s, int *near)
 {
-    char prefix[STR_LEN];
+    int num_rays = vol_p->ih.ic.num_rays;
+    int r, i, last;
 
-    snprintf(prefix, STR_LEN, "%s%s", pfx, "<task_file_scan_info>.");
-    print_u(out, tfsi.az0, prefix, "az0",
-	    "First azimuth angle (binary angle)");
-    print_u(out, tfsi.elev0, prefix, "elev0",
-	    "First elevation angle (binary angle)");
-    print_s(out, tfsi.ant_ctrl, prefix, "ant_ctrl",
-	    "Filename for antenna control");
+    for (i = 0; i < num_rays; i++) {
+	near[i] = -1;
+    }
+    for (r = 0; r < num_rays; r++) {
+	if ( vol_p->ray_hdr[s][r].ok ) {
+	    near[dealias_cell(vol_p, s, r)] = r;
+	}
+    }
+
+    /*
+       Give empty cells the ray from the cell before them, going around the
+       circle twice so that cells before the first ray are filled.
+     */
+
+    for (last = -1, i = 0; i < 2 * num_rays; i++) {
+	if ( near[i % num_rays] >= 0 ) {
+	    last = near[i % num_rays];
+	} else {
+	    near[i % num_rays] = last;
+	}
+    }
+    return last >= 0;
 }
 
 /*
-   get / print task_manual_scan_info.
+   Return the index of the cell, 0 to num_rays - 1, that contains the
+   azimuth at the center of ray r of sweep s.
  */
 
-struct Sigmet_Task_Manual_Scan_Info get_task_manual_scan_info(char *rec)
+static int dealias_cell(struct Sigmet_Vol *vol_p, int s, int r)
 {
-    struct Sigmet_Task_Manual_Scan_Info tmsi;
+    int num_rays = vol_p->ih.ic.num_rays;
+    double az0, az1;
+    int i;
 
-    tmsi.flags = get_uint16(rec + 0);
-    return tmsi;
+    az0 = vol_p->ray_hdr[s][r].az0;
+    az1 = GeogLonR(vol_p->ray_hdr[s][r].az1, az0);
+    i = GeogLonR(0.5 * (az0 + az1), M_PI) / (2.0 * M_PI) * num_rays;
+    return (i < 0) ? 0 : (i >= num_rays) ? num_rays - 1 : i;
 }
 
-void print_task_manual_scan_info(FILE *out, char *pfx,
-	struct Sigmet_Task_Manual_Scan_Info tmsi)
+/*
+   fld_swp_fn for Sigmet_Vol_Fld_Despeckle. arg points to a struct
+   despeckle_arg. Flag the gates with data in sweep s, then slide the
+   window along each ray. colsum[b] holds the number of flagged gates at
+   bin b in the rays of the window, so moving the window costs a few
+   additions, whatever its size.
+ */
+
+static enum SigmetStatus despeckle_swp(struct Sigmet_Vol *vol_p, int s,
+	void *arg)
 {
-    char prefix[STR_LEN];
+    struct despeckle_arg *arg_p = arg;
+    struct Sigmet_Dat *dat_p = arg_p->dat_p;
+    U1BYT *tbl = arg_p->tbl;
+    int d_bin = arg_p->d_bin, d_ray = arg_p->d_ray;
+    int num_rays, num_bins;
+    int wrap;				/* If true, rays wrap around */
+    U1BYT *flags = NULL;		/* flags[r * num_bins + b] is true if
+					   ray r, bin b has data */
+    U1BYT *fl, *blank = NULL;		/* If blank[b], blank bin b */
+    int *colsum = NULL;
+    int r, r1, b, k, n, win;
+    U1BYT *u1;
+    U2BYT *u2;
+    float *f;
 
-    snprintf(prefix, STR_LEN, "%s%s", pfx, "<task_manual_scan_info>.");
-    print_x(out, tmsi.flags, prefix, "flags",
-	    "Flags: bit 0=Continuous recording");
+    num_rays = vol_p->ih.ic.num_rays;
+    num_bins = vol_p->ih.tc.tri.num_bins_out;
+    wrap = (vol_p->ih.tc.tni.scan_mode == PPI_C);
+    if ( wrap && 2 * d_ray + 1 > num_rays ) {
+	d_ray = (num_rays - 1) / 2;
+    }
+    flags = CALLOC((size_t)num_rays * num_bins, 1);
+    blank = CALLOC(num_bins, 1);
+    colsum = CALLOC(num_bins, sizeof(int));
+    if ( !flags || !blank || !colsum ) {
+	fprintf(stderr, "%d: could not allocate despeckle buffers for "
+		"sweep %d.\n", getpid(), s);
+	FREE(flags);
+	FREE(blank);
+	FREE(colsum);
+	return SIGMET_MEM_FAIL;
+    }
+    for (r = 0; r < num_rays; r++) {
+	if ( !vol_p->ray_hdr[s][r].ok ) {
+	    continue;
+	}
+	n = vol_p->ray_hdr[s][r].num_bins;
+	fl = flags + (size_t)r * num_bins;
+	switch (dat_p->stor_fmt) {
+	    case SIGMET_U1:
+		u1 = SIGMET_DAT_U1(dat_p, s, r);
+		for (b = 0; b < n; b++) {
+		    fl[b] = tbl[u1[b]];
+		}
+		break;
+	    case SIGMET_U2:
+	    case SIGMET_F16:
+		u2 = SIGMET_DAT_U2(dat_p, s, r);
+		for (b = 0; b < n; b++) {
+		    fl[b] = tbl[u2[b]];
+		}
+		break;
+	    case SIGMET_FLT:
+		f = SIGMET_DAT_FLT(dat_p, s, r);
+		for (b = 0; b < n; b++) {
+		    fl[b] = !isnan(f[b]);
+		}
+		break;
+	    case SIGMET_DBL:
+	    case SIGMET_MT:
+		break;
+	}
+    }
+
+    /*
+       Fill colsum for the window around ray 0, then for each ray, slide
+       the window along the ray, and move it to the next ray.
+     */
+
+    for (k = -d_ray; k <= d_ray; k++) {
+	r1 = wrap ? (k + num_rays) % num_rays : k;
+	if ( r1 >= 0 && r1 < num_rays ) {
+	    fl = flags + (size_t)r1 * num_bins;
+	    for (b = 0; b < num_bins; b++) {
+		colsum[b] += fl[b];
+	    }
+	}
+    }
+    for (r = 0; r < num_rays; r++) {
+	if ( vol_p->ray_hdr[s][r].ok ) {
+	    n = vol_p->ray_hdr[s][r].num_bins;
+	    fl = flags + (size_t)r * num_bins;
+	    for (win = 0, b = 0; b <= d_bin && b < num_bins; b++) {
+		win += colsum[b];
+	    }
+	    for (b = 0; b < n; b++) {
+		blank[b] = fl[b] && win < arg_p->min_count;
+		if ( b + d_bin + 1 < num_bins ) {
+		    win += colsum[b + d_bin + 1];
+		}
+		if ( b - d_bin >= 0 ) {
+		    win -= colsum[b - d_bin];
+		}
+	    }
+	    fld_blank(dat_p, s, r, blank, n);
+	}
+	r1 = r + d_ray + 1;
+	r1 = wrap ? r1 % num_rays : r1;
+	if ( r1 < num_rays ) {
+	    fl = flags + (size_t)r1 * num_bins;
+	    for (b = 0; b < num_bins; b++) {
+		colsum[b] += fl[b];
+	    }
+	}
+	r1 = r - d_ray;
+	r1 = wrap ? (r1 + num_rays) % num_rays : r1;
+	if ( r1 >= 0 ) {
+	    fl = flags + (size_t)r1 * num_bins;
+	    for (b = 0; b < num_bins; b++) {
+		colsum[b] -= fl[b];
+	    }
+	}
+    }
+    FREE(colsum);
+    FREE(blank);
+    FREE(flags);
+    return SIGMET_OK;
 }
 
 /*
-   get / print task_misc_info.
+   Kernels for fld_apply.
  */
 
-struct Sigmet_Task_Misc_Info get_task_misc_info(char *rec)
+static void kern_set(float *f1, const float *f2, int n, float v)
 {
-    struct Sigmet_Task_Misc_Info tmi;
-    char *p, *p1;
-    unsigned *q;
+    int b;
 
-    tmi.wave_len = get_sint32(rec + 0);
-    memcpy(tmi.tr_ser, rec + 4, 16);
-    trimRight(tmi.tr_ser, 16);
-    tmi.power = get_sint32(rec + 20);
-    tmi.flags = get_uint16(rec + 24);
-    tmi.polarization = get_uint16(rec + 26);
-    tmi.trunc_ht = get_sint32(rec + 28);
-    tmi.comment_sz = get_sint16(rec + 62);
-    tmi.horiz_beam_width = get_uint32(rec + 64);
-    tmi.vert_beam_width = get_uint32(rec + 68);
-    q = tmi.custom;
-    p = rec + 72;
-    p1 = p + sizeof(*tmi.custom) * 10;
-    for ( ; p < p1; p += sizeof(*tmi.custom), q++) {
-	*q = get_uint32(p);
+    for (b = 0; b < n; b++) {
+	f1[b] = v;
     }
-    return tmi;
 }
 
-void print_task_misc_info(FILE *out, char *pfx,
-	struct Sigmet_Task_Misc_Info tmi)
+static void kern_copy(float *f1, const float *f2, int n, float v)
 {
-    int n;
-    char prefix[STR_LEN];
-    char struct_path[STR_LEN];
+    int b;
 
-    snprintf(prefix, STR_LEN, "%s%s", pfx, "<task_misc_info>.");
-    print_i(out, tmi.wave_len, prefix, "wave_len",
-	    "Wavelength in 1/100 of cm");
-    print_s(out, tmi.tr_ser, prefix, "tr_ser",
-	    "T/R Serial Number");
-    print_i(out, tmi.power, prefix, "power",
-	    "Transmit Power in watts");
-    print_x(out, tmi.flags, prefix, "flags",
-	    "Flags: Bit 0: Digital signal simulator in use"
-	    " Bit 1: Polarization in use Bit 4: Keep bit");
-    print_u(out, tmi.polarization, prefix, "polarization",
-	    "Type of polarization");
-    print_i(out, tmi.trunc_ht, prefix, "trunc_ht",
-	    "Truncation height (centimeters above the radar)");
-    print_i(out, tmi.comment_sz, prefix, "comment_sz",
-	    "Number of bytes of comments entered");
-    print_u(out, tmi.horiz_beam_width, prefix, "horiz_beam_width",
-	    "Horizontal beamwidth (binary angle, starting in 7.18)");
-    print_u(out, tmi.vert_beam_width, prefix, "vert_beam_width",
-	    "Vertical beamwidth (binary angle, starting in 7.18)");
-    for (n = 0; n < 10; n++) {
-	snprintf(struct_path, STR_LEN, "%s%s%d%s", prefix, "custom[", n, "]");
-	fprintf(out, "%u" FS "%s" FS "%s\n", tmi.custom[n], struct_path,
-		"Customer defined storage (starting in 7.27)");
+    for (b = 0; b < n; b++) {
+	f1[b] = f2[b];
     }
 }
 
-struct Sigmet_Task_End_Info get_task_end_info(char *rec)
+static void kern_add(float *f1, const float *f2, int n, float v)
 {
-    struct Sigmet_Task_End_Info tei;
+    int b;
 
-    tei.task_major = get_sint16(rec + 0);
-    tei.task_minor = get_sint16(rec + 2);
-    memcpy(tei.task_config, rec + 4, 12);
-    trimRight(tei.task_config, 12);
-    memcpy(tei.task_descr, rec + 16, 80);
-    trimRight(tei.task_descr, 80);
-    tei.hybrid_ntasks = get_sint32(rec + 96);
-    tei.task_state = get_uint16(rec + 100);
-    tei.data_time = get_ymds_time(rec + 104);
-    return tei;
+    for (b = 0; b < n; b++) {
+	f1[b] += v;
+    }
 }
 
-void print_task_end_info(FILE *out, char *pfx,
-	struct Sigmet_Task_End_Info tei)
+static void kern_mul(float *f1, const float *f2, int n, float v)
 {
-    char prefix[STR_LEN];
+    int b;
 
-    snprintf(prefix, STR_LEN, "%s%s", pfx, "<task_end_info>.");
-    print_i(out, tei.task_major, prefix, "task_major",
-	    "Task major number");
-    print_i(out, tei.task_minor, prefix, "task_minor",
-	    "Task minor number");
-    print_s(out, tei.task_config, prefix, "task_config",
-	    "Name of task configuration file");
-    print_s(out, tei.task_descr, prefix, "task_descr",
-	    "Task description");
-    print_i(out, tei.hybrid_ntasks, prefix, "hybrid_ntasks",
-	    "Number of tasks in hybrid task");
-    print_u(out, tei.task_state, prefix, "task_state",
-	    "Task state: 0=no task; 1=task being modified; 2=inactive;"
-	    " 3=scheduled, 4=running.");
-    print_ymds_time(out, tei.data_time, prefix, "data_time",
-	    "Data time of task (TZ flexible)");
+    for (b = 0; b < n; b++) {
+	f1[b] *= v;
+    }
 }
 
-/*
-   get / print dsp_data_mask.
- */
-
-struct Sigmet_DSP_Data_Mask get_dsp_data_mask(char *rec)
+static void kern_div(float *f1, const float *f2, int n, float v)
 {
-    struct Sigmet_DSP_Data_Mask ddm;
+    int b;
 
-    ddm.mask_word_0 = get_uint32(rec + 0);
-    ddm.ext_hdr_type = get_uint32(rec + 4);
-    ddm.mask_word_1 = get_uint32(rec + 8);
-    ddm.mask_word_2 = get_uint32(rec + 12);
-    ddm.mask_word_3 = get_uint32(rec + 16);
-    ddm.mask_word_4 = get_uint32(rec + 20);
-    return ddm;
+    for (b = 0; b < n; b++) {
+	f1[b] /= v;
+    }
 }
 
-void print_dsp_data_mask(FILE *out, char *pfx, struct Sigmet_DSP_Data_Mask ddm,
-	char *suffix)
+static void kern_log10(float *f1, const float *f2, int n, float v)
 {
-    char prefix[STR_LEN];
-    char struct_path[STR_LEN];
+    int b;
 
-    snprintf(prefix, STR_LEN, "%s%s", pfx, "<dsp_data_mask>.");
-    snprintf(struct_path, STR_LEN, "%s%s",
-	    prefix, "mask_word_0");
-    fprintf(out, "%#X" FS "%s" FS "%s.  %s\n",
-	    ddm.mask_word_0, struct_path, "Mask word 0", suffix);
-    snprintf(struct_path, STR_LEN, "%s%s",
-	    prefix, "ext_hdr_type");
-    fprintf(out, "%u" FS "%s" FS "%s.  %s\n",
-	    ddm.ext_hdr_type, struct_path, "Extended header type", suffix);
-    snprintf(struct_path, STR_LEN, "%s%s",
-	    prefix, "mask_word_1");
-    fprintf(out, "%#X" FS "%s" FS "%s.  %s\n", ddm.mask_word_1, struct_path,
-	    "Mask word 1 Contains bits set for all data recorded.", suffix);
-    snprintf(struct_path, STR_LEN, "%s%s",
-	    prefix, "mask_word_2");
-    fprintf(out, "%#X" FS "%s" FS "%s.  %s\n", ddm.mask_word_2, struct_path,
-	    "Mask word 2 See parameter DB_* in Table 36 for", suffix);
-    snprintf(struct_path, STR_LEN, "%s%s", prefix,
-	    "mask_word_3");
-    fprintf(out, "%#X" FS "%s" FS "%s.  %s\n", ddm.mask_word_3, struct_path,
-	    "Mask word 3 bit specification.", suffix);
-    snprintf(struct_path, STR_LEN, "%s%s", prefix, "mask_word_4");
-    fprintf(out, "%#X" FS "%s" FS "%s.  %s\n", ddm.mask_word_4, struct_path,
-	    "Mask word 4", suffix);
+    float x, y;
+
+    for (b = 0; b < n; b++) {
+	x = f1[b];
+	y = log10(x);
+	f1[b] = (x > 0.0f) ? y : NAN;
+    }
 }
 
 /*
-   get / print structure_header.
+   In the field kernels, v is -1 to negate f2, otherwise 1.
  */
 
-struct Sigmet_Structure_Header get_structure_header(char *rec)
+static void kern_add_fld(float *f1, const float *f2, int n, float v)
 {
-    struct Sigmet_Structure_Header sh;
+    int b;
 
-    sh.id = get_sint16(rec + 0);
-    sh.format = get_sint16(rec + 2);
-    sh.sz = get_sint32(rec + 4);
-    sh.flags = get_sint16(rec + 10);
-    return sh;
-}
-
-void print_structure_header(FILE *out, char *prefix,
-	struct Sigmet_Structure_Header sh)
-{
-    print_i(out, sh.id, prefix, "<structure_header>.id",
-	    "Structure identifier: 22 => Task_configuration."
-	    " 23 => Ingest_header. 24 => Ingest_data_header."
-	    " 25 => Tape_inventory. 26 => Product_configuration."
-	    " 27 => Product_hdr. 28 => Tape_header_record");
-    print_i(out, sh.format, prefix, "<structure_header>.format",
-	    "Format version number (see headers.h)");
-    print_i(out, sh.sz, prefix, "<structure_header>.sz",
-	    "Number of bytes in the entire structure");
-    print_x(out, (unsigned)sh.flags, prefix, "<structure_header>.flags",
-	    "Flags: bit0=structure complete");
+    for (b = 0; b < n; b++) {
+	f1[b] += v * f2[b];
+    }
 }
 
-/*
-   get / print ymds_time.
- */
-
-struct Sigmet_YMDS_Time get_ymds_time(char *b)
+static void kern_sub_fld(float *f1, const float *f2, int n, float v)
 {
-    unsigned msec;
-    struct Sigmet_YMDS_Time tm;
+    int b;
 
-    tm.sec = get_sint32(b);
-    msec = get_uint16(b + 4);
-    tm.msec = (msec & 0x3ff);
-    tm.utc = (msec & 0x800);
-    tm.year = get_sint16(b + 6);
-    tm.month = get_sint16(b + 8);
-    tm.day = get_sint16(b + 10);
-    return tm;
+    for (b = 0; b < n; b++) {
+	f1[b] -= v * f2[b];
+    }
 }
 
-void print_ymds_time(FILE *out, struct Sigmet_YMDS_Time tm, char *prefix,
-	char *mmb, char *desc)
+static void kern_mul_fld(float *f1, const float *f2, int n, float v)
 {
-    double fhour, fmin;
-    double ihour, imin;
-    double sec;
-    char struct_path[STR_LEN];
-
-    sec = tm.sec + 0.001 * tm.msec;
-    fhour = modf(sec / 3600.0, &ihour);
-    fmin = modf(fhour * 60.0, &imin);
-    snprintf(struct_path, STR_LEN, "%s%s", prefix, mmb);
-    fprintf(out, "%04d/%02d/%02d %02d:%02d:%05.2f" FS "%s" FS "%s\n",
-	    tm.year, tm.month, tm.day,
-	    (int)ihour, (int)imin, fmin * 60.0,
-	    struct_path, desc);
-}
+    int b;
 
-/*
-   Print unsigned integer u (a struct value), prefix (a struct hierarchy),
-   mmb (the struct member with value u), and desc (descriptor) to stream out.
- */
+    for (b = 0; b < n; b++) {
+	f1[b] *= v * f2[b];
+    }
+}
 
-void print_u(FILE *out, unsigned u, char *prefix, char *mmb, char *desc)
+static void kern_div_fld(float *f1, const float *f2, int n, float v)
 {
-    char struct_path[STR_LEN];
+    int b;
 
-    snprintf(struct_path, STR_LEN, "%s%s", prefix, mmb);
-    fprintf(out, "%u" FS "%s" FS "%s\n", u, struct_path, desc);
+    for (b = 0; b < n; b++) {
+	f1[b] /= v * f2[b];
+    }
 }
 
 /*
-   Print unsigned integer u (a struct value) in hex format, prefix (a struct
-   hierarchy), mmb (the struct member with value u), and desc (descriptor) to
-   stream out.
+   Compile expression expr for vol_p into prog. Return true on success.
+   On failure, print a message and return false. Caller must eventually
+   give prog to calc_free, either way.
+
+   Grammar, from lowest to highest precedence:
+	cond	= or [ "?" cond ":" cond ]
+	or	= and { "||" and }
+	and	= cmp { "&&" cmp }
+	cmp	= add [ ( "<" | "<=" | ">" | ">=" | "==" | "!=" ) add ]
+	add	= mul { ( "+" | "-" ) mul }
+	mul	= unary { ( "*" | "/" ) unary }
+	unary	= ( "-" | "!" ) unary | pow
+	pow	= prim [ "^" unary ]
+	prim	= number | "(" cond ")" | name | name "(" cond { "," cond } ")"
+   A name is a field in vol_p, r_beam, or nan.
  */
 
-void print_x(FILE *out, unsigned u, char *prefix, char *mmb, char *desc)
+static int calc_compile(struct Sigmet_Vol *vol_p, char *expr,
+	struct calc_prog *prog_p)
 {
-    char struct_path[STR_LEN];
+    memset(prog_p, 0, sizeof(struct calc_prog));
+    prog_p->vol_p = vol_p;
+    prog_p->expr = prog_p->p = expr;
+    if ( !calc_cond(prog_p) ) {
+	return 0;
+    }
+    calc_space(prog_p);
+    if ( *prog_p->p != '\0' ) {
+	return calc_err(prog_p, "unexpected character");
+    }
+    return 1;
+}
 
-    snprintf(struct_path, STR_LEN, "%s%s", prefix, mmb);
-    fprintf(out, "%#X" FS "%s" FS "%s\n", u, struct_path, desc);
+static void calc_free(struct calc_prog *prog_p)
+{
+    FREE(prog_p->ins);
+    FREE(prog_p->fld);
+    prog_p->ins = NULL;
+    prog_p->fld = NULL;
 }
 
 /*
-   Print integer i (a struct value), prefix (a struct hierarchy),
-   mmb (the struct member with value i), and desc (descriptor) to stream out.
+   Print message msg about the current position in the expression. Return 0.
  */
 
-void print_i(FILE *out, int i, char *prefix, char *mmb, char *desc)
+static int calc_err(struct calc_prog *prog_p, char *msg)
 {
-    char struct_path[STR_LEN];
+    fprintf(stderr, "%d: %s at position %d in expression %s\n", getpid(),
+	    msg, (int)(prog_p->p - prog_p->expr) + 1, prog_p->expr);
+    return 0;
+}
 
-    snprintf(struct_path, STR_LEN, "%s%s", prefix, mmb);
-    fprintf(out, "%d" FS "%s" FS "%s\n", i, struct_path, desc);
+static void calc_space(struct calc_prog *prog_p)
+{
+    while ( isspace((unsigned char)*prog_p->p) ) {
+	prog_p->p++;
+    }
 }
 
 /*
-   Print string s (a struct value), prefix (a struct hierarchy),
-   mmb (the struct member with value s), and desc (descriptor) to stream out.
+   If the expression continues with token tok, skip it and return true.
  */
 
-void print_s(FILE *out, char *s, char *prefix, char *mmb, char *desc)
+static int calc_tok(struct calc_prog *prog_p, char *tok)
 {
-    char struct_path[STR_LEN];
+    size_t len = strlen(tok);
 
-    snprintf(struct_path, STR_LEN, "%s%s", prefix, mmb);
-    fprintf(out, "%s" FS "%s" FS "%s\n", s, struct_path, desc);
+    calc_space(prog_p);
+    if ( strncmp(prog_p->p, tok, len) == 0 ) {
+	prog_p->p += len;
+	return 1;
+    }
+    return 0;
 }
 
 /*
-   Trim spaces off the end of a character array
-   Returns the input string with a nul character at the start of any
-   trailing spaces and at end of string. The input string is modified.
+   Append an instruction to the program. Track the depth of the stack.
  */
 
-static char *trimRight(char *s, int n)
+static int calc_emit(struct calc_prog *prog_p, enum calc_op op, float v,
+	int f)
 {
-    char *c, *e, *end;
+    struct calc_ins *ins;
+    int max_ins;
 
-    for (c = e = s, end = s + n; c < end; c++) {
-	if ( !isspace((int)*c) ) {
-	    e = c;
+    if ( prog_p->n_ins == prog_p->max_ins ) {
+	max_ins = 2 * prog_p->max_ins + 8;
+	if ( !(ins = REALLOC(prog_p->ins, max_ins * sizeof(struct calc_ins))) ) {
+	    return calc_err(prog_p, "could not allocate instructions");
 	}
+	prog_p->ins = ins;
+	prog_p->max_ins = max_ins;
+    }
+    ins = prog_p->ins + prog_p->n_ins++;
+    ins->op = op;
+    ins->v = v;
+    ins->f = f;
+    switch (op) {
+	case CALC_CONST:
+	case CALC_FLD:
+	case CALC_RBEAM:
+	    prog_p->depth++;
+	    break;
+	case CALC_NEG:
+	case CALC_NOT:
+	case CALC_LOG10:
+	case CALC_LOG:
+	case CALC_EXP:
+	case CALC_SQRT:
+	case CALC_ABS:
+	case CALC_ISNAN:
+	    break;
+	case CALC_COND:
+	    prog_p->depth -= 2;
+	    break;
+	default:
+	    prog_p->depth--;
+	    break;
     }
-    if (e + 1 != end) {
-	*(e + 1) = '\0';
+    if ( prog_p->depth > prog_p->max_depth ) {
+	prog_p->max_depth = prog_p->depth;
     }
-    *(end - 1) = '\0';
-    return s;
+    return 1;
 }
 
-/*
-   Retrieve a 16 bit signed integer from an address
- */
-
-static int get_sint16(void *b) {
-    I16BIT *s = (I16BIT *)(b);
-    Swap_16Bit(s);
-    return *s;
+static int calc_cond(struct calc_prog *prog_p)
+{
+    if ( !calc_or(prog_p) ) {
+	return 0;
+    }
+    if ( calc_tok(prog_p, "?") ) {
+	if ( !calc_cond(prog_p) ) {
+	    return 0;
+	}
+	if ( !calc_tok(prog_p, ":") ) {
+	    return calc_err(prog_p, "expected :");
+	}
+	if ( !calc_cond(prog_p) ) {
+	    return 0;
+	}
+	return calc_emit(prog_p, CALC_COND, 0.0, 0);
+    }
+    return 1;
 }
 
-/*
-   Retrieve a 16 bit unsigned integer from an address
- */
-
-static unsigned get_uint16(void *b) {
-    U16BIT *s = (U16BIT *)(b);
-    Swap_16Bit(s);
-    return *s;
+static int calc_or(struct calc_prog *prog_p)
+{
+    if ( !calc_and(prog_p) ) {
+	return 0;
+    }
+    while ( calc_tok(prog_p, "||") ) {
+	if ( !calc_and(prog_p) || !calc_emit(prog_p, CALC_OR, 0.0, 0) ) {
+	    return 0;
+	}
+    }
+    return 1;
 }
 
-/*
-   Retrieve a 32 bit signed integer from an address
- */
-
-static int get_sint32(void *b) {
-    I32BIT *s = (I32BIT *)(b);
-    Swap_32Bit(s);
-    return *s;
+static int calc_and(struct calc_prog *prog_p)
+{
+    if ( !calc_cmp(prog_p) ) {
+	return 0;
+    }
+    while ( calc_tok(prog_p, "&&") ) {
+	if ( !calc_cmp(prog_p) || !calc_emit(prog_p, CALC_AND, 0.0, 0) ) {
+	    return 0;
+	}
+    }
+    return 1;
 }
 
-/*
-   Retrieve a 32 bit unsigned integer from an address
- */
+static int calc_cmp(struct calc_prog *prog_p)
+{
+    enum calc_op op;
 
-static unsigned get_uint32(void *b) {
-    U32BIT *s = (U32BIT *)(b);
-    Swap_32Bit(s);
-    return *s;
+    if ( !calc_add(prog_p) ) {
+	return 0;
+    }
+    if ( calc_tok(prog_p, "<=") ) {
+	op = CALC_LE;
+    } else if ( calc_tok(prog_p, ">=") ) {
+	op = CALC_GE;
+    } else if ( calc_tok(prog_p, "==") ) {
+	op = CALC_EQ;
+    } else if ( calc_tok(prog_p, "!=") ) {
+	op = CALC_NE;
+    } else if ( calc_tok(prog_p, "<") ) {
+	op = CALC_LT;
+    } else if ( calc_tok(prog_p, ">") ) {
+	op = CALC_GT;
+    } else {
+	return 1;
+    }
+    return calc_add(prog_p) && calc_emit(prog_p, op, 0.0, 0);
 }
 
-/*
-   Allocate a 3 dimensional array of unsigned one byte integers.  Return the
-   array. If something goes wrong, return NULL.
-
-   If id_p is not NULL, use shared memory and copy shared memory identifier
-   to it.
- */
-
-static U1BYT ***malloc3_u1(long kmax, long jmax, long imax, int *id_p)
+static int calc_add(struct calc_prog *prog_p)
 {
-    U1BYT ***dat;
-    long k, j;
-    size_t kk, jj, ii;
-    size_t sz;
-    int id;
+    enum calc_op op;
 
-    /*
-       Make sure casting to size_t does not overflow anything.
-     */
-
-    if ( kmax <= 0 || jmax <= 0 || imax <= 0 ) {
-	fprintf(stderr, "%d: array dimensions must be positive.\n", getpid());
-	return NULL;
+    if ( !calc_mul(prog_p) ) {
+	return 0;
     }
-    kk = (size_t)kmax;
-    jj = (size_t)jmax;
-    ii = (size_t)imax;
-    if ( (kk * jj) / kk != jj || (kk * jj * ii) / (kk * jj) != ii) {
-	fprintf(stderr, "%d: dimensions too big for pointer arithmetic.\n",
-		getpid());
-	return NULL;
+    while ( 1 ) {
+	if ( calc_tok(prog_p, "+") ) {
+	    op = CALC_ADD;
+	} else if ( calc_tok(prog_p, "-") ) {
+	    op = CALC_SUB;
+	} else {
+	    return 1;
+	}
+	if ( !calc_mul(prog_p) || !calc_emit(prog_p, op, 0.0, 0) ) {
+	    return 0;
+	}
     }
+}
 
-    sz = kk * sizeof(U1BYT **)
-	+ kk * jj * sizeof(U1BYT *) + (kk * jj * ii + 1) * sizeof(U1BYT);
-    if ( id_p ) {
-	id = shmget(IPC_PRIVATE, sz, S_IRUSR | S_IWUSR);
-	if ( id == -1 ) {
-	    fprintf(stderr, "%d: could not create shared memory of %lu bytes "
-		    "for field.\n%s\n", getpid(), (unsigned long)sz,
-		    strerror(errno));
-	    return NULL;
-	}
-	if ( (dat = shmat(id, NULL, 0)) == (void *)-1 ) {
-	    fprintf(stderr, "%d: could not attach to shared memory for "
-		    "field.\n%s\n", getpid(), strerror(errno));
-	    return NULL;
+static int calc_mul(struct calc_prog *prog_p)
+{
+    enum calc_op op;
+
+    if ( !calc_unary(prog_p) ) {
+	return 0;
+    }
+    while ( 1 ) {
+	if ( calc_tok(prog_p, "*") ) {
+	    op = CALC_MUL;
+	} else if ( calc_tok(prog_p, "/") ) {
+	    op = CALC_DIV;
+	} else {
+	    return 1;
 	}
-	*id_p = id;
-    } else {
-	dat = (U1BYT ***)MALLOC(sz);
-	if ( !dat ) {
-	    fprintf(stderr, "%d: could not allocate 3rd dimension.\n",
-		    getpid());
-	    return NULL;
+	if ( !calc_unary(prog_p) || !calc_emit(prog_p, op, 0.0, 0) ) {
+	    return 0;
 	}
     }
+}
 
-    /*
-       Set up pointers within the array. This only works with local
-       memory. If the memory is shared, the process will have to
-       set up the pointers again when it attaches.
-     */
-
-    dat[0] = (U1BYT **)(dat + kk);
-    dat[0][0] = (U1BYT *)(dat[0] + kk * jj);
-    for (k = 1; k < kmax; k++) {
-	dat[k] = dat[k - 1] + jmax;
+static int calc_unary(struct calc_prog *prog_p)
+{
+    if ( calc_tok(prog_p, "-") ) {
+	return calc_unary(prog_p) && calc_emit(prog_p, CALC_NEG, 0.0, 0);
     }
-    for (j = 1; j < kmax * jmax; j++) {
-	dat[0][j] = dat[0][j - 1] + imax;
+    calc_space(prog_p);
+    if ( prog_p->p[0] == '!' && prog_p->p[1] != '=' ) {
+	prog_p->p++;
+	return calc_unary(prog_p) && calc_emit(prog_p, CALC_NOT, 0.0, 0);
     }
-    return dat;
+    if ( !calc_prim(prog_p) ) {
+	return 0;
+    }
+    if ( calc_tok(prog_p, "^") ) {
+	return calc_unary(prog_p) && calc_emit(prog_p, CALC_POW, 0.0, 0);
+    }
+    return 1;
 }
 
 /*
-   Allocate a 3 dimensional array of unsigned two byte integers.  Return the
-   array. If something goes wrong, return NULL.
-
-   If id_p is not NULL, use shared memory and copy shared memory identifier
-   to it.
+   Functions that may appear in expressions.
  */
 
-static U2BYT ***malloc3_u2(long kmax, long jmax, long imax, int *id_p)
+static struct {
+    char *nm;
+    enum calc_op op;
+    int n_args;
+} calc_fns[] = {
+    {"log10", CALC_LOG10, 1},	{"log", CALC_LOG, 1},
+    {"exp", CALC_EXP, 1},	{"sqrt", CALC_SQRT, 1},
+    {"abs", CALC_ABS, 1},	{"isnan", CALC_ISNAN, 1},
+    {"pow", CALC_POW, 2},	{"min", CALC_MIN, 2},
+    {"max", CALC_MAX, 2},
+};
+
+static int calc_prim(struct calc_prog *prog_p)
 {
-    U2BYT ***dat;
-    long k, j;
-    size_t kk, jj, ii;
-    size_t sz;
-    int id;
-
-    /*
-       Make sure casting to size_t does not overflow anything.
-     */
+    char nm[SIGMET_NAME_LEN];		/* Name of field or function */
+    char *p, *e;
+    size_t len;
+    double v;
+    int y, f, n, *fld;
+    struct Sigmet_Dat *dat_p;
 
-    if ( kmax <= 0 || jmax <= 0 || imax <= 0 ) {
-	fprintf(stderr, "%d: array dimensions must be positive.\n", getpid());
-	return NULL;
+    calc_space(prog_p);
+    p = prog_p->p;
+    if ( isdigit((unsigned char)*p) || *p == '.' ) {
+	v = strtod(p, &e);
+	if ( e == p ) {
+	    return calc_err(prog_p, "bad number");
+	}
+	prog_p->p = e;
+	return calc_emit(prog_p, CALC_CONST, v, 0);
     }
-    kk = (size_t)kmax;
-    jj = (size_t)jmax;
-    ii = (size_t)imax;
-    if ( (kk * jj) / kk != jj || (kk * jj * ii) / (kk * jj) != ii) {
-	fprintf(stderr, "%d: dimensions too big for pointer arithmetic.\n",
-		getpid());
-	return NULL;
+    if ( *p == '(' ) {
+	prog_p->p++;
+	if ( !calc_cond(prog_p) ) {
+	    return 0;
+	}
+	if ( !calc_tok(prog_p, ")") ) {
+	    return calc_err(prog_p, "expected )");
+	}
+	return 1;
+    }
+    if ( !isalpha((unsigned char)*p) && *p != '_' ) {
+	return calc_err(prog_p, "expected number, name, or (");
+    }
+    for (e = p; isalnum((unsigned char)*e) || *e == '_'; e++) {
+    }
+    len = e - p;
+    if ( len >= SIGMET_NAME_LEN ) {
+	return calc_err(prog_p, "name too long");
     }
+    memcpy(nm, p, len);
+    nm[len] = '\0';
+    prog_p->p = e;
 
-    sz = kk * sizeof(U2BYT **)
-	+ kk * jj * sizeof(U2BYT *) + (kk * jj * ii + 1) * sizeof(U2BYT);
-    if ( id_p ) {
-	id = shmget(IPC_PRIVATE, sz, S_IRUSR | S_IWUSR);
-	if ( id == -1 ) {
-	    fprintf(stderr, "%d: could not create shared memory of %lu bytes "
-		    "for field.\n%s\n", getpid(), (unsigned long)sz,
-		    strerror(errno));
-	    return NULL;
+    /*
+       Function call
+     */
+
+    if ( calc_tok(prog_p, "(") ) {
+	for (f = 0; f < sizeof(calc_fns) / sizeof(calc_fns[0]); f++) {
+	    if ( strcmp(nm, calc_fns[f].nm) == 0 ) {
+		break;
+	    }
 	}
-	if ( (dat = shmat(id, NULL, 0)) == (void *)-1 ) {
-	    fprintf(stderr, "%d: could not attach to shared memory for "
-		    "field.\n%s\n", getpid(), strerror(errno));
-	    return NULL;
+	if ( f == sizeof(calc_fns) / sizeof(calc_fns[0]) ) {
+	    prog_p->p = p;
+	    return calc_err(prog_p, "unknown function");
 	}
-	*id_p = id;
-    } else {
-	dat = (U2BYT ***)MALLOC(sz);
-	if ( !dat ) {
-	    fprintf(stderr, "%d: could not allocate 3rd dimension.\n",
-		    getpid());
-	    return NULL;
+	for (n = 0; n < calc_fns[f].n_args; n++) {
+	    if ( n > 0 && !calc_tok(prog_p, ",") ) {
+		return calc_err(prog_p, "expected ,");
+	    }
+	    if ( !calc_cond(prog_p) ) {
+		return 0;
+	    }
 	}
+	if ( !calc_tok(prog_p, ")") ) {
+	    return calc_err(prog_p, "expected )");
+	}
+	return calc_emit(prog_p, calc_fns[f].op, 0.0, 0);
     }
 
     /*
-       Set up pointers within the array. This only works with local
-       memory. If the memory is shared, the process will have to
-       set up the pointers again when it attaches.
+       Constant, range, or field
      */
 
-    dat[0] = (U2BYT **)(dat + kk);
-    dat[0][0] = (U2BYT *)(dat[0] + kk * jj);
-    for (k = 1; k < kmax; k++) {
-	dat[k] = dat[k - 1] + jmax;
+    if ( strcmp(nm, "nan") == 0 ) {
+	return calc_emit(prog_p, CALC_CONST, NAN, 0);
+    }
+    if ( strcmp(nm, "r_beam") == 0 ) {
+	return calc_emit(prog_p, CALC_RBEAM, 0.0, 0);
+    }
+    if ( (y = Sigmet_Vol_GetFld(prog_p->vol_p, nm, &dat_p)) == -1 ) {
+	prog_p->p = p;
+	return calc_err(prog_p, "no such field");
+    }
+    for (f = 0; f < prog_p->n_fld && prog_p->fld[f] != y; f++) {
     }
-    for (j = 1; j < kmax * jmax; j++) {
-	dat[0][j] = dat[0][j - 1] + imax;
+    if ( f == prog_p->n_fld ) {
+	if ( !(fld = REALLOC(prog_p->fld, (f + 1) * sizeof(int))) ) {
+	    return calc_err(prog_p, "could not allocate field list");
+	}
+	prog_p->fld = fld;
+	prog_p->fld[prog_p->n_fld++] = y;
     }
-    return dat;
+    return calc_emit(prog_p, CALC_FLD, 0.0, f);
 }
 
 /*
-   Allocate a 3 dimensional array of floats. Initialize with NAN.
-   Return the array. If something goes wrong, return NULL.
-
-   If id_p is not NULL, use shared memory and copy shared memory identifier
-   to it.
+   fld_swp_fn for Sigmet_Vol_Fld_Calc. arg points to the compiled
+   expression. Evaluate it for every good ray of sweep s and store the
+   result in its field.
  */
 
-static float ***malloc3_flt(long kmax, long jmax, long imax, int *id_p)
+static enum SigmetStatus calc_swp(struct Sigmet_Vol *vol_p, int s, void *arg)
 {
-    float ***dat, *d;
-    long k, j;
-    size_t kk, jj, ii;
-    size_t sz;
-    int id;
+    struct calc_prog *prog_p = arg;
+    int r, f, n;
+    int num_bins;
+    double bin0;			/* Range to center of 1st bin */
+    double bin_step;
+    float *bufs;			/* Storage for stack, field, and
+					   range rays */
+    float **stk;			/* Stack of rays */
+    float **fld_v;			/* Values of fields in a ray */
+    float *r_beam;			/* Range along beam, meters */
+    float *res;				/* Result for a ray */
 
     /*
-       Make sure casting to size_t does not overflow anything.
+       One allocation holds a ray for each stack level and each field, and
+       the range along the beam.
      */
 
-    if ( kmax <= 0 || jmax <= 0 || imax <= 0 ) {
-	fprintf(stderr, "%d: array dimensions must be positive.\n", getpid());
-	return NULL;
-    }
-    kk = (size_t)kmax;
-    jj = (size_t)jmax;
-    ii = (size_t)imax;
-    if ( (kk * jj) / kk != jj || (kk * jj * ii) / (kk * jj) != ii) {
-	fprintf(stderr, "%d: dimensions too big for pointer arithmetic.\n",
+    num_bins = vol_p->ih.tc.tri.num_bins_out;
+    bufs = CALLOC((size_t)(prog_p->max_depth + prog_p->n_fld + 1) * num_bins,
+	    sizeof(float));
+    stk = CALLOC(prog_p->max_depth + prog_p->n_fld, sizeof(float *));
+    if ( !bufs || !stk ) {
+	fprintf(stderr, "%d: could not allocate buffers for expression.\n",
 		getpid());
-	return NULL;
+	FREE(stk);
+	FREE(bufs);
+	return SIGMET_MEM_FAIL;
     }
-
-    sz = kk * sizeof(float **)
-	+ kk * jj * sizeof(float *) + (kk * jj * ii + 1) * sizeof(float);
-    if ( id_p ) {
-	id = shmget(IPC_PRIVATE, sz, S_IRUSR | S_IWUSR);
-	if ( id == -1 ) {
-	    fprintf(stderr, "%d: could not create shared memory of %lu bytes "
-		    "for field.\n%s\n", getpid(), (unsigned long)sz,
-		    strerror(errno));
-	    return NULL;
-	}
-	if ( (dat = shmat(id, NULL, 0)) == (void *)-1 ) {
-	    fprintf(stderr, "%d: could not attach to shared memory for "
-		    "field.\n%s\n", getpid(), strerror(errno));
-	    return NULL;
-	}
-	*id_p = id;
-    } else {
-	dat = (float ***)MALLOC(sz);
-	if ( !dat ) {
-	    fprintf(stderr, "%d: could not allocate 3rd dimension.\n",
-		    getpid());
-	    return NULL;
+    fld_v = stk + prog_p->max_depth;
+    r_beam = bufs + (size_t)(prog_p->max_depth + prog_p->n_fld) * num_bins;
+    bin_step = 0.01 * vol_p->ih.tc.tri.step_out;	/* cm -> meter */
+    bin0 = 0.01 * vol_p->ih.tc.tri.rng_1st_bin + bin_step / 2;
+    for (n = 0; n < num_bins; n++) {
+	r_beam[n] = bin0 + n * bin_step;
+    }
+    for (r = 0; r < vol_p->ih.ic.num_rays; r++) {
+	if ( vol_p->ray_hdr[s][r].ok ) {
+	    n = vol_p->ray_hdr[s][r].num_bins;
+	    for (f = 0; f < prog_p->n_fld; f++) {
+		fld_v[f] = fld_ray_get(vol_p, vol_p->dat + prog_p->fld[f],
+			s, r, bufs + (size_t)(prog_p->max_depth + f) * num_bins);
+	    }
+	    res = calc_ray(prog_p, stk, bufs, num_bins, fld_v, r_beam, n);
+	    fld_ray_put(prog_p->dat_p, s, r, res, n);
 	}
     }
+    FREE(stk);
+    FREE(bufs);
+    return SIGMET_OK;
+}
 
-    /*
-       Set up pointers within the array. This only works with local
-       memory. If the memory is shared, the process will have to
-       set up the pointers again when it attaches.
-     */
+/*
+   Run program prog_p for a ray of n bins. stk must have space for
+   prog_p->max_depth pointers, and bufs for prog_p->max_depth rays of
+   ray_sz floats. fld_v has the values of the fields in prog_p->fld for
+   the ray. Return the result, which is in bufs, fld_v, or r_beam.
+
+   Each instruction is a loop over the ray. Level i of the stack points
+   to a field or r_beam, or to ray i of bufs, so results never overwrite
+   their inputs.
+ */
 
-    dat[0] = (float **)(dat + kk);
-    dat[0][0] = (float *)(dat[0] + kk * jj);
-    for (k = 1; k < kmax; k++) {
-	dat[k] = dat[k - 1] + jmax;
-    }
-    for (j = 1; j < kmax * jmax; j++) {
-	dat[0][j] = dat[0][j - 1] + imax;
-    }
-    for (d = dat[0][0]; d < dat[0][0] + kk * jj * ii + 1; d++) {
-	*d = NAN;
+#define CALC_UN(x)							\
+    a = stk[sp - 1];							\
+    d = bufs + (size_t)(sp - 1) * ray_sz;				\
+    for (b = 0; b < n; b++) {						\
+	d[b] = (x);							\
+    }									\
+    stk[sp - 1] = d;
+#define CALC_BIN(x)							\
+    a = stk[sp - 2];							\
+    c = stk[sp - 1];							\
+    d = bufs + (size_t)(sp - 2) * ray_sz;				\
+    for (b = 0; b < n; b++) {						\
+	d[b] = (x);							\
+    }									\
+    stk[sp - 2] = d;							\
+    sp--;
+#define CALC_CMP(x)							\
+    CALC_BIN((isnan(a[b]) || isnan(c[b])) ? NAN : (x) ? 1.0f : 0.0f)
+
+static float *calc_ray(struct calc_prog *prog_p, float **stk, float *bufs,
+	int ray_sz, float **fld_v, float *r_beam, int n)
+{
+    struct calc_ins *ins, *ins_e;
+    int sp = 0;				/* Stack index */
+    int b;
+    float *a, *c, *e, *d;
+
+    for (ins = prog_p->ins, ins_e = ins + prog_p->n_ins; ins < ins_e; ins++) {
+	switch (ins->op) {
+	    case CALC_CONST:
+		d = bufs + (size_t)sp * ray_sz;
+		for (b = 0; b < n; b++) {
+		    d[b] = ins->v;
+		}
+		stk[sp++] = d;
+		break;
+	    case CALC_FLD:
+		stk[sp++] = fld_v[ins->f];
+		break;
+	    case CALC_RBEAM:
+		stk[sp++] = r_beam;
+		break;
+	    case CALC_NEG:
+		CALC_UN(-a[b]);
+		break;
+	    case CALC_NOT:
+		CALC_UN(isnan(a[b]) ? NAN : (a[b] == 0.0f) ? 1.0f : 0.0f);
+		break;
+	    case CALC_LOG10:
+		CALC_UN((a[b] > 0.0f) ? log10f(a[b]) : NAN);
+		break;
+	    case CALC_LOG:
+		CALC_UN((a[b] > 0.0f) ? logf(a[b]) : NAN);
+		break;
+	    case CALC_EXP:
+		CALC_UN(expf(a[b]));
+		break;
+	    case CALC_SQRT:
+		CALC_UN(sqrtf(a[b]));
+		break;
+	    case CALC_ABS:
+		CALC_UN(fabsf(a[b]));
+		break;
+	    case CALC_ISNAN:
+		CALC_UN(isnan(a[b]) ? 1.0f : 0.0f);
+		break;
+	    case CALC_ADD:
+		CALC_BIN(a[b] + c[b]);
+		break;
+	    case CALC_SUB:
+		CALC_BIN(a[b] - c[b]);
+		break;
+	    case CALC_MUL:
+		CALC_BIN(a[b] * c[b]);
+		break;
+	    case CALC_DIV:
+		CALC_BIN(a[b] / c[b]);
+		break;
+	    case CALC_POW:
+		CALC_BIN(powf(a[b], c[b]));
+		break;
+	    case CALC_MIN:
+		CALC_BIN((isnan(a[b]) || isnan(c[b])) ? NAN
+			: (a[b] < c[b]) ? a[b] : c[b]);
+		break;
+	    case CALC_MAX:
+		CALC_BIN((isnan(a[b]) || isnan(c[b])) ? NAN
+			: (a[b] > c[b]) ? a[b] : c[b]);
+		break;
+	    case CALC_LT:
+		CALC_CMP(a[b] < c[b]);
+		break;
+	    case CALC_LE:
+		CALC_CMP(a[b] <= c[b]);
+		break;
+	    case CALC_GT:
+		CALC_CMP(a[b] > c[b]);
+		break;
+	    case CALC_GE:
+		CALC_CMP(a[b] >= c[b]);
+		break;
+	    case CALC_EQ:
+		CALC_CMP(a[b] == c[b]);
+		break;
+	    case CALC_NE:
+		CALC_CMP(a[b] != c[b]);
+		break;
+	    case CALC_AND:
+		CALC_CMP(a[b] != 0.0f && c[b] != 0.0f);
+		break;
+	    case CALC_OR:
+		CALC_CMP(a[b] != 0.0f || c[b] != 0.0f);
+		break;
+	    case CALC_COND:
+		e = stk[sp - 3];
+		a = stk[sp - 2];
+		c = stk[sp - 1];
+		d = bufs + (size_t)(sp - 3) * ray_sz;
+		for (b = 0; b < n; b++) {
+		    d[b] = isnan(e[b]) ? NAN : (e[b] != 0.0f) ? a[b] : c[b];
+		}
+		stk[sp - 3] = d;
+		sp -= 2;
+		break;
+	}
     }
-    return dat;
+    return stk[0];
 }
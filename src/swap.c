@@ -1,7 +1,7 @@
 /*
    -	swap.c ---
-   -		This file defines functions that copy values,
-   -		swapping bytes if desired.  See swap (3).
+   -		This file defines functions that swap bytes.
+   -		See swap (3).
    -
    .	Copyright (c) 2011, Gordon D. Carrie. All rights reserved.
    .	
@@ -36,60 +36,47 @@
 #include "swap.h"
 #include "type_nbit.h"
 
-/* If true, we are swapping bytes */
-static int swapping;
-
-void Swap_Off(void) { swapping = 0; }
-
-void Swap_On(void) { swapping = 1; }
-
-void Toggle_Swap(void) { swapping = !swapping; }
+/*
+   These functions always reverse the bytes at p. Callers keep their own
+   byte swapping policy, e.g. in the structure for the file being read,
+   so that files with different byte order can be read at the same time.
+ */
 
 void Swap_2Byt(void *p)
 {
-    if (swapping) {
-	U2BYT *q = (U2BYT *)p;
-	*q = SWAP2BYT(*q);
-    }
+    U2BYT *q = (U2BYT *)p;
+    *q = SWAP2BYT(*q);
 }
 
 void Swap_4Byt(void *p)
 {
-    if (swapping) {
-	U4BYT *q = (U4BYT *)p;
-	*q = SWAP4BYT(*q);
-    }
+    U4BYT *q = (U4BYT *)p;
+    *q = SWAP4BYT(*q);
 }
 
 void Swap_8Byt(void *p)
 {
-    if (swapping) {
-	char t[8], *p_ = (char *)p;
+    char t[8], *p_ = (char *)p;
 
-	memcpy(t, p, 8);
-	p_[7] = t[0];
-	p_[6] = t[1];
-	p_[5] = t[2];
-	p_[4] = t[3];
-	p_[3] = t[4];
-	p_[2] = t[5];
-	p_[1] = t[6];
-	p_[0] = t[7];
-    }
+    memcpy(t, p, 8);
+    p_[7] = t[0];
+    p_[6] = t[1];
+    p_[5] = t[2];
+    p_[4] = t[3];
+    p_[3] = t[4];
+    p_[2] = t[5];
+    p_[1] = t[6];
+    p_[0] = t[7];
 }
 
 void Swap_16Bit(void *p)
 {
-    if (swapping) {
-	U16BIT *q = (U16BIT *)p;
-	*q = SWAP16BIT(*q);
-    }
+    U16BIT *q = (U16BIT *)p;
+    *q = SWAP16BIT(*q);
 }
 
 void Swap_32Bit(void *p)
 {
-    if (swapping) {
-	U32BIT *q = (U32BIT *)p;
-	*q = SWAP32BIT(*q);
-    }
+    U32BIT *q = (U32BIT *)p;
+    *q = SWAP32BIT(*q);
 }
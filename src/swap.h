@@ -35,9 +35,6 @@
 #ifndef SWAP_H_
 #define SWAP_H_
 
-void Swap_On(void);
-void Swap_Off(void);
-void Toggle_Swap(void);
 void Swap_2Byt(void *);
 void Swap_4Byt(void *);
 void Swap_8Byt(void *);
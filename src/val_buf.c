@@ -38,41 +38,54 @@
 #include "val_buf.h"
 #include "swap.h"
 
+/*
+   The ValBuf_Get functions swap bytes in the values they retrieve if swap
+   is true. The ValBuf_Put functions store values in native byte order.
+ */
+
 void ValBuf_GetBytes(char **buf_p, char *s, size_t n)
 {
     memcpy(s, *buf_p, n);
     *buf_p += n;
 }
 
-I2BYT ValBuf_GetI2BYT(char **buf_p)
+I2BYT ValBuf_GetI2BYT(char **buf_p, int swap)
 {
     I2BYT i = *(I2BYT *)*buf_p;
     *buf_p += 2;
-    Swap_2Byt(&i);
+    if ( swap ) {
+	Swap_2Byt(&i);
+    }
     return i;
 }
 
-I4BYT ValBuf_GetI4BYT(char **buf_p)
+I4BYT ValBuf_GetI4BYT(char **buf_p, int swap)
 {
     I4BYT i = *(I4BYT *)*buf_p;
     *buf_p += 4;
-    Swap_4Byt(&i);
+    if ( swap ) {
+	Swap_4Byt(&i);
+    }
     return i;
 }
 
-F4BYT ValBuf_GetF4BYT(char **buf_p)
+F4BYT ValBuf_GetF4BYT(char **buf_p, int swap)
 {
     F4BYT f = *(F4BYT *)*buf_p;
     *buf_p += 4;
-    Swap_4Byt(&f);
+    if ( swap ) {
+	Swap_4Byt(&f);
+    }
     return f;
 }
 
-F8BYT ValBuf_GetF8BYT(char **buf_p)
+F8BYT ValBuf_GetF8BYT(char **buf_p, int swap)
 {
     F8BYT f = *(F8BYT *)*buf_p;
     *buf_p += 8;
-    Swap_8Byt(&f);
+    if ( swap ) {
+	Swap_8Byt(&f);
+    }
     return f;
 }
 
@@ -84,28 +97,24 @@ void ValBuf_PutBytes(char **buf_p, char *s, size_t n)
 
 void ValBuf_PutI2BYT(char **buf_p, I2BYT i)
 {
-    Swap_2Byt(&i);
     *(I2BYT *)*buf_p = i;
     *buf_p += 2;
 }
 
 void ValBuf_PutI4BYT(char **buf_p, I4BYT i)
 {
-    Swap_4Byt(&i);
     *(I4BYT *)*buf_p = i;
     *buf_p += 4;
 }
 
 void ValBuf_PutF4BYT(char **buf_p, F4BYT f)
 {
-    Swap_4Byt(&f);
     *(F4BYT *)*buf_p = f;
     *buf_p += 4;
 }
 
 void ValBuf_PutF8BYT(char **buf_p, F8BYT f)
 {
-    Swap_8Byt(&f);
     *(F8BYT *)*buf_p = f;
     *buf_p += 8;
 }
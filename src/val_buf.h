@@ -40,10 +40,10 @@
 #include "swap.h"
 
 void ValBuf_GetBytes(char **, char *, size_t);
-I2BYT ValBuf_GetI2BYT(char **);
-I4BYT ValBuf_GetI4BYT(char **);
-F4BYT ValBuf_GetF4BYT(char **);
-F8BYT ValBuf_GetF8BYT(char **);
+I2BYT ValBuf_GetI2BYT(char **, int);
+I4BYT ValBuf_GetI4BYT(char **, int);
+F4BYT ValBuf_GetF4BYT(char **, int);
+F8BYT ValBuf_GetF8BYT(char **, int);
 void ValBuf_PutBytes(char **, char *, size_t);
 void ValBuf_PutI2BYT(char **, I2BYT);
 void ValBuf_PutI4BYT(char **, I4BYT);